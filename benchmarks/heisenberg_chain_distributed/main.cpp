@@ -1,15 +1,37 @@
 #include <xdiag/all.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace xdiag;
 using namespace arma;
 
+// Scaling benchmark of the distributed Heisenberg chain. Run with varying
+// numbers of MPI ranks and OpenMP threads per rank, e.g.
+//
+//   OMP_NUM_THREADS=32 mpirun -np 4 --bind-to none ./main 36 20
+//   OMP_NUM_THREADS=1 mpirun -np 128 ./main 36 20
+//
+// and compare the time per matrix-vector multiplication (MVM).
 int main(int argc, char *argv[]) try {
-  MPI_Init(&argc, &argv);
+  // only the main thread of a rank calls MPI
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
   int N = atoi(argv[1]);
+  int nmvm = (argc > 2) ? atoi(argv[2]) : 10;
   int nup = N / 2;
-  XDIAG_SHOW(N);
 
-  Log.set_verbosity(3);
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  XDIAG_SHOW(N);
+  XDIAG_SHOW(mpi_size);
+  XDIAG_SHOW(nthreads);
 
   tic();
   auto block = SpinhalfDistributed(N, nup);
@@ -21,9 +43,30 @@ int main(int argc, char *argv[]) try {
     ops += Op("SdotS", {i, (i + 1) % N});
   }
 
+  auto v = State(block);
+  fill(v, RandomState(42));
+  auto w = State(block);
+
+  apply(ops, v, w); // warm-up, allocates the communication buffers
+  reset_phase_times_mpi();
+  MPI_Barrier(MPI_COMM_WORLD);
+  double t0 = MPI_Wtime();
+  for (int i = 0; i < nmvm; ++i) {
+    apply(ops, v, w);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  double t1 = MPI_Wtime();
+  if (mpi_rank == 0) {
+    Log("ranks: {}, threads/rank: {}, time/MVM: {:.4f} secs", mpi_size,
+        nthreads, (t1 - t0) / nmvm);
+  }
+  LogMPI.set_verbosity(1);
+  print_phase_times_mpi();
+
   tic();
   double e0 = eigval0(ops, block, 1e-12, 5);
-  toc("MVM");
+  toc("eigval0");
+  XDIAG_SHOW(e0);
   MPI_Finalize();
 } catch (Error e) {
   error_trace(e);
@@ -3,6 +3,13 @@
 using namespace xdiag;
 using namespace arma;
 
+// Full diagonalization of a small Heisenberg chain, followed by a Lanczos run
+// on a larger chain with the default and the fused recurrence, e.g.
+//
+//   ./main 26 100
+//
+// Run with set_verbosity(1) to see the time per MVM; the remainder of the
+// time per iteration is spent in the recurrence.
 int main(int argc, char *argv[]) try {
   int N = 13;
   auto block = Spinhalf(N);
@@ -21,6 +28,24 @@ int main(int argc, char *argv[]) try {
   eig_sym(eigval, eigvec, H);
   toc("diagonalization");
 
+  int NL = (argc > 1) ? atoi(argv[1]) : 24;
+  int niter = (argc > 2) ? atoi(argv[2]) : 50;
+  auto blockL = Spinhalf(NL, NL / 2);
+  OpSum opsL;
+  for (int i = 0; i < NL; ++i) {
+    opsL += Op("SdotS", {i, (i + 1) % NL});
+  }
+  XDIAG_SHOW(blockL);
+  for (bool fused : {false, true}) {
+    // precision 0: performs exactly niter iterations
+    auto t0 = rightnow();
+    std::string recurrence = fused ? "fused" : "standard";
+    auto r = eigvals_lanczos(opsL, blockL, 1, 0., niter, 1e-7, 42, recurrence,
+                             fused);
+    double t = std::chrono::duration<double>(rightnow() - t0).count();
+    Log("fused: {}, time/iteration: {:.4f} secs, e0: {:.12f}",
+        fused, t / r.niterations, r.eigenvalues(0));
+  }
 } catch (Error e) {
   error_trace(e);
 }
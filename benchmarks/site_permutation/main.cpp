@@ -0,0 +1,103 @@
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <xdiag/combinatorics/combinations/combinations.hpp>
+#include <xdiag/symmetries/action/representative.hpp>
+#include <xdiag/symmetries/action/site_permutation.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/timing.hpp>
+
+using namespace xdiag;
+using namespace symmetries;
+using combinatorics::Combinations;
+
+// Compares the precompiled SitePermutation::apply with the bit-by-bit
+// apply_generic by permuting all states of a fixed particle number with all
+// group elements, as done when computing representatives.
+static void bench(std::string name, PermutationGroup const &group, int n,
+                  int k) {
+  auto sp = SitePermutation(group);
+  auto combs = Combinations<uint64_t>(n, k);
+
+  uint64_t x1 = 0;
+  tic();
+  for (auto s : combs) {
+    for (int64_t sym = 0; sym < sp.size(); ++sym) {
+      x1 ^= sp.apply_generic(sym, s);
+    }
+  }
+  toc(name + " apply_generic");
+
+  uint64_t x2 = 0;
+  tic();
+  for (auto s : combs) {
+    for (int64_t sym = 0; sym < sp.size(); ++sym) {
+      x2 ^= sp.apply(sym, s);
+    }
+  }
+  toc(name + " apply");
+  Log("{} states x {} syms, checksums {} {}", combs.size(), sp.size(), x1, x2);
+
+  // representative search, symmetry by symmetry vs. batched
+  uint64_t r1 = 0;
+  tic();
+  for (auto s : combs) {
+    uint64_t rep = std::numeric_limits<uint64_t>::max();
+    for (int64_t sym = 0; sym < sp.size(); ++sym) {
+      uint64_t t = sp.apply(sym, s);
+      rep = (t < rep) ? t : rep;
+    }
+    r1 ^= rep;
+  }
+  toc(name + " representative (loop)");
+
+  uint64_t r2 = 0;
+  tic();
+  for (auto s : combs) {
+    r2 ^= representative(s, sp);
+  }
+  toc(name + " representative (batched)");
+  Log("checksums {} {}", r1, r2);
+}
+
+int main() try {
+  // chain translations: shift-and-mask
+  int n = 32;
+  int k = 6;
+  bench("chain", cyclic_group(n), n, k);
+
+  // chain reflections: lookup tables
+  std::vector<Permutation> perms;
+  for (int64_t t = 0; t < n; ++t) {
+    std::vector<int64_t> p(n), r(n);
+    for (int64_t i = 0; i < n; ++i) {
+      p[i] = (i + t) % n;
+      r[i] = (n - 1 - i + t) % n;
+    }
+    perms.push_back(Permutation(p));
+    perms.push_back(Permutation(r));
+  }
+  bench("dihedral", PermutationGroup(perms), n, k);
+
+  // 6 x 6 square lattice translations
+  int L = 6;
+  perms.clear();
+  for (int64_t tx = 0; tx < L; ++tx) {
+    for (int64_t ty = 0; ty < L; ++ty) {
+      std::vector<int64_t> p(L * L);
+      for (int64_t x = 0; x < L; ++x) {
+        for (int64_t y = 0; y < L; ++y) {
+          p[y * L + x] = ((y + ty) % L) * L + (x + tx) % L;
+        }
+      }
+      perms.push_back(Permutation(p));
+    }
+  }
+  bench("square", PermutationGroup(perms), L * L, 6);
+
+} catch (Error e) {
+  error_trace(e);
+}
@@ -43,6 +43,13 @@ int main(int argc, char *argv[]) try {
   auto coo = coo_matrix(ops, block);
   toc("COO matrix creation");
 
+  // single-pass vs. two-pass assembly
+  for (std::string assembly : {"twopass", "singlepass"}) {
+    tic();
+    auto csr = csr_matrix(ops, block, 0, assembly);
+    toc(fmt::format("CSR matrix creation ({})", assembly));
+  }
+
   tic();
   auto csr = csr_matrix(ops, block);
   toc("CSR matrix creation");
@@ -56,7 +63,47 @@ int main(int argc, char *argv[]) try {
   tic();
   apply(csr, x, y);
   toc("CSR matrix multiply");
-  
+
+  // SELL-C-sigma against CSR (MKL if enabled), single and multiple vectors
+  auto csr32 = csr_matrix_32(ops, block);
+  auto sell = sell_matrix(csr);
+  auto sell32 = sell_matrix(csr32);
+  tic();
+  apply(sell, x, y);
+  toc("SELL matrix multiply");
+  tic();
+  apply(csr32, x, y);
+  toc("CSR matrix multiply (int32)");
+  tic();
+  apply(sell32, x, y);
+  toc("SELL matrix multiply (int32)");
+
+  // value-indexed CSR, few distinct entries in the Heisenberg chain
+  auto csrvi = csrvi_matrix(csr);
+  tic();
+  apply(csrvi, x, y);
+  toc("CSRVI matrix multiply");
+
+  // Hermitian half storage against the full matrix
+  tic();
+  auto csr_upper = csr_matrix_triangle(ops, block);
+  toc("CSR matrix creation (upper triangle)");
+  tic();
+  apply(csr_upper, x, y);
+  toc("CSR matrix multiply (upper triangle)");
+
+  auto X = arma::mat(csr.ncols, 8, arma::fill::randu);
+  auto Y = arma::mat(csr.nrows, 8, arma::fill::zeros);
+  tic();
+  apply(csr, X, Y);
+  toc("CSR matrix multiply (8 vectors)");
+  tic();
+  apply(sell, X, Y);
+  toc("SELL matrix multiply (8 vectors)");
+  tic();
+  apply(csrvi, X, Y);
+  toc("CSRVI matrix multiply (8 vectors)");
+
   tic();
   double e0 = eigval0(ops, block, 1e-12, 3);
   toc("MVM");
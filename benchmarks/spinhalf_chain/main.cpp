@@ -2,6 +2,57 @@
 
 using namespace xdiag;
 
+// Compares the term-by-term apply (one sweep over the basis per term) with the
+// fused apply (a single sweep evaluating all terms per basis state) and the
+// apply of a precompiled operator
+void bench_apply(OpSum const &ops, Block const &block, int64_t nmvm = 10) {
+  arma::vec v(size(block), arma::fill::randn);
+  arma::vec w(size(block), arma::fill::zeros);
+
+  tic();
+  for (int64_t i = 0; i < nmvm; ++i) {
+    apply(ops, block, v, block, w);
+  }
+  toc(fmt::format("{} MVMs (term-by-term)", nmvm));
+
+  tic();
+  for (int64_t i = 0; i < nmvm; ++i) {
+    apply(ops, block, v, block, w, true);
+  }
+  toc(fmt::format("{} MVMs (fused)", nmvm));
+
+  // CompiledOpSum: normal ordering is done once when building the plan
+  tic();
+  auto plan = compiled_opsum(ops, block, true);
+  toc("CompiledOpSum build");
+  tic();
+  for (int64_t i = 0; i < nmvm; ++i) {
+    apply(plan, block, v, block, w);
+  }
+  toc(fmt::format("{} MVMs (compiled, fused)", nmvm));
+
+  tic();
+  auto res =
+      eigs_lanczos(ops, block, 1, 1e-12, 20, 1e-7, 42, "rerun", "fused", true);
+  toc("eigs_lanczos (fused)");
+  Log("e0 (fused): {:.12f}", res.eigenvalues(0));
+}
+
+// Compares eigs_lanczos rerunning the Lanczos recurrence to form the
+// eigenvectors with the single run storing the Lanczos vectors
+void bench_eigs_lanczos(OpSum const &ops, Block const &block) {
+  for (std::string store : {"rerun", "memory", "disk"}) {
+    tic();
+    auto res = eigs_lanczos(ops, block, 1, 1e-12, 1000, 1e-7, 42, store,
+                            "fused", true);
+    int64_t nmvm = (store == "rerun") ? 2 * res.niterations : res.niterations;
+    toc(fmt::format("eigs_lanczos ({}), {} MVMs", store, nmvm));
+    if (store != "rerun") {
+      Log("MVMs saved ({}): {}", store, res.niterations);
+    }
+  }
+}
+
 int main(int argc, char *argv[]) try {
   assert(argc == 2);
   int64_t nsites = atoi(argv[1]);
@@ -29,6 +80,9 @@ int main(int argc, char *argv[]) try {
     double e0 = eigval0(ops, block, 1e-12, 20);
     toc("MVM");
 
+    bench_apply(ops, block);
+    bench_eigs_lanczos(ops, block);
+
   } else {
     auto fl =
         FileToml(fmt::format("lattice-files/chain.{}.J1J2.2sl.toml", nsites));
@@ -47,6 +101,9 @@ int main(int argc, char *argv[]) try {
     tic();
     double e0 = eigval0(ops, block, 1e-12, 20);
     toc("MVM");
+
+    bench_apply(ops, block);
+    bench_eigs_lanczos(ops, block);
   }
 } catch (Error e) {
   error_trace(e);
@@ -7,9 +7,12 @@ set(XDIAG_SOURCES
   utils/say_hello.cpp
   utils/read_vectors.cpp
   utils/timing.cpp
+  utils/thread_utilization.cpp
+  utils/memory.cpp
 
   # Input / Output 
   io/read.cpp
+  io/basis_cache.cpp
   io/file_toml.cpp
   io/toml/file_toml_handler.cpp
   io/toml/value.cpp
@@ -30,6 +33,7 @@ set(XDIAG_SOURCES
 
   # Core computational kernels
   kernels/apply.cpp
+  kernels/compiled_opsum.cpp
   kernels/matrix.cpp
   kernels/sparse/coo_matrix.cpp
   kernels/sparse/sparse_build.cpp
@@ -37,6 +41,8 @@ set(XDIAG_SOURCES
   kernels/sparse/csc_matrix.cpp
   kernels/sparse/valid.cpp
   kernels/sparse/apply.cpp
+  kernels/sparse/sell_matrix.cpp
+  kernels/sparse/csrvi_matrix.cpp
   kernels/blocks/spinhalf/kernels.cpp
   kernels/blocks/boson/kernels.cpp
   kernels/blocks/fermion/kernels.cpp
@@ -125,6 +131,7 @@ set(XDIAG_SOURCES
   symmetries/action/sublattice_stability.cpp
   symmetries/tables/representative_table.cpp
   symmetries/tables/fermi_table.cpp
+  symmetries/tables/fermi_block_table.cpp
 
   # Algebraic capabilities
   algebra/symmetrize.cpp
@@ -153,9 +160,11 @@ set(XDIAG_SOURCES
   linalg/lanczos/tmatrix.cpp
   linalg/lanczos/eigvals_lanczos.cpp
   linalg/lanczos/eigs_lanczos.cpp
+  linalg/lanczos/eigs_trlanczos.cpp
   linalg/lobpcg/eigs_lobpcg.cpp
   linalg/sparse_diag.cpp
   linalg/arnoldi/arnoldi_to_disk.cpp
+  linalg/arnoldi/krylov_store.cpp
   linalg/gram_schmidt/gram_schmidt.cpp
   linalg/gram_schmidt/orthogonalize.cpp
   linalg/norm_estimate.cpp
@@ -164,6 +173,7 @@ set(XDIAG_SOURCES
   linalg/time_evolution/time_evolve_expokit.cpp
   linalg/time_evolution/evolve_lanczos.cpp
   linalg/time_evolution/expm.cpp
+  linalg/time_evolution/time_evolve_trajectory.cpp
 )
 
 set(XDIAG_HDF5_SOURCES
@@ -184,6 +194,7 @@ set(XDIAG_DISTRIBUTED_SOURCES
   mpi/comm_pattern.cpp
   mpi/communicator.cpp
   mpi/datatype.cpp
+  mpi/exchange.cpp
   mpi/timing_mpi.cpp
 
   # distributed bases
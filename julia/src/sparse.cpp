@@ -28,25 +28,25 @@ template <typename block_t> static void register_sparse(jlcxx::Module &mod) {
   mod.method("fun_coo_fill",
              [](OpSum const &ops, block_t const &in, int64_t nnz, int64_t *row,
                 int64_t *col, double *data, int64_t i0) {
-               JULIA_XDIAG_CALL_VOID((coo_matrix_fill<int64_t, double>(
+               JULIA_XDIAG_CALL_RETURN((coo_matrix_fill<int64_t, double>(
                    ops, in, block(ops, in), nnz, row, col, data, i0)));
              });
   mod.method("fun_coo_fill",
              [](OpSum const &ops, block_t const &in, int64_t nnz, int32_t *row,
                 int32_t *col, double *data, int32_t i0) {
-               JULIA_XDIAG_CALL_VOID((coo_matrix_fill<int32_t, double>(
+               JULIA_XDIAG_CALL_RETURN((coo_matrix_fill<int32_t, double>(
                    ops, in, block(ops, in), nnz, row, col, data, i0)));
              });
   mod.method("fun_coo_fill",
              [](OpSum const &ops, block_t const &in, int64_t nnz, int64_t *row,
                 int64_t *col, complex *data, int64_t i0) {
-               JULIA_XDIAG_CALL_VOID((coo_matrix_fill<int64_t, complex>(
+               JULIA_XDIAG_CALL_RETURN((coo_matrix_fill<int64_t, complex>(
                    ops, in, block(ops, in), nnz, row, col, data, i0)));
              });
   mod.method("fun_coo_fill",
              [](OpSum const &ops, block_t const &in, int64_t nnz, int32_t *row,
                 int32_t *col, complex *data, int32_t i0) {
-               JULIA_XDIAG_CALL_VOID((coo_matrix_fill<int32_t, complex>(
+               JULIA_XDIAG_CALL_RETURN((coo_matrix_fill<int32_t, complex>(
                    ops, in, block(ops, in), nnz, row, col, data, i0)));
              });
 
@@ -20,10 +20,14 @@ function _coo_matrix(ops::OpSum, block_in::Block, ::Type{Ti}; i0=1) where {Ti<:I
     nrows = Ti(fun_sparse_dim_out(ops.cxx_object, block_in.cxx_object))
     ncols = Ti(size(block_in))
     row, col, data = Vector{Ti}(undef, nnz), Vector{Ti}(undef, nnz), Vector{Tc}(undef, nnz)
-    GC.@preserve row col data begin
+    nnz_merged = GC.@preserve row col data begin
         fun_coo_fill(ops.cxx_object, block_in.cxx_object, Int64(nnz),
                      pointer(row), pointer(col), pointer(data), Ti(i0))
     end
+    # duplicate entries are merged, the tail beyond the merged nnz is unused
+    resize!(row, nnz_merged)
+    resize!(col, nnz_merged)
+    resize!(data, nnz_merged)
     return COOMatrix{Ti,Tc}(nrows, ncols, row, col, data, Ti(i0), herm)
 end
 coo_matrix(ops::OpSum, block::Block; i0=1) = _coo_matrix(ops, block, Int64; i0)
@@ -39,6 +43,9 @@ function _csr_matrix(ops::OpSum, block_in::Block, ::Type{Ti}; i0=1) where {Ti<:I
         fun_csr_fill(ops.cxx_object, block_in.cxx_object, counts,
                      pointer(rowptr), pointer(col), pointer(data), Ti(i0), false)
     end
+    # duplicate entries are merged, the tail beyond the merged nnz is unused
+    resize!(col, rowptr[end] - i0)
+    resize!(data, rowptr[end] - i0)
     return CSRMatrix{Ti,Tc}(nrows, ncols, rowptr, col, data, Ti(i0), herm)
 end
 csr_matrix(ops::OpSum, block::Block; i0=1) = _csr_matrix(ops, block, Int64; i0)
@@ -55,6 +62,8 @@ function _csc_matrix(ops::OpSum, block_in::Block, ::Type{Ti}; i0=1) where {Ti<:I
         fun_csr_fill(ops.cxx_object, block_in.cxx_object, counts,
                      pointer(colptr), pointer(row), pointer(data), Ti(i0), true)
     end
+    resize!(row, colptr[end] - i0)
+    resize!(data, colptr[end] - i0)
     return CSCMatrix{Ti,Tc}(nrows, ncols, colptr, row, data, Ti(i0), herm)
 end
 csc_matrix(ops::OpSum, block::Block; i0=1) = _csc_matrix(ops, block, Int64; i0)
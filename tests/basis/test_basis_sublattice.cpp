@@ -6,6 +6,10 @@
 
 #include <iostream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <xdiag/basis/basis_sublattice.hpp>
 #include <xdiag/basis/basis_symmetric.hpp>
 #include <xdiag/combinatorics/combinations/combinations.hpp>
@@ -181,6 +185,52 @@ template <typename bit_t> void test_basis_sublattice() {
   }
 }
 
+// Build a BasisSublattice with a single and with several OpenMP threads and
+// check that the representatives, norms and index lookups agree
+template <typename bit_t, int n_sublat>
+void test_sublattice_threads(std::string const &lfile,
+                             std::vector<std::string> const &irrep_names) {
+#ifdef _OPENMP
+  using namespace basis;
+  using namespace combinatorics;
+  int nthreads = omp_get_max_threads();
+  auto fl = FileToml(lfile);
+  for (auto const &irrep_name : irrep_names) {
+    auto irrep = read_representation(fl, irrep_name);
+    int64_t nsites = irrep.group().nsites();
+    for (int64_t nup = -1; nup <= nsites; ++nup) {
+      auto build = [&]() {
+        return (nup < 0) ? BasisSublattice<bit_t, n_sublat>(
+                               irrep.group(), irrep.characters())
+                         : BasisSublattice<bit_t, n_sublat>(
+                               nup, irrep.group(), irrep.characters());
+      };
+      omp_set_num_threads(1);
+      auto basis_serial = build();
+      for (int64_t idx = 0; idx < basis_serial.size(); ++idx) {
+        REQUIRE(basis_serial.index(basis_serial[idx]) == idx);
+      }
+      for (int n : {2, 3, 4}) {
+        omp_set_num_threads(n);
+        auto basis = build();
+        REQUIRE(basis.size() == basis_serial.size());
+        for (int64_t idx = 0; idx < basis.size(); ++idx) {
+          REQUIRE(basis[idx] == basis_serial[idx]);
+          REQUIRE(basis.norm(idx) == basis_serial.norm(idx));
+        }
+        for (auto state : Subsets<bit_t>(nsites)) {
+          REQUIRE(basis.index(state) == basis_serial.index(state));
+        }
+      }
+    }
+  }
+  omp_set_num_threads(nthreads);
+#else
+  (void)lfile;
+  (void)irrep_names;
+#endif
+}
+
 TEST_CASE("basis_sublattice", "[basis]") try {
   Log("Test basis_sublattice");
   // uint32_t sublattice coding was removed to shrink the library; the block
@@ -192,3 +242,21 @@ TEST_CASE("basis_sublattice", "[basis]") try {
   error_trace(e);
   throw;
 }
+
+TEST_CASE("basis_sublattice_threads", "[basis]") try {
+  Log("Test basis_sublattice with several threads");
+  test_sublattice_threads<uint64_t, 2>(
+      XDIAG_DIRECTORY "/misc/data/square.8.heisenberg.2sl.toml",
+      {"Gamma.D4.A1", "M.D4.E", "X.D2.B1"});
+  test_sublattice_threads<uint64_t, 3>(
+      XDIAG_DIRECTORY
+      "/misc/data/triangular.9.Jz1Jz2Jx1Jx2D1.sublattices.tsl.toml",
+      {"Gamma.D6.A1", "K.D3.E", "Y.D1.B"});
+  test_sublattice_threads<uint64_t, 5>(
+      XDIAG_DIRECTORY "/misc/data/square.10.heisenberg.5sl.toml",
+      {"Gamma.C2.A", "Z1.C1.A"});
+  Log("Done");
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
@@ -50,6 +50,28 @@ template <class Basis> void check_iterator(Basis const &basis) {
   REQUIRE(count == basis.size());
 }
 
+// Checks that a basis with compact tables agrees with the full tables
+template <typename bit_t, class Basis, class Enumeration>
+void check_compact(Basis const &basis, Basis const &basis_compact,
+                   Enumeration const &enumeration) {
+  REQUIRE(basis_compact.size() == basis.size());
+  REQUIRE(basis_compact.table_memory() <= basis.table_memory());
+  for (int64_t idx = 0; idx < basis.size(); ++idx) {
+    REQUIRE(basis_compact[idx] == basis[idx]);
+    REQUIRE(basis_compact.norm(idx) == basis.norm(idx));
+  }
+  auto action = symmetries::SitePermutation(basis.group());
+  for (bit_t state : enumeration) {
+    auto [raw, sym, norm_out] = basis.representative_data(state);
+    auto [raw_c, sym_c, norm_out_c] = basis_compact.representative_data(state);
+    REQUIRE(raw_c == raw);
+    if (raw_c) {
+      REQUIRE(action.apply(sym_c, state) == basis_compact[raw_c - 1]);
+      REQUIRE(norm_out_c == norm_out);
+    }
+  }
+}
+
 template <typename bit_t> void test_no_sz(Representation const &irrep) {
   using namespace basis;
   using namespace combinatorics;
@@ -62,6 +84,10 @@ template <typename bit_t> void test_no_sz(Representation const &irrep) {
   for (auto state : enumeration)
     check_state(state, b);
   check_iterator(b);
+
+  auto bc = BasisSymmetric<Subsets<bit_t>>(enumeration, irrep.group(),
+                                           irrep.characters(), false, true);
+  check_compact<bit_t>(b, bc, enumeration);
 }
 
 template <typename bit_t>
@@ -77,6 +103,10 @@ void test_sz(int64_t nup, Representation const &irrep) {
   for (auto state : enumeration)
     check_state(state, b);
   check_iterator(b);
+
+  auto bc = BasisSymmetric<Combinations<bit_t>>(
+      enumeration, irrep.group(), irrep.characters(), false, true);
+  check_compact<bit_t>(b, bc, enumeration);
 }
 
 template <typename bit_t> void test_basis_symmetric_cyclic() {
@@ -88,6 +118,22 @@ template <typename bit_t> void test_basis_symmetric_cyclic() {
         test_sz<bit_t>(nup, irrep);
     }
   }
+
+  // Compact tables are only used once the enumeration outweighs the
+  // precompiled symmetry tables they keep
+  {
+    using namespace basis;
+    using namespace combinatorics;
+    int64_t nsites = 16;
+    auto irrep = cyclic_group_irrep(nsites, 3);
+    test_no_sz<bit_t>(irrep);
+    auto enumeration = Subsets<bit_t>(nsites);
+    auto b = BasisSymmetric<Subsets<bit_t>>(enumeration, irrep.group(),
+                                            irrep.characters());
+    auto bc = BasisSymmetric<Subsets<bit_t>>(enumeration, irrep.group(),
+                                             irrep.characters(), false, true);
+    REQUIRE(bc.table_memory() < b.table_memory());
+  }
 }
 
 template <typename bit_t> void test_basis_symmetric_lattice() {
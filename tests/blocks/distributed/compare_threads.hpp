@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <tests/catch.hpp>
+
+#include <xdiag/algebra/isapprox.hpp>
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/states/apply.hpp>
+#include <xdiag/states/create_state.hpp>
+
+namespace xdiag {
+
+// Apply an OpSum on a distributed block with a single and with several
+// OpenMP threads per rank and check that the results agree -- shared by the
+// tJ / electron / spinhalf distributed test files.
+inline void compare_threads(OpSum const &ops, Block const &block) {
+#ifdef _OPENMP
+  int nthreads = omp_get_max_threads();
+  auto r = random_state(block, false);
+  omp_set_num_threads(1);
+  auto w = apply(ops, r);
+  for (int n : {2, 3, 4}) {
+    omp_set_num_threads(n);
+    auto wn = apply(ops, r);
+    REQUIRE(isapprox(w, wn));
+  }
+  omp_set_num_threads(nthreads);
+#else
+  (void)ops;
+  (void)block;
+#endif
+}
+
+} // namespace xdiag
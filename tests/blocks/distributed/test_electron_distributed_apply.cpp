@@ -14,6 +14,7 @@
 #include <xdiag/blocks/distributed/tj_distributed.hpp>
 #include <xdiag/blocks/tj.hpp>
 #include <xdiag/linalg/sparse_diag.hpp>
+#include <xdiag/mpi/exchange.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/matrix.hpp>
 #include <xdiag/states/apply.hpp>
@@ -23,6 +24,7 @@
 #include <xdiag/utils/logger.hpp>
 
 #include <tests/blocks/distributed/compare_observables.hpp>
+#include <tests/blocks/distributed/compare_threads.hpp>
 
 
 using namespace xdiag;
@@ -123,6 +125,26 @@ TEST_CASE("electron_distributed_apply", "[electron_distributed]") {
     }
   }
 
+  // Up hoppings in rounds of bounded size must give the same result
+  for (int nsites = 3; nsites < 6; ++nsites) {
+    Log("electron_apply: Hubbard all-to-all in rounds, N: {}", nsites);
+    OpSum ops = freefermion_alltoall_complex_updn(nsites);
+    ops["U"] = 5.0;
+    for (int nup = 0; nup <= nsites; ++nup) {
+      for (int ndn = 0; ndn <= nsites; ++ndn) {
+        auto block = ElectronDistributed(nsites, nup, ndn);
+        auto r = random_state(block, false);
+        auto w = apply(ops, r);
+        for (int64_t round_size : {1, 7, 100}) {
+          mpi::exchange_settings.round_size = round_size;
+          auto w2 = apply(ops, r);
+          mpi::exchange_settings.round_size = 0;
+          REQUIRE(isapprox(w, w2));
+        }
+      }
+    }
+  }
+
   ////////////////////////////
   // Henry's MATLAB code test (tests Heisenberg terms)
   Log("electron_apply: U-hopping-HB apply of Henry's Matlab code");
@@ -237,3 +259,16 @@ TEST_CASE("electron_distributed_observables", "[electron_distributed]") {
                         ElectronDistributed(N, nup, ndn), onesite, twosite);
   }
 }
+
+TEST_CASE("electron_distributed_threads", "[electron_distributed]") {
+  Log("ElectronDistributed: threaded apply test, N=2,..,5");
+  for (int N = 2; N <= 5; ++N) {
+    auto ops = testcases::tj::tj_alltoall_complex(N);
+    ops += 3.0 * Op("HubbardU");
+    for (int nup = 0; nup <= N; ++nup) {
+      for (int ndn = 0; ndn <= N; ++ndn) {
+        compare_threads(ops, ElectronDistributed(N, nup, ndn));
+      }
+    }
+  }
+}
@@ -14,6 +14,7 @@
 #include <xdiag/linalg/sparse_diag.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/matrix.hpp>
+#include <xdiag/mpi/exchange.hpp>
 #include <xdiag/states/apply.hpp>
 #include <xdiag/states/inner.hpp>
 #include <xdiag/states/dot.hpp>
@@ -21,6 +22,7 @@
 #include <xdiag/utils/logger.hpp>
 
 #include <tests/blocks/distributed/compare_observables.hpp>
+#include <tests/blocks/distributed/compare_threads.hpp>
 
 using namespace xdiag;
 
@@ -229,6 +231,46 @@ TEST_CASE("spinhalf_distributed_apply", "[spinhalf_distributed]") try {
     test_sz_sp_sm_commutators(N);
   }
 
+  // Exchanges in rounds of bounded size must give the same result
+  Log("SpinhalfDistributed: Heisenberg alltoall in rounds, N=2,..,8");
+  for (int N = 2; N <= 8; ++N) {
+    auto ops = HB_alltoall(N);
+    for (int nup = 0; nup <= N; ++nup) {
+      auto block = SpinhalfDistributed(N, nup);
+      auto r = random_state(block);
+      auto w = apply(ops, r);
+      for (int64_t round_size : {1, 7, 100}) {
+        mpi::exchange_settings.round_size = round_size;
+        auto w2 = apply(ops, r);
+        mpi::exchange_settings.round_size = 0;
+        REQUIRE(isapprox(w, w2));
+      }
+      mpi::release_buffers();
+      REQUIRE(mpi::buffer_memory() == 0);
+    }
+  }
+
+  // Several terms per exchange and several exchanges in flight
+  Log("SpinhalfDistributed: Heisenberg alltoall batched exchanges, N=2,..,8");
+  for (int N = 2; N <= 8; ++N) {
+    auto ops = HB_alltoall(N);
+    for (int nup = 0; nup <= N; ++nup) {
+      auto block = SpinhalfDistributed(N, nup);
+      auto r = random_state(block);
+      auto w = apply(ops, r);
+      for (auto [terms, inflight] : {std::pair<int64_t, int64_t>{2, 2},
+                                     {3, 1},
+                                     {1, 3}}) {
+        mpi::exchange_settings.terms_per_exchange = terms;
+        mpi::exchange_settings.exchanges_in_flight = inflight;
+        auto w2 = apply(ops, r);
+        mpi::exchange_settings.terms_per_exchange = 1;
+        mpi::exchange_settings.exchanges_in_flight = 1;
+        REQUIRE(isapprox(w, w2));
+      }
+    }
+  }
+
   test_onsite("Sz", "SzSz");
 
   for (int nsites = 2; nsites < 6; ++nsites) {
@@ -284,3 +326,19 @@ TEST_CASE("spinhalf_distributed_observables", "[spinhalf_distributed]") {
                         onesite, twosite);
   }
 }
+
+TEST_CASE("spinhalf_distributed_threads", "[spinhalf_distributed]") {
+  using namespace xdiag::testcases::spinhalf;
+  Log("SpinhalfDistributed: threaded apply test, N=2,..,8");
+  for (int N = 2; N <= 8; ++N) {
+    OpSum ops = HB_alltoall(N);
+    for (int i = 0; i < N; ++i) {
+      ops += complex(0.0, 0.1 * (i + 1)) *
+             Op("ExchangeAsym", {i, (i + 1) % N});
+      ops += (0.2 * i) * Op("Sz", i);
+    }
+    for (int nup = 0; nup <= N; ++nup) {
+      compare_threads(ops, SpinhalfDistributed(N, nup));
+    }
+  }
+}
@@ -15,7 +15,9 @@
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/matrix.hpp>
 #include <xdiag/linalg/sparse_diag.hpp>
+#include <xdiag/mpi/exchange.hpp>
 #include <tests/blocks/distributed/compare_observables.hpp>
+#include <tests/blocks/distributed/compare_threads.hpp>
 
 #include <xdiag/states/apply.hpp>
 #include <xdiag/states/create_state.hpp>
@@ -177,6 +179,25 @@ TEST_CASE("tj_distributed_apply", "[tj_distributed]") {
     }
   }
 
+  // Up hoppings in rounds of bounded size must give the same result
+  for (int nsites = 2; nsites < 7; ++nsites) {
+    Log("tj_distributed: tj_alltoall in rounds N={}", nsites);
+    auto ops = tj_alltoall_complex(nsites);
+    for (int nup = 0; nup <= nsites; ++nup) {
+      for (int ndn = 0; ndn <= nsites - nup; ++ndn) {
+        auto block = tJDistributed(nsites, nup, ndn);
+        auto r = random_state(block, false);
+        auto w = apply(ops, r);
+        for (int64_t round_size : {1, 7, 100}) {
+          mpi::exchange_settings.round_size = round_size;
+          auto w2 = apply(ops, r);
+          mpi::exchange_settings.round_size = 0;
+          REQUIRE(isapprox(w, w2));
+        }
+      }
+    }
+  }
+
   Log.out("tj_distributed: HB triangular N=12 complex exchange");
   int nsites = 12;
   std::vector<double> etas = {0.00, 0.01, 0.02,
@@ -312,3 +333,15 @@ TEST_CASE("tj_distributed_observables", "[tj_distributed]") {
                         onesite, twosite);
   }
 }
+
+TEST_CASE("tj_distributed_threads", "[tj_distributed]") {
+  Log("tJDistributed: threaded apply test, N=2,..,6");
+  for (int N = 2; N <= 6; ++N) {
+    auto ops = testcases::tj::tj_alltoall_complex(N);
+    for (int nup = 0; nup <= N; ++nup) {
+      for (int ndn = 0; ndn <= N - nup; ++ndn) {
+        compare_threads(ops, tJDistributed(N, nup, ndn));
+      }
+    }
+  }
+}
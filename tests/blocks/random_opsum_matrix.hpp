@@ -54,6 +54,35 @@ inline Op random_op(std::string const &type, int64_t nsites,
   return Op(type, sites);
 }
 
+// Random OpSum with complex coefficients made of n_monomials random Ops of
+// the non-matrix types in the implementation algebra of the block, whose site
+// arity does not exceed nsites.
+template <typename block_t>
+inline OpSum random_opsum(block_t const &block, std::mt19937 &gen,
+                          int n_monomials = 20) {
+  int64_t nsites = block.nsites();
+  algebra::Algebra alg = algebra::implementation_algebra(block);
+  std::vector<std::string> types;
+  for (std::string const &t : alg.allowed_types) {
+    OpTypeInfo const &info = info_of_type(t);
+    if (info.matrix_required) {
+      continue;
+    }
+    if (info.nsites != undefined && info.nsites > nsites) {
+      continue;
+    }
+    types.push_back(t);
+  }
+  std::uniform_real_distribution<double> cdist(-1.0, 1.0);
+  std::uniform_int_distribution<std::size_t> typedist(0, types.size() - 1);
+  OpSum ops;
+  for (int m = 0; m < n_monomials; ++m) {
+    ops += complex(cdist(gen), cdist(gen)) *
+           random_op(types[typedist(gen)], nsites, gen);
+  }
+  return ops;
+}
+
 // Shared randomized cross-check of the operator layer, applicable to any block:
 // it builds a random OpSum (random complex coefficients, random monomial
 // lengths, random sites) over every operator type the block supports, then
@@ -450,6 +450,12 @@ TEST_CASE("spinhalf_symmetric_apply", "[spinhalf]") try {
       auto spinhalf = Spinhalf(nsites, nup, irrep);
       double e0 = eigval0(ops, spinhalf);
       REQUIRE(isapprox(e0, energy, 1e-12, 1e-10));
+
+      // compact representative tables
+      auto spinhalf_compact = Spinhalf(nsites, nup, irrep, "compact");
+      REQUIRE(spinhalf_compact.size() == spinhalf.size());
+      double e0_compact = eigval0(ops, spinhalf_compact);
+      REQUIRE(isapprox(e0_compact, energy, 1e-12, 1e-10));
     }
   }
 
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <random>
+
+#include <tests/blocks/random_opsum_matrix.hpp>
+
+#include "testcases_spinhalf.hpp"
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/blocks/spinhalf.hpp>
+#include <xdiag/config.hpp>
+#include <xdiag/io/file_toml.hpp>
+#include <xdiag/io/read.hpp>
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/math/isapprox.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+using namespace xdiag::testcases::spinhalf;
+
+static OpSum random_spinhalf_opsum(int64_t nsites, int64_t nterms,
+                                   bool conserve_sz, std::mt19937 &gen) {
+  std::vector<std::string> types = {"Id", "Exchange", "ExchangeAsym", "SzSz",
+                                    "Sz", "ScalarChirality"};
+  if (!conserve_sz) {
+    types.push_back("S+");
+    types.push_back("S-");
+  }
+  std::uniform_int_distribution<int64_t> typedist(0, types.size() - 1);
+  std::normal_distribution<double> coeffdist;
+  OpSum ops;
+  for (int64_t i = 0; i < nterms; ++i) {
+    auto op = testcases::random_op(types[typedist(gen)], nsites, gen);
+    ops += complex(coeffdist(gen), coeffdist(gen)) * op;
+  }
+  if (!conserve_sz) {
+    arma::cx_mat m(2, 2, arma::fill::randn);
+    ops += complex(coeffdist(gen), 0.) * Op("Matrix", 0, m);
+  }
+  return ops;
+}
+
+static void test_fused_apply(OpSum const &ops, Spinhalf const &block) {
+  arma::cx_mat v(block.size(), 3, arma::fill::randn);
+  arma::cx_mat w1(block.size(), 3, arma::fill::zeros);
+  arma::cx_mat w2(block.size(), 3, arma::fill::zeros);
+  apply(ops, block, v, block, w1);
+  apply(ops, block, v, block, w2, true);
+  REQUIRE(isapprox(w1, w2));
+}
+
+static void test_fused_apply_real(OpSum const &ops, Spinhalf const &block) {
+  arma::vec v(block.size(), arma::fill::randn);
+  arma::vec w1(block.size(), arma::fill::zeros);
+  arma::vec w2(block.size(), arma::fill::zeros);
+  apply(ops, block, v, block, w1);
+  apply(ops, block, v, block, w2, true);
+  REQUIRE(isapprox(w1, w2));
+}
+
+TEST_CASE("spinhalf_fused", "[spinhalf]") try {
+  std::mt19937 gen(42);
+
+  Log("spinhalf_fused: random OpSums, no symmetries");
+  for (int64_t nsites = 3; nsites <= 7; ++nsites) {
+    auto ops = random_spinhalf_opsum(nsites, 20, false, gen);
+    test_fused_apply(ops, Spinhalf(nsites));
+
+    auto ops_sz = random_spinhalf_opsum(nsites, 20, true, gen);
+    for (int64_t nup = 0; nup <= nsites; ++nup) {
+      test_fused_apply(ops_sz, Spinhalf(nsites, nup));
+    }
+  }
+
+  Log("spinhalf_fused: Heisenberg chain, cyclic symmetries");
+  for (int64_t nsites = 3; nsites <= 8; ++nsites) {
+    auto ops = HBchain(nsites, 1.0, 0.3);
+    for (int64_t k = 0; k < nsites; ++k) {
+      auto irrep = cyclic_group_irrep(nsites, k);
+      test_fused_apply(ops, Spinhalf(nsites, irrep));
+      test_fused_apply(ops, Spinhalf(nsites, irrep, "1sublattice"));
+      for (int64_t nup = 0; nup <= nsites; ++nup) {
+        test_fused_apply(ops, Spinhalf(nsites, nup, irrep));
+        test_fused_apply(ops, Spinhalf(nsites, nup, irrep, "1sublattice"));
+      }
+      if (isreal(irrep)) {
+        test_fused_apply_real(ops, Spinhalf(nsites, irrep));
+      }
+    }
+    ops += 0.2 * Op("S+", 0) + 0.2 * Op("S-", 0) + 0.1 * Op("Sz", 1);
+    test_fused_apply_real(ops, Spinhalf(nsites));
+  }
+
+  Log("spinhalf_fused: triangular J1J2Jchi N=12 ground state");
+  {
+    std::string lfile =
+        XDIAG_DIRECTORY "/misc/data/triangular.j1j2jch/"
+                        "triangular.12.j1j2jch.sublattices.fsl.toml";
+    auto fl = FileToml(lfile);
+    auto ops = fl["Interactions"].as<OpSum>();
+    ops["J1"] = 1.00;
+    ops["J2"] = 0.15;
+    ops["Jchi"] = 0.09;
+    auto block = Spinhalf(12, 6);
+    auto res = eigs_lanczos(ops, block, 1, 1e-12, 1000, 1e-7, 42, "rerun",
+                           "fused", true);
+    REQUIRE(isapprox(res.eigenvalues(0), -6.9456000700824329641, 1e-12,
+                     1e-8));
+  }
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+  throw;
+}
@@ -77,6 +77,12 @@ TEST_CASE("print_block", "[blocks]") try {
     std::string s = to_string(Spinhalf(4, 2, irrep));
     REQUIRE(s.find("irrep ID") != std::string::npos);
   }
+  {
+    auto irrep = cyclic_group_irrep(4, 1);
+    std::string s = to_string(Spinhalf(4, 2, irrep, "compact"));
+    REQUIRE(s.find("irrep ID") != std::string::npos);
+    REQUIRE(s.find("tables") != std::string::npos);
+  }
   {
     auto irrep = cyclic_group_irrep(4, 0);
     std::string s = to_string(Electron(4, 2, 1, irrep));
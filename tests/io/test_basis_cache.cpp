@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tests/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <xdiag/basis/basis_sublattice.hpp>
+#include <xdiag/combinatorics/combinations/combinations.hpp>
+#include <xdiag/combinatorics/subsets/subsets.hpp>
+#include <xdiag/config.hpp>
+#include <xdiag/io/basis_cache.hpp>
+#include <xdiag/io/file_toml.hpp>
+#include <xdiag/io/read.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/symmetries/tables/representative_table.hpp>
+#include <xdiag/utils/error.hpp>
+
+using namespace xdiag;
+
+static int64_t nfiles(std::filesystem::path const &directory) {
+  int64_t n = 0;
+  for (auto const &entry : std::filesystem::directory_iterator(directory)) {
+    (void)entry;
+    ++n;
+  }
+  return n;
+}
+
+template <typename enumeration_t>
+void check_tables(symmetries::RepresentativeTable<enumeration_t> const &table,
+                  symmetries::RepresentativeTable<enumeration_t> const &ref,
+                  enumeration_t const &enumeration, bool fermionic) {
+  REQUIRE(table == ref);
+  REQUIRE(table.memory() == ref.memory());
+  for (int64_t idx = 0; idx < ref.size(); ++idx) {
+    REQUIRE(table.representative_norm(idx) == ref.representative_norm(idx));
+  }
+  if (fermionic) {
+    for (int64_t idx = 0; idx < enumeration.size(); ++idx) {
+      REQUIRE(table.representative_fermi_bool(idx) ==
+              ref.representative_fermi_bool(idx));
+    }
+  }
+}
+
+TEST_CASE("basis_cache", "[io]") try {
+  using namespace combinatorics;
+  using table_t = symmetries::RepresentativeTable<Combinations<uint64_t>>;
+
+  auto directory =
+      std::filesystem::temp_directory_path() / "xdiag_test_basis_cache";
+  std::filesystem::remove_all(directory);
+
+  int64_t nsites = 10;
+  for (int64_t k = 0; k < nsites; ++k) {
+    auto irrep = cyclic_group_irrep(nsites, k);
+    auto group = irrep.group();
+    auto characters = irrep.characters();
+    for (int64_t nup = 0; nup <= nsites; nup += 3) {
+      auto enumeration = Combinations<uint64_t>(nsites, nup);
+      for (bool fermionic : {false, true}) {
+        io::basis_cache_settings.directory = "";
+        auto ref = table_t(enumeration, group, characters, fermionic);
+
+        // the first construction writes the cache, the second one reads it
+        io::basis_cache_settings.directory = directory.string();
+        auto written = table_t(enumeration, group, characters, fermionic);
+        auto read = table_t(enumeration, group, characters, fermionic);
+        check_tables(written, ref, enumeration, fermionic);
+        check_tables(read, ref, enumeration, fermionic);
+
+        auto compact = table_t(enumeration, group, characters, fermionic,
+                               /*compact=*/true);
+        auto compact_read = table_t(enumeration, group, characters,
+                                    fermionic, /*compact=*/true);
+        REQUIRE(compact_read == compact);
+        for (int64_t idx = 0; idx < compact.size(); ++idx) {
+          REQUIRE(compact_read[idx] == ref[idx]);
+        }
+        // small enumerations fall back to full tables
+        if (compact.compact()) {
+          for (auto state : enumeration) {
+            REQUIRE(compact_read.raw_representative_index_sym(state) ==
+                    compact.raw_representative_index_sym(state));
+          }
+        }
+      }
+    }
+  }
+  io::basis_cache_settings.directory = "";
+
+  // one file per distinct table, no temporary files are left behind
+  int64_t nfiles_tables = nfiles(directory);
+  REQUIRE(nfiles_tables == nsites * 4 * 2 * 2);
+
+  // truncated or corrupt files are ignored and the tables rebuilt
+  {
+    auto irrep = cyclic_group_irrep(nsites, 1);
+    auto enumeration = Combinations<uint64_t>(nsites, 3);
+    auto ref = table_t(enumeration, irrep.group(), irrep.characters());
+    for (auto const &entry : std::filesystem::directory_iterator(directory)) {
+      auto size = std::filesystem::file_size(entry.path());
+      std::filesystem::resize_file(entry.path(), size / 2);
+    }
+    io::basis_cache_settings.directory = directory.string();
+    auto table = table_t(enumeration, irrep.group(), irrep.characters());
+    REQUIRE(table == ref);
+
+    for (auto const &entry : std::filesystem::directory_iterator(directory)) {
+      std::fstream file(entry.path(), std::ios::in | std::ios::out |
+                                          std::ios::binary);
+      file.seekp(0);
+      file.put('Y');
+    }
+    auto table2 = table_t(enumeration, irrep.group(), irrep.characters());
+    REQUIRE(table2 == ref);
+    io::basis_cache_settings.directory = "";
+  }
+
+  // keys with the same hash are told apart by the full key in the header
+  {
+    auto filename = (directory / "key.bin").string();
+    auto key = io::CacheKey().add(std::string_view("key"));
+    auto other = io::CacheKey().add(std::string_view("other"));
+    {
+      io::CacheWriter file(filename, key);
+      file.write((int64_t)42);
+      file.commit();
+    }
+    REQUIRE(io::CacheReader(filename, key).good());
+    REQUIRE(!io::CacheReader(filename, other).good());
+
+    // overwrite the stored hash (after magic and version) by the other one
+    std::fstream file(filename, std::ios::in | std::ios::out |
+                                    std::ios::binary);
+    file.seekp(16);
+    uint64_t value = other.value();
+    file.write(reinterpret_cast<char const *>(&value), sizeof(value));
+    file.close();
+    REQUIRE(!io::CacheReader(filename, key).good());
+    REQUIRE(!io::CacheReader(filename, other).good());
+    std::filesystem::remove(filename);
+  }
+
+  // a cache directory which cannot be written only issues a warning
+  {
+    auto irrep = cyclic_group_irrep(nsites, 1);
+    auto enumeration = Combinations<uint64_t>(nsites, 3);
+    auto ref = table_t(enumeration, irrep.group(), irrep.characters());
+    auto blocker = directory / "blocker";
+    std::ofstream(blocker).put('x');
+    io::basis_cache_settings.directory = (blocker / "cache").string();
+    auto table = table_t(enumeration, irrep.group(), irrep.characters());
+    REQUIRE(table == ref);
+
+    auto fl = FileToml(XDIAG_DIRECTORY
+                       "/misc/data/square.8.heisenberg.2sl.toml");
+    auto irrep_sl = read_representation(fl, "M.D4.A1");
+    using basis_t = basis::BasisSublattice<uint64_t, 2>;
+    auto basis = basis_t(4, irrep_sl.group(), irrep_sl.characters());
+    REQUIRE(basis.size() > 0);
+    io::basis_cache_settings.directory = "";
+    std::filesystem::remove(blocker);
+  }
+
+  // compact tables, which are only used for larger enumerations
+  {
+    auto irrep = cyclic_group_irrep(20, 1);
+    auto enumeration = Combinations<uint64_t>(20, 10);
+    io::basis_cache_settings.directory = directory.string();
+    auto compact = table_t(enumeration, irrep.group(), irrep.characters(),
+                           false, /*compact=*/true);
+    auto compact_read = table_t(enumeration, irrep.group(),
+                                irrep.characters(), false, /*compact=*/true);
+    io::basis_cache_settings.directory = "";
+    REQUIRE(compact.compact());
+    REQUIRE(compact_read == compact);
+    for (auto state : enumeration) {
+      REQUIRE(compact_read.raw_representative_index_sym(state) ==
+              compact.raw_representative_index_sym(state));
+    }
+  }
+
+  // sublattice bases
+  {
+    auto fl = FileToml(XDIAG_DIRECTORY
+                       "/misc/data/square.8.heisenberg.2sl.toml");
+    auto irrep = read_representation(fl, "M.D4.A1");
+    using basis_t = basis::BasisSublattice<uint64_t, 2>;
+    auto ref = basis_t(4, irrep.group(), irrep.characters());
+    io::basis_cache_settings.directory = directory.string();
+    auto written = basis_t(4, irrep.group(), irrep.characters());
+    auto read = basis_t(4, irrep.group(), irrep.characters());
+    io::basis_cache_settings.directory = "";
+    REQUIRE(read.size() == ref.size());
+    for (int64_t idx = 0; idx < ref.size(); ++idx) {
+      REQUIRE(written[idx] == ref[idx]);
+      REQUIRE(read[idx] == ref[idx]);
+      REQUIRE(read.norm(idx) == ref.norm(idx));
+      REQUIRE(read.index(ref[idx]) == idx);
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+}
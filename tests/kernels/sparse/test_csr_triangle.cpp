@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/csrvi_matrix.hpp>
+#include <xdiag/kernels/sparse/sell_matrix.hpp>
+#include <xdiag/operators/op.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/utils/error.hpp>
+
+#include "testcases_sparse.hpp"
+
+using namespace xdiag;
+using namespace arma;
+
+TEST_CASE("csr_triangle", "[kernels]") try {
+  testcases::sparse::for_each_csr_testcase(
+      [](OpSum const &ops, Block const &block, auto const &csr) {
+        using csr_t = std::decay_t<decltype(csr)>;
+        using coeff_t = typename decltype(csr.data)::elem_type;
+        auto dense = to_dense(csr);
+        for (std::string triangle : {"upper", "lower"}) {
+          for (std::string assembly : {"twopass", "singlepass"}) {
+            csr_t tri = csr_matrix_triangle<decltype(csr.i0), coeff_t>(
+                ops, block, triangle, csr.i0, assembly);
+            REQUIRE(tri.triangle == triangle);
+            REQUIRE(tri.ishermitian);
+            Mat<coeff_t> stored =
+                (triangle == "upper") ? trimatu(dense) : trimatl(dense);
+            REQUIRE(tri.data.n_elem == accu(stored != coeff_t(0.)));
+            tri.triangle = "full";
+            REQUIRE(norm(to_dense(tri) - stored) < 1e-12);
+            tri.triangle = triangle;
+            REQUIRE(norm(to_dense(tri) - dense) < 1e-12);
+            testcases::sparse::check_apply(tri, csr);
+            REQUIRE_THROWS(sell_matrix(tri));
+            REQUIRE_THROWS(csrvi_matrix(tri));
+          }
+        }
+      });
+
+  // non-Hermitian operators, invalid triangles or entries
+  REQUIRE_THROWS(csr_matrix_triangle(OpSum(Op("S+", 0)), Spinhalf(4)));
+  OpSum ops = testcases::spinhalf::HB_alltoall(4);
+  REQUIRE_THROWS(csr_matrix_triangle(ops, Spinhalf(4), "full"));
+  auto tri = csr_matrix_triangle(ops, Spinhalf(4), "upper");
+  tri.triangle = "lower";
+  vec v(tri.ncols, fill::randn);
+  REQUIRE_THROWS(xdiag::apply(tri, v));
+
+  // columns of a row not sorted
+  tri.triangle = "upper";
+  int64_t row = 0;
+  while (tri.rowptr(row + 1) - tri.rowptr(row) < 2) {
+    ++row;
+  }
+  std::swap(tri.col(tri.rowptr(row)), tri.col(tri.rowptr(row) + 1));
+  std::swap(tri.data(tri.rowptr(row)), tri.data(tri.rowptr(row) + 1));
+  REQUIRE_THROWS(xdiag::apply(tri, v));
+  mat V(tri.ncols, 2, fill::randn);
+  REQUIRE_THROWS(xdiag::apply(tri, V));
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
+
+TEST_CASE("csr_triangle_algorithms", "[kernels]") try {
+  testcases::sparse::check_algorithms([](OpSum const &ops, Block const &block) {
+    return csr_matrix_triangle(ops, block);
+  });
+  testcases::sparse::check_algorithms([](OpSum const &ops, Block const &block) {
+    return csr_matrixC_triangle(ops, block, "lower");
+  });
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
@@ -33,7 +33,7 @@ using namespace arma;
 // The two-phase CSR build (csr_matrix_nnz -> allocate -> csr_matrix_fill),
 // exactly as the Julia wrapper drives it, must reproduce the one-shot
 // csr_matrix (which is itself checked against the dense matrix elsewhere). We
-// compare the dense forms and the nnz count.
+// compare the dense forms and the merged nnz count.
 template <typename idx_t, typename coeff_t>
 static void check_twophase(OpSum const &ops, Block const &block, int i0) {
   std::vector<int64_t> counts = csr_matrix_nnz<coeff_t>(ops, block, block);
@@ -52,12 +52,13 @@ static void check_twophase(OpSum const &ops, Block const &block, int i0) {
                                      false};
   CSRMatrix<idx_t, coeff_t> concrete =
       csr_matrix<idx_t, coeff_t>(ops, block, block, (idx_t)i0);
-  REQUIRE(nnz == (int64_t)concrete.data.n_elem);
+  REQUIRE((int64_t)(rowptr(nrows) - i0) == (int64_t)concrete.data.n_elem);
+  REQUIRE(nnz >= (int64_t)concrete.data.n_elem);
   REQUIRE(norm(to_dense(twophase) - to_dense(concrete)) < 1e-12);
 }
 
 // COO two-phase (coo_matrix_nnz -> allocate -> coo_matrix_fill) must reproduce
-// the one-shot coo_matrix.
+// the one-shot coo_matrix in the leading merged entries.
 template <typename idx_t, typename coeff_t>
 static void check_twophase_coo(OpSum const &ops, Block const &block, int i0) {
   int64_t nnz = coo_matrix_nnz<coeff_t>(ops, block, block);
@@ -65,15 +66,22 @@ static void check_twophase_coo(OpSum const &ops, Block const &block, int i0) {
 
   arma::Col<idx_t> row((arma::uword)nnz), col((arma::uword)nnz);
   arma::Col<coeff_t> data((arma::uword)nnz);
-  coo_matrix_fill<idx_t, coeff_t>(ops, block, block, nnz, row.memptr(),
-                                  col.memptr(), data.memptr(), (idx_t)i0);
+  int64_t nnz_merged = coo_matrix_fill<idx_t, coeff_t>(
+      ops, block, block, nnz, row.memptr(), col.memptr(), data.memptr(),
+      (idx_t)i0);
 
-  COOMatrix<idx_t, coeff_t> twophase{(idx_t)nrows, (idx_t)nrows, row,
-                                     col,          data,         (idx_t)i0,
-                                     false};
   COOMatrix<idx_t, coeff_t> concrete =
       coo_matrix<idx_t, coeff_t>(ops, block, block, (idx_t)i0);
-  REQUIRE(nnz == (int64_t)concrete.data.n_elem);
+  REQUIRE(nnz_merged == (int64_t)concrete.data.n_elem);
+  REQUIRE(arma::all(row.head(nnz_merged) == concrete.row));
+  REQUIRE(arma::all(col.head(nnz_merged) == concrete.col));
+  REQUIRE(arma::all(data.head(nnz_merged) == concrete.data));
+  REQUIRE(arma::all(row.tail(nnz - nnz_merged) == (idx_t)i0));
+  REQUIRE(arma::all(col.tail(nnz - nnz_merged) == (idx_t)i0));
+  REQUIRE(arma::norm(data.tail(nnz - nnz_merged)) == 0.);
+
+  COOMatrix<idx_t, coeff_t> twophase{
+      (idx_t)nrows, (idx_t)nrows, row, col, data, (idx_t)i0, false};
   REQUIRE(norm(to_dense(twophase) - to_dense(concrete)) < 1e-12);
 }
 
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/csrvi_matrix.hpp>
+#include <xdiag/operators/op.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/utils/error.hpp>
+
+#include "testcases_sparse.hpp"
+
+using namespace xdiag;
+using namespace arma;
+
+// diagonal matrix with n distinct entries
+static CSRMatrix<int64_t, double> diagonal(int64_t n) {
+  CSRMatrix<int64_t, double> diag;
+  diag.nrows = n;
+  diag.ncols = n;
+  diag.rowptr = regspace<Col<int64_t>>(0, n);
+  diag.col = regspace<Col<int64_t>>(0, n - 1);
+  diag.data = regspace<vec>(1, n);
+  diag.i0 = 0;
+  diag.ishermitian = true;
+  return diag;
+}
+
+TEST_CASE("csrvi_matrix", "[kernels]") try {
+  testcases::sparse::for_each_csr_testcase(
+      [](OpSum const &, Block const &, auto const &csr) {
+        auto csrvi = csrvi_matrix(csr);
+        REQUIRE(csrvi.ishermitian == csr.ishermitian);
+        REQUIRE(csrvi.coldelta.n_elem == csr.data.n_elem);
+        REQUIRE(csrvi.values.n_elem <= csr.data.n_elem);
+        REQUIRE(norm(to_dense(csrvi) - to_dense(csr)) == 0.);
+        testcases::sparse::check_apply(csrvi, csr);
+        decltype(csr.data) w(csr.ncols + 1, fill::randn);
+        REQUIRE_THROWS(xdiag::apply(csrvi, w));
+      });
+
+  // nearest-neighbor Heisenberg models have few distinct entries
+  for (int64_t N = 2; N <= 8; ++N) {
+    OpSum ops_nn;
+    for (int64_t i = 0; i < N; ++i) {
+      ops_nn += Op("SdotS", {i, (i + 1) % N});
+    }
+    auto csrvi = csrvi_matrix(csr_matrix(ops_nn, Spinhalf(N, N / 2)));
+    REQUIRE(csrvi.values.n_elem <= (uword)N + 2);
+    REQUIRE(csrvi.validx8.n_elem == csrvi.coldelta.n_elem);
+    REQUIRE(csrvi.validx16.n_elem == 0);
+  }
+
+  // more than 256 distinct values use 16-bit indices
+  auto diag = diagonal(1000);
+  auto csrvi = csrvi_matrix(diag);
+  REQUIRE(csrvi.values.n_elem == 1000);
+  REQUIRE(csrvi.validx16.n_elem == 1000);
+  REQUIRE(norm(to_dense(csrvi) - to_dense(diag)) == 0.);
+
+  // too many distinct values, or columns in descending order
+  REQUIRE_THROWS(csrvi_matrix(diagonal(70000)));
+  auto descending = diagonal(2);
+  descending.rowptr = {0, 2, 2};
+  descending.col = {1, 0};
+  REQUIRE_THROWS(csrvi_matrix(descending));
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
+
+TEST_CASE("csrvi_matrix_algorithms", "[kernels]") try {
+  testcases::sparse::check_algorithms([](OpSum const &ops, Block const &block) {
+    return csrvi_matrix(csr_matrix(ops, block));
+  });
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
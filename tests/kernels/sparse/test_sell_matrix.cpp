@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/sell_matrix.hpp>
+#include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/linalg/lobpcg/eigs_lobpcg.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/utils/error.hpp>
+
+#include "testcases_sparse.hpp"
+
+using namespace xdiag;
+using namespace arma;
+
+TEST_CASE("sell_matrix", "[kernels]") try {
+  testcases::sparse::for_each_csr_testcase(
+      [](OpSum const &, Block const &, auto const &csr) {
+        auto dense = to_dense(csr);
+        for (int64_t C : {1, 3, 4, 8, 16}) {
+          for (int64_t sigma : {0, 1, 5, 64}) {
+            auto sell = sell_matrix(csr, C, sigma);
+            REQUIRE(sell.ishermitian == csr.ishermitian);
+            REQUIRE(norm(to_dense(sell) - dense) < 1e-12);
+            // several vectors at once, including remainders of SIMD registers
+            testcases::sparse::check_apply(sell, csr, {1, 2, 3, 5});
+          }
+        }
+        auto sell = sell_matrix(csr);
+        REQUIRE_THROWS(sell_matrix(csr, 0));
+        REQUIRE_THROWS(sell_matrix(csr, 8, -1));
+        decltype(csr.data) v(csr.ncols + 1, fill::randn);
+        REQUIRE_THROWS(xdiag::apply(sell, v));
+      });
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
+
+TEST_CASE("sell_matrix_algorithms", "[kernels]") try {
+  testcases::sparse::check_algorithms([](OpSum const &ops, Block const &block) {
+    return sell_matrix(csr_matrix(ops, block));
+  });
+  testcases::sparse::check_algorithms([](OpSum const &ops, Block const &block) {
+    return sell_matrix(csr_matrixC(ops, block));
+  });
+
+  OpSum ops = testcases::sparse::hubbard_alltoall(6);
+  auto block = Electron(6, 3, 3);
+  vec evals_ref;
+  eig_sym(evals_ref, matrix(ops, block));
+  auto sell = sell_matrix(csr_matrix(ops, block));
+  REQUIRE(sell.ishermitian);
+  auto resl = eigs_lobpcg(sell, block, 3, 3, 1e-9, 800);
+  for (int64_t i = 0; i < 3; ++i) {
+    REQUIRE(std::abs(resl.eigenvalues(i) - evals_ref(i)) < 1e-6);
+  }
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <string>
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/sparse/coo_matrix.hpp>
+#include <xdiag/kernels/sparse/csc_matrix.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/entry_arena.hpp>
+#include <xdiag/operators/op.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+
+#include "../../blocks/electron/testcases_electron.hpp"
+#include "../../blocks/spinhalf/testcases_spinhalf.hpp"
+
+using namespace xdiag;
+using namespace arma;
+
+// The single-pass assembly stores the same entries as the two-pass one. Only
+// the order in which duplicates are summed can differ.
+template <typename idx_t, typename coeff_t>
+static void check_assembly(OpSum const &ops, Block const &block) {
+  for (int i0 = 0; i0 < 2; ++i0) {
+    auto csr2 = csr_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, "twopass");
+    auto csc2 = csc_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, "twopass");
+    auto coo2 = coo_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, "twopass");
+    for (std::string assembly : {"singlepass", "auto"}) {
+      auto csr1 = csr_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, assembly);
+      auto csc1 = csc_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, assembly);
+      auto coo1 = coo_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0, assembly);
+      REQUIRE(all(csr1.rowptr == csr2.rowptr));
+      REQUIRE(all(csr1.col == csr2.col));
+      REQUIRE(norm(csr1.data - csr2.data) < 1e-12);
+      REQUIRE(all(csc1.colptr == csc2.colptr));
+      REQUIRE(all(csc1.row == csc2.row));
+      REQUIRE(norm(csc1.data - csc2.data) < 1e-12);
+      REQUIRE(all(coo1.row == coo2.row));
+      REQUIRE(all(coo1.col == coo2.col));
+      REQUIRE(norm(coo1.data - coo2.data) < 1e-12);
+    }
+  }
+}
+
+TEST_CASE("sparse_assembly", "[kernels]") try {
+  for (int64_t N = 2; N <= 8; ++N) {
+    OpSum ops = testcases::spinhalf::HB_alltoall(N);
+    check_assembly<int64_t, double>(ops, Spinhalf(N));
+    for (int64_t nup = 0; nup <= N; ++nup) {
+      check_assembly<int32_t, double>(ops, Spinhalf(N, nup));
+    }
+    OpSum ops_nn;
+    for (int64_t i = 0; i < N; ++i) {
+      ops_nn += Op("SdotS", {i, (i + 1) % N});
+    }
+    for (int64_t k = 0; k < N; ++k) {
+      auto irrep = cyclic_group_irrep(N, k);
+      check_assembly<int64_t, complex>(ops_nn, Spinhalf(N, N / 2, irrep));
+    }
+  }
+  for (int64_t N = 2; N <= 4; ++N) {
+    OpSum ops = testcases::electron::freefermion_alltoall_complex_updn(N);
+    for (int64_t nup = 0; nup <= N; ++nup) {
+      check_assembly<int64_t, complex>(ops, Electron(N, nup, N - nup));
+    }
+  }
+
+  OpSum ops = testcases::spinhalf::HB_alltoall(4);
+  REQUIRE_THROWS(csr_matrix(ops, Spinhalf(4), 0, "onepass"));
+  REQUIRE_THROWS(csc_matrix(ops, Spinhalf(4), 0, "onepass"));
+  REQUIRE_THROWS(coo_matrix(ops, Spinhalf(4), 0, "onepass"));
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
+
+TEST_CASE("entry_arenas", "[kernels]") {
+  using arenas_t = kernels::EntryArenas<double>;
+  int64_t chunk_bytes = arenas_t::chunk_size * sizeof(arenas_t::entry_t);
+
+  // unlimited arenas grow by chunks without ever overflowing
+  arenas_t unlimited(2, -1);
+  for (int64_t i = 0; i < 3 * arenas_t::chunk_size + 5; ++i) {
+    unlimited.push(i % 2, i, -i, (double)i);
+  }
+  REQUIRE(!unlimited.overflow());
+  int64_t n = 0;
+  for (int64_t a = 0; a < unlimited.narenas(); ++a) {
+    for (auto const &chunk : unlimited.chunks(a)) {
+      for (auto const &entry : chunk) {
+        REQUIRE(entry.group % 2 == a);
+        REQUIRE(entry.idx == -entry.group);
+        REQUIRE(entry.val == (double)entry.group);
+        ++n;
+      }
+    }
+  }
+  REQUIRE(n == 3 * arenas_t::chunk_size + 5);
+
+  // a budget of two chunks is exceeded by the third one
+  arenas_t limited(1, 2 * chunk_bytes);
+  for (int64_t i = 0; i < 2 * arenas_t::chunk_size; ++i) {
+    limited.push(0, i, i, 1.0);
+  }
+  REQUIRE(!limited.overflow());
+  limited.push(0, 0, 0, 1.0);
+  REQUIRE(limited.overflow());
+  limited.clear();
+  REQUIRE(limited.chunks(0).empty());
+}
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../catch.hpp"
+
+#include <numeric>
+#include <vector>
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/kernels/sparse/coo_matrix.hpp>
+#include <xdiag/kernels/sparse/csc_matrix.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
+#include <xdiag/operators/op.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+
+using namespace xdiag;
+using namespace arma;
+
+// Every row (column) is strictly ascending, i.e. sorted and free of duplicates
+template <typename idx_t>
+static bool strictly_ascending(Col<idx_t> const &ptr, Col<idx_t> const &idx,
+                               idx_t i0) {
+  for (uword g = 0; g + 1 < ptr.n_elem; ++g) {
+    for (idx_t k = ptr(g) - i0 + 1; k < ptr(g + 1) - i0; ++k) {
+      if (idx(k) <= idx(k - 1)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename idx_t, typename coeff_t>
+static void check_merge(OpSum const &ops, Block const &block, bool exact) {
+  Mat<coeff_t> dense;
+  if constexpr (isreal<coeff_t>()) {
+    dense = matrix(ops, block);
+  } else {
+    dense = matrixC(ops, block);
+  }
+  int64_t nnz_dense = accu(dense != coeff_t(0.));
+  for (int i0 = 0; i0 < 2; ++i0) {
+    auto csr = csr_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0);
+    auto csc = csc_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0);
+    auto coo = coo_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0);
+    REQUIRE(norm(to_dense(csr) - dense) < 1e-12);
+    REQUIRE(norm(to_dense(csc) - dense) < 1e-12);
+    REQUIRE(norm(to_dense(coo) - dense) < 1e-12);
+    REQUIRE(strictly_ascending(csr.rowptr, csr.col, (idx_t)i0));
+    REQUIRE(strictly_ascending(csc.colptr, csc.row, (idx_t)i0));
+    REQUIRE(csr.data.n_elem == csc.data.n_elem);
+    REQUIRE(csr.data.n_elem == coo.data.n_elem);
+    REQUIRE(all(csr.data != coeff_t(0.)));
+    if (exact) { // all matrix elements are sums of exact binary fractions
+      REQUIRE((int64_t)csr.data.n_elem == nnz_dense);
+    }
+
+    // the caller-allocated build merges into the leading entries
+    std::vector<int64_t> counts = csr_matrix_nnz<coeff_t>(ops, block, block);
+    int64_t nnz = std::accumulate(counts.begin(), counts.end(), (int64_t)0);
+    REQUIRE(nnz >= (int64_t)csr.data.n_elem);
+    Col<idx_t> rowptr(counts.size() + 1);
+    Col<idx_t> col(nnz);
+    Col<coeff_t> data(nnz);
+    csr_matrix_fill<idx_t, coeff_t>(ops, block, block, counts, rowptr.memptr(),
+                                    col.memptr(), data.memptr(), (idx_t)i0);
+    int64_t nnz_merged = rowptr(counts.size()) - i0;
+    REQUIRE(nnz_merged == (int64_t)csr.data.n_elem);
+    REQUIRE(all(rowptr == csr.rowptr));
+    REQUIRE(all(col.head(nnz_merged) == csr.col));
+    REQUIRE(norm(data.head(nnz_merged) - csr.data) == 0.);
+    REQUIRE(all(col.tail(nnz - nnz_merged) == (idx_t)i0));
+    REQUIRE(norm(data.tail(nnz - nnz_merged)) == 0.);
+
+    int64_t nnz_coo = coo_matrix_nnz<coeff_t>(ops, block, block);
+    REQUIRE(nnz_coo == nnz);
+    Col<idx_t> row(nnz);
+    REQUIRE(coo_matrix_fill<idx_t, coeff_t>(ops, block, block, nnz,
+                                            row.memptr(), col.memptr(),
+                                            data.memptr(), (idx_t)i0) ==
+            nnz_merged);
+    REQUIRE(all(row.head(nnz_merged) == coo.row));
+    REQUIRE(all(col.head(nnz_merged) == coo.col));
+    REQUIRE(norm(data.head(nnz_merged) - coo.data) == 0.);
+
+    Col<coeff_t> v(size(block), fill::randn);
+    Col<coeff_t> w = xdiag::apply(csr, v);
+    REQUIRE(norm(w - dense * v) < 1e-10);
+  }
+}
+
+TEST_CASE("sparse_merge", "[kernels]") try {
+  for (int64_t N = 3; N <= 8; ++N) {
+    // every bond three times, plus a term which cancels exactly
+    OpSum ops;
+    for (int64_t rep = 0; rep < 3; ++rep) {
+      for (int64_t i = 0; i < N; ++i) {
+        ops += 0.5 * Op("SdotS", {i, (i + 1) % N});
+        ops += 0.25 * Op("SzSz", {i, (i + 2) % N});
+      }
+    }
+    ops += Op("Exchange", {0, 1});
+    ops += -1.0 * Op("Exchange", {0, 1});
+    ops += Op("Sz", 0);
+    ops += -1.0 * Op("Sz", 0);
+
+    check_merge<int64_t, double>(ops, Spinhalf(N), true);
+    check_merge<int32_t, complex>(ops, Spinhalf(N), true);
+    for (int64_t nup = 0; nup <= N; ++nup) {
+      check_merge<int64_t, double>(ops, Spinhalf(N, nup), true);
+      check_merge<int32_t, double>(ops, Spinhalf(N, nup), true);
+    }
+
+    // translation-invariant part only for the momentum sectors
+    OpSum ops_nn;
+    for (int64_t rep = 0; rep < 2; ++rep) {
+      for (int64_t i = 0; i < N; ++i) {
+        ops_nn += Op("SdotS", {i, (i + 1) % N});
+      }
+    }
+    for (int64_t k = 0; k < N; ++k) {
+      auto irrep = cyclic_group_irrep(N, k);
+      for (int64_t nup = 0; nup <= N; ++nup) {
+        check_merge<int64_t, complex>(ops_nn, Spinhalf(N, nup, irrep), false);
+      }
+    }
+
+    // fermionic signs of equal hoppings add up as well
+    int64_t nsites = N / 2 + 1;
+    OpSum hops;
+    for (int64_t i = 0; i < nsites; ++i) {
+      hops += Op("Hop", {i, (i + 1) % nsites});
+      hops += Op("Hop", {i, (i + 1) % nsites});
+      hops += Op("HubbardU");
+    }
+    for (int64_t nup = 0; nup <= nsites; ++nup) {
+      check_merge<int64_t, double>(hops, Electron(nsites, nup, nup), true);
+    }
+  }
+} catch (xdiag::Error e) {
+  error_trace(e);
+  throw;
+}
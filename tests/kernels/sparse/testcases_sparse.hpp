@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <tests/catch.hpp>
+
+#include <tests/blocks/electron/testcases_electron.hpp>
+#include <tests/blocks/spinhalf/testcases_spinhalf.hpp>
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/linalg/time_evolution/time_evolve.hpp>
+#include <xdiag/operators/op.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/states/create_state.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+
+namespace xdiag::testcases::sparse {
+
+template <typename idx_t, typename coeff_t, class check_f>
+inline void check_csr(OpSum const &ops, Block const &block, check_f &&check) {
+  for (int i0 = 0; i0 < 2; ++i0) {
+    check(ops, block, csr_matrix<idx_t, coeff_t>(ops, block, (idx_t)i0));
+  }
+}
+
+// Calls check(ops, block, csr) with the CSR matrices, counted from 0 and 1,
+// of Hermitian models on spin-1/2 blocks with and without symmetries and on
+// electron blocks, whose rows have different lengths
+template <class check_f> inline void for_each_csr_testcase(check_f &&check) {
+  for (int64_t N = 2; N <= 8; ++N) {
+    OpSum ops = testcases::spinhalf::HB_alltoall(N);
+    check_csr<int64_t, double>(ops, Spinhalf(N), check);
+    check_csr<int32_t, complex>(ops, Spinhalf(N), check);
+    for (int64_t nup = 0; nup <= N; ++nup) {
+      check_csr<int32_t, double>(ops, Spinhalf(N, nup), check);
+    }
+    OpSum ops_nn;
+    for (int64_t i = 0; i < N; ++i) {
+      ops_nn += Op("SdotS", {i, (i + 1) % N});
+    }
+    for (int64_t k = 0; k < N; ++k) {
+      auto irrep = cyclic_group_irrep(N, k);
+      check_csr<int64_t, complex>(ops_nn, Spinhalf(N, N / 2, irrep), check);
+    }
+  }
+  for (int64_t N = 2; N <= 4; ++N) {
+    OpSum ops = testcases::electron::freefermion_alltoall(N);
+    ops += 2.0 * Op("HubbardU");
+    OpSum opsc = testcases::electron::freefermion_alltoall_complex_updn(N);
+    for (int64_t nup = 0; nup <= N; ++nup) {
+      auto block = Electron(N, nup, N - nup);
+      check_csr<int64_t, double>(ops, block, check);
+      check_csr<int64_t, complex>(opsc, block, check);
+    }
+  }
+}
+
+// Compares the products of the sparse matrix A with those of the CSR matrix
+// it describes, for one and nvecs vectors and, if real, a complex vector
+template <class matrix_t, typename idx_t, typename coeff_t>
+inline void check_apply(matrix_t const &A,
+                        CSRMatrix<idx_t, coeff_t> const &csr,
+                        std::vector<int64_t> const &nvecs = {2, 3}) {
+  int64_t n = csr.ncols;
+  arma::Col<coeff_t> v(n, arma::fill::randn);
+  REQUIRE(norm(xdiag::apply(A, v) - xdiag::apply(csr, v)) < 1e-10);
+  for (int64_t nvec : nvecs) {
+    arma::Mat<coeff_t> V(n, nvec, arma::fill::randn);
+    REQUIRE(norm(xdiag::apply(A, V) - xdiag::apply(csr, V)) < 1e-10);
+  }
+  if constexpr (isreal<coeff_t>()) {
+    arma::cx_vec vc(n, arma::fill::randn);
+    REQUIRE(norm(xdiag::apply(A, vc) - xdiag::apply(csr, vc)) < 1e-10);
+  }
+}
+
+inline OpSum hubbard_alltoall(int64_t nsites) {
+  OpSum ops = testcases::electron::freefermion_alltoall(nsites);
+  ops += 5.0 * Op("HubbardU");
+  return ops;
+}
+
+// Runs eigs_lanczos and time_evolve with the sparse matrix make(ops, block)
+// of a Hubbard model at half filling and compares to the OpSum
+template <class make_f> inline void check_algorithms(make_f &&make) {
+  int64_t nsites = 6;
+  OpSum ops = hubbard_alltoall(nsites);
+  auto block = Electron(nsites, 3, 3);
+  arma::vec evals_ref;
+  arma::eig_sym(evals_ref, matrix(ops, block));
+
+  auto A = make(ops, block);
+  auto res = eigs_lanczos(A, block, 2);
+  for (int64_t i = 0; i < 2; ++i) {
+    REQUIRE(std::abs(res.eigenvalues(i) - evals_ref(i)) < 1e-8);
+  }
+
+  auto psi0 = product_state(block, std::vector<int64_t>{1, 2, 1, 2, 1, 2});
+  for (std::string algorithm : {"lanczos", "expokit"}) {
+    auto psi = time_evolve(ops, psi0, 0.7, 1e-12, algorithm);
+    auto psi_sparse = time_evolve(A, psi0, 0.7, 1e-12, algorithm);
+    REQUIRE(norm(psi.vectorC() - psi_sparse.vectorC()) < 1e-8);
+  }
+}
+
+} // namespace xdiag::testcases::sparse
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tests/catch.hpp>
+
+#include <random>
+
+#include <tests/blocks/random_opsum_matrix.hpp>
+
+#include <xdiag/algebra/ishermitian.hpp>
+#include <xdiag/armadillo.hpp>
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/math/isapprox.hpp>
+#include <xdiag/operators/hc.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+
+// Random Hermitian OpSum built from all non-matrix types of the block algebra
+template <typename block_t>
+static OpSum random_hermitian_opsum(block_t const &block, std::mt19937 &gen) {
+  auto ops = testcases::random_opsum(block, gen);
+  return ops + hc(ops);
+}
+
+template <typename block_t>
+static void test_apply_pull(OpSum const &ops, block_t const &block) {
+  arma::cx_vec v(block.size(), arma::fill::randn);
+  arma::cx_vec w_push(block.size(), arma::fill::zeros);
+  arma::cx_vec w_pull(block.size(), arma::fill::zeros);
+  arma::cx_vec w_default(block.size(), arma::fill::zeros);
+  apply(ops, block, v, block, w_push, false, "push");
+  apply(ops, block, v, block, w_pull, false, "pull");
+  apply(ops, block, v, block, w_default);
+  REQUIRE(isapprox(w_push, w_pull));
+  REQUIRE(isapprox(w_push, w_default));
+
+  arma::cx_mat V(block.size(), 3, arma::fill::randn);
+  arma::cx_mat W_push(block.size(), 3, arma::fill::zeros);
+  arma::cx_mat W_pull(block.size(), 3, arma::fill::zeros);
+  apply(ops, block, V, block, W_push, false, "push");
+  apply(ops, block, V, block, W_pull, true, "pull");
+  REQUIRE(isapprox(W_push, W_pull));
+}
+
+TEST_CASE("apply_pull", "[kernels]") try {
+  Log("Test apply pull");
+  std::mt19937 gen(42);
+
+  for (int64_t nsites = 2; nsites <= 5; ++nsites) {
+    auto spinhalf = Spinhalf(nsites);
+    test_apply_pull(random_hermitian_opsum(spinhalf, gen), spinhalf);
+    auto boson = Boson(nsites, 3);
+    test_apply_pull(random_hermitian_opsum(boson, gen), boson);
+    auto fermion = Fermion(nsites);
+    test_apply_pull(random_hermitian_opsum(fermion, gen), fermion);
+    auto electron = Electron(nsites);
+    test_apply_pull(random_hermitian_opsum(electron, gen), electron);
+    auto tj = tJ(nsites);
+    test_apply_pull(random_hermitian_opsum(tj, gen), tj);
+  }
+
+  // Same-site ExchangeAsym equals Sz, such that its symbolic hermiticity
+  // agrees with the matrix the kernels build
+  {
+    auto block = Spinhalf(3);
+    auto ops = complex(0.0, 1.0) * Op("ExchangeAsym", {0, 0}) +
+               Op("Exchange", {0, 1});
+    REQUIRE(!ishermitian(ops, block));
+    ops = Op("ExchangeAsym", {0, 0}) + Op("Exchange", {0, 1});
+    REQUIRE(ishermitian(ops, block));
+    arma::cx_mat H = matrixC(ops, block);
+    REQUIRE(isapprox(H, arma::cx_mat(H.t())));
+    test_apply_pull(ops, block);
+  }
+
+  // Invalid directions are rejected
+  {
+    auto block = Spinhalf(3);
+    arma::vec v(block.size(), arma::fill::randn);
+    arma::vec w(block.size(), arma::fill::zeros);
+    REQUIRE_THROWS(
+        apply(OpSum(Op("SzSz", {0, 1})), block, v, block, w, false, "auto"));
+  }
+
+  // Symmetric blocks with a translationally invariant Hamiltonian
+  for (int64_t nsites = 3; nsites <= 6; ++nsites) {
+    OpSum ops;
+    for (int64_t i = 0; i < nsites; ++i) {
+      ops += Op("Hop", {i, (i + 1) % nsites});
+      ops += complex(0.0, 0.3) * Op("ExchangeAsym", {i, (i + 1) % nsites});
+      ops += 0.7 * Op("Exchange", {i, (i + 1) % nsites});
+    }
+    OpSum ops_spin;
+    for (int64_t i = 0; i < nsites; ++i) {
+      ops_spin += Op("Exchange", {i, (i + 1) % nsites});
+      ops_spin += complex(0.0, 0.3) * Op("ExchangeAsym", {i, (i + 1) % nsites});
+    }
+    for (int64_t k = 0; k < nsites; ++k) {
+      auto irrep = cyclic_group_irrep(nsites, k);
+      test_apply_pull(ops_spin, Spinhalf(nsites, nsites / 2, irrep));
+      test_apply_pull(ops, tJ(nsites, 1, 1, irrep));
+      test_apply_pull(ops, Electron(nsites, 1, 2, irrep));
+    }
+  }
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+  throw;
+}
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tests/catch.hpp>
+
+#include <random>
+
+#include <tests/blocks/random_opsum_matrix.hpp>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/linalg/lobpcg/eigs_lobpcg.hpp>
+#include <xdiag/linalg/time_evolution/time_evolve.hpp>
+#include <xdiag/math/dot.hpp>
+#include <xdiag/math/isapprox.hpp>
+#include <xdiag/operators/hc.hpp>
+#include <xdiag/states/fill.hpp>
+#include <xdiag/states/random_state.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+
+template <typename block_t>
+static void test_compiled_apply(OpSum const &ops, block_t const &block) {
+  for (bool fused : {false, true}) {
+    auto plan = compiled_opsum(ops, block, fused);
+    REQUIRE(plan.isreal == isreal(ops));
+    arma::cx_mat H = matrixC(ops, block);
+    REQUIRE(plan.ishermitian == isapprox(H, arma::cx_mat(H.t())));
+    REQUIRE(plan.build_time >= 0.);
+
+    arma::cx_mat v(block.size(), 3, arma::fill::randn);
+    arma::cx_mat w1(block.size(), 3, arma::fill::zeros);
+    arma::cx_mat w2(block.size(), 3, arma::fill::zeros);
+    apply(ops, block, v, block, w1, fused);
+    apply(plan, block, v, block, w2);
+    REQUIRE(isapprox(w1, w2));
+
+    // applying the plan twice gives the same result
+    apply(plan, block, v, block, w2);
+    REQUIRE(isapprox(w1, w2));
+
+    if (plan.ishermitian) {
+      apply(plan, block, v, block, w2, "pull");
+      REQUIRE(isapprox(w1, w2));
+    }
+  }
+}
+
+TEST_CASE("compiled_opsum", "[kernels]") try {
+  Log("Test CompiledOpSum");
+  std::mt19937 gen(42);
+
+  for (int64_t nsites = 2; nsites <= 5; ++nsites) {
+    auto spinhalf = Spinhalf(nsites);
+    auto ops = testcases::random_opsum(spinhalf, gen);
+    test_compiled_apply(ops, spinhalf);
+    test_compiled_apply(ops + hc(ops), spinhalf);
+    auto boson = Boson(nsites, 3);
+    test_compiled_apply(testcases::random_opsum(boson, gen), boson);
+    auto fermion = Fermion(nsites);
+    test_compiled_apply(testcases::random_opsum(fermion, gen), fermion);
+    auto electron = Electron(nsites);
+    test_compiled_apply(testcases::random_opsum(electron, gen), electron);
+    auto tj = tJ(nsites);
+    test_compiled_apply(testcases::random_opsum(tj, gen), tj);
+  }
+
+  // Symmetric blocks, in particular the tJ kernel which expands Exchange
+  for (int64_t nsites = 3; nsites <= 6; ++nsites) {
+    OpSum ops;
+    for (int64_t i = 0; i < nsites; ++i) {
+      ops += Op("Hop", {i, (i + 1) % nsites});
+      ops += 0.7 * Op("Exchange", {i, (i + 1) % nsites});
+    }
+    for (int64_t k = 0; k < nsites; ++k) {
+      auto irrep = cyclic_group_irrep(nsites, k);
+      test_compiled_apply(ops, tJ(nsites, 1, 1, irrep));
+      test_compiled_apply(ops, Electron(nsites, 1, 2, irrep));
+    }
+  }
+
+  // Plan is bound to the block it has been built for
+  {
+    auto ops = OpSum(Op("SzSz", {0, 1}));
+    auto plan = compiled_opsum(ops, Spinhalf(4, 2));
+    auto block = Spinhalf(4, 1);
+    arma::vec v(block.size(), arma::fill::randn);
+    arma::vec w(block.size(), arma::fill::zeros);
+    REQUIRE_THROWS(apply(plan, block, v, block, w));
+  }
+
+  // Operators the kernels accept, but the symmetry algebra does not
+  {
+    auto ops = OpSum(Op("TotalSz")) + Op("Exchange", {0, 1});
+    auto plan = compiled_opsum(ops, Spinhalf(4));
+    REQUIRE(plan.ishermitian);
+    test_compiled_apply(ops, Spinhalf(4));
+  }
+
+  Log("Test CompiledOpSum in eigs_lanczos, eigs_lobpcg and time_evolve");
+  {
+    int64_t nsites = 10;
+    OpSum ops;
+    for (int64_t i = 0; i < nsites; ++i) {
+      ops += Op("Exchange", {i, (i + 1) % nsites});
+      ops += Op("SzSz", {i, (i + 1) % nsites});
+      ops += 0.3 * Op("Exchange", {i, (i + 2) % nsites});
+    }
+    auto block = Spinhalf(nsites, nsites / 2);
+    for (bool fused : {false, true}) {
+      auto plan = compiled_opsum(ops, block, fused);
+
+      auto r1 = eigs_lanczos(ops, block, 2);
+      auto r2 = eigs_lanczos(plan, block, 2);
+      REQUIRE(isapprox(r1.eigenvalues, r2.eigenvalues));
+
+      auto l1 = eigs_lobpcg(ops, block, 2);
+      auto l2 = eigs_lobpcg(plan, block, 2);
+      REQUIRE(isapprox(l1.eigenvalues, l2.eigenvalues, 1e-8, 1e-8));
+
+      State psi(block, /*real=*/false);
+      fill(psi, RandomState(1234));
+      for (std::string algorithm : {"lanczos", "expokit"}) {
+        auto psi1 = time_evolve(ops, psi, 0.5, 1e-12, algorithm);
+        auto psi2 = time_evolve(plan, psi, 0.5, 1e-12, algorithm);
+        REQUIRE(isapprox(psi1.vectorC(), psi2.vectorC(), 1e-8, 1e-10));
+      }
+    }
+  }
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+  throw;
+}
@@ -6,6 +6,7 @@
 // Created by Luke Staszewski on 19.06.23.
 //
 
+#include <cstdio>
 #include <iostream>
 
 #include <tests/blocks/electron/testcases_electron.hpp>
@@ -16,12 +17,12 @@
 #include <xdiag/kernels/matrix.hpp>
 #include <xdiag/linalg/arnoldi/arnoldi.hpp>
 #include <xdiag/linalg/arnoldi/arnoldi_to_disk.hpp>
+#include <xdiag/linalg/arnoldi/krylov_store.hpp>
 #include <xdiag/linalg/time_evolution/expm.hpp>
 #include <xdiag/states/create_state.hpp>
 #include <xdiag/states/random_state.hpp>
 #include <xdiag/utils/logger.hpp>
 
-// TODO: write tests for arnoldi_to_disk
 bool check_basis_orthonormality(arma::cx_mat const &Q, double tol = 1e-12) {
   using namespace arma;
   int M = Q.n_cols;
@@ -118,3 +119,107 @@ TEST_CASE("ritz_vecs_arnoldi", "[arnoldi]") {
                                        1e-12));
   }
 }
+
+TEST_CASE("krylov_store", "[arnoldi]") try {
+  using namespace xdiag;
+  using namespace arma;
+
+  Log("testing krylov_store");
+  std::string filename = XDIAG_DIRECTORY "/misc/dump/test.krylov";
+  int64_t dim = 100;
+  int64_t capacity = 10;
+  cx_mat V(dim, capacity - 1, fill::randn);
+  {
+    KrylovStore<complex> store(filename, dim, capacity);
+    REQUIRE(store.size() == 0);
+    for (int64_t k = 0; k < capacity - 1; ++k) {
+      cx_vec v = V.col(k);
+      if (k > 0) {
+        cx_vec h = store.orthogonalize(v);
+        REQUIRE(h.n_elem == k);
+      }
+      v /= norm(v);
+      cx_vec h(k > 0 ? k + 1 : 0, fill::value(complex(k, 1.0)));
+      store.push(v, h);
+    }
+    REQUIRE(store.size() == capacity - 1);
+  }
+
+  // reopening a store keeps the vectors and the projection
+  {
+    KrylovStore<complex> store(filename, dim, capacity, true);
+    REQUIRE(store.size() == capacity - 1);
+    cx_mat P = store.projection();
+    for (int64_t k = 1; k < store.size(); ++k) {
+      REQUIRE(P(k, k - 1) == complex(k, 1.0));
+      REQUIRE(P(k + 1, k - 1) == complex(0.));
+    }
+    cx_mat Q(dim, store.size());
+    for (int64_t k = 0; k < store.size(); ++k) {
+      Q.col(k) = store.vector(k);
+    }
+    REQUIRE(check_basis_orthonormality(Q));
+    REQUIRE(norm(Q * Q.t() * V.col(3) - V.col(3)) < 1e-12);
+
+    cx_vec y(store.size(), fill::randn);
+    REQUIRE(norm(store.combine(y) - Q * y) < 1e-12);
+
+    // orthogonalizing a vector in the span gives zero
+    cx_vec v = V.col(5);
+    cx_vec h = store.orthogonalize(v);
+    REQUIRE(norm(v) < 1e-12);
+    REQUIRE(norm(Q * h - V.col(5)) < 1e-12);
+
+    cx_vec w(dim, fill::randn);
+    store.push(w / norm(w), cx_vec());
+    REQUIRE_THROWS(store.push(w / norm(w), cx_vec()));
+  }
+  REQUIRE_THROWS(KrylovStore<complex>(filename, dim + 1, capacity, true));
+  REQUIRE_THROWS(KrylovStore<double>{filename});
+  {
+    KrylovStore<complex> store(filename, dim, capacity); // replaces the file
+    REQUIRE(store.size() == 0);
+  }
+  std::remove(filename.c_str());
+} catch (xdiag::Error const &e) {
+  xdiag::error_trace(e);
+  throw;
+}
+
+TEST_CASE("arnoldi_to_disk_resume", "[arnoldi]") try {
+  using namespace xdiag;
+  using namespace arma;
+
+  Log("testing arnoldi_to_disk_resume");
+  std::string dumpdir = XDIAG_DIRECTORY "/misc/dump";
+  int64_t dim = 200;
+  cx_mat T(dim, dim, fill::randn);
+  cx_vec q0(dim, fill::randn);
+  auto apply_T = [&T](cx_vec const &v, cx_vec &w) { w = T * v; };
+
+  int n = 40;
+  cx_mat h = arnoldi_iteration(apply_T, q0, dumpdir, n);
+  cx_mat Q = read_arnoldi_vectors_cplx(dumpdir);
+  REQUIRE(Q.n_cols == n + 1);
+  REQUIRE(check_basis_orthonormality(Q));
+  REQUIRE(norm(T * Q.head_cols(n) - Q * h) < 1e-10);
+
+  // Interrupt the iteration and resume
+  int count = 0;
+  auto apply_T_crash = [&T, &count](cx_vec const &v, cx_vec &w) {
+    if (++count > 15) {
+      XDIAG_THROW("crash");
+    }
+    w = T * v;
+  };
+  REQUIRE_THROWS(arnoldi_iteration(apply_T_crash, q0, dumpdir, n));
+  REQUIRE(read_arnoldi_vectors_cplx(dumpdir).n_cols == 16);
+  cx_mat h_resumed =
+      arnoldi_iteration(apply_T, q0, dumpdir, n, 1e-12, /*resume=*/true);
+  REQUIRE(norm(h_resumed - h) < 1e-10);
+  REQUIRE(norm(read_arnoldi_vectors_cplx(dumpdir) - Q) < 1e-10);
+  std::remove(arnoldi_store_filename(dumpdir).c_str());
+} catch (xdiag::Error const &e) {
+  xdiag::error_trace(e);
+  throw;
+}
@@ -11,10 +11,13 @@
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/matrix.hpp>
 #include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/linalg/lanczos/lanczos_vectors.hpp>
 #include <xdiag/linalg/sparse_diag.hpp>
 #include <xdiag/states/apply.hpp>
 #include <xdiag/states/dot.hpp>
+#include <xdiag/states/fill.hpp>
 #include <xdiag/states/norm.hpp>
+#include <xdiag/states/random_state.hpp>
 #include <xdiag/utils/logger.hpp>
 
 using namespace xdiag;
@@ -97,4 +100,41 @@ TEST_CASE("eigs_lanczos", "[lanczos]") {
       }
     }
   Log("Done.");
+
+  Log("eigs_lanczos storage of Lanczos vectors test ...");
+  ops = freefermion_alltoall_complex_updn(nsites);
+  ops["U"] = 5.0;
+  for (auto block : {Electron(nsites, 3, 3), Electron(nsites, 2, 3)}) {
+    for (bool real : {true, false}) {
+      State psi0(block, real);
+      fill(psi0, RandomState(42));
+      // default: no storage, second Lanczos run
+      auto res = eigs_lanczos(ops, psi0, max_num_eigenvalue);
+      for (std::string store : {"auto", "memory", "disk"}) {
+        auto res2 = eigs_lanczos(ops, psi0, max_num_eigenvalue, 1e-12, 1000,
+                                 1e-7, store);
+        REQUIRE(res.niterations == res2.niterations);
+        REQUIRE(arma::norm(res.eigenvalues - res2.eigenvalues) < 1e-10);
+        REQUIRE(arma::norm(res.eigenvectors.matrixC() -
+                           res2.eigenvectors.matrixC()) < 1e-8);
+      }
+    }
+  }
+  REQUIRE_THROWS(eigs_lanczos(ops, Electron(nsites, 3, 3), 1, 1e-12, 1000,
+                              1e-7, 42, "tape"));
+
+  // Lanczos vectors exceeding the memory budget are moved to disk
+  {
+    lanczos::LanczosVectors<double> vectors("auto", 3 * 10 * sizeof(double));
+    for (int k = 0; k < 5; ++k) {
+      vectors.push(arma::vec(10, arma::fill::value(k)));
+      REQUIRE(vectors.ondisk() == (k >= 3));
+    }
+    REQUIRE(vectors.size() == 5);
+    vectors.for_each([](int64_t k, arma::vec const &v) {
+      REQUIRE(v.n_elem == 10);
+      REQUIRE(arma::all(v == (double)k));
+    });
+  }
+  Log("Done.");
 }
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tests/catch.hpp>
+
+#include <random>
+#include <type_traits>
+
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
+#include <xdiag/kernels/matrix.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/linalg/lanczos/eigs_trlanczos.hpp>
+#include <xdiag/linalg/lanczos/trlanczos.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+
+// Heisenberg model with random couplings and fields, such that the spectrum
+// is (generically) non-degenerate
+static OpSum random_heisenberg(int64_t nsites, bool cplx, std::mt19937 &gen) {
+  std::uniform_real_distribution<double> dist(0.5, 1.5);
+  OpSum ops;
+  for (int64_t i = 0; i < nsites; ++i) {
+    for (int64_t j = i + 1; j < nsites; ++j) {
+      ops += dist(gen) * Op("Exchange", {i, j});
+      ops += dist(gen) * Op("SzSz", {i, j});
+    }
+    ops += (dist(gen) - 1.0) * Op("Sz", i);
+    if (cplx) {
+      ops += complex(0.0, 0.3) * Op("ExchangeAsym", {i, (i + 1) % nsites});
+    }
+  }
+  return ops;
+}
+
+template <typename mat_t>
+static void check_eigenpairs(mat_t const &H, EigsTRLanczosResult const &res,
+                             int64_t neigvals, double tol = 1e-8) {
+  arma::vec exact = arma::eig_sym(H);
+  REQUIRE(res.criterion == "converged");
+  REQUIRE((int64_t)res.eigenvalues.n_elem == neigvals);
+  REQUIRE(res.eigenvectors.ncols() == neigvals);
+  REQUIRE(arma::norm(res.eigenvalues - exact.head(neigvals)) < tol);
+
+  mat_t V;
+  if constexpr (std::is_same_v<mat_t, arma::mat>) {
+    V = res.eigenvectors.matrix();
+  } else {
+    V = res.eigenvectors.matrixC();
+  }
+  mat_t HV = H * V;
+  for (int64_t i = 0; i < neigvals; ++i) {
+    REQUIRE(arma::norm(HV.col(i) - res.eigenvalues(i) * V.col(i)) < 1e-6);
+  }
+  mat_t overlaps = V.t() * V;
+  REQUIRE(arma::norm(overlaps - arma::eye<mat_t>(neigvals, neigvals), "inf") <
+          1e-8);
+}
+
+TEST_CASE("eigs_trlanczos", "[lanczos]") try {
+  std::mt19937 gen(42);
+
+  Log("thick-restart Lanczos, dense random matrix");
+  {
+    int64_t n = 600;
+    int64_t neigvals = 30;
+    arma::mat A(n, n, arma::fill::randn);
+    A = (A + A.t()) / 2.0;
+    for (int64_t nbasis : {40, 60, 100}) {
+      arma::mat V(n, nbasis, arma::fill::zeros);
+      V.col(0).randn();
+      auto mult = [&A](arma::vec const &v, arma::vec &w) { w = A * v; };
+      auto mdot = [](arma::mat const &X, arma::mat const &Y) {
+        return arma::mat(X.t() * Y);
+      };
+      auto r = lanczos::trlanczos(mult, mdot, V, neigvals, 1e-10, 10000, n);
+      REQUIRE(r.criterion == "converged");
+      REQUIRE(r.nrestarts > 0);
+      arma::vec exact = arma::eig_sym(A);
+      arma::vec evals = arma::sort(r.eigenvalues);
+      REQUIRE(arma::norm(evals - exact.head(neigvals)) < 1e-8);
+      arma::mat Q = V.head_cols(neigvals);
+      REQUIRE(arma::norm(Q.t() * Q - arma::eye(neigvals, neigvals), "inf") <
+              1e-8);
+    }
+  }
+
+  Log("thick-restart Lanczos, real Heisenberg model");
+  {
+    int64_t nsites = 12;
+    auto ops = random_heisenberg(nsites, false, gen);
+    auto block = Spinhalf(nsites, nsites / 2);
+    arma::mat H = matrix(ops, block);
+    for (int64_t neigvals : {1, 5, 20}) {
+      auto res = eigs_trlanczos(ops, block, neigvals);
+      check_eigenpairs(H, res, neigvals);
+    }
+
+    // fused apply, precompiled operator and small basis
+    auto res = eigs_trlanczos(ops, block, 10, 14, 1e-10, 10000, 1, true);
+    check_eigenpairs(H, res, 10);
+    auto plan = compiled_opsum(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(plan, block, 10), 10);
+
+    // sparse matrix
+    auto csr32 = csr_matrix<int32_t, double>(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(csr32, block, 10), 10);
+    auto csr64 = csr_matrix<int64_t, double>(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(csr64, block, 10), 10);
+  }
+
+  Log("thick-restart Lanczos, complex Heisenberg model");
+  {
+    int64_t nsites = 10;
+    auto ops = random_heisenberg(nsites, true, gen);
+    auto block = Spinhalf(nsites, nsites / 2);
+    arma::cx_mat H = matrixC(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(ops, block, 12), 12);
+    auto csr = csr_matrix<int64_t, complex>(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(csr, block, 12), 12);
+  }
+
+  Log("thick-restart Lanczos, small blocks");
+  {
+    auto ops = random_heisenberg(4, false, gen);
+    auto block = Spinhalf(4, 2); // dimension 6
+    arma::mat H = matrix(ops, block);
+    check_eigenpairs(H, eigs_trlanczos(ops, block, 3), 3);
+    check_eigenpairs(H, eigs_trlanczos(ops, block, 10), 6);
+    REQUIRE_THROWS(eigs_trlanczos(ops, block, 3, 3));
+  }
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+  throw;
+}
@@ -9,6 +9,7 @@
 
 #include <xdiag/algebra/isapprox.hpp>
 #include <xdiag/kernels/matrix.hpp>
+#include <xdiag/kernels/sparse/csr_matrix.hpp>
 #include <xdiag/linalg/lanczos/eigvals_lanczos.hpp>
 #include <xdiag/linalg/sparse_diag.hpp>
 #include <xdiag/utils/logger.hpp>
@@ -71,3 +72,48 @@ TEST_CASE("eigvals_lanczos", "[lanczos]") {
     }
   Log("Done.");
 }
+
+TEST_CASE("eigvals_lanczos_fused_recurrence", "[lanczos]") {
+  using namespace xdiag::testcases::electron;
+  Log("eigvals_lanczos fused recurrence test ...");
+  int nsites = 6;
+  int num_eigenvalue = 2;
+  for (auto ops : {freefermion_alltoall(nsites),
+                   freefermion_alltoall_complex_updn(nsites)}) {
+    for (int nup = 0; nup <= nsites; ++nup)
+      for (int ndn = 0; ndn <= nsites; ++ndn) {
+        auto block = Electron(nsites, nup, ndn);
+        auto H = matrixC(ops, block, block);
+        arma::vec evals_mat;
+        arma::eig_sym(evals_mat, H);
+
+        // the recurrence is selected independently of the fused kernel
+        auto res = eigvals_lanczos(ops, block, num_eigenvalue, 1e-12, 1000,
+                                   1e-7, 42, "standard");
+        auto res_fused = eigvals_lanczos(ops, block, num_eigenvalue, 1e-12,
+                                         1000, 1e-7, 42, "fused");
+        REQUIRE(res.niterations == res_fused.niterations);
+        REQUIRE(res.criterion == res_fused.criterion);
+        int64_t n = std::min((int64_t)num_eigenvalue,
+                             (int64_t)res_fused.eigenvalues.size());
+        for (int64_t i = 0; i < n; ++i) {
+          REQUIRE(std::abs(evals_mat(i) - res_fused.eigenvalues(i)) < 1e-7);
+        }
+
+        // sparse matrices
+        if (block.size() > 0) {
+          auto A = csr_matrixC(ops, block);
+          auto res_sparse = eigvals_lanczos(A, block, num_eigenvalue, 1e-12,
+                                            1000, 1e-7, 42, "fused");
+          for (int64_t i = 0; i < n; ++i) {
+            REQUIRE(std::abs(evals_mat(i) - res_sparse.eigenvalues(i)) <
+                    1e-7);
+          }
+        }
+      }
+  }
+  auto block = Electron(nsites, 3, 3);
+  REQUIRE_THROWS(eigvals_lanczos(freefermion_alltoall(nsites), block, 1,
+                                 1e-12, 1000, 1e-7, 42, "paige"));
+  Log("Done.");
+}
@@ -16,8 +16,10 @@
 #include <xdiag/linalg/time_evolution/imaginary_time_evolve.hpp>
 #include <xdiag/linalg/time_evolution/time_evolve.hpp>
 #include <xdiag/linalg/time_evolution/time_evolve_expokit.hpp>
+#include <xdiag/linalg/time_evolution/time_evolve_trajectory.hpp>
 #include <xdiag/states/create_state.hpp>
 #include <xdiag/states/fill.hpp>
+#include <xdiag/states/inner.hpp>
 #include <xdiag/states/product_state.hpp>
 #include <xdiag/utils/logger.hpp>
 #include <xdiag/utils/timing.hpp>
@@ -348,6 +350,82 @@ TEST_CASE("tj_complex_timeevo", "[time_evolution]") try {
   throw;
 }
 
+TEST_CASE("time_evolve_trajectory", "[time_evolution]") try {
+  Log("testing time evolution: time_evolve_trajectory");
+  Log.set_verbosity(0);
+  int N = 10;
+  auto block = Spinhalf(N, N / 2);
+  OpSum ops;
+  for (int i = 0; i < N; ++i) {
+    ops += "J" * Op("SdotS", {i, (i + 1) % N});
+    ops += "J2" * Op("SdotS", {i, (i + 2) % N});
+  }
+  ops["J"] = 1.0;
+  ops["J2"] = 0.3;
+  auto csr = csr_matrix(ops, block);
+
+  std::vector<int> pstate(N, 0);
+  for (int i = 0; i < N / 2; ++i) {
+    pstate[i] = 1;
+  }
+  auto psi_0 = product_state(block, pstate);
+
+  // exact evolution from the full spectrum
+  mat H = matrix(ops, block);
+  vec evals;
+  mat evecs;
+  eig_sym(evals, evecs, H);
+  cx_vec c0 = conv_to<cx_vec>::from(vec(evecs.t() * psi_0.vector()));
+  auto psi_exact = [&](double time) {
+    cx_vec phases = exp(cx_double(0, -time) * evals);
+    return cx_vec(evecs * (phases % c0));
+  };
+
+  std::vector<double> times;
+  for (int i = 0; i <= 200; ++i) {
+    times.push_back(0.025 * i);
+  }
+  std::vector<OpSum> observables = {OpSum(Op("Sz", {0})),
+                                    OpSum(Op("SzSz", {0, N / 2})),
+                                    OpSum(Op("S+", {0}))};
+
+  for (double tol : {1e-6, 1e-12}) {
+    int64_t ncalls = 0;
+    auto check = [&](double time, State const &psi) {
+      REQUIRE(time == times[ncalls]);
+      REQUIRE(norm(psi.vectorC() - psi_exact(time)) < 4 * tol);
+      ++ncalls;
+    };
+    auto res = time_evolve_trajectory(ops, psi_0, times, observables, check,
+                                      tol);
+    REQUIRE(ncalls == (int64_t)times.size());
+    REQUIRE(norm(res.state.vectorC() - psi_exact(times.back())) < 4 * tol);
+
+    // output times reuse the Krylov spaces of the steps to the final time
+    auto res_final = time_evolve_trajectory(ops, psi_0, {times.back()}, {},
+                                            nullptr, tol);
+    REQUIRE(res.nmvm == res_final.nmvm);
+    REQUIRE(norm(res_final.state.vectorC() - res.state.vectorC()) < 1e-14);
+
+    for (int64_t i = 0; i < (int64_t)times.size(); ++i) {
+      auto psi = State(block, psi_exact(times[i]));
+      REQUIRE(std::abs(res.measurements(i, 0) -
+                       innerC(observables[0], psi)) < 4 * tol);
+      REQUIRE(std::abs(res.measurements(i, 1) -
+                       innerC(observables[1], psi)) < 4 * tol);
+      REQUIRE(res.measurements(i, 2) == 0.);
+    }
+
+    auto rescsr = time_evolve_trajectory(csr, psi_0, times, observables,
+                                         nullptr, tol);
+    REQUIRE(norm(rescsr.measurements - res.measurements) < 4 * tol);
+    REQUIRE(norm(rescsr.state.vectorC() - res.state.vectorC()) < 4 * tol);
+  }
+} catch (xdiag::Error e) {
+  xdiag::error_trace(e);
+  throw;
+}
+
 // TEST_CASE("zero_state_timeevo", "[time_evolution]") try {
 //   int N = 4;
 //   auto b = Spinhalf(N);
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <tests/catch.hpp>
+#include <xdiag/math/complex.hpp>
+#include <xdiag/mpi/alltoall.hpp>
+#include <xdiag/mpi/communicator.hpp>
+#include <xdiag/mpi/exchange.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+
+template <class coeff_t> static coeff_t value(int from, int to, int64_t j) {
+  double re = 1000. * from + 100. * to + j;
+  if constexpr (std::is_same_v<coeff_t, complex>) {
+    return complex(re, -re);
+  } else {
+    return re;
+  }
+}
+
+// Exchanges the values of a pattern with all_to_all and Exchange and checks
+// that every rank receives the values sent to it
+template <class coeff_t>
+static void check_exchange(mpi::Communicator const &comm) {
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  std::vector<coeff_t> send(comm.send_buffer_size());
+  for (int r = 0; r < size; ++r) {
+    for (int64_t j = 0; j < comm.n_values_i_send(r); ++j) {
+      send[comm.n_values_i_send_offset(r) + j] = value<coeff_t>(rank, r, j);
+    }
+  }
+  auto check = [&](std::vector<coeff_t> const &recv) {
+    for (int r = 0; r < size; ++r) {
+      for (int64_t j = 0; j < comm.n_values_i_recv(r); ++j) {
+        REQUIRE(recv[comm.n_values_i_recv_offset(r) + j] ==
+                value<coeff_t>(r, rank, j));
+      }
+    }
+  };
+
+  std::vector<coeff_t> recv(comm.recv_buffer_size());
+  comm.all_to_all(send.data(), recv.data());
+  check(recv);
+
+  std::fill(recv.begin(), recv.end(), coeff_t(0.));
+  mpi::Exchange exchange;
+  exchange.start(comm, send.data(), recv.data());
+  exchange.wait();
+  check(recv);
+}
+
+TEST_CASE("alltoall_chunked", "[mpi]") {
+  Log("alltoall_chunked test");
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // complex counts at the limit still fit into an int
+  constexpr int64_t limit = mpi::ExchangeSettings::max_chunk_size_limit;
+  REQUIRE(2 * limit <= std::numeric_limits<int>::max());
+  REQUIRE(2 * (limit + 1) > std::numeric_limits<int>::max());
+
+  for (int64_t n = 0; n < 4; ++n) {
+    std::vector<int64_t> n_values_i_send(size);
+    for (int r = 0; r < size; ++r) {
+      n_values_i_send[r] = (rank + 2 * r + n) % 5;
+    }
+    mpi::exchange_settings.max_chunk_size = limit;
+    auto comm0 = mpi::Communicator(n_values_i_send);
+    int64_t buffer_size =
+        std::max(comm0.send_buffer_size(), comm0.recv_buffer_size());
+    int64_t buffer_size_max = 0;
+    MPI_Allreduce(&buffer_size, &buffer_size_max, 1, MPI_INT64_T, MPI_MAX,
+                  MPI_COMM_WORLD);
+
+    // buffers reaching the maximal chunk size are chunked
+    for (int64_t max_chunk_size = 1; max_chunk_size <= buffer_size_max + 1;
+         ++max_chunk_size) {
+      mpi::exchange_settings.max_chunk_size = max_chunk_size;
+      auto comm = mpi::Communicator(n_values_i_send);
+      if (buffer_size_max >= max_chunk_size) {
+        REQUIRE(comm.chunk_size() == max_chunk_size);
+      } else {
+        REQUIRE(comm.chunk_size() == 0);
+      }
+      check_exchange<double>(comm);
+      check_exchange<complex>(comm);
+    }
+
+    // chunk sizes beyond the limit are clamped
+    mpi::exchange_settings.max_chunk_size = (int64_t)1 << 40;
+    auto comm = mpi::Communicator(n_values_i_send);
+    REQUIRE(comm.chunk_size() == 0);
+    check_exchange<complex>(comm);
+
+    // chunk sizes whose complex counts overflow an int are reduced
+    std::vector<complex> send(comm.send_buffer_size());
+    std::vector<complex> recv(comm.recv_buffer_size());
+    std::vector<int64_t> send_counts(size), send_offsets(size);
+    std::vector<int64_t> recv_counts(size), recv_offsets(size);
+    for (int r = 0; r < size; ++r) {
+      send_counts[r] = comm.n_values_i_send(r);
+      send_offsets[r] = comm.n_values_i_send_offset(r);
+      recv_counts[r] = comm.n_values_i_recv(r);
+      recv_offsets[r] = comm.n_values_i_recv_offset(r);
+      for (int64_t j = 0; j < send_counts[r]; ++j) {
+        send[send_offsets[r] + j] = value<complex>(rank, r, j);
+      }
+    }
+    mpi::Alltoallv_chunked<complex>(
+        send.data(), send_counts.data(), send_offsets.data(), recv.data(),
+        recv_counts.data(), recv_offsets.data(), (int64_t)1 << 30,
+        MPI_COMM_WORLD);
+    for (int r = 0; r < size; ++r) {
+      for (int64_t j = 0; j < recv_counts[r]; ++j) {
+        REQUIRE(recv[recv_offsets[r] + j] == value<complex>(r, rank, j));
+      }
+    }
+  }
+  mpi::exchange_settings.max_chunk_size = limit;
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tests/catch.hpp>
+
+#include <vector>
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/states/fill.hpp>
+#include <xdiag/symmetries/cyclic_group.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+using namespace xdiag;
+
+static double coefficient(ProductState const &pstate) {
+  double c = 0.;
+  for (int64_t i = 0; i < pstate.size(); ++i) {
+    c = 1.7 * c + (double)(pstate[i] * (i + 1)) - 0.3;
+  }
+  return c;
+}
+
+static arma::cx_vec coefficients(State const &psi) {
+  return psi.isreal() ? arma::conv_to<arma::cx_vec>::from(psi.vector())
+                      : psi.vectorC();
+}
+
+template <typename block_t> static void test_fill(block_t const &block) {
+  // serial reference from the block iterator
+  arma::cx_vec ref(block.size());
+  int64_t idx = 0;
+  for (auto const &pstate : block) {
+    ref(idx++) = coefficient(pstate);
+  }
+
+  std::function<double(ProductState const &)> f = coefficient;
+  auto psi = State(block);
+  fill(psi, f);
+  REQUIRE(arma::norm(coefficients(psi) - ref) == 0.);
+
+  std::function<complex(ProductState const &)> fc =
+      [](ProductState const &pstate) {
+        return complex(coefficient(pstate), -coefficient(pstate));
+      };
+  auto psic = State(block, false);
+  fill(psic, fc);
+  REQUIRE(arma::norm(arma::real(psic.vectorC()) - arma::real(ref)) == 0.);
+  REQUIRE(arma::norm(arma::imag(psic.vectorC()) + arma::real(ref)) == 0.);
+
+  std::function<void(std::vector<ProductState> const &, arma::vec &)> fb =
+      [](std::vector<ProductState> const &pstates, arma::vec &coeffs) {
+        if (pstates.size() != coeffs.n_elem) { // Catch is not thread safe
+          XDIAG_THROW("batch size mismatch");
+        }
+        for (int64_t i = 0; i < (int64_t)pstates.size(); ++i) {
+          coeffs(i) = coefficient(pstates[i]);
+        }
+      };
+  auto psib = State(block);
+  fill(psib, fb);
+  REQUIRE(arma::norm(coefficients(psib) - ref) == 0.);
+
+  auto psibc = State(block, false);
+  fill(psibc, fb);
+  REQUIRE(arma::norm(psibc.vectorC() - ref) == 0.);
+
+  // exceptions thrown by the coefficient function are passed on
+  if (block.size() > 0) {
+    std::function<double(ProductState const &)> fthrow =
+        [](ProductState const &) -> double { XDIAG_THROW("coefficient"); };
+    REQUIRE_THROWS(fill(psi, fthrow));
+  }
+}
+
+TEST_CASE("fill", "[states]") try {
+  Log("testing fill");
+  for (int64_t nsites = 1; nsites <= 10; ++nsites) {
+    test_fill(Spinhalf(nsites));
+    test_fill(Spinhalf(nsites, nsites / 2));
+    test_fill(Electron(nsites / 2 + 1));
+    test_fill(Electron(nsites, nsites / 2, nsites / 3));
+    test_fill(tJ(nsites, nsites / 2, nsites / 3));
+    test_fill(Boson(nsites / 2 + 1, 3));
+    test_fill(Fermion(nsites, nsites / 2));
+    for (int64_t k = 0; k < nsites; ++k) {
+      auto irrep = cyclic_group_irrep(nsites, k);
+      test_fill(Spinhalf(nsites, nsites / 2, irrep));
+      test_fill(Electron(nsites, nsites / 2, nsites / 3, irrep));
+      test_fill(tJ(nsites, nsites / 2, nsites / 3, irrep));
+    }
+  }
+} catch (xdiag::Error const &e) {
+  error_trace(e);
+}
@@ -4,6 +4,10 @@
 
 #include "../../catch.hpp"
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+
 #include <xdiag/bits/bitarray.hpp>
 #include <xdiag/bits/bitset.hpp>
 #include <xdiag/symmetries/action/site_permutation.hpp>
@@ -121,6 +125,67 @@ TEST_CASE("site_permutation", "[symmetries]") try {
     REQUIRE(to_uint64(sp.apply(3, bits_in)) == 0b1000);
   }
 
+  // native integers: precompiled permutations agree with bit-by-bit apply
+  {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint64_t> dist;
+    auto check = [&](PermutationGroup const &group) {
+      auto sp = SitePermutation(group);
+      int64_t n = group.nsites();
+      uint64_t mask = (n == 64) ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+      for (int64_t sym = 0; sym < group.size(); ++sym) {
+        for (int r = 0; r < 20; ++r) {
+          uint64_t bits = dist(gen) & mask;
+          REQUIRE(sp.apply(sym, bits) == sp.apply_generic(sym, bits));
+          if (n <= 32) {
+            uint32_t bits32 = (uint32_t)bits;
+            REQUIRE(sp.apply(sym, bits32) == sp.apply_generic(sym, bits32));
+          }
+        }
+      }
+    };
+
+    for (int64_t n : {2, 3, 4, 7, 8, 9, 16, 31, 32, 33, 63, 64}) {
+      // translations (shift-and-mask)
+      check(cyclic_group(n));
+
+      // reflection (lookup tables)
+      std::vector<int64_t> refl(n);
+      for (int64_t i = 0; i < n; ++i) {
+        refl[i] = n - 1 - i;
+      }
+      check(PermutationGroup({Permutation(n), Permutation(refl)}));
+
+      // random involution (lookup tables)
+      std::vector<int64_t> sites(n);
+      std::iota(sites.begin(), sites.end(), 0);
+      std::shuffle(sites.begin(), sites.end(), gen);
+      std::vector<int64_t> invo(n);
+      std::iota(invo.begin(), invo.end(), 0);
+      for (int64_t i = 0; i + 1 < n; i += 2) {
+        invo[sites[i]] = sites[i + 1];
+        invo[sites[i + 1]] = sites[i];
+      }
+      check(PermutationGroup({Permutation(n), Permutation(invo)}));
+    }
+
+    // translations on a 8 x 8 square lattice
+    int64_t L = 8;
+    std::vector<Permutation> translations;
+    for (int64_t tx = 0; tx < L; ++tx) {
+      for (int64_t ty = 0; ty < L; ++ty) {
+        std::vector<int64_t> perm(L * L);
+        for (int64_t x = 0; x < L; ++x) {
+          for (int64_t y = 0; y < L; ++y) {
+            perm[y * L + x] = ((y + ty) % L) * L + (x + tx) % L;
+          }
+        }
+        translations.push_back(Permutation(perm));
+      }
+    }
+    check(PermutationGroup(translations));
+  }
+
   Log("done");
 } catch (xdiag::Error e) {
   xdiag::error_trace(e);
@@ -5,11 +5,13 @@
 #include "../../catch.hpp"
 
 #include <iostream>
+#include <vector>
 
 #include <xdiag/combinatorics/combinations/combinations.hpp>
 #include <xdiag/combinatorics/subsets/subsets.hpp>
 #include <xdiag/config.hpp>
 #include <xdiag/io/file_toml.hpp>
+#include <xdiag/symmetries/action/norm.hpp>
 #include <xdiag/symmetries/action/representative.hpp>
 #include <xdiag/symmetries/action/site_permutation.hpp>
 #include <xdiag/symmetries/action/site_permutation_sublattice.hpp>
@@ -25,6 +27,9 @@ void compare_actions(SitePermutation const &action1, action_t const &action2) {
 
   REQUIRE(action2.nsites() == nsites);
   REQUIRE(action2.size() == n_symmetries);
+  std::vector<arma::cx_vec> characters_list = {
+      arma::cx_vec(n_symmetries, arma::fill::ones),
+      arma::cx_vec(n_symmetries, arma::fill::randn)};
 
   for (auto bits : combinatorics::Subsets<uint64_t>(nsites)) {
 
@@ -50,6 +55,20 @@ void compare_actions(SitePermutation const &action1, action_t const &action2) {
       REQUIRE(action2.apply(sym2, bits) == r2);
     }
 
+    // Check single-scan representative test with the norm, which holds for
+    // arbitrary characters
+    {
+      using bit_t = decltype(action2.representative(bits));
+      bool isrep = (representative(bits, action1) == bits);
+      for (auto const &characters : characters_list) {
+        double nrm = isrep ? norm(bits, action1, characters) : 0.;
+        double nrm1 = representative_norm(bits, action1, characters);
+        double nrm2 = representative_norm((bit_t)bits, action2, characters);
+        REQUIRE(std::abs(nrm - nrm1) < 1e-12);
+        REQUIRE(std::abs(nrm - nrm2) < 1e-12);
+      }
+    }
+
     {
       auto [r1, syms1] = representative_syms(bits, action1);
       auto [r2, syms2] = action2.representative_syms(bits);
@@ -13,11 +13,30 @@
 #include <xdiag/config.hpp>
 #include <xdiag/io/file_toml.hpp>
 #include <xdiag/symmetries/fermi_sign.hpp>
+#include <xdiag/symmetries/tables/fermi_block_table.hpp>
 #include <xdiag/symmetries/tables/fermi_table.hpp>
 #include <xdiag/utils/logger.hpp>
 
 using namespace xdiag;
 
+// parity of the inversions among the images of the occupied sites
+template <typename bit_t>
+bool fermi_bool_reference(bit_t state, Permutation const &perm) {
+  std::vector<int64_t> images;
+  for (int64_t site = 0; site < perm.size(); ++site) {
+    if ((state >> site) & 1) {
+      images.push_back(perm[site]);
+    }
+  }
+  bool fermi = false;
+  for (int64_t i = 0; i < (int64_t)images.size(); ++i) {
+    for (int64_t j = i + 1; j < (int64_t)images.size(); ++j) {
+      fermi ^= (images[i] > images[j]);
+    }
+  }
+  return fermi;
+}
+
 template <typename bit_t>
 void test_fermi_bool_table(PermutationGroup const &group) {
   using combinatorics::Combinations;
@@ -26,15 +45,24 @@ void test_fermi_bool_table(PermutationGroup const &group) {
 
   int nsites = group.nsites();
   int n_symmetries = group.size();
+  auto blocks = FermiBlockTable(group);
 
   for (int npar = 0; npar <= nsites; ++npar) {
 
     auto fermi_tbl =
         symmetries::FermiTable(Combinations<bit_t>(nsites, npar), group);
+    auto fermi_tbl_blocks =
+        symmetries::FermiTable(Combinations<bit_t>(nsites, npar), group, 0);
+    if (Combinations<bit_t>(nsites, npar).size() > 0) {
+      REQUIRE(!fermi_tbl_blocks.dense());
+    }
     for (int sym = 0; sym < n_symmetries; ++sym) {
       for (bit_t state : Combinations<bit_t>(nsites, npar)) {
-        REQUIRE(fermi_tbl.sign(sym, state) ==
-                fermi_bool_of_permutation(state, group[sym]));
+        bool fermi = fermi_bool_reference(state, group[sym]);
+        REQUIRE(fermi_bool_of_permutation(state, group[sym]) == fermi);
+        REQUIRE(fermi_tbl.sign(sym, state) == fermi);
+        REQUIRE(fermi_tbl_blocks.sign(sym, state) == fermi);
+        REQUIRE(blocks.sign(sym, state) == fermi);
       }
     }
   }
@@ -87,4 +115,26 @@ TEST_CASE("fermi_table", "[symmetries]") {
       }
     }
   }
+
+  Log("  block tables, chain N=64");
+  {
+    using namespace combinatorics;
+    using namespace symmetries;
+    int nsites = 64;
+    auto irreps = xdiag::testcases::electron::get_cyclic_group_irreps(nsites);
+    auto group = irreps[0].group();
+    auto blocks = FermiBlockTable(group);
+    for (int npar = 0; npar <= 2; ++npar) {
+      auto fermi_tbl =
+          FermiTable(Combinations<uint64_t>(nsites, npar), group, 0);
+      for (int sym = 0; sym < group.size(); ++sym) {
+        for (auto state : Combinations<uint64_t>(nsites, npar)) {
+          bool fermi = fermi_bool_reference(state, group[sym]);
+          REQUIRE(fermi_bool_of_permutation(state, group[sym]) == fermi);
+          REQUIRE(fermi_tbl.sign(sym, state) == fermi);
+          REQUIRE(blocks.sign(sym, state) == fermi);
+        }
+      }
+    }
+  }
 }
@@ -4,6 +4,7 @@
 
 #include "algebra.hpp"
 
+#include <type_traits>
 #include <variant>
 
 #include <xdiag/algebra/rewrite/electron_rules.hpp>
@@ -227,6 +228,23 @@ Algebra implementation_algebra(Block const &block) try {
 }
 XDIAG_CATCH
 
+Algebra kernel_algebra(Block const &block) try {
+  return std::visit(
+      [](auto const &b) {
+        using block_t = std::decay_t<decltype(b)>;
+        if constexpr (std::is_same_v<block_t, tJ>) {
+          // symmetric tJ kernels expand Exchange to Cdag/C strings
+          if (b.irreps().group("SitePermutation")) {
+            return tj_implementation_algebra(b.nsites(),
+                                             /*exchange_as_kernel=*/false);
+          }
+        }
+        return implementation_algebra(b);
+      },
+      block);
+}
+XDIAG_CATCH
+
 Algebra symmetry_algebra(Spinhalf const &block) try {
   return matrix_algebra(block.nsites(), 2);
 }
@@ -89,6 +89,11 @@ Algebra implementation_algebra(ElectronDistributed const &block);
 #endif
 Algebra implementation_algebra(Block const &block);
 
+// Algebra in which the numerical kernels of the block process an OpSum. Agrees
+// with implementation_algebra(block), except for the symmetric tJ block whose
+// kernels do not treat Exchange as a named operator.
+Algebra kernel_algebra(Block const &block);
+
 Algebra symmetry_algebra(Boson const &block);
 Algebra symmetry_algebra(Spinhalf const &block);
 Algebra symmetry_algebra(Fermion const &block);
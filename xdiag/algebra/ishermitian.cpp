@@ -37,6 +37,14 @@ template <typename idx_t, typename coeff_t>
 bool ishermitian(COOMatrix<idx_t, coeff_t> const &A, Block const &, double) {
   return A.ishermitian;
 }
+template <typename idx_t, typename coeff_t>
+bool ishermitian(SELLMatrix<idx_t, coeff_t> const &A, Block const &, double) {
+  return A.ishermitian;
+}
+template <typename idx_t, typename coeff_t>
+bool ishermitian(CSRVIMatrix<idx_t, coeff_t> const &A, Block const &, double) {
+  return A.ishermitian;
+}
 
 // Explicit instantiations matching the sparse-matrix coefficient/index types.
 #define XDIAG_INSTANTIATE_ISHERMITIAN(Mat, idx_t, coeff_t)                     \
@@ -51,6 +59,8 @@ bool ishermitian(COOMatrix<idx_t, coeff_t> const &A, Block const &, double) {
 XDIAG_INSTANTIATE_ISHERMITIAN_ALL(CSRMatrix)
 XDIAG_INSTANTIATE_ISHERMITIAN_ALL(CSCMatrix)
 XDIAG_INSTANTIATE_ISHERMITIAN_ALL(COOMatrix)
+XDIAG_INSTANTIATE_ISHERMITIAN_ALL(SELLMatrix)
+XDIAG_INSTANTIATE_ISHERMITIAN_ALL(CSRVIMatrix)
 
 #undef XDIAG_INSTANTIATE_ISHERMITIAN_ALL
 #undef XDIAG_INSTANTIATE_ISHERMITIAN
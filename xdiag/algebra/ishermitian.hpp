@@ -36,5 +36,11 @@ bool ishermitian(CSCMatrix<idx_t, coeff_t> const &A, Block const &block,
 template <typename idx_t, typename coeff_t>
 bool ishermitian(COOMatrix<idx_t, coeff_t> const &A, Block const &block,
                  double tol = 1e-12);
+template <typename idx_t, typename coeff_t>
+bool ishermitian(SELLMatrix<idx_t, coeff_t> const &A, Block const &block,
+                 double tol = 1e-12);
+template <typename idx_t, typename coeff_t>
+bool ishermitian(CSRVIMatrix<idx_t, coeff_t> const &A, Block const &block,
+                 double tol = 1e-12);
 
 } // namespace xdiag
@@ -26,17 +26,22 @@ limitations under the License.
 #include <xdiag/blocks/fermion.hpp>
 #include <xdiag/blocks/spinhalf.hpp>
 #include <xdiag/blocks/tj.hpp>
+#include <xdiag/io/basis_cache.hpp>
 #include <xdiag/io/file_toml.hpp>
 #include <xdiag/io/read.hpp>
 #include <xdiag/io/toml/file_toml_handler.hpp>
 #include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/matrix.hpp>
 #include <xdiag/kernels/sparse/apply.hpp>
 #include <xdiag/kernels/sparse/coo_matrix.hpp>
 #include <xdiag/kernels/sparse/csc_matrix.hpp>
 #include <xdiag/kernels/sparse/csr_matrix.hpp>
+#include <xdiag/kernels/sparse/csrvi_matrix.hpp>
+#include <xdiag/kernels/sparse/sell_matrix.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/linalg/lanczos/eigs_lanczos.hpp>
+#include <xdiag/linalg/lanczos/eigs_trlanczos.hpp>
 #include <xdiag/linalg/lanczos/eigvals_lanczos.hpp>
 #include <xdiag/linalg/lobpcg/eigs_lobpcg.hpp>
 #include <xdiag/linalg/sparse_diag.hpp>
@@ -44,6 +49,7 @@ limitations under the License.
 #include <xdiag/linalg/time_evolution/imaginary_time_evolve.hpp>
 #include <xdiag/linalg/time_evolution/time_evolve_expokit.hpp>
 #include <xdiag/linalg/time_evolution/time_evolve.hpp>
+#include <xdiag/linalg/time_evolution/time_evolve_trajectory.hpp>
 #include <xdiag/operators/hc.hpp>
 #include <xdiag/operators/monomial.hpp>
 #include <xdiag/operators/op.hpp>
@@ -79,6 +85,8 @@ limitations under the License.
 #include <xdiag/blocks/distributed/electron_distributed.hpp>
 #include <xdiag/blocks/distributed/spinhalf_distributed.hpp>
 #include <xdiag/blocks/distributed/tj_distributed.hpp>
+#include <xdiag/mpi/exchange.hpp>
+#include <xdiag/mpi/timing_mpi.hpp>
 #endif
 
 #undef XDIAG_API
@@ -87,6 +95,7 @@ limitations under the License.
 #undef XDIAG_INSTANTIATE_APPLY
 #undef XDIAG_INSTANTIATE_COO_FILL
 #undef XDIAG_INSTANTIATE_COO_NNZ
+#undef XDIAG_INSTANTIATE_CSR_ENTRIES
 #undef XDIAG_INSTANTIATE_CSR_FILL
 #undef XDIAG_INSTANTIATE_CSR_NNZ
 #undef XDIAG_INSTANTIATE_KERNELS
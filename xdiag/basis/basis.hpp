@@ -7,7 +7,9 @@
 #include <cstddef>
 #include <memory>
 #include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <xdiag/bits/get_set.hpp>
 #include <xdiag/bits/zero_one.hpp>
@@ -29,6 +31,9 @@ public:
   virtual ~BasisIterator() = default;
   virtual void advance() = 0;
   virtual ProductState product_state() const = 0;
+  // Writes the current product state into pstate of size nsites, such that a
+  // loop over the basis does not allocate a ProductState per element.
+  virtual void product_state(ProductState &pstate) const = 0;
 };
 
 class Basis {
@@ -44,7 +49,14 @@ public:
   virtual int64_t size_max() const { return size(); }
   virtual int64_t size_min() const { return size(); }
   virtual std::unique_ptr<BasisIterator> product_state_iterator() const = 0;
+  // Iterators positioned at the ascending indices starts (each < size()),
+  // e.g. at the beginnings of chunks of the basis iterated by different threads
+  virtual std::vector<std::unique_ptr<BasisIterator>>
+  product_state_iterators(std::vector<int64_t> const &starts) const = 0;
   virtual int64_t index(ProductState const &pstate) const = 0;
+
+  // memory in bytes occupied by the lookup tables of the basis, if any
+  virtual int64_t table_memory() const { return 0; }
   virtual ~Basis() = default;
 };
 
@@ -100,12 +112,16 @@ public:
   void advance() override { ++it_; }
 
   ProductState product_state() const override {
-    auto config = *it_;
     ProductState ps(nsites_);
+    product_state(ps);
+    return ps;
+  }
+
+  void product_state(ProductState &ps) const override {
+    auto config = *it_;
     for (int64_t i = 0; i < nsites_; ++i) {
       ps[i] = local_state(config, i);
     }
-    return ps;
   }
 
 private:
@@ -113,6 +129,15 @@ private:
   int64_t nsites_;
 };
 
+// Iterators of the combinatorial enumerations and of stored tables can jump
+// forward by n elements (operator+=), others have to be advanced step by step
+template <typename iterator_t, typename = void>
+struct is_seekable : std::false_type {};
+template <typename iterator_t>
+struct is_seekable<iterator_t, std::void_t<decltype(std::declval<iterator_t &>()
+                                                    += int64_t())>>
+    : std::true_type {};
+
 template <typename Derived> class BasisType : public Basis {
 public:
   static std::size_t static_type() {
@@ -128,6 +153,31 @@ public:
                                                         derived->nsites());
   }
 
+  std::vector<std::unique_ptr<BasisIterator>>
+  product_state_iterators(std::vector<int64_t> const &starts) const override {
+    using iterator_t = typename Derived::iterator_t;
+    Derived const *derived = static_cast<Derived const *>(this);
+    std::vector<std::unique_ptr<BasisIterator>> iterators;
+    iterators.reserve(starts.size());
+    iterator_t it = derived->begin();
+    int64_t idx = 0;
+    for (int64_t start : starts) {
+      if constexpr (is_seekable<iterator_t>::value) {
+        if (start > idx) {
+          it += (start - idx);
+        }
+      } else { // a single pass over the basis for all starts
+        for (; idx < start; ++idx) {
+          ++it;
+        }
+      }
+      idx = start;
+      iterators.push_back(
+          std::make_unique<BasisIteratorImpl<Derived>>(it, derived->nsites()));
+    }
+    return iterators;
+  }
+
 protected:
   ~BasisType() = default;
 };
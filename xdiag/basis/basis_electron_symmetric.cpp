@@ -4,6 +4,7 @@
 
 #include "basis_electron_symmetric.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include <xdiag/bits/bitset.hpp>
@@ -13,6 +14,8 @@
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/timing.hpp>
 
 namespace xdiag::basis {
 
@@ -66,54 +69,95 @@ BasisElectronSymmetric<enumeration_t>::BasisElectronSymmetric(
   arma::cx_vec chars = characters_.as<arma::cx_vec>();
 
   ups_offset_.resize(n_rep_ups);
-  // (start, length) of each up representative's dn block in the flat storage;
-  // converted to spans below, once the storage has stopped reallocating.
-  std::vector<std::pair<span_size_t, span_size_t>> dns_limits(n_rep_ups);
 
   // Shared front block: all dn states (norm 1), used by every up representative
   // with a trivial up-stabilizer. The dn enumeration is ascending, so the front
   // doubles as the (ascending) search block for the trivial case.
-  for (bit_t dns : basis_dn_) {
-    dns_storage_.push_back(dns);
-    norms_storage_.push_back(1.0);
+  Log(2, "Creating symmetric electron basis...");
+  auto time_total = rightnow();
+
+  // A trivial up-stabilizer (the common case) just points at the shared front,
+  // only the non-trivial up-stabilizers materialise a dn-rep block with an
+  // O(size_dn) scan. The blocks are built in two passes: the first collects the
+  // block of every non-trivial representative in parallel, the second copies
+  // the blocks to their position in the flat storage given by the prefix sums
+  // of the block lengths.
+  Log(2, "  collect dn blocks...");
+  auto time_collect = rightnow();
+  std::vector<int64_t> nontrivial;
+  for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
+    if (stab_size(idx_up) != 1) {
+      nontrivial.push_back(idx_up);
+    }
   }
+  int64_t n_nontrivial = nontrivial.size();
+  std::vector<std::vector<bit_t>> dns_for_nontrivial(n_nontrivial);
+  std::vector<std::vector<double>> norms_for_nontrivial(n_nontrivial);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t i = 0; i < n_nontrivial; ++i) {
+    // The stabilizer of the representative equals syms_ups(ups) since ups is
+    // a rep here.
+    bit_t ups = basis_up_[nontrivial[i]];
+    std::vector<int64_t> stab = syms_ups(ups);
+    for (bit_t dns : basis_dn_) {
+      bit_t dns_rep = symmetries::representative_subset(dns, action_, stab);
+      if (dns == dns_rep) {
+        double nrm = coupled_norm<enumeration_t>(ups, dns, action_, stab, chars,
+                                                 fermi_up_, fermi_dn_);
+        if (nrm > 1e-6) {
+          dns_for_nontrivial[i].push_back(dns);
+          norms_for_nontrivial[i].push_back(nrm);
+        }
+      }
+    }
+  }
+  timing(time_collect, rightnow(), "  time (collect)", 2);
+
+  Log(2, "  write dn blocks...");
+  auto time_write = rightnow();
 
-  // One-time construction, kept serial: a trivial up-stabilizer (the common
-  // case) is O(1) -- it just points at the shared front -- and only the rare
-  // non-trivial up-stabilizers do the O(size_dn) dn scan. It parallelises over
-  // representatives if it ever becomes a bottleneck (each rep fills a disjoint
-  // block), but that is not worth the added machinery here.
+  // (start, length) of each up representative's dn block in the flat storage
+  std::vector<std::pair<span_size_t, span_size_t>> dns_limits(n_rep_ups);
   size_ = 0;
-  for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
-    bit_t ups = basis_up_[idx_up];
+  span_size_t storage_size = size_dn;
+  for (int64_t idx_up = 0, i = 0; idx_up < n_rep_ups; ++idx_up) {
     ups_offset_[idx_up] = size_;
-
-    if (stab_size(idx_up) == 1) {
-      // trivial up-stabilizer: point at the shared front block
+    if ((i < n_nontrivial) && (nontrivial[i] == idx_up)) {
+      span_size_t length = dns_for_nontrivial[i].size();
+      dns_limits[idx_up] = {storage_size, length};
+      storage_size += length;
+      size_ += (int64_t)length;
+      ++i;
+    } else {
       dns_limits[idx_up] = {(span_size_t)0, (span_size_t)size_dn};
       size_ += size_dn;
-    } else {
-      // non-trivial up-stabilizer: materialise the dn-rep block. The stabilizer
-      // of the representative equals syms_ups(ups) since ups is a rep here.
-      std::vector<int64_t> stab = syms_ups(ups);
-      span_size_t start = dns_storage_.size();
-      for (bit_t dns : basis_dn_) {
-        bit_t dns_rep = symmetries::representative_subset(dns, action_, stab);
-        if (dns == dns_rep) {
-          double nrm = coupled_norm<enumeration_t>(ups, dns, action_, stab,
-                                                   chars, fermi_up_, fermi_dn_);
-          if (nrm > 1e-6) {
-            dns_storage_.push_back(dns);
-            norms_storage_.push_back(nrm);
-          }
-        }
-      }
-      span_size_t length = dns_storage_.size() - start;
-      dns_limits[idx_up] = {start, length};
-      size_ += (int64_t)length;
     }
   }
 
+  dns_storage_.resize(storage_size);
+  norms_storage_.resize(storage_size);
+  span_size_t idx_dn = 0;
+  for (bit_t dns : basis_dn_) {
+    dns_storage_[idx_dn] = dns;
+    norms_storage_[idx_dn] = 1.0;
+    ++idx_dn;
+  }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t i = 0; i < n_nontrivial; ++i) {
+    span_size_t start = dns_limits[nontrivial[i]].first;
+    std::copy(dns_for_nontrivial[i].begin(), dns_for_nontrivial[i].end(),
+              dns_storage_.begin() + start);
+    std::copy(norms_for_nontrivial[i].begin(), norms_for_nontrivial[i].end(),
+              norms_storage_.begin() + start);
+    std::vector<bit_t>().swap(dns_for_nontrivial[i]);
+    std::vector<double>().swap(norms_for_nontrivial[i]);
+  }
+
   // Storage is now final: materialise the per-rep spans (cannot dangle now).
   dns_for_ups_rep_.reserve(n_rep_ups);
   norms_for_ups_rep_.reserve(n_rep_ups);
@@ -122,6 +166,8 @@ BasisElectronSymmetric<enumeration_t>::BasisElectronSymmetric(
     dns_for_ups_rep_.push_back({dns_storage_.data() + start, length});
     norms_for_ups_rep_.push_back({norms_storage_.data() + start, length});
   }
+  timing(time_write, rightnow(), "  time (write)", 2);
+  timing(time_total, rightnow(), "done", 2);
 }
 XDIAG_CATCH
 
@@ -6,16 +6,20 @@
 
 #include <algorithm>
 #include <limits>
+#include <string>
+#include <utility>
 
 #include <xdiag/bits/get_set.hpp>
 #include <xdiag/bits/popcount.hpp>
 #include <xdiag/combinatorics/combinations/combinations.hpp>
 #include <xdiag/combinatorics/subsets/subsets.hpp>
+#include <xdiag/io/basis_cache.hpp>
 #include <xdiag/states/product_state.hpp>
 #include <xdiag/symmetries/action/norm.hpp>
 #include <xdiag/symmetries/action/site_permutation_sublattice.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/timing.hpp>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -27,82 +31,123 @@ namespace {
 
 constexpr int64_t undefined = std::numeric_limits<int64_t>::min();
 
+// number of chunks per thread for the dynamic scheduling of the construction
+constexpr int64_t chunks_per_thread = 16;
+
+// Computes the representatives and their norms of a sublattice basis. States
+// are enumerated as (prefix << n_trailing) | postfix, where the prefixes are
+// given in ascending order and postfixes(prefix) returns the ascending
+// enumeration of postfixes for a prefix. The concatenation of the postfixes of
+// all prefixes is split into chunks of near-equal size. A first pass collects
+// the representatives of every chunk in parallel, and a second pass copies
+// them to their final position given by the prefix sums of the chunk counts.
+// Since the chunks are ordered, the representatives come out ascending.
+template <typename bit_t, typename coeff_t, int n_sublat, class postfixes_f>
+std::pair<std::vector<bit_t>, std::vector<double>>
+reps_norms(symmetries::SitePermutationSublattice<bit_t, n_sublat> const &action,
+           arma::Col<coeff_t> const &characters, int64_t n_trailing,
+           std::vector<bit_t> const &prefixes, postfixes_f &&postfixes) {
+  Log(2, "Creating sublattice basis...");
+  auto time_total = rightnow();
+
+  // offsets of the postfixes of each prefix in the concatenated enumeration
+  int64_t nprefixes = prefixes.size();
+  std::vector<int64_t> offsets(nprefixes + 1, 0);
+  for (int64_t p = 0; p < nprefixes; ++p) {
+    offsets[p + 1] = offsets[p] + (int64_t)postfixes(prefixes[p]).size();
+  }
+  int64_t total = offsets[nprefixes];
+
+#ifdef _OPENMP
+  int64_t nchunks =
+      std::min(total, chunks_per_thread * (int64_t)omp_get_max_threads());
+#else
+  int64_t nchunks = std::min(total, (int64_t)1);
+#endif
+
+  Log(2, "  collect representatives...");
+  auto time_collect = rightnow();
+  std::vector<std::vector<bit_t>> reps_for_chunk(nchunks);
+  std::vector<std::vector<double>> norms_for_chunk(nchunks);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t chunk = 0; chunk < nchunks; ++chunk) {
+    int64_t begin = (total * chunk) / nchunks;
+    int64_t end = (total * (chunk + 1)) / nchunks;
+    auto &reps = reps_for_chunk[chunk];
+    auto &norms = norms_for_chunk[chunk];
+
+    // last prefix whose postfixes start at or before begin
+    int64_t p = std::upper_bound(offsets.begin(), offsets.end(), begin) -
+                offsets.begin() - 1;
+    for (int64_t idx = begin; idx < end; ++p) {
+      bit_t prefix = prefixes[p];
+      auto posts = postfixes(prefix);
+      int64_t local_end = std::min(end, offsets[p + 1]) - offsets[p];
+      auto it = posts.begin() + (idx - offsets[p]);
+      for (int64_t local = idx - offsets[p]; local < local_end; ++local, ++it) {
+        bit_t state = (prefix << n_trailing) | *it;
+        double norm =
+            symmetries::representative_norm(state, action, characters);
+        if (std::abs(norm) > 1e-6) {
+          reps.push_back(state);
+          norms.push_back(norm);
+        }
+      }
+      idx = offsets[p] + local_end;
+    }
+  }
+  timing(time_collect, rightnow(), "  time (collect)", 2);
+
+  Log(2, "  write representatives...");
+  auto time_write = rightnow();
+  std::vector<int64_t> chunk_offsets(nchunks + 1, 0);
+  for (int64_t chunk = 0; chunk < nchunks; ++chunk) {
+    chunk_offsets[chunk + 1] =
+        chunk_offsets[chunk] + (int64_t)reps_for_chunk[chunk].size();
+  }
+  std::vector<bit_t> reps(chunk_offsets[nchunks]);
+  std::vector<double> norms(chunk_offsets[nchunks]);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t chunk = 0; chunk < nchunks; ++chunk) {
+    std::copy(reps_for_chunk[chunk].begin(), reps_for_chunk[chunk].end(),
+              reps.begin() + chunk_offsets[chunk]);
+    std::copy(norms_for_chunk[chunk].begin(), norms_for_chunk[chunk].end(),
+              norms.begin() + chunk_offsets[chunk]);
+    std::vector<bit_t>().swap(reps_for_chunk[chunk]);
+    std::vector<double>().swap(norms_for_chunk[chunk]);
+  }
+  timing(time_write, rightnow(), "  time (write representatives)", 2);
+  timing(time_total, rightnow(), "done", 2);
+  return {std::move(reps), std::move(norms)};
+}
+
 template <typename bit_t, typename coeff_t, int n_sublat>
 std::pair<std::vector<bit_t>, std::vector<double>> reps_norms_no_sz(
     symmetries::SitePermutationSublattice<bit_t, n_sublat> const &action,
     arma::Col<coeff_t> const &characters) {
   using combinatorics::Subsets;
 
-  std::vector<bit_t> reps;
-  std::vector<double> norms;
-
   int64_t nsites = action.nsites();
   int64_t nsites_sublat = nsites / n_sublat;
   int64_t n_leading = nsites_sublat;
   int64_t n_trailing = (n_sublat - 1) * nsites_sublat;
 
+  std::vector<bit_t> prefixes;
   for (auto prefix : Subsets<bit_t>(n_leading)) {
-
     // if prefix is not rep, the full state also cannot be rep
     auto prefix_rep = action.reps_[n_sublat - 1][(int64_t)prefix];
-    if (prefix_rep < prefix) {
-      continue;
+    if (prefix_rep >= prefix) {
+      prefixes.push_back(prefix);
     }
-
-#ifndef _OPENMP
-    for (auto postfix : Subsets<bit_t>(n_trailing)) {
-      bit_t state = (prefix << n_trailing) | postfix;
-      bit_t rep = action.representative(state);
-      if (state == rep) {
-        double norm = symmetries::norm(rep, action, characters);
-        if (std::abs(norm) > 1e-6) {
-          reps.push_back(rep);
-          norms.push_back(norm);
-        }
-      }
-    }
-#else
-    std::vector<std::vector<bit_t>> reps_thread;
-    std::vector<std::vector<double>> norms_thread;
-    auto postfixes = Subsets<bit_t>(n_trailing);
-    int64_t sz = postfixes.size();
-
-#pragma omp parallel
-    {
-      int myid = omp_get_thread_num();
-      int nthr = omp_get_num_threads();
-#pragma omp single
-      {
-        reps_thread.resize(nthr);
-        norms_thread.resize(nthr);
-      }
-      int64_t start = myid * (sz / nthr);
-      int64_t end = (myid == nthr - 1) ? sz : (myid + 1) * (sz / nthr);
-      for (auto it = postfixes.begin() + start, eit = postfixes.begin() + end;
-           it != eit; ++it) {
-        bit_t postfix = *it;
-        bit_t state = (prefix << n_trailing) | postfix;
-        bit_t rep = action.representative(state);
-        if (state == rep) {
-          double norm = symmetries::norm(rep, action, characters);
-          if (std::abs(norm) > 1e-6) {
-            reps_thread[myid].push_back(rep);
-            norms_thread[myid].push_back(norm);
-          }
-        }
-      }
-    } // omp parallel
-
-    for (auto const &rv : reps_thread)
-      reps.insert(reps.end(), rv.begin(), rv.end());
-    for (auto const &nv : norms_thread)
-      norms.insert(norms.end(), nv.begin(), nv.end());
-#endif
-  } // for prefix
-
-  reps.shrink_to_fit();
-  norms.shrink_to_fit();
-  return {reps, norms};
+  }
+  return reps_norms(action, characters, n_trailing, prefixes,
+                    [&](bit_t) { return Subsets<bit_t>(n_trailing); });
 }
 
 template <typename bit_t, typename coeff_t, int n_sublat>
@@ -110,16 +155,16 @@ std::pair<std::vector<bit_t>, std::vector<double>> reps_norms_sz(
     int64_t nup,
     symmetries::SitePermutationSublattice<bit_t, n_sublat> const &action,
     arma::Col<coeff_t> const &characters) {
-  std::vector<bit_t> reps;
-  std::vector<double> norms;
+  using combinatorics::Combinations;
+  using combinatorics::Subsets;
 
   int64_t nsites = action.nsites();
   int64_t nsites_sublat = nsites / n_sublat;
   int64_t n_leading = nsites_sublat;
   int64_t n_trailing = (n_sublat - 1) * nsites_sublat;
 
-  for (auto prefix : combinatorics::Subsets<bit_t>(n_leading)) {
-
+  std::vector<bit_t> prefixes;
+  for (auto prefix : Subsets<bit_t>(n_leading)) {
     int64_t nup_prefix = bits::popcount(prefix);
     int64_t nup_postfix = nup - nup_prefix;
     if ((nup_postfix < 0) || (nup_postfix > n_trailing)) {
@@ -128,94 +173,90 @@ std::pair<std::vector<bit_t>, std::vector<double>> reps_norms_sz(
 
     // if prefix is not rep, the full state also cannot be rep
     auto prefix_rep = action.reps_[n_sublat - 1][(int64_t)prefix];
-    if (prefix_rep < prefix) {
-      continue;
-    }
-
-#ifndef _OPENMP
-    for (auto postfix :
-         combinatorics::Combinations<bit_t>(n_trailing, nup_postfix)) {
-      bit_t state = (prefix << n_trailing) | postfix;
-      bit_t rep = action.representative(state);
-      if (state == rep) {
-        double norm = symmetries::norm(rep, action, characters);
-        if (std::abs(norm) > 1e-6) {
-          reps.push_back(rep);
-          norms.push_back(norm);
-        }
-      }
+    if (prefix_rep >= prefix) {
+      prefixes.push_back(prefix);
     }
-#else
-    std::vector<std::vector<bit_t>> reps_thread;
-    std::vector<std::vector<double>> norms_thread;
-    auto combs = combinatorics::Combinations<bit_t>(n_trailing, nup_postfix);
-    int64_t sz = combs.size();
-
-#pragma omp parallel
-    {
-      int myid = omp_get_thread_num();
-      int nthr = omp_get_num_threads();
-#pragma omp single
-      {
-        reps_thread.resize(nthr);
-        norms_thread.resize(nthr);
-      }
-      int64_t start = myid * (sz / nthr);
-      int64_t end = (myid == nthr - 1) ? sz : (myid + 1) * (sz / nthr);
-      for (auto it = combs.begin() + start, eit = combs.begin() + end;
-           it != eit; ++it) {
-        bit_t postfix = *it;
-        bit_t state = (prefix << n_trailing) | postfix;
-        bit_t rep = action.representative(state);
-        if (state == rep) {
-          double norm = symmetries::norm(rep, action, characters);
-          if (std::abs(norm) > 1e-6) {
-            reps_thread[myid].push_back(rep);
-            norms_thread[myid].push_back(norm);
-          }
-        }
-      }
-    } // omp parallel
-
-    for (auto const &rv : reps_thread)
-      reps.insert(reps.end(), rv.begin(), rv.end());
-    for (auto const &nv : norms_thread)
-      norms.insert(norms.end(), nv.begin(), nv.end());
-#endif
-  } // for prefix
-
-  reps.shrink_to_fit();
-  norms.shrink_to_fit();
-  return {reps, norms};
+  }
+  auto postfixes = [&](bit_t prefix) {
+    return Combinations<bit_t>(n_trailing, nup - bits::popcount(prefix));
+  };
+  return reps_norms(action, characters, n_trailing, prefixes, postfixes);
 }
 
+// Ranges [begin, end) of the representatives sharing the same leading bits
+// above n_postfix_bits. The boundaries of the ranges are found in parallel,
+// only the insertion into the hash map is serial.
 template <typename bit_t>
-ska::flat_hash_map<bit_t, gsl::span<bit_t const>>
+ska::flat_hash_map<bit_t, std::pair<int64_t, int64_t>>
 compute_rep_search_range(std::vector<bit_t> const &reps,
                          int64_t n_postfix_bits) {
-  ska::flat_hash_map<bit_t, gsl::span<bit_t const>> rep_search_range;
-
-  if (reps.size() > 0) {
-    int64_t start = 0;
-    int64_t end = 0;
-    bit_t previous_prefix = reps[0] >> n_postfix_bits;
-    for (auto rep : reps) {
-      bit_t prefix = rep >> n_postfix_bits;
-      if (prefix != previous_prefix) {
-        rep_search_range[previous_prefix] =
-            gsl::span<bit_t const>(reps.data() + start, end - start);
-        previous_prefix = prefix;
-        start = end;
-      }
-      ++end;
+  int64_t size = reps.size();
+  std::vector<char> is_start(size, 0);
+  int64_t nranges = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : nranges)
+#endif
+  for (int64_t idx = 0; idx < size; ++idx) {
+    if ((idx == 0) ||
+        ((reps[idx] >> n_postfix_bits) != (reps[idx - 1] >> n_postfix_bits))) {
+      is_start[idx] = 1;
+      ++nranges;
     }
-    rep_search_range[previous_prefix] =
-        gsl::span<bit_t const>(reps.data() + start, end - start);
   }
 
+  ska::flat_hash_map<bit_t, std::pair<int64_t, int64_t>> rep_search_range;
+  rep_search_range.reserve(nranges);
+  int64_t start = 0;
+  for (int64_t idx = 1; idx <= size; ++idx) {
+    if ((idx == size) || is_start[idx]) {
+      rep_search_range[reps[start] >> n_postfix_bits] = {start, idx};
+      start = idx;
+    }
+  }
   return rep_search_range;
 }
 
+// Representatives and norms from/to the on-disk cache
+template <typename bit_t, int n_sublat>
+io::CacheKey cache_key(int64_t nsites, int64_t nup,
+                       PermutationGroup const &group,
+                       Vector const &characters) {
+  io::CacheKey key;
+  key.add(BasisSublattice<bit_t, n_sublat>::type_name)
+      .add(nsites)
+      .add(nup)
+      .add(group)
+      .add(characters);
+  return key;
+}
+
+template <typename bit_t>
+bool read_cache(std::string const &filename, io::CacheKey const &key,
+                std::vector<bit_t> &reps, std::vector<double> &norms) {
+  io::CacheReader file(filename, key);
+  file.read(reps);
+  file.read(norms);
+  return file.good() && (reps.size() == norms.size());
+}
+
+// The cache is optional, failing to write it only issues a warning
+template <typename bit_t>
+void write_cache(std::string const &filename, io::CacheKey const &key,
+                 std::vector<bit_t> const &reps,
+                 std::vector<double> const &norms) {
+  try {
+    io::CacheWriter file(filename, key);
+    file.write(reps);
+    file.write(norms);
+    file.commit();
+    Log(2, "Wrote sublattice basis to \"{}\"", filename);
+  } catch (Error const &e) {
+    Log.warn("Warning: unable to write sublattice basis to basis cache "
+             "\"{}\": {}",
+             filename, e.what());
+  }
+}
+
 } // namespace
 
 template <typename bit_t, int n_sublat>
@@ -225,13 +266,23 @@ BasisSublattice<bit_t, n_sublat>::BasisSublattice(PermutationGroup const &group,
       nsites_(group.nsites()), nup_(undefined),
       n_postfix_bits_(nsites_ - std::min(maximum_prefix_bits, nsites_)) {
   check_nsites_work_with_bits<bit_t>(nsites_);
-  if (isreal(characters)) {
-    std::tie(reps_, norms_) =
-        reps_norms_no_sz(action_, characters.as<arma::vec>());
+  auto key = cache_key<bit_t, n_sublat>(nsites_, nup_, group, characters);
+  std::string filename = io::basis_cache_filename("basis_sublattice", key);
+  if (!filename.empty() && read_cache(filename, key, reps_, norms_)) {
+    Log(2, "Read sublattice basis from \"{}\"", filename);
   } else {
-    std::tie(reps_, norms_) =
-        reps_norms_no_sz(action_, characters.as<arma::cx_vec>());
+    if (isreal(characters)) {
+      std::tie(reps_, norms_) =
+          reps_norms_no_sz(action_, characters.as<arma::vec>());
+    } else {
+      std::tie(reps_, norms_) =
+          reps_norms_no_sz(action_, characters.as<arma::cx_vec>());
+    }
+    if (!filename.empty()) {
+      write_cache(filename, key, reps_, norms_);
+    }
   }
+  rep_search_range_ = compute_rep_search_range(reps_, n_postfix_bits_);
 }
 XDIAG_CATCH
 
@@ -243,13 +294,23 @@ BasisSublattice<bit_t, n_sublat>::BasisSublattice(int64_t nup,
       nsites_(group.nsites()), nup_(nup),
       n_postfix_bits_(nsites_ - std::min(maximum_prefix_bits, nsites_)) {
   check_nsites_work_with_bits<bit_t>(nsites_);
-  if (isreal(characters)) {
-    std::tie(reps_, norms_) =
-        reps_norms_sz(nup, action_, characters.as<arma::vec>());
+  auto key = cache_key<bit_t, n_sublat>(nsites_, nup_, group, characters);
+  std::string filename = io::basis_cache_filename("basis_sublattice", key);
+  if (!filename.empty() && read_cache(filename, key, reps_, norms_)) {
+    Log(2, "Read sublattice basis from \"{}\"", filename);
   } else {
-    std::tie(reps_, norms_) =
-        reps_norms_sz(nup, action_, characters.as<arma::cx_vec>());
+    if (isreal(characters)) {
+      std::tie(reps_, norms_) =
+          reps_norms_sz(nup, action_, characters.as<arma::vec>());
+    } else {
+      std::tie(reps_, norms_) =
+          reps_norms_sz(nup, action_, characters.as<arma::cx_vec>());
+    }
+    if (!filename.empty()) {
+      write_cache(filename, key, reps_, norms_);
+    }
   }
+  rep_search_range_ = compute_rep_search_range(reps_, n_postfix_bits_);
 }
 XDIAG_CATCH
 
@@ -299,10 +360,10 @@ BasisSublattice<bit_t, n_sublat>::index_of_representative(bit_t rep) const {
   if (itr == rep_search_range_.end()) {
     return invalid_index;
   } else {
-    gsl::span<bit_t const> search_range = itr->second;
-    auto it = std::lower_bound(search_range.begin(), search_range.end(), rep);
-    if ((it != search_range.end()) && (*it == rep)) {
-      return &(*it) - reps_.data();
+    auto [begin, end] = itr->second;
+    auto it = std::lower_bound(reps_.begin() + begin, reps_.begin() + end, rep);
+    if ((it != reps_.begin() + end) && (*it == rep)) {
+      return it - reps_.begin();
     } else {
       return invalid_index;
     }
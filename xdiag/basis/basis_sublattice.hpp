@@ -60,7 +60,8 @@ private:
 
   std::vector<bit_t> reps_;
   std::vector<double> norms_;
-  ska::flat_hash_map<bit_t, gsl::span<bit_t const>> rep_search_range_;
+  // [begin, end) of the representatives with the same leading bits
+  ska::flat_hash_map<bit_t, std::pair<int64_t, int64_t>> rep_search_range_;
 
   int64_t index_of_representative(bit_t rep) const;
 
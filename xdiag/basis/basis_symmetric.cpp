@@ -17,9 +17,10 @@ template <typename enumeration_t>
 BasisSymmetric<enumeration_t>::BasisSymmetric(enumeration_t const &enumeration,
                                               PermutationGroup const &group,
                                               Vector const &characters,
-                                              bool fermionic) try
+                                              bool fermionic,
+                                              bool compact) try
     : enumeration_(enumeration), group_(group), characters_(characters),
-      table_(enumeration, group, characters, fermionic) {}
+      table_(enumeration, group, characters, fermionic, compact) {}
 XDIAG_CATCH
 
 template <typename enumeration_t>
@@ -42,6 +43,11 @@ BasisSymmetric<enumeration_t>::index(ProductState const &pstate) const {
   return raw > 0 ? raw - 1 : invalid_index;
 }
 
+template <typename enumeration_t>
+int64_t BasisSymmetric<enumeration_t>::table_memory() const {
+  return table_.memory();
+}
+
 template <typename enumeration_t>
 int64_t BasisSymmetric<enumeration_t>::d() const {
   return enumeration_.d();
@@ -33,11 +33,12 @@ public:
   BasisSymmetric() = default;
   BasisSymmetric(enumeration_t const &enumeration,
                  PermutationGroup const &group, Vector const &characters,
-                 bool fermionic = false);
+                 bool fermionic = false, bool compact = false);
 
   int64_t size() const override;
   int64_t nsites() const override;
   int64_t index(ProductState const &pstate) const override;
+  int64_t table_memory() const override;
   int64_t d() const; // Local Hilbert space dimension per site
   PermutationGroup const &group() const;
   Vector const &characters() const;
@@ -47,6 +48,14 @@ public:
   // - 1.
   inline std::tuple<int64_t, int64_t, double>
   representative_data(bit_t bits) const {
+    if (table_.compact()) {
+      auto [raw, sym] = table_.raw_representative_index_sym(bits);
+      if (XDIAG_LIKELY(raw)) {
+        return {raw, sym, table_.representative_norm(raw - 1)};
+      } else {
+        return {0, 0, 0.0};
+      }
+    }
     int64_t idx = enumeration_.index(bits);
     int64_t raw = table_.raw_representative_index(idx);
     if (XDIAG_LIKELY(raw)) {
@@ -62,6 +71,15 @@ public:
   // 3-tuple representative_data.
   inline std::tuple<int64_t, int64_t, double, bool>
   representative_data_fermi(bit_t bits) const {
+    if (table_.compact()) {
+      auto [raw, sym] = table_.raw_representative_index_sym(bits);
+      if (XDIAG_LIKELY(raw)) {
+        return {raw, sym, table_.representative_norm(raw - 1),
+                table_.representative_fermi_bool(bits, sym)};
+      } else {
+        return {0, 0, 0.0, false};
+      }
+    }
     int64_t idx = enumeration_.index(bits);
     int64_t raw = table_.raw_representative_index(idx);
     if (XDIAG_LIKELY(raw)) {
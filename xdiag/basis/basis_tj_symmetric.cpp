@@ -4,6 +4,7 @@
 
 #include "basis_tj_symmetric.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include <xdiag/bits/bitmask.hpp>
@@ -17,6 +18,8 @@
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/timing.hpp>
 
 namespace xdiag::basis {
 
@@ -95,45 +98,28 @@ BasistJSymmetric<enumeration_t>::BasistJSymmetric(
   int64_t n_rep_ups = basis_up_.size();
   arma::cx_vec chars = characters_.as<arma::cx_vec>();
 
+  Log(2, "Creating symmetric tJ basis...");
+  auto time_total = rightnow();
+
+  // precompile the compression masks (the non-up sites) of the up reps
   if constexpr (use_compressed_index_) {
     extractors_.reserve(n_rep_ups);
-  }
-  ups_offset_.resize(n_rep_ups);
-  // (start, length) of each up representative's dn block in the flat storage;
-  // converted to spans below, once the storage has stopped reallocating.
-  std::vector<std::pair<span_size_t, span_size_t>> dns_limits(n_rep_ups);
-
-  // Unlike BasisElectronSymmetric there is NO shared front block: the
-  // no-double-occupancy constraint `ups & dns == 0` couples the allowed dn
-  // configurations to the up representative, so EVERY up representative
-  // materialises its own dn block (filtered by the constraint). One-time
-  // construction, kept serial.
-  //
-  // valid_dns holds this up rep's valid dn configurations (no double occupancy,
-  // i.e. the dns supported on its free / non-up sites), reused across up reps.
-  // In the number-conserving case every up rep has exactly C(nsites-nup, ndn) of
-  // them (== compressed_dns.size()), so reserve that capacity once up front;
-  // clear() below keeps it, so the per-up-rep fill never reallocates.
-  std::vector<bit_t> valid_dns;
-  valid_dns.reserve(compressed_dns.size());
-  size_ = 0;
-  for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
-    bit_t ups = basis_up_[idx_up];
-    ups_offset_[idx_up] = size_;
-    span_size_t start = dns_storage_.size();
-
-    // precompile this up rep's compression mask (its non-up sites)
-    if constexpr (use_compressed_index_) {
+    for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
+      bit_t ups = basis_up_[idx_up];
       extractors_.emplace_back((bit_t)((~ups) & sitesmask));
     }
+  }
+  ups_offset_.resize(n_rep_ups);
 
-    // Collect the valid dns in ascending order. In the integral
-    // (compressed-index) case we obtain them DIRECTLY by depositing the
-    // precomputed compressed dn patterns into the free-site mask, instead of
-    // scanning the whole dn Hilbert space and discarding the double-occupied
-    // ones. deposit is the inverse of the compressor and monotonic, so the dns
-    // come out in the same ascending order (hence the same block layout) as the
-    // old full-scan-and-filter. The BitsetDynamic fallback keeps the full scan.
+  // Collect the valid dns (no double occupancy, i.e. the dns supported on the
+  // free / non-up sites) of an up rep in ascending order. In the integral
+  // (compressed-index) case we obtain them DIRECTLY by depositing the
+  // precomputed compressed dn patterns into the free-site mask, instead of
+  // scanning the whole dn Hilbert space and discarding the double-occupied
+  // ones. deposit is the inverse of the compressor and monotonic, so the dns
+  // come out in the same ascending order (hence the same block layout) as the
+  // old full-scan-and-filter. The BitsetDynamic fallback keeps the full scan.
+  auto collect_valid_dns = [&](int64_t idx_up, std::vector<bit_t> &valid_dns) {
     valid_dns.clear();
     if constexpr (use_compressed_index_) {
       bit_t free = extractors_[idx_up].mask();
@@ -149,50 +135,119 @@ BasistJSymmetric<enumeration_t>::BasistJSymmetric(
         }
       }
     } else {
+      bit_t ups = basis_up_[idx_up];
       for (bit_t dns : basis_dn_) {
         if (bits::iszero(dns & ups)) {
           valid_dns.push_back(dns);
         }
       }
     }
+  };
 
-    if (stab_size(idx_up) == 1) {
-      // trivial up-stabilizer: every valid dn has norm 1. valid_dns is
-      // ascending, so the block stays ascending.
-      for (bit_t dns : valid_dns) {
-        dns_storage_.push_back(dns);
-        norms_storage_.push_back(1.0);
-      }
-    } else {
-      // non-trivial up-stabilizer: materialise the dn-rep block, keeping only dn
-      // representatives with non-zero coupled norm. The stabilizer of the
-      // representative equals syms_ups(ups) since ups is a rep here.
-      std::vector<int64_t> stab = syms_ups(ups);
-      for (bit_t dns : valid_dns) {
-        bit_t dns_rep = symmetries::representative_subset(dns, action_, stab);
-        if (dns == dns_rep) {
-          double nrm = coupled_norm<enumeration_t>(ups, dns, action_, stab,
-                                                   chars, fermi_up_, fermi_dn_);
-          if (nrm > 1e-6) {
-            dns_storage_.push_back(dns);
-            norms_storage_.push_back(nrm);
+  // Unlike BasisElectronSymmetric there is NO shared front block: the
+  // no-double-occupancy constraint `ups & dns == 0` couples the allowed dn
+  // configurations to the up representative, so EVERY up representative
+  // materialises its own dn block (filtered by the constraint). The blocks are
+  // built in two passes over the up reps. The first pass counts the block
+  // length of every up rep in parallel. A trivial up-stabilizer keeps all
+  // valid dns with norm 1, and a non-trivial one keeps only the dn
+  // representatives with non-zero coupled norm, whose (rare) blocks are stored
+  // right away. The second pass writes the blocks to their position in the flat
+  // storage given by the prefix sums of the block lengths.
+  Log(2, "  count dn blocks...");
+  auto time_count = rightnow();
+  std::vector<span_size_t> lengths(n_rep_ups, 0);
+  std::vector<std::vector<bit_t>> dns_for_nontrivial(n_rep_ups);
+  std::vector<std::vector<double>> norms_for_nontrivial(n_rep_ups);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    // valid_dns holds the valid dn configurations of an up rep, reused across
+    // up reps. In the number-conserving case every up rep has exactly
+    // C(nsites-nup, ndn) of them (== compressed_dns.size()), so reserve that
+    // capacity once up front.
+    std::vector<bit_t> valid_dns;
+    valid_dns.reserve(compressed_dns.size());
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
+      collect_valid_dns(idx_up, valid_dns);
+      if (stab_size(idx_up) == 1) {
+        lengths[idx_up] = valid_dns.size();
+      } else {
+        // The stabilizer of the representative equals syms_ups(ups) since ups
+        // is a rep here.
+        bit_t ups = basis_up_[idx_up];
+        std::vector<int64_t> stab = syms_ups(ups);
+        for (bit_t dns : valid_dns) {
+          bit_t dns_rep = symmetries::representative_subset(dns, action_, stab);
+          if (dns == dns_rep) {
+            double nrm = coupled_norm<enumeration_t>(
+                ups, dns, action_, stab, chars, fermi_up_, fermi_dn_);
+            if (nrm > 1e-6) {
+              dns_for_nontrivial[idx_up].push_back(dns);
+              norms_for_nontrivial[idx_up].push_back(nrm);
+            }
           }
         }
+        lengths[idx_up] = dns_for_nontrivial[idx_up].size();
+      }
+    }
+  }
+  timing(time_count, rightnow(), "  time (count)", 2);
+
+  Log(2, "  write dn blocks...");
+  auto time_write = rightnow();
+  size_ = 0;
+  for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
+    ups_offset_[idx_up] = size_;
+    size_ += (int64_t)lengths[idx_up];
+  }
+  dns_storage_.resize(size_);
+  norms_storage_.resize(size_);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<bit_t> valid_dns;
+    valid_dns.reserve(compressed_dns.size());
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
+      int64_t start = ups_offset_[idx_up];
+      if (stab_size(idx_up) == 1) {
+        collect_valid_dns(idx_up, valid_dns);
+        std::copy(valid_dns.begin(), valid_dns.end(),
+                  dns_storage_.begin() + start);
+        std::fill(norms_storage_.begin() + start,
+                  norms_storage_.begin() + start + valid_dns.size(), 1.0);
+      } else {
+        auto &dns = dns_for_nontrivial[idx_up];
+        auto &norms = norms_for_nontrivial[idx_up];
+        std::copy(dns.begin(), dns.end(), dns_storage_.begin() + start);
+        std::copy(norms.begin(), norms.end(), norms_storage_.begin() + start);
+        std::vector<bit_t>().swap(dns);
+        std::vector<double>().swap(norms);
       }
     }
-    span_size_t length = dns_storage_.size() - start;
-    dns_limits[idx_up] = {start, length};
-    size_ += (int64_t)length;
   }
 
   // Storage is now final: materialise the per-rep spans (cannot dangle now).
   dns_for_ups_rep_.reserve(n_rep_ups);
   norms_for_ups_rep_.reserve(n_rep_ups);
   for (int64_t idx_up = 0; idx_up < n_rep_ups; ++idx_up) {
-    auto [start, length] = dns_limits[idx_up];
+    span_size_t start = ups_offset_[idx_up];
+    span_size_t length = lengths[idx_up];
     dns_for_ups_rep_.push_back({dns_storage_.data() + start, length});
     norms_for_ups_rep_.push_back({norms_storage_.data() + start, length});
   }
+  timing(time_write, rightnow(), "  time (write)", 2);
+  timing(time_total, rightnow(), "done", 2);
 }
 XDIAG_CATCH
 
@@ -252,6 +252,23 @@ BasisElectronDistributed<bit_t>::end() const {
   return iterator_t(*this, false);
 }
 
+template <typename bit_t>
+mpi::CommPattern &BasisElectronDistributed<bit_t>::comm_pattern() const {
+  return comm_pattern_;
+}
+
+template <typename bit_t>
+mpi::Communicator const &
+BasisElectronDistributed<bit_t>::transpose_communicator_r() const {
+  return transpose_communicator_r_;
+}
+
+template <typename bit_t>
+std::vector<int64_t> const &
+BasisElectronDistributed<bit_t>::transpose_permutation_r() const {
+  return transpose_permutation_r_;
+}
+
 template <typename bit_t>
 std::vector<bit_t> const &BasisElectronDistributed<bit_t>::my_ups() const {
   return my_ups_;
@@ -285,6 +285,23 @@ typename BasistJDistributed<bit_t>::iterator_t BasistJDistributed<bit_t>::end()
   return iterator_t(*this, false);
 }
 
+template <typename bit_t>
+mpi::CommPattern &BasistJDistributed<bit_t>::comm_pattern() const {
+  return comm_pattern_;
+}
+
+template <typename bit_t>
+mpi::Communicator const &
+BasistJDistributed<bit_t>::transpose_communicator_r() const {
+  return transpose_communicator_r_;
+}
+
+template <typename bit_t>
+std::vector<int64_t> const &
+BasistJDistributed<bit_t>::transpose_permutation_r() const {
+  return transpose_permutation_r_;
+}
+
 template <typename bit_t>
 std::vector<bit_t> const &BasistJDistributed<bit_t>::my_ups() const {
   return my_ups_;
@@ -11,6 +11,7 @@
 #include <xdiag/bits/extract_deposit.hpp>
 #include <xdiag/bits/popcount.hpp>
 #include <xdiag/combinatorics/combinations/lin_table.hpp>
+#include <xdiag/mpi/comm_pattern.hpp>
 #include <xdiag/mpi/communicator.hpp>
 #include <xdiag/random/hash_functions.hpp>
 #include <xdiag/utils/type_name.hpp>
@@ -71,6 +72,7 @@ private:
   mpi::Communicator transpose_communicator_r_;
   std::vector<int64_t> transpose_permutation_;
   std::vector<int64_t> transpose_permutation_r_;
+  mutable mpi::CommPattern comm_pattern_;
 
   std::vector<bit_t> my_ups_;
   std::unordered_map<bit_t, int64_t> my_ups_offset_;
@@ -83,6 +85,15 @@ private:
   std::vector<bit_t> my_ups_for_dns_storage_;
 
 public:
+  // Communication patterns of the exchange terms, determined at their first
+  // application
+  mpi::CommPattern &comm_pattern() const;
+
+  // Pattern and permutation of the transpose from dn/up to up/dn order. The
+  // values received from a rank are ordered by its dns, ascending.
+  mpi::Communicator const &transpose_communicator_r() const;
+  std::vector<int64_t> const &transpose_permutation_r() const;
+
   std::vector<bit_t> const &my_ups() const;
   int64_t my_ups_offset(bit_t ups) const;
   gsl::span<bit_t> my_dns_for_ups(int64_t idx_ups) const;
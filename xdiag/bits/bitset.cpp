@@ -44,6 +44,12 @@ Bitset<chunk_t, nchunks>::chunks() const noexcept {
   return chunks_;
 }
 
+template <typename chunk_t, int64_t nchunks>
+typename Bitset<chunk_t, nchunks>::storage_t &
+Bitset<chunk_t, nchunks>::chunks() noexcept {
+  return chunks_;
+}
+
 template <typename chunk_t, int64_t nchunks>
 int64_t Bitset<chunk_t, nchunks>::count() const noexcept {
   int64_t total = 0;
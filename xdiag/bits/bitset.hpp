@@ -245,6 +245,7 @@ public:
   }
 
   storage_t const &chunks() const noexcept;
+  storage_t &chunks() noexcept;
 
 private:
   // Optimized shift-by-1 for division algorithm
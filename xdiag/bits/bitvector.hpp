@@ -138,6 +138,10 @@ public:
   bool operator==(BitVector<value_t> const &rhs) const noexcept;
   bool operator!=(BitVector<value_t> const &rhs) const noexcept;
 
+  // packed storage, e.g. to write the vector to a file and read it back
+  inline BitsetDynamic const &storage() const noexcept { return storage_; }
+  inline BitsetDynamic &storage() noexcept { return storage_; }
+
 private:
   int64_t nbits_ = 0;
   int64_t size_ = 0;
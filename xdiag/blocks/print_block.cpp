@@ -118,6 +118,9 @@ void print_block(std::ostream &out, block_t const &block) {
       std::regex_replace(basisname, std::regex("unsigned int"), "uint32_t");
 
   out << fmt::format("│ {:<9}: {}\n", "basis", basisname);
+  if (int64_t memory = block.basis()->table_memory(); memory > 0) {
+    out << fmt::format("│ {:<9}: {:.3f} MB\n", "tables", memory / 1e6);
+  }
   out << fmt::format("│ {:<9}: {:x}\n", "ID", random::hash(block));
 
   if constexpr (is_distributed_v<block_t>) {
@@ -116,6 +116,17 @@ Spinhalf::Spinhalf(int64_t nsites, RepresentationSet const &irreps,
       basis_ = std::make_shared<BasisSymmetric<enum_t>>(enumeration, *group,
                                                         *characters);
     });
+  } else if (backend == "compact") { // BasisSymmetric, compact tables
+    if (nsites > 64) {
+      XDIAG_THROW("Unsupported nsites > 64 for Spinhalf block with compact "
+                  "backend");
+    }
+    dispatch_enumeration(nsites, nup, [&](auto &&enumeration) {
+      using enum_t = std::decay_t<decltype(enumeration)>;
+      basis_ = std::make_shared<BasisSymmetric<enum_t>>(
+          enumeration, *group, *characters, /*fermionic=*/false,
+          /*compact=*/true);
+    });
   } else { // "<k>sublattice" coding -> BasisSublattice
     dispatch_sublattice(backend, nsites, [&](auto tag) {
       using basis_t = typename decltype(tag)::type;
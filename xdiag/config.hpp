@@ -0,0 +1,10 @@
+#pragma once
+
+#define XDIAG_VERSION "0.5.0"
+#define XDIAG_DIRECTORY "/root/repo"
+#define XDIAG_HOSTNAME "vm"
+#define XDIAG_COMPILEDBY "root"
+
+namespace xdiag {
+inline const char *git_hash() { return "ec4af620a98a9fd2cd15b1343e0d6ce51ffcb653"; }
+} // namespace xdiag
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "basis_cache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+
+namespace xdiag::io {
+
+// Bump the version whenever the layout of any cached table changes
+static constexpr char cache_magic[8] = {'X', 'D', 'I', 'A', 'G', 'B', 'C', 0};
+static constexpr uint64_t cache_version = 2;
+
+CacheKey &CacheKey::add(void const *data, int64_t nbytes) {
+  auto bytes = static_cast<unsigned char const *>(data);
+  for (int64_t i = 0; i < nbytes; ++i) {
+    hash_ ^= bytes[i];
+    hash_ *= 1099511628211ULL;
+  }
+  bytes_.append(static_cast<char const *>(data), nbytes);
+  return *this;
+}
+
+CacheKey &CacheKey::add(std::string_view str) {
+  add((int64_t)str.size());
+  return add(str.data(), str.size());
+}
+
+CacheKey &CacheKey::add(PermutationGroup const &group) {
+  int64_t nsites = group.nsites();
+  int64_t size = group.size();
+  add(nsites);
+  add(size);
+  for (int64_t sym = 0; sym < size; ++sym) {
+    add(group.ptr(sym), nsites * sizeof(int64_t));
+  }
+  return *this;
+}
+
+CacheKey &CacheKey::add(Vector const &characters) {
+  // real and complex characters of the same values give the same tables
+  arma::cx_vec chars = characters.as<arma::cx_vec>();
+  add((int64_t)chars.n_elem);
+  return add(chars.memptr(), chars.n_elem * sizeof(complex));
+}
+
+uint64_t CacheKey::value() const { return hash_; }
+std::string const &CacheKey::bytes() const { return bytes_; }
+
+std::string basis_cache_filename(std::string const &name,
+                                 CacheKey const &key) {
+  std::string const &directory = basis_cache_settings.directory;
+  if (directory.empty()) {
+    return "";
+  }
+  return (std::filesystem::path(directory) /
+          fmt::format("{}_{:016x}.bin", name, key.value()))
+      .string();
+}
+
+CacheWriter::CacheWriter(std::string const &filename,
+                         CacheKey const &key) try
+    : filename_(filename) {
+  std::filesystem::path path(filename);
+  std::error_code ec;
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+  std::random_device rd;
+  tmpname_ = fmt::format("{}.tmp.{:08x}{:08x}", filename, rd(), rd());
+  file_.open(tmpname_, std::ios::binary | std::ios::trunc);
+  if (!file_) {
+    XDIAG_THROW(fmt::format("Unable to open basis cache file \"{}\" for "
+                            "writing",
+                            tmpname_));
+  }
+  write(cache_magic, sizeof(cache_magic));
+  write(cache_version);
+  write(key.value());
+  write((int64_t)key.bytes().size());
+  write(key.bytes().data(), key.bytes().size());
+}
+XDIAG_CATCH
+
+CacheWriter::~CacheWriter() {
+  if (!committed_) {
+    file_.close();
+    std::error_code ec;
+    std::filesystem::remove(tmpname_, ec);
+  }
+}
+
+void CacheWriter::write(void const *data, int64_t nbytes) try {
+  file_.write(static_cast<char const *>(data), nbytes);
+  if (!file_) {
+    XDIAG_THROW(fmt::format("Unable to write to basis cache file \"{}\"",
+                            tmpname_));
+  }
+}
+XDIAG_CATCH
+
+void CacheWriter::write(bits::BitVector<uint64_t> const &values) try {
+  write(values.size());
+  write(values.nbits());
+  write(values.storage().chunks());
+}
+XDIAG_CATCH
+
+void CacheWriter::commit() try {
+  file_.close();
+  if (!file_) {
+    XDIAG_THROW(fmt::format("Unable to write to basis cache file \"{}\"",
+                            tmpname_));
+  }
+  // rename is atomic, a concurrent reader sees either no file or all of it
+  std::error_code ec;
+  std::filesystem::rename(tmpname_, filename_, ec);
+  if (ec) {
+    XDIAG_THROW(fmt::format("Unable to rename basis cache file \"{}\" to "
+                            "\"{}\": {}",
+                            tmpname_, filename_, ec.message()));
+  }
+  committed_ = true;
+}
+XDIAG_CATCH
+
+CacheReader::CacheReader(std::string const &filename, CacheKey const &key) {
+  std::error_code ec;
+  int64_t size = std::filesystem::file_size(filename, ec);
+  if (ec) {
+    return;
+  }
+  file_.open(filename, std::ios::binary);
+  if (!file_) {
+    return;
+  }
+  good_ = true;
+  remaining_ = size;
+  char magic[sizeof(cache_magic)];
+  uint64_t version = 0;
+  uint64_t value = 0;
+  int64_t nbytes = 0;
+  read(magic, sizeof(magic));
+  read(version);
+  read(value);
+  read(nbytes);
+  good_ = good_ && (std::memcmp(magic, cache_magic, sizeof(magic)) == 0) &&
+          (version == cache_version) && (value == key.value()) &&
+          (nbytes == (int64_t)key.bytes().size());
+
+  // the hashes of different keys can agree, compare the keys in full
+  std::string bytes(good_ ? nbytes : 0, '\0');
+  read(bytes.data(), bytes.size());
+  good_ = good_ && (bytes == key.bytes());
+}
+
+bool CacheReader::good() const { return good_; }
+
+void CacheReader::read(void *data, int64_t nbytes) {
+  if (!good_ || (nbytes > remaining_)) {
+    good_ = false;
+    return;
+  }
+  file_.read(static_cast<char *>(data), nbytes);
+  remaining_ -= nbytes;
+  good_ = (bool)file_;
+}
+
+void CacheReader::read(bits::BitVector<uint64_t> &values) {
+  int64_t size = 0;
+  int64_t nbits = 0;
+  read(size);
+  read(nbits);
+  if (!good_ || (size < 0) || (nbits < 0) ||
+      (nbits > 0 && size > remaining_ * 8 / nbits)) {
+    good_ = false;
+    return;
+  }
+  values = (nbits > 0) ? bits::BitVector<uint64_t>(size, nbits)
+                       : bits::BitVector<uint64_t>();
+  std::vector<uint64_t> chunks;
+  read(chunks);
+  if (good_ && (chunks.size() == values.storage().chunks().size())) {
+    values.storage().chunks() = std::move(chunks);
+  } else {
+    good_ = false;
+  }
+}
+
+} // namespace xdiag::io
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <xdiag/bits/bitvector.hpp>
+#include <xdiag/math/vector.hpp>
+#include <xdiag/symmetries/permutation_group.hpp>
+
+namespace xdiag::io {
+
+// Settings of the on-disk cache of symmetric basis tables.
+//
+// If directory is not empty, the tables of symmetric bases (the
+// RepresentativeTable of BasisSymmetric, also used for the up spins of the
+// symmetric electron and tJ bases, and the representatives of BasisSublattice)
+// are written to binary files in this directory when they are built for the
+// first time. Later constructions of a basis with the same enumeration, group,
+// characters and options read the tables back instead of rebuilding them, also
+// in other processes. Files are written under a temporary name and renamed when
+// complete, such that concurrent jobs never read partial files.
+struct BasisCacheSettings {
+  std::string directory = "";
+};
+inline BasisCacheSettings basis_cache_settings;
+
+// Identifies the content of a cache file. The serialized key is stored in the
+// file header and compared in full when reading, its 64-bit FNV-1a hash names
+// the file.
+class CacheKey {
+public:
+  CacheKey() = default;
+  CacheKey &add(void const *data, int64_t nbytes);
+  CacheKey &add(std::string_view str);
+  CacheKey &add(PermutationGroup const &group);
+  CacheKey &add(Vector const &characters);
+  template <typename T> CacheKey &add(T const &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return add(&value, sizeof(T));
+  }
+  uint64_t value() const;
+  std::string const &bytes() const;
+
+private:
+  uint64_t hash_ = 14695981039346656037ULL;
+  std::string bytes_;
+};
+
+// Name of the cache file for the table `name` with the given key, or an empty
+// string if the cache is disabled
+std::string basis_cache_filename(std::string const &name, CacheKey const &key);
+
+// Writes a cache file. The data is written to a temporary file which is
+// renamed to filename by commit(), or removed if commit() is never called.
+class CacheWriter {
+public:
+  CacheWriter(std::string const &filename, CacheKey const &key);
+  ~CacheWriter();
+
+  void write(void const *data, int64_t nbytes);
+  template <typename T> void write(T const &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write(&value, sizeof(T));
+  }
+  template <typename T> void write(std::vector<T> const &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write((int64_t)values.size());
+    write(values.data(), values.size() * sizeof(T));
+  }
+  void write(bits::BitVector<uint64_t> const &values);
+  void commit();
+
+private:
+  std::string filename_;
+  std::string tmpname_;
+  std::ofstream file_;
+  bool committed_ = false;
+};
+
+// Reads a cache file. good() is false if the file does not exist, has a
+// different format version or key (also if only the hashes of the keys
+// agree), or is too short; the tables then have to be rebuilt.
+class CacheReader {
+public:
+  CacheReader(std::string const &filename, CacheKey const &key);
+
+  bool good() const;
+  void read(void *data, int64_t nbytes);
+  template <typename T> void read(T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    read(&value, sizeof(T));
+  }
+  template <typename T> void read(std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    int64_t size = 0;
+    read(size);
+    if (good_ && (size >= 0) && (size <= remaining_ / (int64_t)sizeof(T))) {
+      values.resize(size);
+      read(values.data(), size * sizeof(T));
+    } else {
+      good_ = false;
+    }
+  }
+  void read(bits::BitVector<uint64_t> &values);
+
+private:
+  std::ifstream file_;
+  int64_t remaining_ = 0;
+  bool good_ = false;
+};
+
+} // namespace xdiag::io
@@ -8,11 +8,13 @@
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/kernels/blocks/dispatch_bases.hpp>
 #include <xdiag/kernels/blocks/distributed/apply_distributed.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/kernels.hpp>
 #include <xdiag/operators/monomial.hpp>
 #include <xdiag/operators/op.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
 #include <xdiag/utils/variants.hpp>
 
 // Dispatch overview
@@ -43,14 +45,34 @@
 
 namespace xdiag {
 
+// Decides whether the "pull" variant of the kernels is used, which iterates
+// over the output basis and gathers from the input vector. This avoids the
+// atomic updates of the "push" variant when running with several OpenMP
+// threads, but is only valid for Hermitian ops. It is therefore never chosen
+// automatically and has to be requested explicitly.
+static bool use_pull(std::string const &direction) try {
+  if (direction == "push") {
+    return false;
+  } else if (direction == "pull") {
+    return true;
+  } else {
+    XDIAG_THROW(fmt::format("Invalid direction \"{}\" for apply. Must be "
+                            "either \"push\" or \"pull\"",
+                            direction));
+  }
+}
+XDIAG_CATCH
+
 // Layer 2 implementation — internal, called only from apply(op_t, Block, ...).
 // One body for every block type: the dispatch_basis overload supplies the basis
 // dispatch (the numerical kernel is selected by block_t in kernels.cpp). A
-// block type with no dispatch_basis overload is a compile error here.
+// block type with no dispatch_basis overload is a compile error here. With
+// compiled = true, ops is already normal ordered (see CompiledOpSum).
 template <typename block_t, typename vec_t>
 static void apply_template(OpSum const &ops, block_t const &block_in,
                            vec_t const &vec_in, block_t const &block_out,
-                           vec_t &vec_out) try {
+                           vec_t &vec_out, bool fused, bool pull,
+                           bool compiled) try {
   vec_out.zeros();
 
   if constexpr (is_distributed_v<block_t>) {
@@ -76,7 +98,8 @@ static void apply_template(OpSum const &ops, block_t const &block_in,
     kernels::dispatch_basis(
         block_in, block_out, [&](auto const &basis_in, auto const &basis_out) {
           // Kernel: definition is in kernels.cpp, instantiated per basis type.
-          kernels::apply<block_t>(ops, basis_in, vec_in, basis_out, vec_out);
+          kernels::apply<block_t>(ops, basis_in, vec_in, basis_out, vec_out,
+                                  fused, pull, compiled);
         });
   }
 }
@@ -85,13 +108,41 @@ XDIAG_CATCH
 template <typename mat_t>
 static void apply_variant(OpSum const &ops, Block const &block_in,
                           mat_t const &vec_in, Block const &block_out,
-                          mat_t &vec_out) try {
+                          mat_t &vec_out, bool fused,
+                          std::string const &direction) try {
   // Layer 1: unwrap the Block variant (op_t is promoted to OpSum inside) and
   // forward to the block-generic apply_impl.
+  bool pull = use_pull(direction);
   utils::visit_same_type(
       block_in, block_out,
       [&](auto const &bin, auto const &bout) {
-        apply_template(OpSum(ops), bin, vec_in, bout, vec_out);
+        apply_template(OpSum(ops), bin, vec_in, bout, vec_out, fused, pull,
+                       false);
+      },
+      "Type mismatch of Block types");
+}
+XDIAG_CATCH
+
+// Same as apply_variant, but with ops validated, normal ordered and checked for
+// hermiticity beforehand
+template <typename mat_t>
+static void apply_compiled(CompiledOpSum const &ops, Block const &block_in,
+                           mat_t const &vec_in, Block const &block_out,
+                           mat_t &vec_out, std::string const &direction) try {
+  if (!isapprox(block_in, ops.block)) {
+    XDIAG_THROW("Input block does not agree with the block the CompiledOpSum "
+                "has been built for");
+  }
+  if (nsites(block_out) != nsites(ops.block)) {
+    XDIAG_THROW("Number of sites of output block does not agree with the "
+                "block the CompiledOpSum has been built for");
+  }
+  bool pull = use_pull(direction);
+  utils::visit_same_type(
+      block_in, block_out,
+      [&](auto const &bin, auto const &bout) {
+        apply_template(ops.ops_compiled, bin, vec_in, bout, vec_out, ops.fused,
+                       pull, true);
       },
       "Type mismatch of Block types");
 }
@@ -99,67 +150,108 @@ XDIAG_CATCH
 
 void apply(Op const &op, Block const &block_in, arma::vec const &vec_in,
            Block const &block_out, arma::vec &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 
 void apply(Op const &op, Block const &block_in, arma::cx_vec const &vec_in,
            Block const &block_out, arma::cx_vec &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 void apply(Op const &op, Block const &block_in, arma::mat const &vec_in,
            Block const &block_out, arma::mat &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 void apply(Op const &op, Block const &block_in, arma::cx_mat const &vec_in,
            Block const &block_out, arma::cx_mat &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 
 void apply(Monomial const &op, Block const &block_in, arma::vec const &vec_in,
            Block const &block_out, arma::vec &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 void apply(Monomial const &op, Block const &block_in,
            arma::cx_vec const &vec_in, Block const &block_out,
            arma::cx_vec &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 void apply(Monomial const &op, Block const &block_in, arma::mat const &vec_in,
            Block const &block_out, arma::mat &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 void apply(Monomial const &op, Block const &block_in,
            arma::cx_mat const &vec_in, Block const &block_out,
            arma::cx_mat &vec_out) try {
-  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out);
+  apply_variant(OpSum(op), block_in, vec_in, block_out, vec_out, false,
+                "push");
 }
 XDIAG_CATCH
 
-void apply(OpSum const &op, Block const &block_in, arma::vec const &vec_in,
-           Block const &block_out, arma::vec &vec_out) try {
-  apply_variant(op, block_in, vec_in, block_out, vec_out);
+void apply(OpSum const &op, Block const &block_in,
+           arma::vec const &vec_in, Block const &block_out,
+           arma::vec &vec_out, bool fused,
+           std::string const &direction) try {
+  apply_variant(op, block_in, vec_in, block_out, vec_out, fused, direction);
 }
 XDIAG_CATCH
-void apply(OpSum const &op, Block const &block_in, arma::cx_vec const &vec_in,
-           Block const &block_out, arma::cx_vec &vec_out) try {
-  apply_variant(op, block_in, vec_in, block_out, vec_out);
+void apply(OpSum const &op, Block const &block_in,
+           arma::cx_vec const &vec_in, Block const &block_out,
+           arma::cx_vec &vec_out, bool fused,
+           std::string const &direction) try {
+  apply_variant(op, block_in, vec_in, block_out, vec_out, fused, direction);
 }
 XDIAG_CATCH
-void apply(OpSum const &op, Block const &block_in, arma::mat const &vec_in,
-           Block const &block_out, arma::mat &vec_out) try {
-  apply_variant(op, block_in, vec_in, block_out, vec_out);
+void apply(OpSum const &op, Block const &block_in,
+           arma::mat const &vec_in, Block const &block_out,
+           arma::mat &vec_out, bool fused,
+           std::string const &direction) try {
+  apply_variant(op, block_in, vec_in, block_out, vec_out, fused, direction);
 }
 XDIAG_CATCH
-void apply(OpSum const &op, Block const &block_in, arma::cx_mat const &vec_in,
-           Block const &block_out, arma::cx_mat &vec_out) try {
-  apply_variant(op, block_in, vec_in, block_out, vec_out);
+void apply(OpSum const &op, Block const &block_in,
+           arma::cx_mat const &vec_in, Block const &block_out,
+           arma::cx_mat &vec_out, bool fused,
+           std::string const &direction) try {
+  apply_variant(op, block_in, vec_in, block_out, vec_out, fused, direction);
+}
+XDIAG_CATCH
+
+void apply(CompiledOpSum const &ops, Block const &block_in,
+           arma::vec const &vec_in, Block const &block_out,
+           arma::vec &vec_out, std::string const &direction) try {
+  apply_compiled(ops, block_in, vec_in, block_out, vec_out, direction);
+}
+XDIAG_CATCH
+void apply(CompiledOpSum const &ops, Block const &block_in,
+           arma::cx_vec const &vec_in, Block const &block_out,
+           arma::cx_vec &vec_out, std::string const &direction) try {
+  apply_compiled(ops, block_in, vec_in, block_out, vec_out, direction);
+}
+XDIAG_CATCH
+void apply(CompiledOpSum const &ops, Block const &block_in,
+           arma::mat const &vec_in, Block const &block_out,
+           arma::mat &vec_out, std::string const &direction) try {
+  apply_compiled(ops, block_in, vec_in, block_out, vec_out, direction);
+}
+XDIAG_CATCH
+void apply(CompiledOpSum const &ops, Block const &block_in,
+           arma::cx_mat const &vec_in, Block const &block_out,
+           arma::cx_mat &vec_out, std::string const &direction) try {
+  apply_compiled(ops, block_in, vec_in, block_out, vec_out, direction);
 }
 XDIAG_CATCH
 
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <string>
+
 #include <xdiag/armadillo.hpp>
 #include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/operators/monomial.hpp>
 #include <xdiag/operators/op.hpp>
 #include <xdiag/operators/opsum.hpp>
@@ -17,6 +20,21 @@ namespace xdiag {
 // arma::Mat (real or complex).
 // vec_out is zeroed before accumulation. block_in and block_out must be the
 // same Block type.
+//
+// For an OpSum, fused = true applies all terms in a single sweep over the
+// basis instead of one sweep per term, if block_in and block_out agree and the
+// block provides a fused kernel (currently Spinhalf). Otherwise the terms are
+// applied one by one.
+//
+// The direction selects how the kernels run in parallel: "push" (default)
+// iterates over block_in and scatters into vec_out using atomic updates,
+// "pull" iterates over block_out and gathers from vec_in without atomics.
+// "pull" requires ops to be Hermitian, which is not checked.
+//
+// A CompiledOpSum (see compiled_opsum) has been validated, normal ordered and
+// checked for hermiticity beforehand, such that these steps are not repeated
+// when applying the same operator many times. block_in has to agree with the
+// block the CompiledOpSum has been built for.
 
 // Comment: this is not templated over the vec/mat type, to make it
 // automatically accessible to the Julia wrapper generator
@@ -48,15 +66,34 @@ XDIAG_API void apply(Monomial const &op, Block const &block_in,
 
 XDIAG_API void apply(OpSum const &op, Block const &block_in,
                      arma::vec const &vec_in, Block const &block_out,
-                     arma::vec &vec_out);
+                     arma::vec &vec_out, bool fused = false,
+                     std::string const &direction = "push");
 XDIAG_API void apply(OpSum const &op, Block const &block_in,
                      arma::cx_vec const &vec_in, Block const &block_out,
-                     arma::cx_vec &vec_out);
+                     arma::cx_vec &vec_out, bool fused = false,
+                     std::string const &direction = "push");
 XDIAG_API void apply(OpSum const &op, Block const &block_in,
                      arma::mat const &vec_in, Block const &block_out,
-                     arma::mat &vec_out);
+                     arma::mat &vec_out, bool fused = false,
+                     std::string const &direction = "push");
 XDIAG_API void apply(OpSum const &op, Block const &block_in,
                      arma::cx_mat const &vec_in, Block const &block_out,
-                     arma::cx_mat &vec_out);
+                     arma::cx_mat &vec_out, bool fused = false,
+                     std::string const &direction = "push");
+
+XDIAG_API void apply(CompiledOpSum const &ops, Block const &block_in,
+                     arma::vec const &vec_in, Block const &block_out,
+                     arma::vec &vec_out, std::string const &direction = "push");
+XDIAG_API void apply(CompiledOpSum const &ops, Block const &block_in,
+                     arma::cx_vec const &vec_in, Block const &block_out,
+                     arma::cx_vec &vec_out,
+                     std::string const &direction = "push");
+XDIAG_API void apply(CompiledOpSum const &ops, Block const &block_in,
+                     arma::mat const &vec_in, Block const &block_out,
+                     arma::mat &vec_out, std::string const &direction = "push");
+XDIAG_API void apply(CompiledOpSum const &ops, Block const &block_in,
+                     arma::cx_mat const &vec_in, Block const &block_out,
+                     arma::cx_mat &vec_out,
+                     std::string const &direction = "push");
 
 } // namespace xdiag
@@ -18,7 +18,8 @@ namespace xdiag::kernels::boson {
 
 template <typename coeff_t, typename basis_t, typename fill_f>
 void matrix_generic(OpSum const &ops, basis_t const &basis_in,
-                    basis_t const &basis_out, fill_f fill) try {
+                    basis_t const &basis_out, fill_f fill,
+                    bool compiled = false) try {
 
   if (basis_in.d() != basis_out.d()) {
     XDIAG_THROW(
@@ -26,10 +27,15 @@ void matrix_generic(OpSum const &ops, basis_t const &basis_in,
                     basis_in.d(), basis_out.d()));
   }
 
-  // Get OpSum into format that can be processed
-  operators::check_valid(ops);
-  auto algebra = algebra::matrix_algebra(basis_in.nsites(), basis_in.d());
-  auto ops_compiled = normal_order(ops.plain(), algebra);
+  // Get OpSum into format that can be processed, unless this has already
+  // been done when building a CompiledOpSum
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::matrix_algebra(basis_in.nsites(), basis_in.d());
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
 
   for (auto const &[c, monomial] : ops_compiled) {
     assert(monomial.size() == 1); // required for properly compiled ops
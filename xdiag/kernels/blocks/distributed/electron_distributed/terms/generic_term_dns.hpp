@@ -35,9 +35,14 @@ void generic_term_dns(basis_t const &basis_in, basis_t const &basis_out,
   int64_t ndn_out = basis_out.ndn();
   int64_t ndn_configurations_out = math::binomial(nsites, ndn_out);
 
-  // Loop over all configurations
-  int64_t idx_up = 0;
-  for (bit_t up : basis_in.my_ups()) {
+  // Loop over all configurations. The term does not change the up spins,
+  // hence every up configuration writes to its own block of vec_out.
+  auto const &my_ups = basis_in.my_ups();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t idx_up = 0; idx_up < (int64_t)my_ups.size(); ++idx_up) {
+    bit_t up = my_ups[idx_up];
 
     if (non_zero_term_ups(up)) {
       int64_t up_offset_in = idx_up * ndn_configurations_in;
@@ -62,7 +67,6 @@ void generic_term_dns(basis_t const &basis_in, basis_t const &basis_out,
         ++idx_in;
       }
     } // non-zero-term ups
-    ++idx_up;
   }
 }
 
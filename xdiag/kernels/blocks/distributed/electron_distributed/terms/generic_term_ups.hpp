@@ -14,13 +14,17 @@
 
 namespace xdiag::basis::electron_distributed {
 
+// Applies a term acting on the up spins to a vector in dn/up order. If a range
+// [dn_begin, dn_end) of my dns is given, vec_in and vec_out only hold the
+// blocks of these dns.
 template <typename coeff_t, class basis_t, class non_zero_term_ups_f,
           class non_zero_term_dns_f, class term_action_f>
 void generic_term_ups(basis_t const &basis_in, basis_t const &basis_out,
                       non_zero_term_ups_f non_zero_term_ups,
                       non_zero_term_dns_f non_zero_term_dns,
                       term_action_f term_action, const coeff_t *vec_in,
-                      coeff_t *vec_out) {
+                      coeff_t *vec_out, int64_t dn_begin = 0,
+                      int64_t dn_end = -1) {
   using bit_t = typename basis_t::bit_t;
 
   int64_t nsites = basis_in.nsites();
@@ -35,13 +39,21 @@ void generic_term_ups(basis_t const &basis_in, basis_t const &basis_out,
   int64_t ndn_out = basis_out.ndn();
   int64_t nup_configurations_out = math::binomial(nsites, nup_out);
 
-  // Loop over all configurations
-  int64_t idx_dn = 0;
-  for (bit_t dn : basis_in.my_dns()) {
+  // Loop over all configurations. The term does not change the dn spins,
+  // hence every dn configuration writes to its own block of vec_out.
+  auto const &my_dns = basis_in.my_dns();
+  if (dn_end < 0) {
+    dn_end = my_dns.size();
+  }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t idx_dn = dn_begin; idx_dn < dn_end; ++idx_dn) {
+    bit_t dn = my_dns[idx_dn];
 
     if (non_zero_term_dns(dn)) {
-      int64_t dn_offset_in = idx_dn * nup_configurations_in;
-      int64_t dn_offset_out = idx_dn * nup_configurations_out;
+      int64_t dn_offset_in = (idx_dn - dn_begin) * nup_configurations_in;
+      int64_t dn_offset_out = (idx_dn - dn_begin) * nup_configurations_out;
 
       int64_t idx_in = dn_offset_in;
       for (bit_t up : basis_in.all_ups()) {
@@ -59,8 +71,6 @@ void generic_term_ups(basis_t const &basis_in, basis_t const &basis_out,
         ++idx_in;
       } // for (bit_t up : basis_in.all_ups())
     } // non-zero-term ups
-
-    ++idx_dn;
   } // for (bit_t dn : basis_in.my_dns())
 }
 
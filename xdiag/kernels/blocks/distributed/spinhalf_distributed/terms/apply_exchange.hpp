@@ -6,16 +6,19 @@
 
 #include <algorithm>
 #include <tuple>
+#include <vector>
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/bits/bitmask.hpp>
 #include <xdiag/bits/popcount.hpp>
 #include <xdiag/combinatorics/subsets/subsets.hpp>
-#include <xdiag/operators/coeff.hpp>
-#include <xdiag/operators/op.hpp>
+#include <xdiag/math/binomial.hpp>
 #include <xdiag/mpi/buffer.hpp>
 #include <xdiag/mpi/comm_pattern.hpp>
 #include <xdiag/mpi/communicator.hpp>
+#include <xdiag/mpi/for_each_ordered.hpp>
+#include <xdiag/operators/coeff.hpp>
+#include <xdiag/operators/op.hpp>
 
 namespace xdiag::basis::spinhalf_distributed {
 
@@ -45,11 +48,19 @@ void apply_exchange_postfix(Coeff const &cpl, Op const &op,
   coeff_t j_s1dn = Jhalf;
   coeff_t j_s1up = is_asym ? -Jhalf : Jhalf;
 
-  int64_t idx = 0;
-  for (bit_t prefix : basis.prefixes()) {
+  // The term does not change the prefix, hence every prefix block is
+  // processed independently by a thread
+  auto const &prefixes = basis.prefixes();
+  int64_t n_prefixes = prefixes.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = 0; i < n_prefixes; ++i) {
+    bit_t prefix = prefixes[i];
     auto const &lintable = basis.postfix_lintable(prefix);
     auto const &postfixes = basis.postfix_states(prefix);
     int64_t prefix_begin = basis.prefix_begin(prefix);
+    int64_t idx = prefix_begin;
     for (bit_t postfix : postfixes) {
 
       if (bits::popcount(postfix & mask) & 1) {
@@ -62,17 +73,15 @@ void apply_exchange_postfix(Coeff const &cpl, Op const &op,
   }
 }
 
-// apply_exchange_prefix works with the send/recv buffer as input/output vectors
+// apply_exchange_prefix acts on vectors in the transposed (postfix|prefix)
+// order. The postfixes basis.postfixes()[postfix_begin, postfix_end) are
+// processed, whose values are stored in vec_in/vec_out starting at index 0.
 template <class basis_t, typename coeff_t>
-void apply_exchange_prefix(Coeff const &cpl, Op const &op,
-                           basis_t const &basis) {
+void apply_exchange_prefix(Coeff const &cpl, Op const &op, basis_t const &basis,
+                           const coeff_t *vec_in, coeff_t *vec_out,
+                           int64_t postfix_begin, int64_t postfix_end) {
   using bit_t = typename basis_t::bit_t;
 
-  int64_t buffer_size = basis.size_max();
-  mpi::buffer.reserve<coeff_t>(buffer_size);
-  coeff_t *send_buffer = mpi::buffer.send<coeff_t>();
-  coeff_t *recv_buffer = mpi::buffer.recv<coeff_t>();
-
   coeff_t J = cpl.scalar().as<coeff_t>();
   coeff_t Jhalf = J / 2.0;
   bool is_asym = (op.type() == "ExchangeAsym");
@@ -92,95 +101,319 @@ void apply_exchange_prefix(Coeff const &cpl, Op const &op,
   coeff_t j_s1dn = Jhalf;
   coeff_t j_s1up = is_asym ? -Jhalf : Jhalf;
 
-  // loop through all postfixes
-  int64_t idx = 0;
-  for (bit_t postfix : basis.postfixes()) {
+  // loop through the postfixes, every postfix block is processed
+  // independently by a thread
+  auto const &postfixes = basis.postfixes();
+  if (postfix_begin >= postfix_end) {
+    return;
+  }
+  int64_t offset = basis.postfix_begin(postfixes[postfix_begin]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = postfix_begin; i < postfix_end; ++i) {
+    bit_t postfix = postfixes[i];
     auto const &lintable = basis.prefix_lintable(postfix);
     auto const &prefixes = basis.prefix_states(postfix);
-    int64_t postfix_begin = basis.postfix_begin(postfix);
+    int64_t begin = basis.postfix_begin(postfix) - offset;
+    int64_t idx = begin;
     for (bit_t prefix : prefixes) {
       if (bits::popcount(prefix & mask) & 1) {
         bit_t new_prefix = prefix ^ mask;
-        int64_t new_idx = postfix_begin + lintable.index(new_prefix);
-        recv_buffer[new_idx] +=
-            ((prefix & s1mask) ? j_s1up : j_s1dn) * send_buffer[idx];
+        int64_t new_idx = begin + lintable.index(new_prefix);
+        vec_out[new_idx] +=
+            ((prefix & s1mask) ? j_s1up : j_s1dn) * vec_in[idx];
       }
       ++idx;
     }
   }
 }
 
-template <class basis_t, typename coeff_t>
-void apply_exchange_mixed(Coeff const &cpl, Op const &op,
-                          basis_t const &basis,
-                          arma::Col<coeff_t> const &vec_in,
-                          arma::Col<coeff_t> &vec_out) {
+// Exchange term acting on a prefix and a postfix site. Flipping the prefix
+// site moves a state to the rank owning the flipped prefix. Hence, the values
+// of vec_in are packed into a send buffer, exchanged among the ranks, and the
+// received values are unpacked into vec_out. The values for every rank are
+// ordered by the prefixes of the sending rank.
+//
+// If round_size is positive, the exchange is split into rounds. In every
+// round, a rank sends the values of a contiguous range of its prefixes, at
+// most round_size values (or the values of a single prefix). The rounds are
+// determined identically on all ranks without communication.
+template <class basis_t, typename coeff_t> class ExchangeMixed {
+public:
   using bit_t = typename basis_t::bit_t;
-  int32_t mpi_rank, mpi_size;
-  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
 
-  coeff_t J = cpl.scalar().as<coeff_t>();
-  coeff_t Jhalf = J / 2.0;
-  bool is_asym = (op.type() == "ExchangeAsym");
-  int64_t s1 = op[0];
-  int64_t s2 = op[1];
-  assert((s1 >= 0) && (s2 >= 0));
+  ExchangeMixed(Coeff const &cpl, Op const &op, basis_t const &basis,
+                int64_t round_size = 0)
+      : basis_(basis) {
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size_);
+
+    coeff_t J = cpl.scalar().as<coeff_t>();
+    coeff_t Jhalf = J / 2.0;
+    bool is_asym = (op.type() == "ExchangeAsym");
+    int64_t s1 = op[0];
+    int64_t s2 = op[1];
+    assert((s1 >= 0) && (s2 >= 0));
+
+    int64_t n_postfix_bits = basis.n_postfix_bits();
+    int64_t ss1 = std::min(s1, s2);
+    int64_t ss2 = std::max(s1, s2);
+    prefix_mask_ = ((bit_t)1 << (ss2 - n_postfix_bits));
+    postfix_mask_ = ((bit_t)1 << ss1);
+
+    // Per-branch coupling, hoisted out of the fill loop. ExchangeAsym =
+    // 1/2(S+_{s1}S-_{s2} - S-_{s1}S+_{s2}) gives -Jhalf when the input s1 spin
+    // is up (matching term_exchange_asym); plain Exchange uses Jhalf
+    // throughout. s1 lives on the prefix iff it is the larger site (ss2); the
+    // two fill branches below fix the s1 spin from the prefix/postfix
+    // occupation.
+    coeff_t j_s1up = is_asym ? -Jhalf : Jhalf;
+    bool s1_on_prefix = (s1 > s2);
+    // "prefix up, postfix dn" branch: s1 is up iff s1 sits on the prefix.
+    coeff_prefix_up_ = s1_on_prefix ? j_s1up : Jhalf;
+    // "prefix dn, postfix up" branch: s1 is up iff s1 sits on the postfix.
+    coeff_prefix_dn_ = s1_on_prefix ? Jhalf : j_s1up;
+
+    // Check whether communication pattern has already been determined
+    if (basis.comm_pattern().contains(op)) {
+      comm_ = basis.comm_pattern()[op];
+    }
+    // if not, compute it anew
+    else {
+      std::vector<int64_t> n_states_i_send(mpi_size_, 0);
+      for (bit_t prefix : basis.prefixes()) {
+        n_states_i_send[basis.rank(prefix ^ prefix_mask_)] +=
+            n_values_sent(prefix);
+      }
+      comm_ = mpi::Communicator(n_states_i_send);
+      basis.comm_pattern().append(op, comm_);
+    }
 
-  int64_t nup = basis.nup();
-  int64_t n_prefix_bits = basis.n_prefix_bits();
-  int64_t n_postfix_bits = basis.n_postfix_bits();
-  int64_t ss1 = std::min(s1, s2);
-  int64_t ss2 = std::max(s1, s2);
-  bit_t prefix_mask = ((bit_t)1 << (ss2 - n_postfix_bits));
-  bit_t postfix_mask = ((bit_t)1 << ss1);
-
-  // Per-branch coupling, hoisted out of the fill loop. ExchangeAsym =
-  // 1/2(S+_{s1}S-_{s2} - S-_{s1}S+_{s2}) gives -Jhalf when the input s1 spin is
-  // up (matching term_exchange_asym); plain Exchange uses Jhalf throughout.
-  // s1 lives on the prefix iff it is the larger site (ss2); the two fill
-  // branches below fix the s1 spin from the prefix/postfix occupation.
-  coeff_t j_s1up = is_asym ? -Jhalf : Jhalf;
-  bool s1_on_prefix = (s1 > s2);
-  // "prefix up, postfix dn" branch: s1 is up iff s1 sits on the prefix.
-  coeff_t coeff_prefix_up = s1_on_prefix ? j_s1up : Jhalf;
-  // "prefix dn, postfix up" branch: s1 is up iff s1 sits on the postfix.
-  coeff_t coeff_prefix_dn = s1_on_prefix ? Jhalf : j_s1up;
+    if (round_size > 0) {
+      split(op, round_size);
+    } else {
+      send_begin_ = {0, (int64_t)basis.prefixes().size()};
+      prefixes_recv_ = prefixes_received();
+      recv_begin_ = {0, (int64_t)prefixes_recv_.size()};
+      comms_ = {comm_};
+    }
+  }
 
-  mpi::Communicator comm;
+  mpi::Communicator const &communicator() const { return comm_; }
 
-  // Check whether communication pattern has already been determined
-  if (basis.comm_pattern().contains(op)) {
-    comm = basis.comm_pattern()[op];
+  int64_t n_rounds() const { return comms_.size(); }
+  mpi::Communicator const &communicator(int64_t round) const {
+    return comms_[round];
   }
-  // if not, compute it anew
-  else {
-    std::vector<int64_t> n_states_i_send(mpi_size, 0);
 
-    for (bit_t prefix : basis.prefixes()) {
+  // Fills my states of a round into the send buffer, the values for rank r
+  // start at send_offsets[r]. Every prefix sends to a single rank, the
+  // prefixes are distributed among the threads.
+  void pack(arma::Col<coeff_t> const &vec_in, coeff_t *send_buffer,
+            std::vector<int64_t> const &send_offsets,
+            int64_t round = 0) const {
+    auto const &prefixes = basis_.prefixes();
+    int64_t begin = send_begin_[round];
+    mpi::for_each_ordered(
+        send_begin_[round + 1] - begin, send_offsets,
+        [&](int64_t i, int64_t *counts) {
+          bit_t prefix = prefixes[begin + i];
+          counts[basis_.rank(prefix ^ prefix_mask_)] += n_values_sent(prefix);
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t prefix = prefixes[begin + i];
+          int64_t &p = pos[basis_.rank(prefix ^ prefix_mask_)];
+          bool postfix_up = !(prefix & prefix_mask_);
+          int64_t idx = basis_.prefix_begin(prefix);
+          for (bit_t postfix : basis_.postfix_states(prefix)) {
+            if ((bool)(postfix & postfix_mask_) == postfix_up) {
+              send_buffer[p++] = vec_in(idx);
+            }
+            ++idx;
+          }
+        });
+  }
 
-      bit_t prefix_flipped = prefix ^ prefix_mask;
-      int32_t target_rank = basis.rank(prefix_flipped);
+  // Adds the received states of a round to vec_out, the values from rank r
+  // start at recv_offsets[r]. The flipped prefixes are distinct such that the
+  // prefixes can be processed by different threads.
+  void unpack(const coeff_t *recv_buffer,
+              std::vector<int64_t> const &recv_offsets,
+              arma::Col<coeff_t> &vec_out, int64_t round = 0) const {
+    int64_t begin = recv_begin_[round];
+    mpi::for_each_ordered(
+        recv_begin_[round + 1] - begin, recv_offsets,
+        [&](int64_t i, int64_t *counts) {
+          bit_t prefix = prefixes_recv_[begin + i];
+          counts[basis_.rank(prefix)] += n_values_sent(prefix);
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t prefix = prefixes_recv_[begin + i];
+          bit_t prefix_flipped = prefix ^ prefix_mask_;
+          int64_t &p = pos[basis_.rank(prefix)];
+          auto const &postfix_flipped_lintable =
+              basis_.postfix_lintable(prefix_flipped);
+          int64_t prefix_flipped_offset = basis_.prefix_begin(prefix_flipped);
+
+          // prefix up, postfix must be dn and vice versa
+          bool prefix_up = (prefix & prefix_mask_);
+          coeff_t coeff = prefix_up ? coeff_prefix_up_ : coeff_prefix_dn_;
+          for (bit_t postfix : basis_.postfix_states(prefix)) {
+            if ((bool)(postfix & postfix_mask_) != prefix_up) {
+              bit_t postfix_flipped = postfix ^ postfix_mask_;
+              int64_t idx_target =
+                  prefix_flipped_offset +
+                  postfix_flipped_lintable.index(postfix_flipped);
+              vec_out(idx_target) += coeff * recv_buffer[p++];
+            }
+          }
+        });
+  }
 
-      auto const &postfixes = basis.postfix_states(prefix);
+private:
+  basis_t const &basis_;
+  int mpi_rank_;
+  int mpi_size_;
+  bit_t prefix_mask_;
+  bit_t postfix_mask_;
+  coeff_t coeff_prefix_up_;
+  coeff_t coeff_prefix_dn_;
+  mpi::Communicator comm_;
+
+  // Rounds: my prefixes [send_begin_[k], send_begin_[k+1]) are sent and the
+  // prefixes prefixes_recv_[recv_begin_[k], recv_begin_[k+1]) are received
+  // in round k
+  std::vector<int64_t> send_begin_;
+  std::vector<bit_t> prefixes_recv_;
+  std::vector<int64_t> recv_begin_;
+  std::vector<mpi::Communicator> comms_;
+
+  // Number of values a prefix sends: prefix up, postfix must be dn and vice
+  // versa
+  int64_t n_values_sent(bit_t prefix) const {
+    int64_t n_postfix_bits = basis_.n_postfix_bits();
+    int64_t nup_postfix = basis_.nup() - bits::popcount(prefix);
+    if ((nup_postfix < 0) || (nup_postfix > n_postfix_bits)) {
+      return 0;
+    }
+    bool postfix_up = !(prefix & prefix_mask_);
+    return postfix_up ? math::binomial(n_postfix_bits - 1, nup_postfix - 1)
+                      : math::binomial(n_postfix_bits - 1, nup_postfix);
+  }
 
-      // prefix up, postfix must be dn
-      if (prefix & prefix_mask) {
-        for (bit_t postfix : postfixes) {
-          n_states_i_send[target_rank] += !(bool)(postfix & postfix_mask);
-        }
+  // Assigns the prefixes of every rank to rounds, walking through all
+  // prefixes in ascending order, as every rank stores its prefixes. The
+  // communication patterns of the rounds are kept by the basis.
+  void split(Op const &op, int64_t round_size) {
+    int64_t nup = basis_.nup();
+    int64_t n_prefix_bits = basis_.n_prefix_bits();
+    int64_t n_postfix_bits = basis_.n_postfix_bits();
+    std::vector<int64_t> round(mpi_size_, 0);
+    std::vector<int64_t> filled(mpi_size_, 0);
+    std::vector<int64_t> send_rounds; // round of every prefix of mine
+    std::vector<std::pair<int64_t, bit_t>> recv_rounds;
+    for (bit_t prefix : combinatorics::Subsets<bit_t>(n_prefix_bits)) {
+      int64_t nup_postfix = nup - bits::popcount(prefix);
+      if ((nup_postfix < 0) || (nup_postfix > n_postfix_bits)) {
+        continue;
+      }
+      int rank = basis_.rank(prefix);
+      int64_t n = n_values_sent(prefix);
+      if ((filled[rank] > 0) && (filled[rank] + n > round_size)) {
+        ++round[rank];
+        filled[rank] = 0;
+      }
+      filled[rank] += n;
+      if (rank == mpi_rank_) {
+        send_rounds.push_back(round[rank]);
       }
 
-      // prefix dn, postfix must be dn
-      if (!(prefix & prefix_mask)) {
-        for (auto postfix : postfixes) {
-          n_states_i_send[target_rank] += (bool)(postfix & postfix_mask);
-        }
+      bit_t prefix_flipped = prefix ^ prefix_mask_;
+      int64_t nup_postfix_flipped = nup - bits::popcount(prefix_flipped);
+      if ((nup_postfix_flipped >= 0) &&
+          (nup_postfix_flipped <= n_postfix_bits) &&
+          (basis_.rank(prefix_flipped) == mpi_rank_)) {
+        recv_rounds.push_back({round[rank], prefix});
       }
     }
-    comm = mpi::Communicator(n_states_i_send);
-    basis.comm_pattern().append(op, comm);
+    int64_t n_rounds = *std::max_element(round.begin(), round.end()) + 1;
+
+    // prefixes received in round k are ordered ascending
+    std::stable_sort(
+        recv_rounds.begin(), recv_rounds.end(),
+        [](auto const &a, auto const &b) { return a.first < b.first; });
+    send_begin_.assign(n_rounds + 1, 0);
+    recv_begin_.assign(n_rounds + 1, 0);
+    for (int64_t k : send_rounds) {
+      ++send_begin_[k + 1];
+    }
+    for (auto const &[k, prefix] : recv_rounds) {
+      ++recv_begin_[k + 1];
+      prefixes_recv_.push_back(prefix);
+    }
+    for (int64_t k = 0; k < n_rounds; ++k) {
+      send_begin_[k + 1] += send_begin_[k];
+      recv_begin_[k + 1] += recv_begin_[k];
+    }
+
+    if (basis_.comm_pattern().contains(op, round_size)) {
+      comms_ = basis_.comm_pattern().rounds(op, round_size);
+      return;
+    }
+    auto const &prefixes = basis_.prefixes();
+    for (int64_t k = 0; k < n_rounds; ++k) {
+      std::vector<int64_t> n_states_i_send(mpi_size_, 0);
+      for (int64_t i = send_begin_[k]; i < send_begin_[k + 1]; ++i) {
+        bit_t prefix = prefixes[i];
+        n_states_i_send[basis_.rank(prefix ^ prefix_mask_)] +=
+            n_values_sent(prefix);
+      }
+      comms_.push_back(mpi::Communicator(n_states_i_send));
+    }
+    basis_.comm_pattern().append(op, round_size, comms_);
+  }
+
+  // Prefixes (of all ranks) whose flipped prefix belongs to this rank
+  std::vector<bit_t> prefixes_received() const {
+    int64_t nup = basis_.nup();
+    int64_t n_prefix_bits = basis_.n_prefix_bits();
+    int64_t n_postfix_bits = basis_.n_postfix_bits();
+    std::vector<bit_t> prefixes_recv;
+    for (bit_t prefix : combinatorics::Subsets<bit_t>(n_prefix_bits)) {
+
+      // Only consider prefix if both itself and flipped version are valid
+      int64_t nup_prefix = bits::popcount(prefix);
+      int64_t nup_postfix = nup - nup_prefix;
+      if ((nup_postfix < 0) || (nup_postfix > n_postfix_bits)) {
+        continue;
+      }
+
+      bit_t prefix_flipped = prefix ^ prefix_mask_;
+      int64_t nup_prefix_flipped = bits::popcount(prefix_flipped);
+      int64_t nup_postfix_flipped = nup - nup_prefix_flipped;
+      if ((nup_postfix_flipped < 0) ||
+          (nup_postfix_flipped > n_postfix_bits))
+        continue;
+
+      // Only consider prefix if it got sent to this mpi_rank
+      if (basis_.rank(prefix_flipped) == mpi_rank_) {
+        prefixes_recv.push_back(prefix);
+      }
+    }
+    return prefixes_recv;
   }
+};
+
+template <class basis_t, typename coeff_t>
+void apply_exchange_mixed(Coeff const &cpl, Op const &op,
+                          basis_t const &basis,
+                          arma::Col<coeff_t> const &vec_in,
+                          arma::Col<coeff_t> &vec_out) {
+  ExchangeMixed<basis_t, coeff_t> term(cpl, op, basis);
+  auto const &comm = term.communicator();
+  int mpi_size;
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
 
   // prepare send/recv buffers
   int64_t max_send_size = comm.send_buffer_size();
@@ -191,96 +424,15 @@ void apply_exchange_mixed(Coeff const &cpl, Op const &op,
   mpi::buffer.clean_send();
   mpi::buffer.clean_recv();
 
-  // Loop through all my states and fill them in send buffer
-  int64_t idx = 0;
-  for (auto prefix : basis.prefixes()) {
-    bit_t prefix_flipped = prefix ^ prefix_mask;
-    int32_t target_rank = basis.rank(prefix_flipped);
-    auto const &postfixes = basis.postfix_states(prefix);
-
-    // prefix up, postfix must be dn
-    if (prefix & prefix_mask) {
-      for (auto postfix : postfixes) {
-        if (!(postfix & postfix_mask)) {
-          comm.add_to_send_buffer(target_rank, vec_in(idx), send_buffer);
-        }
-        ++idx;
-      }
-    }
-    // prefix dn, postfix must be up
-    else {
-      for (auto postfix : postfixes) {
-        if (postfix & postfix_mask) {
-          comm.add_to_send_buffer(target_rank, vec_in(idx), send_buffer);
-        }
-        ++idx;
-      }
-    }
+  std::vector<int64_t> send_offsets(mpi_size);
+  std::vector<int64_t> recv_offsets(mpi_size);
+  for (int r = 0; r < mpi_size; ++r) {
+    send_offsets[r] = comm.n_values_i_send_offset(r);
+    recv_offsets[r] = comm.n_values_i_recv_offset(r);
   }
-
-  // Communicate
+  term.pack(vec_in, send_buffer, send_offsets);
   comm.all_to_all(send_buffer, recv_buffer);
-
-  // Fill received states into vec_out (gnarlyy!!!)
-  // auto recv_offsets = comm.n_values_i_recv_offsets();
-  std::vector<int64_t> offsets(mpi_size, 0);
-  for (bit_t prefix : combinatorics::Subsets<bit_t>(n_prefix_bits)) {
-
-    // Only consider prefix if both itself and flipped version are valid
-    int64_t nup_prefix = bits::popcount(prefix);
-    int64_t nup_postfix = nup - nup_prefix;
-    if ((nup_postfix < 0) || (nup_postfix > n_postfix_bits)) {
-      continue;
-    }
-
-    bit_t prefix_flipped = prefix ^ prefix_mask;
-    int64_t nup_prefix_flipped = bits::popcount(prefix_flipped);
-    int64_t nup_postfix_flipped = nup - nup_prefix_flipped;
-    if ((nup_postfix_flipped < 0) || (nup_postfix_flipped > n_postfix_bits))
-      continue;
-
-    // Only consider prefix if it got sent to this mpi_rank
-    int target_rank = basis.rank(prefix_flipped);
-    if (target_rank != mpi_rank)
-      continue;
-
-    int32_t origin_rank = basis.rank(prefix);
-    int64_t origin_offset = comm.n_values_i_recv_offset(origin_rank);
-
-    auto const &postfixes = basis.postfix_states(prefix);
-    auto const &postfix_flipped_lintable =
-        basis.postfix_lintable(prefix_flipped);
-    int64_t prefix_flipped_offset = basis.prefix_begin(prefix_flipped);
-
-    // prefix up, postfix must be dn
-    if (prefix & prefix_mask) {
-      for (auto postfix : postfixes) {
-        if (!(postfix & postfix_mask)) {
-          bit_t postfix_flipped = postfix ^ postfix_mask;
-          int64_t idx_received = origin_offset + offsets[origin_rank];
-          int64_t int64_target =
-              prefix_flipped_offset +
-              postfix_flipped_lintable.index(postfix_flipped);
-          vec_out(int64_target) += coeff_prefix_up * recv_buffer[idx_received];
-          ++offsets[origin_rank];
-        }
-      }
-    }
-    // prefix dn, postfix must be up
-    else {
-      for (auto postfix : postfixes) {
-        if (postfix & postfix_mask) {
-          bit_t postfix_flipped = postfix ^ postfix_mask;
-          int64_t idx_received = origin_offset + offsets[origin_rank];
-          int64_t int64_target =
-              prefix_flipped_offset +
-              postfix_flipped_lintable.index(postfix_flipped);
-          vec_out(int64_target) += coeff_prefix_dn * recv_buffer[idx_received];
-          ++offsets[origin_rank];
-        }
-      }
-    }
-  } // for (bit_t prefix : Subsets<bit_t>(n_prefix_bits))
+  term.unpack(recv_buffer, recv_offsets, vec_out);
 }
 
 } // namespace xdiag::basis::spinhalf_distributed
@@ -26,9 +26,16 @@ void apply_spsm_postfix(Coeff const &cpl, Op const &op,
   bit_t mask = ((bit_t)1 << s);
 
   int64_t n_postfix_bits = basis_in.n_postfix_bits();
-  int64_t idx = 0;
-  for (auto prefix : basis_in.prefixes()) {
+  // every prefix block is processed independently by a thread
+  auto const &prefixes = basis_in.prefixes();
+  int64_t n_prefixes = prefixes.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = 0; i < n_prefixes; ++i) {
+    bit_t prefix = prefixes[i];
     auto const &postfixes = basis_in.postfix_states(prefix);
+    int64_t idx = basis_in.prefix_begin(prefix);
     auto const &lintable = basis_out.postfix_lintable(prefix);
     int64_t idx_prefix = basis_out.prefix_begin(prefix);
 
@@ -52,8 +59,6 @@ void apply_spsm_postfix(Coeff const &cpl, Op const &op,
           ++idx;
         }
       }
-    } else {
-      idx += postfixes.size();
     }
   }
 }
@@ -76,9 +81,16 @@ void apply_spsm_prefix(Coeff const &cpl, Op const &op,
   coeff_t *send_buffer = mpi::buffer.send<coeff_t>();
   coeff_t *recv_buffer = mpi::buffer.recv<coeff_t>();
 
-  // loop through all postfixes
-  int64_t idx = 0;
-  for (auto postfix : basis_in.postfixes()) {
+  // loop through all postfixes, every postfix block is processed
+  // independently by a thread
+  auto const &postfixes = basis_in.postfixes();
+  int64_t n_postfixes = postfixes.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = 0; i < n_postfixes; ++i) {
+    bit_t postfix = postfixes[i];
+    int64_t idx = basis_in.postfix_begin(postfix);
 
     auto const &prefixes = basis_in.prefix_states(postfix);
     auto const &lintable = basis_out.prefix_lintable(postfix);
@@ -105,8 +117,6 @@ void apply_spsm_prefix(Coeff const &cpl, Op const &op,
           ++idx;
         }
       }
-    } else {
-      idx += prefixes.size();
     }
   }
 }
@@ -28,9 +28,15 @@ void apply_sz(Coeff const &cpl, Op const &op, basis_t const &basis,
   coeff_t val_dn = -H / 2.;
   int n_postfix_bits = basis.n_postfix_bits();
 
-  int64_t idx = 0;
-  for (auto prefix : basis.prefixes()) {
-    auto postfixes = basis.postfix_states(prefix);
+  auto const &prefixes = basis.prefixes();
+  int64_t n_prefixes = prefixes.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = 0; i < n_prefixes; ++i) {
+    bit_t prefix = prefixes[i];
+    auto const &postfixes = basis.postfix_states(prefix);
+    int64_t idx = basis.prefix_begin(prefix);
 
     // site in postfixes
     if (s < n_postfix_bits) {
@@ -51,7 +57,7 @@ void apply_sz(Coeff const &cpl, Op const &op, basis_t const &basis,
         vec_out(idx) += val * vec_in(idx);
       }
     }
-  } // for (auto prefix : basis.prefixes())
+  } // for (int64_t i = 0; i < n_prefixes; ++i)
 }
 
 } // namespace xdiag::basis::spinhalf_distributed
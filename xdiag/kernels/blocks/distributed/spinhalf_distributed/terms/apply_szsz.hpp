@@ -31,6 +31,9 @@ void apply_szsz(Coeff const &cpl, Op const &op, basis_t const &basis,
   // no up/dn dependence. The general code below uses a single-bit mask when
   // s1==s2 and would wrongly assign val_diff to up spins, so handle it here.
   if (ss1 == ss2) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
     for (int64_t idx = 0; idx < (int64_t)vec_in.size(); ++idx) {
       vec_out(idx) += val_same * vec_in(idx);
     }
@@ -45,10 +48,16 @@ void apply_szsz(Coeff const &cpl, Op const &op, basis_t const &basis,
   bit_t s1mask = (bit_t)1 << s1;
   bit_t s2mask = (bit_t)1 << (s2 - n_postfix_bits);
 
-  int64_t idx = 0;
-  for (bit_t prefix : basis.prefixes()) {
+  auto const &prefixes = basis.prefixes();
+  int64_t n_prefixes = prefixes.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t i = 0; i < n_prefixes; ++i) {
+    bit_t prefix = prefixes[i];
     bit_t prefix_shifted = (prefix << n_postfix_bits);
     auto const &postfixes = basis.postfix_states(prefix);
+    int64_t idx = basis.prefix_begin(prefix);
 
     // Both sites are on prefixes
     if ((s1 >= n_postfix_bits) && (s2 >= n_postfix_bits)) {
@@ -101,6 +110,6 @@ void apply_szsz(Coeff const &cpl, Op const &op, basis_t const &basis,
       }
     }
   }
-} 
+}
 
 } // namespace xdiag::basis::spinhalf_distributed
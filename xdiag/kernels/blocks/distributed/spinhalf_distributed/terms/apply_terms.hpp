@@ -15,6 +15,7 @@
 #include <xdiag/algebra/algebra.hpp>
 #include <xdiag/algebra/normal_order.hpp>
 #include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/timing_mpi.hpp>
 #include <xdiag/operators/coeff.hpp>
 #include <xdiag/operators/op.hpp>
 #include <xdiag/operators/opsum.hpp>
@@ -25,6 +26,8 @@
 #include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/apply_spsm.hpp>
 #include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/apply_sz.hpp>
 #include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/apply_szsz.hpp>
+#include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/mixed_pipeline.hpp>
+#include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/prefix_rounds.hpp>
 #include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/transpose.hpp>
 
 namespace xdiag::basis::spinhalf_distributed {
@@ -35,6 +38,11 @@ namespace xdiag::basis::spinhalf_distributed {
 // ops are classified by whether they act purely on the postfix bits (local),
 // purely on the prefix bits (needs a transpose), or are mixed (needs a custom
 // all-to-all). Anything beyond single-operator terms throws "not implemented".
+// The all-to-alls of the mixed terms are started first and overlap with the
+// application of the local terms (cf. MixedPipeline). If
+// mpi::exchange_settings.round_size is positive, the exchanges of the mixed
+// terms and the transposes of the number conserving prefix terms are
+// performed in rounds of bounded size (cf. apply_prefix_rounds).
 template <typename coeff_t, class basis_t>
 void apply_terms(OpSum const &ops, basis_t const &basis_in,
                  arma::Col<coeff_t> const &vec_in, basis_t const &basis_out,
@@ -90,7 +98,24 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     }
   }
 
+  // Mixed operators (custom all-to-all), started before the local work
+  int64_t round_size = mpi::exchange_settings.round_size;
+  std::vector<ExchangeMixed<basis_t, coeff_t>> mixed_terms;
+  for (auto const &[c, op] : mixed) {
+    std::string type = op.type();
+    if ((type == "Exchange") || (type == "ExchangeAsym")) {
+      mixed_terms.emplace_back(c, op, basis_in, round_size);
+    } else {
+      XDIAG_THROW(fmt::format("Unsupported mixed Op type for "
+                              "SpinhalfDistributed block: \"{}\"",
+                              type));
+    }
+  }
+  MixedPipeline<basis_t, coeff_t> pipeline(mixed_terms, vec_in);
+  pipeline.start();
+
   // Diagonal operators (purely local)
+  double t0 = rightnow_mpi();
   for (auto const &[c, op] : diagonal) {
     std::string type = op.type();
     if (type == "SzSz") {
@@ -98,16 +123,23 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     } else if (type == "Sz") {
       apply_sz(c, op, basis_in, vec_in, vec_out);
     } else if (type == "Exchange") { // same-site Exchange_{s,s} = (J/2) I
-      coeff_t jhalf = c.scalar().as<coeff_t>() / 2.0;
+      coeff_t jhalf = c.scalar().template as<coeff_t>() / 2.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
       for (int64_t idx = 0; idx < (int64_t)vec_in.size(); ++idx) {
         vec_out(idx) += jhalf * vec_in(idx);
       }
     } else { // Id
-      coeff_t cc = c.scalar().as<coeff_t>();
+      coeff_t cc = c.scalar().template as<coeff_t>();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
       for (int64_t idx = 0; idx < (int64_t)vec_in.size(); ++idx) {
         vec_out(idx) += cc * vec_in(idx);
       }
     }
+    pipeline.progress();
   }
 
   // Postfix operators (local, off-diagonal)
@@ -118,11 +150,24 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     } else { // S+ / S-
       apply_spsm_postfix(c, op, basis_in, vec_in, basis_out, vec_out);
     }
+    pipeline.progress();
   }
+  double t1 = rightnow_mpi();
+  add_phase_time_mpi("local", t1 - t0);
 
   // Prefix operators: transpose to postfix|prefix order, act in the buffers,
-  // transpose back, then accumulate into vec_out.
-  if (!prefix.empty()) {
+  // transpose back, then accumulate into vec_out. S+ / S- change the number
+  // of up spins and always transpose the whole vector.
+  bool prefix_in_rounds =
+      (round_size > 0) &&
+      std::all_of(prefix.begin(), prefix.end(), [](auto const &term) {
+        return (term.second.type() == "Exchange") ||
+               (term.second.type() == "ExchangeAsym");
+      });
+  if (!prefix.empty() && prefix_in_rounds) {
+    apply_prefix_rounds(prefix, basis_in, vec_in, vec_out, round_size,
+                        [&]() { pipeline.progress(); });
+  } else if (!prefix.empty()) {
     int64_t buffer_size = std::max(basis_out.size_max(), basis_in.size_max());
     mpi::buffer.reserve<coeff_t>(buffer_size);
     coeff_t *send_buffer = mpi::buffer.send<coeff_t>();
@@ -131,28 +176,26 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     for (auto const &[c, op] : prefix) {
       std::string type = op.type();
       if ((type == "Exchange") || (type == "ExchangeAsym")) {
-        apply_exchange_prefix<basis_t, coeff_t>(c, op, basis_in);
+        apply_exchange_prefix<basis_t, coeff_t>(
+            c, op, basis_in, send_buffer, mpi::buffer.recv<coeff_t>(), 0,
+            basis_in.postfixes().size());
       } else { // S+ / S-
         apply_spsm_prefix<basis_t, coeff_t>(c, op, basis_in, basis_out);
       }
+      pipeline.progress();
     }
     transpose(basis_out, mpi::buffer.recv<coeff_t>(), true);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
     for (int64_t idx = 0; idx < (int64_t)vec_out.size(); ++idx) {
       vec_out(idx) += send_buffer[idx];
     }
   }
+  add_phase_time_mpi("prefix", rightnow_mpi() - t1);
 
-  // Mixed operators (custom all-to-all)
-  for (auto const &[c, op] : mixed) {
-    std::string type = op.type();
-    if ((type == "Exchange") || (type == "ExchangeAsym")) {
-      apply_exchange_mixed(c, op, basis_in, vec_in, vec_out);
-    } else {
-      XDIAG_THROW(fmt::format("Unsupported mixed Op type for "
-                              "SpinhalfDistributed block: \"{}\"",
-                              type));
-    }
-  }
+  // Mixed operators: wait for the exchanges and add the received values
+  pipeline.finish(vec_out);
 }
 XDIAG_CATCH
 
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifdef XDIAG_DISTRIBUTED
+
+#include <algorithm>
+#include <vector>
+
+#include <mpi.h>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/apply_exchange.hpp>
+#include <xdiag/mpi/communicator.hpp>
+#include <xdiag/mpi/exchange.hpp>
+#include <xdiag/mpi/timing_mpi.hpp>
+
+namespace xdiag::basis::spinhalf_distributed {
+
+// Applies the mixed prefix/postfix terms with pipelined, non-blocking
+// communication. The terms, or the rounds of the terms if their exchanges are
+// split into rounds, are grouped into batches of
+// mpi::exchange_settings.terms_per_exchange, whose values are sent in a
+// single all-to-all. start() packs and starts the first
+// exchanges_in_flight exchanges, such that they proceed while the local terms
+// are applied (calling progress() in between). finish() waits for the
+// exchanges in order, unpacks them into vec_out, and packs and starts the next
+// batch into the buffers just released while the later batches are in flight.
+template <class basis_t, typename coeff_t> class MixedPipeline {
+public:
+  MixedPipeline(std::vector<ExchangeMixed<basis_t, coeff_t>> const &terms,
+                arma::Col<coeff_t> const &vec_in)
+      : terms_(terms), vec_in_(vec_in), nstarted_(0) {
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size_);
+    for (int64_t t = 0; t < (int64_t)terms.size(); ++t) {
+      for (int64_t round = 0; round < terms[t].n_rounds(); ++round) {
+        parts_.push_back({t, round});
+      }
+    }
+    int64_t nparts = parts_.size();
+    int64_t batch_size =
+        std::max((int64_t)1, mpi::exchange_settings.terms_per_exchange);
+    for (int64_t begin = 0; begin < nparts; begin += batch_size) {
+      int64_t end = std::min(nparts, begin + batch_size);
+      std::vector<mpi::Communicator> comms;
+      for (int64_t p = begin; p < end; ++p) {
+        comms.push_back(communicator(parts_[p]));
+      }
+      batches_.push_back({begin, end, mpi::Communicator(comms)});
+    }
+    int64_t nslots =
+        std::max((int64_t)1, mpi::exchange_settings.exchanges_in_flight);
+    nslots = std::min(nslots, (int64_t)batches_.size());
+    exchanges_.resize(nslots);
+    if ((int64_t)mpi::exchange_buffers.size() < nslots) {
+      mpi::exchange_buffers.resize(nslots);
+    }
+  }
+
+  void start() {
+    while (nstarted_ < (int64_t)exchanges_.size()) {
+      start_next();
+    }
+  }
+
+  void progress() {
+    for (auto &exchange : exchanges_) {
+      exchange.test();
+    }
+  }
+
+  void finish(arma::Col<coeff_t> &vec_out) {
+    start();
+    int64_t nslots = exchanges_.size();
+    std::vector<int64_t> offsets(mpi_size_);
+    for (int64_t k = 0; k < (int64_t)batches_.size(); ++k) {
+      auto const &batch = batches_[k];
+      int64_t slot = k % nslots;
+
+      double t0 = rightnow_mpi();
+      exchanges_[slot].wait();
+      double t1 = rightnow_mpi();
+      add_phase_time_mpi("mixed wait", t1 - t0);
+
+      coeff_t *recv_buffer = mpi::exchange_buffers[slot].recv<coeff_t>();
+      for (int r = 0; r < mpi_size_; ++r) {
+        offsets[r] = batch.comm.n_values_i_recv_offset(r);
+      }
+      for (int64_t p = batch.begin; p < batch.end; ++p) {
+        auto const &part = parts_[p];
+        terms_[part.term].unpack(recv_buffer, offsets, vec_out, part.round);
+        auto const &comm = communicator(part);
+        for (int r = 0; r < mpi_size_; ++r) {
+          offsets[r] += comm.n_values_i_recv(r);
+        }
+      }
+      add_phase_time_mpi("mixed unpack", rightnow_mpi() - t1);
+
+      if (nstarted_ < (int64_t)batches_.size()) {
+        start_next();
+      }
+    }
+  }
+
+private:
+  struct Part {
+    int64_t term;
+    int64_t round;
+  };
+  struct Batch {
+    int64_t begin;
+    int64_t end;
+    mpi::Communicator comm;
+  };
+
+  std::vector<ExchangeMixed<basis_t, coeff_t>> const &terms_;
+  arma::Col<coeff_t> const &vec_in_;
+  int mpi_size_;
+  std::vector<Part> parts_;
+  std::vector<Batch> batches_;
+  std::vector<mpi::Exchange> exchanges_;
+  int64_t nstarted_;
+
+  // Packs the next batch into the buffers of its slot and starts the exchange
+  void start_next() {
+    auto const &batch = batches_[nstarted_];
+    int64_t slot = nstarted_ % exchanges_.size();
+    ++nstarted_;
+
+    double t0 = rightnow_mpi();
+    auto &buffer = mpi::exchange_buffers[slot];
+    buffer.reserve<coeff_t>(batch.comm.send_buffer_size(),
+                            batch.comm.recv_buffer_size());
+    coeff_t *send_buffer = buffer.send<coeff_t>();
+    std::vector<int64_t> offsets(mpi_size_);
+    for (int r = 0; r < mpi_size_; ++r) {
+      offsets[r] = batch.comm.n_values_i_send_offset(r);
+    }
+    for (int64_t p = batch.begin; p < batch.end; ++p) {
+      auto const &part = parts_[p];
+      terms_[part.term].pack(vec_in_, send_buffer, offsets, part.round);
+      auto const &comm = communicator(part);
+      for (int r = 0; r < mpi_size_; ++r) {
+        offsets[r] += comm.n_values_i_send(r);
+      }
+    }
+    add_phase_time_mpi("mixed pack", rightnow_mpi() - t0);
+    exchanges_[slot].start(batch.comm, send_buffer, buffer.recv<coeff_t>());
+  }
+
+  mpi::Communicator const &communicator(Part const &part) const {
+    return terms_[part.term].communicator(part.round);
+  }
+};
+
+} // namespace xdiag::basis::spinhalf_distributed
+#endif
@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifdef XDIAG_DISTRIBUTED
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/bits/bitmask.hpp>
+#include <xdiag/bits/popcount.hpp>
+#include <xdiag/combinatorics/subsets/subsets.hpp>
+#include <xdiag/kernels/blocks/distributed/spinhalf_distributed/terms/apply_exchange.hpp>
+#include <xdiag/math/binomial.hpp>
+#include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/communicator.hpp>
+#include <xdiag/mpi/for_each_ordered.hpp>
+#include <xdiag/operators/coeff.hpp>
+#include <xdiag/operators/op.hpp>
+
+namespace xdiag::basis::spinhalf_distributed {
+
+// Partition of the transposed (postfix|prefix) vector into rounds. In every
+// round, a rank holds a contiguous range of its postfixes, whose blocks
+// contain at most round_size values (or a single postfix block). The
+// partition is determined identically on all ranks without communication,
+// walking through all postfixes in ascending order as every rank stores its
+// postfixes.
+template <class basis_t> class PrefixRounds {
+public:
+  using bit_t = typename basis_t::bit_t;
+
+  PrefixRounds(basis_t const &basis, int64_t round_size) {
+    int mpi_rank, mpi_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    int64_t nup = basis.nup();
+    int64_t n_prefix_bits = basis.n_prefix_bits();
+    int64_t n_postfix_bits = basis.n_postfix_bits();
+
+    std::vector<int64_t> round(mpi_size, 0);
+    std::vector<int64_t> filled(mpi_size, 0);
+    std::vector<int64_t> n_states(n_postfix_bits + 1, 0);
+    std::vector<int64_t> my_rounds;
+    for (bit_t postfix : combinatorics::Subsets<bit_t>(n_postfix_bits)) {
+      int64_t nup_postfix = bits::popcount(postfix);
+      int64_t nup_prefix = nup - nup_postfix;
+      if ((nup_prefix < 0) || (nup_prefix > n_prefix_bits)) {
+        continue;
+      }
+      int rank = basis.rank(postfix);
+      int64_t size = math::binomial(n_prefix_bits, nup_prefix);
+      if ((filled[rank] > 0) && (filled[rank] + size > round_size)) {
+        ++round[rank];
+        filled[rank] = 0;
+      }
+      filled[rank] += size;
+      int64_t k = round[rank];
+      if (k >= (int64_t)postfixes_.size()) {
+        postfixes_.resize(k + 1);
+        states_.resize(k + 1, std::vector<States>(n_postfix_bits + 1));
+      }
+      postfixes_[k].push_back(postfix);
+      states_[k][nup_postfix].index.push_back(n_states[nup_postfix]++);
+      states_[k][nup_postfix].rank.push_back(rank);
+      if (rank == mpi_rank) {
+        my_rounds.push_back(k);
+      }
+    }
+    int64_t n_rounds = std::max((int64_t)1, (int64_t)postfixes_.size());
+    postfixes_.resize(n_rounds);
+    states_.resize(n_rounds, std::vector<States>(n_postfix_bits + 1));
+
+    postfix_begin_.assign(n_rounds + 1, 0);
+    for (int64_t k : my_rounds) {
+      ++postfix_begin_[k + 1];
+    }
+    for (int64_t k = 0; k < n_rounds; ++k) {
+      postfix_begin_[k + 1] += postfix_begin_[k];
+    }
+  }
+
+  int64_t n_rounds() const { return postfixes_.size(); }
+
+  // My postfixes basis.postfixes()[postfix_begin(k), postfix_end(k)) are
+  // held in round k
+  int64_t postfix_begin(int64_t round) const { return postfix_begin_[round]; }
+  int64_t postfix_end(int64_t round) const {
+    return postfix_begin_[round + 1];
+  }
+
+  // Postfixes of all ranks in round k, ascending
+  std::vector<bit_t> const &postfixes(int64_t round) const {
+    return postfixes_[round];
+  }
+
+  // Indices and ranks of the postfix states (cf.
+  // BasisSpinhalfDistributed::postfix_states) with nup_postfix up spins in
+  // round k, ascending
+  std::vector<int64_t> const &state_indices(int64_t round,
+                                            int64_t nup_postfix) const {
+    return states_[round][nup_postfix].index;
+  }
+  std::vector<int> const &state_ranks(int64_t round,
+                                      int64_t nup_postfix) const {
+    return states_[round][nup_postfix].rank;
+  }
+
+private:
+  struct States {
+    std::vector<int64_t> index;
+    std::vector<int> rank;
+  };
+  std::vector<std::vector<bit_t>> postfixes_;
+  std::vector<std::vector<States>> states_;
+  std::vector<int64_t> postfix_begin_;
+};
+
+// Applies Exchange terms acting on the prefix bits in rounds of bounded size,
+// instead of transposing the whole vector. Every round transposes a range of
+// postfix blocks into the global send buffer, applies the terms into the
+// receive buffer, transposes the result back and adds it to vec_out. The
+// buffers hold about round_size values instead of local vectors. progress()
+// is called after every term.
+template <class basis_t, typename coeff_t, class progress_f>
+void apply_prefix_rounds(std::vector<std::pair<Coeff, Op>> const &terms,
+                         basis_t const &basis, arma::Col<coeff_t> const &vec_in,
+                         arma::Col<coeff_t> &vec_out, int64_t round_size,
+                         progress_f &&progress) {
+  using bit_t = typename basis_t::bit_t;
+  int mpi_size;
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+  int64_t nup = basis.nup();
+  int64_t n_prefix_bits = basis.n_prefix_bits();
+  int64_t n_postfix_bits = basis.n_postfix_bits();
+
+  PrefixRounds<basis_t> rounds(basis, round_size);
+
+  // All valid prefixes, and the offsets of my prefixes per number of up spins
+  std::vector<bit_t> prefixes_all;
+  for (bit_t prefix : combinatorics::Subsets<bit_t>(n_prefix_bits)) {
+    int64_t nup_postfix = nup - bits::popcount(prefix);
+    if ((nup_postfix >= 0) && (nup_postfix <= n_postfix_bits)) {
+      prefixes_all.push_back(prefix);
+    }
+  }
+  std::vector<std::vector<int64_t>> prefix_begins(n_prefix_bits + 1);
+  for (bit_t prefix : basis.prefixes()) {
+    prefix_begins[bits::popcount(prefix)].push_back(basis.prefix_begin(prefix));
+  }
+
+  // Target ranks of the prefix states, they only depend on the number of up
+  // spins of the prefix
+  auto const &postfixes = basis.postfixes();
+  std::vector<std::vector<int>> prefix_ranks(n_prefix_bits + 1);
+  std::vector<std::vector<int64_t>> n_values_to_rank(n_prefix_bits + 1);
+  for (bit_t postfix : postfixes) {
+    int64_t nup_prefix = nup - bits::popcount(postfix);
+    if (n_values_to_rank[nup_prefix].empty()) {
+      auto const &prefix_states = basis.prefix_states(postfix);
+      n_values_to_rank[nup_prefix].assign(mpi_size, 0);
+      for (bit_t prefix : prefix_states) {
+        int rank = basis.rank(prefix);
+        prefix_ranks[nup_prefix].push_back(rank);
+        ++n_values_to_rank[nup_prefix][rank];
+      }
+    }
+  }
+
+  // Communication patterns of the forward and backward transposes of the
+  // rounds, determined at the first application and kept by the basis
+  std::string pattern_name = "prefix_transpose";
+  if (!basis.comm_pattern().contains(pattern_name, round_size)) {
+    std::vector<mpi::Communicator> comms;
+    for (int64_t k = 0; k < rounds.n_rounds(); ++k) {
+      std::vector<std::vector<int64_t>> n_values_round(n_postfix_bits + 1);
+      for (int64_t nup_postfix = 0; nup_postfix <= n_postfix_bits;
+           ++nup_postfix) {
+        n_values_round[nup_postfix].assign(mpi_size, 0);
+        for (int rank : rounds.state_ranks(k, nup_postfix)) {
+          ++n_values_round[nup_postfix][rank];
+        }
+      }
+      std::vector<int64_t> n_states_i_send(mpi_size, 0);
+      for (bit_t prefix : basis.prefixes()) {
+        auto const &n_values = n_values_round[nup - bits::popcount(prefix)];
+        for (int r = 0; r < mpi_size; ++r) {
+          n_states_i_send[r] += n_values[r];
+        }
+      }
+      comms.push_back(mpi::Communicator(n_states_i_send));
+      std::fill(n_states_i_send.begin(), n_states_i_send.end(), 0);
+      for (int64_t i = rounds.postfix_begin(k); i < rounds.postfix_end(k);
+           ++i) {
+        auto const &n_values =
+            n_values_to_rank[nup - bits::popcount(postfixes[i])];
+        for (int r = 0; r < mpi_size; ++r) {
+          n_states_i_send[r] += n_values[r];
+        }
+      }
+      comms.push_back(mpi::Communicator(n_states_i_send));
+    }
+    basis.comm_pattern().append(pattern_name, round_size, comms);
+  }
+  std::vector<mpi::Communicator> comms =
+      basis.comm_pattern().rounds(pattern_name, round_size);
+
+  std::vector<int64_t> send_offsets(mpi_size);
+  std::vector<int64_t> recv_offsets(mpi_size);
+  for (int64_t k = 0; k < rounds.n_rounds(); ++k) {
+    int64_t begin = rounds.postfix_begin(k);
+    int64_t end = rounds.postfix_end(k);
+    int64_t offset = 0;
+    int64_t size = 0;
+    std::vector<std::vector<int64_t>> postfix_begins(n_postfix_bits + 1);
+    if (begin < end) {
+      offset = basis.postfix_begin(postfixes[begin]);
+      bit_t last = postfixes[end - 1];
+      size = basis.postfix_begin(last) + basis.prefix_states(last).size() -
+             offset;
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      bit_t postfix = postfixes[i];
+      postfix_begins[bits::popcount(postfix)].push_back(
+          basis.postfix_begin(postfix) - offset);
+    }
+
+    std::vector<std::vector<int64_t>> n_values_round(n_postfix_bits + 1);
+    for (int64_t nup_postfix = 0; nup_postfix <= n_postfix_bits;
+         ++nup_postfix) {
+      n_values_round[nup_postfix].assign(mpi_size, 0);
+      for (int rank : rounds.state_ranks(k, nup_postfix)) {
+        ++n_values_round[nup_postfix][rank];
+      }
+    }
+    mpi::Communicator const &com = comms[2 * k];
+    mpi::Communicator const &com_r = comms[2 * k + 1];
+
+    int64_t buffer_size =
+        std::max({com.send_buffer_size(), com.recv_buffer_size(),
+                  com_r.send_buffer_size(), com_r.recv_buffer_size(), size});
+    mpi::buffer.reserve<coeff_t>(buffer_size);
+    coeff_t *send_buffer = mpi::buffer.send<coeff_t>();
+    coeff_t *recv_buffer = mpi::buffer.recv<coeff_t>();
+
+    // Transpose the postfix blocks of the round into the send buffer
+    for (int r = 0; r < mpi_size; ++r) {
+      send_offsets[r] = com.n_values_i_send_offset(r);
+      recv_offsets[r] = com.n_values_i_recv_offset(r);
+    }
+    auto const &prefixes = basis.prefixes();
+    mpi::for_each_ordered(
+        prefixes.size(), send_offsets,
+        [&](int64_t i, int64_t *counts) {
+          auto const &n_values =
+              n_values_round[nup - bits::popcount(prefixes[i])];
+          for (int r = 0; r < mpi_size; ++r) {
+            counts[r] += n_values[r];
+          }
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t prefix = prefixes[i];
+          int64_t nup_postfix = nup - bits::popcount(prefix);
+          auto const &indices = rounds.state_indices(k, nup_postfix);
+          auto const &ranks = rounds.state_ranks(k, nup_postfix);
+          int64_t prefix_begin = basis.prefix_begin(prefix);
+          for (int64_t j = 0; j < (int64_t)indices.size(); ++j) {
+            send_buffer[pos[ranks[j]]++] = vec_in[prefix_begin + indices[j]];
+          }
+        });
+    com.all_to_all(send_buffer, recv_buffer);
+    mpi::for_each_ordered(
+        prefixes_all.size(), recv_offsets,
+        [&](int64_t i, int64_t *counts) {
+          bit_t prefix = prefixes_all[i];
+          int64_t nup_postfix = nup - bits::popcount(prefix);
+          counts[basis.rank(prefix)] += postfix_begins[nup_postfix].size();
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t prefix = prefixes_all[i];
+          int64_t nup_postfix = nup - bits::popcount(prefix);
+          int64_t &idx_received = pos[basis.rank(prefix)];
+          bit_t postfix = bits::bitmask<bit_t>(nup_postfix);
+          int64_t prefix_idx = basis.prefix_lintable(postfix).index(prefix);
+          for (int64_t postfix_begin : postfix_begins[nup_postfix]) {
+            send_buffer[postfix_begin + prefix_idx] =
+                recv_buffer[idx_received++];
+          }
+        });
+
+    // Apply the terms into the receive buffer
+    std::fill(recv_buffer, recv_buffer + size, coeff_t(0));
+    for (auto const &[c, op] : terms) {
+      apply_exchange_prefix<basis_t, coeff_t>(c, op, basis, send_buffer,
+                                              recv_buffer, begin, end);
+      progress();
+    }
+
+    // Transpose the result back and add it to vec_out
+    for (int r = 0; r < mpi_size; ++r) {
+      send_offsets[r] = com_r.n_values_i_send_offset(r);
+      recv_offsets[r] = com_r.n_values_i_recv_offset(r);
+    }
+    mpi::for_each_ordered(
+        end - begin, send_offsets,
+        [&](int64_t i, int64_t *counts) {
+          auto const &n_values =
+              n_values_to_rank[nup - bits::popcount(postfixes[begin + i])];
+          for (int r = 0; r < mpi_size; ++r) {
+            counts[r] += n_values[r];
+          }
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t postfix = postfixes[begin + i];
+          auto const &ranks = prefix_ranks[nup - bits::popcount(postfix)];
+          int64_t idx = basis.postfix_begin(postfix) - offset;
+          for (int rank : ranks) {
+            send_buffer[pos[rank]++] = recv_buffer[idx++];
+          }
+        });
+    com_r.all_to_all(send_buffer, recv_buffer);
+    auto const &postfixes_round = rounds.postfixes(k);
+    mpi::for_each_ordered(
+        postfixes_round.size(), recv_offsets,
+        [&](int64_t i, int64_t *counts) {
+          bit_t postfix = postfixes_round[i];
+          int64_t nup_prefix = nup - bits::popcount(postfix);
+          counts[basis.rank(postfix)] += prefix_begins[nup_prefix].size();
+        },
+        [&](int64_t i, int64_t *pos) {
+          bit_t postfix = postfixes_round[i];
+          int64_t nup_prefix = nup - bits::popcount(postfix);
+          int64_t &idx_received = pos[basis.rank(postfix)];
+          bit_t prefix = bits::bitmask<bit_t>(nup_prefix);
+          int64_t postfix_idx = basis.postfix_lintable(prefix).index(postfix);
+          for (int64_t prefix_begin : prefix_begins[nup_prefix]) {
+            vec_out[prefix_begin + postfix_idx] += recv_buffer[idx_received++];
+          }
+        });
+  }
+}
+
+} // namespace xdiag::basis::spinhalf_distributed
+#endif
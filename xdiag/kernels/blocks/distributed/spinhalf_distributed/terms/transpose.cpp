@@ -4,7 +4,10 @@
 
 #include "transpose.hpp"
 
+#include <vector>
+
 #include <xdiag/combinatorics/subsets/subsets.hpp>
+#include <xdiag/mpi/for_each_ordered.hpp>
 
 namespace xdiag::basis::spinhalf_distributed {
 
@@ -25,62 +28,102 @@ void transpose(BasisSpinhalfDistributed<bit_t> const &basis, coeff_t const *vec_
   coeff_t *recv_buffer = mpi::buffer.recv<coeff_t>();
 
   auto const& prefixes = reverse ? basis.postfixes() : basis.prefixes();
-
-  // Fill send buffer
-  int64_t idx = 0;
+  int n_prefix_bits = reverse ? basis.n_postfix_bits() : basis.n_prefix_bits();
+  int n_postfix_bits = reverse ? basis.n_prefix_bits() : basis.n_postfix_bits();
+  auto postfix_states = [&](bit_t prefix) -> std::vector<bit_t> const & {
+    return reverse ? basis.prefix_states(prefix) : basis.postfix_states(prefix);
+  };
+  auto prefix_begin = [&](bit_t prefix) {
+    return reverse ? basis.postfix_begin(prefix) : basis.prefix_begin(prefix);
+  };
+
+  // The postfix states of a prefix only depend on the number of up spins of
+  // the postfix. Their target ranks are computed once per number of up spins.
+  std::vector<std::vector<int>> target_ranks(n_postfix_bits + 1);
+  std::vector<std::vector<int64_t>> n_values_to_rank(n_postfix_bits + 1);
   for (auto prefix : prefixes) {
-    auto const& postfixes = reverse ? basis.prefix_states(prefix) : basis.postfix_states(prefix);
-    for (auto postfix : postfixes) {
-      int target_rank = basis.rank(postfix);
-      com.add_to_send_buffer(target_rank, vec_in[idx], send_buffer);
-      ++idx;
+    int nup_postfix = basis.nup() - bits::popcount(prefix);
+    if (n_values_to_rank[nup_postfix].empty()) {
+      auto const &postfixes = postfix_states(prefix);
+      target_ranks[nup_postfix].resize(postfixes.size());
+      n_values_to_rank[nup_postfix].assign(mpi_size, 0);
+      for (int64_t j = 0; j < (int64_t)postfixes.size(); ++j) {
+        int target_rank = basis.rank(postfixes[j]);
+        target_ranks[nup_postfix][j] = target_rank;
+        ++n_values_to_rank[nup_postfix][target_rank];
+      }
     }
   }
 
+  // Fill send buffer, the prefixes are distributed among the threads
+  std::vector<int64_t> send_offsets(mpi_size);
+  std::vector<int64_t> recv_offsets(mpi_size);
+  for (int r = 0; r < mpi_size; ++r) {
+    send_offsets[r] = com.n_values_i_send_offset(r);
+    recv_offsets[r] = com.n_values_i_recv_offset(r);
+  }
+  mpi::for_each_ordered(
+      prefixes.size(), send_offsets,
+      [&](int64_t i, int64_t *counts) {
+        int nup_postfix = basis.nup() - bits::popcount(prefixes[i]);
+        auto const &n_values = n_values_to_rank[nup_postfix];
+        for (int r = 0; r < mpi_size; ++r) {
+          counts[r] += n_values[r];
+        }
+      },
+      [&](int64_t i, int64_t *pos) {
+        bit_t prefix = prefixes[i];
+        int nup_postfix = basis.nup() - bits::popcount(prefix);
+        auto const &ranks = target_ranks[nup_postfix];
+        int64_t idx = prefix_begin(prefix);
+        for (int target_rank : ranks) {
+          send_buffer[pos[target_rank]++] = vec_in[idx++];
+        }
+      });
+
   // Communicate
   com.all_to_all(send_buffer, recv_buffer);
 
-  // Sort reveived coefficients to postfix ordering (this is gnarly!!!)
-  std::vector<int64_t> offsets(mpi_size, 0);
-
-  int n_prefix_bits = reverse ? basis.n_postfix_bits() : basis.n_prefix_bits();
-  int n_postfix_bits = reverse ? basis.n_prefix_bits() : basis.n_postfix_bits();
+  // Sort received coefficients to postfix ordering. Every prefix of the full
+  // space has been sent by one rank, together with the coefficients of all
+  // postfixes of this rank with the matching number of up spins.
+  auto const &postfixes = reverse ? basis.prefixes() : basis.postfixes();
+  std::vector<std::vector<int64_t>> postfix_begins(n_postfix_bits + 1);
+  for (bit_t postfix : postfixes) {
+    int64_t postfix_begin =
+        reverse ? basis.prefix_begin(postfix) : basis.postfix_begin(postfix);
+    postfix_begins[bits::popcount(postfix)].push_back(postfix_begin);
+  }
 
+  std::vector<bit_t> prefixes_all;
   for (auto prefix : combinatorics::Subsets<bit_t>(n_prefix_bits)) {
     int nup_prefix = bits::popcount(prefix);
     int nup_postfix = basis.nup() - nup_prefix;
     if ((nup_postfix < 0) || (nup_postfix > n_postfix_bits))
       continue;
-
-    int origin_rank = basis.rank(prefix);
-    int64_t origin_offset = com.n_values_i_recv_offset(origin_rank);
-    int64_t prefix_idx = 0;
-    if (reverse) {
-      bit_t postfix = bits::bitmask<bit_t>(nup_postfix);
-      prefix_idx = basis.postfix_lintable(postfix).index(prefix);
-    } else {
-      bit_t postfix = bits::bitmask<bit_t>(nup_postfix);
-      prefix_idx = basis.prefix_lintable(postfix).index(prefix);
-    }
-
-    auto postfixes = reverse ? basis.prefixes() : basis.postfixes();
-    for (bit_t postfix : postfixes) {
-      if (bits::popcount(postfix) != nup_postfix)
-        continue;
-
-      int64_t idx_received = origin_offset + offsets[origin_rank];
-      int64_t postfix_begin = 0;
-      if (reverse) {
-        postfix_begin = basis.prefix_begin(postfix);
-      } else {
-        postfix_begin = basis.postfix_begin(postfix);
-      }
-      int64_t idx_sorted = postfix_begin + prefix_idx;
-
-      send_buffer[idx_sorted] = recv_buffer[idx_received];
-      ++offsets[origin_rank];
-    }
+    prefixes_all.push_back(prefix);
   }
+
+  mpi::for_each_ordered(
+      prefixes_all.size(), recv_offsets,
+      [&](int64_t i, int64_t *counts) {
+        bit_t prefix = prefixes_all[i];
+        int nup_postfix = basis.nup() - bits::popcount(prefix);
+        counts[basis.rank(prefix)] += postfix_begins[nup_postfix].size();
+      },
+      [&](int64_t i, int64_t *pos) {
+        bit_t prefix = prefixes_all[i];
+        int nup_postfix = basis.nup() - bits::popcount(prefix);
+        int64_t &idx_received = pos[basis.rank(prefix)];
+        bit_t postfix = bits::bitmask<bit_t>(nup_postfix);
+        int64_t prefix_idx = reverse
+                                 ? basis.postfix_lintable(postfix).index(prefix)
+                                 : basis.prefix_lintable(postfix).index(prefix);
+        for (int64_t postfix_begin : postfix_begins[nup_postfix]) {
+          send_buffer[postfix_begin + prefix_idx] =
+              recv_buffer[idx_received++];
+        }
+      });
   mpi::buffer.clean_recv();
 }
 
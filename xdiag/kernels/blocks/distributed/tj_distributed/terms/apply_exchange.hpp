@@ -13,6 +13,7 @@
 #include <xdiag/operators/coeff.hpp>
 #include <xdiag/operators/op.hpp>
 #include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/comm_pattern.hpp>
 #include <xdiag/mpi/communicator.hpp>
 
 namespace xdiag::basis::tj_distributed {
@@ -44,31 +45,35 @@ void apply_exchange(Coeff const &cpl, Op const &op, basis_t const &basis,
   int64_t ndn = basis.ndn();
   int64_t ndn_configurations = math::binomial(nsites - nup, ndn);
 
-  // Find out how many states is sent to each process
-  std::vector<int64_t> n_states_i_send(mpi_size, 0);
+  // The communication pattern of the term is determined once per basis
+  if (!basis.comm_pattern().contains(op)) {
+    // Find out how many states is sent to each process
+    std::vector<int64_t> n_states_i_send(mpi_size, 0);
 
-  // Flip states and check out how much needs to be communicated
-  int64_t idx_up = 0;
-  for (bit_t up : basis.my_ups()) {
-    if (bits::popcount(up & flipmask) == 1) {
-      bit_t flipped_up = up ^ flipmask;
-      int target = basis.rank(flipped_up);
+    // Flip states and check out how much needs to be communicated
+    int64_t idx_up = 0;
+    for (bit_t up : basis.my_ups()) {
+      if (bits::popcount(up & flipmask) == 1) {
+        bit_t flipped_up = up ^ flipmask;
+        int target = basis.rank(flipped_up);
 
-      for (bit_t dn : basis.my_dns_for_ups(idx_up)) {
-        if (bits::popcount(dn & flipmask) == 1)
-          ++n_states_i_send[target];
+        for (bit_t dn : basis.my_dns_for_ups(idx_up)) {
+          if (bits::popcount(dn & flipmask) == 1)
+            ++n_states_i_send[target];
+        }
       }
+      ++idx_up;
     }
-    ++idx_up;
-  }
 
-  // Exchange information on who sends how much to whom
-  mpi::Communicator comm(n_states_i_send);
+    // Exchange information on who sends how much to whom
+    basis.comm_pattern().append(op, mpi::Communicator(n_states_i_send));
+  }
+  mpi::Communicator comm = basis.comm_pattern()[op];
   mpi::buffer.reserve<coeff_t>(comm.send_buffer_size(),
                                comm.recv_buffer_size());
 
   // Flip states and check how much needs to be communicated
-  idx_up = 0;
+  int64_t idx_up = 0;
   int64_t idx = 0;
   for (bit_t up : basis.my_ups()) {
     if (bits::popcount(up & flipmask) == 1) {
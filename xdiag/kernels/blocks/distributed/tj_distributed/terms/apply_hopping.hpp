@@ -15,9 +15,12 @@
 
 namespace xdiag::basis::tj_distributed {
 
+// Up hoppings act on a vector in dn/up order, restricted to the blocks of my
+// dns [dn_begin, dn_end) if given (cf. generic_term_ups)
 template <typename coeff_t, class basis_t>
 void apply_hopping(Coeff const &cpl, Op const &op, basis_t const &basis,
-                   const coeff_t *vec_in, coeff_t *vec_out) {
+                   const coeff_t *vec_in, coeff_t *vec_out,
+                   int64_t dn_begin = 0, int64_t dn_end = -1) {
   using bit_t = typename basis_t::bit_t;
 
   coeff_t t = cpl.scalar().as<coeff_t>();
@@ -44,7 +47,8 @@ void apply_hopping(Coeff const &cpl, Op const &op, basis_t const &basis,
       };
       tj_distributed::generic_term_ups<coeff_t>(basis, basis, non_zero_term_ups,
                                                 non_zero_term_dns, term_action,
-                                                vec_in, vec_out);
+                                                vec_in, vec_out, dn_begin,
+                                                dn_end);
     } else {
       auto non_zero_term_ups = [&](bit_t const &ups) -> bool {
         return (ups & flipmask) == 0;
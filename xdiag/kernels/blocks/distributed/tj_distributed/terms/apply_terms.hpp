@@ -15,11 +15,13 @@
 #include <xdiag/algebra/algebra.hpp>
 #include <xdiag/algebra/normal_order.hpp>
 #include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/exchange.hpp>
 #include <xdiag/operators/coeff.hpp>
 #include <xdiag/operators/op.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/utils/error.hpp>
 
+#include <xdiag/kernels/blocks/distributed/transpose_rounds.hpp>
 #include <xdiag/kernels/blocks/distributed/tj_distributed/terms/apply_exchange.hpp>
 #include <xdiag/kernels/blocks/distributed/tj_distributed/terms/apply_hopping.hpp>
 #include <xdiag/kernels/blocks/distributed/tj_distributed/terms/apply_number.hpp>
@@ -52,6 +54,7 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
 
   std::vector<std::pair<Coeff, Op>> terms;
   bool has_up = false;
+  bool has_up_raise_lower = false;
   for (auto const &[c, monomial] : ops_compiled) {
     if (monomial.size() != 1) {
       XDIAG_THROW("tJDistributed only supports single-operator terms "
@@ -61,13 +64,9 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     Op op = monomial[0];
     terms.push_back({c, op});
     has_up |= is_up_term(op.type());
+    has_up_raise_lower |= (op.type() == "Cdagup") || (op.type() == "Cup");
   }
 
-  int64_t buffer_size =
-      std::max({basis_in.size(), basis_in.size_transpose(), basis_out.size(),
-                basis_out.size_transpose()});
-  mpi::buffer.reserve<coeff_t>(buffer_size);
-
   // Operators in the native up/dn ordering (dn species + diagonal terms).
   for (auto const &[c, op] : terms) {
     std::string type = op.type();
@@ -88,7 +87,7 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
       apply_raise_lower<coeff_t>(c, op, basis_in, vec_in.memptr(), basis_out,
                                  vec_out.memptr());
     } else if (type == "Id") {
-      coeff_t cc = c.scalar().as<coeff_t>();
+      coeff_t cc = c.scalar().template as<coeff_t>();
       for (int64_t i = 0; i < basis_in.size(); ++i) {
         vec_out[i] += cc * vec_in[i];
       }
@@ -100,8 +99,28 @@ void apply_terms(OpSum const &ops, basis_t const &basis_in,
     }
   }
 
-  // Up-species operators: transpose to dn/up ordering, apply, transpose back.
-  if (has_up) {
+  // Up hoppings are applied in rounds of bounded size if
+  // mpi::exchange_settings.round_size is positive, cf. apply_transpose_rounds
+  int64_t round_size = mpi::exchange_settings.round_size;
+  if (has_up && !has_up_raise_lower && (round_size > 0)) {
+    apply_transpose_rounds(
+        basis_in, vec_in, vec_out, round_size,
+        [&](const coeff_t *vec_in_round, coeff_t *vec_out_round,
+            int64_t dn_begin, int64_t dn_end) {
+          for (auto const &[c, op] : terms) {
+            if (is_up_term(op.type())) {
+              apply_hopping<coeff_t>(c, op, basis_in, vec_in_round,
+                                     vec_out_round, dn_begin, dn_end);
+            }
+          }
+        });
+  } else if (has_up) {
+    // Up-species operators: transpose to dn/up ordering, apply, transpose
+    // back.
+    int64_t buffer_size =
+        std::max({basis_in.size(), basis_in.size_transpose(), basis_out.size(),
+                  basis_out.size_transpose()});
+    mpi::buffer.reserve<coeff_t>(buffer_size);
     basis_in.transpose(vec_in.memptr());
     coeff_t *vec_in_trans = mpi::buffer.send<coeff_t>();
     coeff_t *vec_out_trans = mpi::buffer.recv<coeff_t>();
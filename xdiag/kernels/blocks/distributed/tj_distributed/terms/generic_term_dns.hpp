@@ -37,9 +37,14 @@ void generic_term_dns(basis_t const &basis_in, basis_t const &basis_out,
   int64_t ndn_configurations_out =
       math::binomial(nsites - nup_out, ndn_out);
 
-  // Loop over all configurations
-  int64_t idx_up = 0;
-  for (bit_t up : basis_in.my_ups()) {
+  // Loop over all configurations. The term does not change the up spins,
+  // hence every up configuration writes to its own block of vec_out.
+  auto const &my_ups = basis_in.my_ups();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t idx_up = 0; idx_up < (int64_t)my_ups.size(); ++idx_up) {
+    bit_t up = my_ups[idx_up];
 
     if (non_zero_term_ups(up)) {
       bit_t not_up = (~up) & sitesmask;
@@ -65,8 +70,6 @@ void generic_term_dns(basis_t const &basis_in, basis_t const &basis_out,
         } // non-zero term dns
       } // if ((upspins & flipmask) == 0)
     } // non-zero-term ups
-
-    ++idx_up;
   } // for(const bit_t& upspins : my_upspins_)
 }
 
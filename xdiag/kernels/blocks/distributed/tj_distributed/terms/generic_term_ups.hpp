@@ -14,13 +14,17 @@
 
 namespace xdiag::basis::tj_distributed {
 
+// Applies a term acting on the up spins to a vector in dn/up order. If a range
+// [dn_begin, dn_end) of my dns is given, vec_in and vec_out only hold the
+// blocks of these dns.
 template <typename coeff_t, class basis_t, class non_zero_term_ups_f,
           class non_zero_term_dns_f, class term_action_f>
 void generic_term_ups(basis_t const &basis_in, basis_t const &basis_out,
                       non_zero_term_ups_f non_zero_term_ups,
                       non_zero_term_dns_f non_zero_term_dns,
                       term_action_f term_action, const coeff_t *vec_in,
-                      coeff_t *vec_out) {
+                      coeff_t *vec_out, int64_t dn_begin = 0,
+                      int64_t dn_end = -1) {
   using bit_t = typename basis_t::bit_t;
 
   int64_t nsites = basis_in.nsites();
@@ -37,31 +41,40 @@ void generic_term_ups(basis_t const &basis_in, basis_t const &basis_out,
   int64_t nup_configurations_out =
       math::binomial(nsites - ndn_out, nup_out);
 
-  // Loop over all configurations
-  int64_t idx_dn = 0;
-  for (bit_t dn : basis_in.my_dns()) {
+  // Loop over all configurations. The term does not change the dn spins,
+  // hence every dn configuration writes to its own block of vec_out.
+  auto const &my_dns = basis_in.my_dns();
+  if (dn_end < 0) {
+    dn_end = my_dns.size();
+  }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (int64_t idx_dn = dn_begin; idx_dn < dn_end; ++idx_dn) {
+    bit_t dn = my_dns[idx_dn];
 
     if (non_zero_term_dns(dn)) {
       bit_t not_dn = (~dn) & sitesmask;
-      int64_t dn_offset_in = idx_dn * nup_configurations_in;
+      // The ups depend on dn and are stored for all my dns, whereas vec_in
+      // only holds the blocks of the dns in [dn_begin, dn_end)
+      int64_t ups_offset = idx_dn * nup_configurations_in;
+      int64_t dn_offset_in = (idx_dn - dn_begin) * nup_configurations_in;
 
-      for (int64_t idx_in = dn_offset_in;
-           idx_in < dn_offset_in + nup_configurations_in; ++idx_in) {
-
-        bit_t up = basis_in.my_ups_for_dns_storage(idx_in);
+      for (int64_t k = 0; k < nup_configurations_in; ++k) {
+        int64_t idx_in = dn_offset_in + k;
+        bit_t up = basis_in.my_ups_for_dns_storage(ups_offset + k);
 
         // Check if hopping is possible
         if (non_zero_term_ups(up)) {
           auto [up_flip, coeff] = term_action(up);
           if ((up_flip & dn) == 0) { // tJ constraint
-            int64_t idx_out = basis_out.index_r(up_flip, dn);
+            int64_t idx_out = basis_out.index_r(up_flip, dn) -
+                              dn_begin * nup_configurations_out;
             vec_out[idx_out] += coeff * vec_in[idx_in];
           } // tJ constraint
         } // non-zero term dns
       } // if ((upspins & flipmask) == 0)
     } // non-zero-term ups
-
-    ++idx_dn;
   } // for(const bit_t& upspins : my_upspins_)
 }
 
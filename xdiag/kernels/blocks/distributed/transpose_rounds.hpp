@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifdef XDIAG_DISTRIBUTED
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include <extern/gsl/span>
+#include <xdiag/armadillo.hpp>
+#include <xdiag/basis/distributed/basis_electron_distributed.hpp>
+#include <xdiag/basis/distributed/basis_tj_distributed.hpp>
+#include <xdiag/mpi/allreduce.hpp>
+#include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/communicator.hpp>
+#include <xdiag/mpi/for_each_ordered.hpp>
+#include <xdiag/utils/error.hpp>
+
+namespace xdiag::basis {
+
+// Up configurations in the block of my dn with index idx_dn (dn/up order)
+template <typename bit_t>
+inline gsl::span<bit_t const>
+ups_for_dn(BasistJDistributed<bit_t> const &basis, int64_t idx_dn) {
+  return basis.my_ups_for_dns(idx_dn);
+}
+
+template <typename bit_t>
+inline gsl::span<bit_t const>
+ups_for_dn(BasisElectronDistributed<bit_t> const &basis, int64_t) {
+  auto const &ups = basis.all_ups();
+  return gsl::span<bit_t const>(ups.data(), ups.size());
+}
+
+// Applies terms acting on the up spins of a distributed tJ or electron basis
+// in rounds of bounded size, instead of transposing the whole vector. In every
+// round, a rank holds a contiguous range of its dns, whose blocks in dn/up
+// order contain at most round_size values (or a single block). The values of
+// the round are gathered from the ranks owning the ups, the terms are applied
+// and the result is sent back and added to vec_out.
+//
+// The values a rank exchanges with rank r in a round form a contiguous segment
+// of the back transpose, which is ordered by the dns of r. Hence, the values
+// are located by basis.transpose_permutation_r() and no further permutation
+// is stored. The communication patterns of the rounds are determined at the
+// first application and kept by the basis.
+//
+// apply(vec_in_round, vec_out_round, dn_begin, dn_end) applies the terms to
+// the blocks of my dns [dn_begin, dn_end), held in vec_in_round, and adds the
+// result to vec_out_round.
+template <class basis_t, typename coeff_t, class apply_f>
+void apply_transpose_rounds(basis_t const &basis,
+                            arma::Col<coeff_t> const &vec_in,
+                            arma::Col<coeff_t> &vec_out, int64_t round_size,
+                            apply_f &&apply) try {
+  using bit_t = typename basis_t::bit_t;
+  int mpi_size;
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+  auto const &my_dns = basis.my_dns();
+  int64_t n_dns = my_dns.size();
+
+  // My dns [dn_begin[k], dn_begin[k + 1]) are held in round k
+  std::vector<int64_t> dn_begin = {0};
+  int64_t filled = 0;
+  for (int64_t idx_dn = 0; idx_dn < n_dns; ++idx_dn) {
+    int64_t n = ups_for_dn(basis, idx_dn).size();
+    if ((filled > 0) && (filled + n > round_size)) {
+      dn_begin.push_back(idx_dn);
+      filled = 0;
+    }
+    filled += n;
+  }
+  dn_begin.push_back(n_dns);
+  auto block_begin = [&](int64_t idx_dn) {
+    return (idx_dn < n_dns) ? basis.my_dns_offset(my_dns[idx_dn])
+                            : basis.size_transpose();
+  };
+
+  // Communication patterns of the rounds, forward and back
+  std::string pattern_name = "transpose";
+  if (!basis.comm_pattern().contains(pattern_name, round_size)) {
+    int64_t n_rounds = dn_begin.size() - 1;
+    int64_t n_rounds_max = 0;
+    mpi::Allreduce(&n_rounds, &n_rounds_max, 1, MPI_MAX, MPI_COMM_WORLD);
+    std::vector<mpi::Communicator> comms;
+    for (int64_t k = 0; k < n_rounds_max; ++k) {
+      std::vector<int64_t> n_states_i_send(mpi_size, 0);
+      if (k < n_rounds) {
+        for (int64_t idx_dn = dn_begin[k]; idx_dn < dn_begin[k + 1];
+             ++idx_dn) {
+          for (bit_t up : ups_for_dn(basis, idx_dn)) {
+            ++n_states_i_send[basis.rank(up)];
+          }
+        }
+      }
+      mpi::Communicator com_r(n_states_i_send);
+
+      // forward, every rank sends what it receives when sending back
+      for (int r = 0; r < mpi_size; ++r) {
+        n_states_i_send[r] = com_r.n_values_i_recv(r);
+      }
+      comms.push_back(mpi::Communicator(n_states_i_send));
+      comms.push_back(com_r);
+    }
+    basis.comm_pattern().append(pattern_name, round_size, comms);
+  }
+  std::vector<mpi::Communicator> comms =
+      basis.comm_pattern().rounds(pattern_name, round_size);
+  int64_t n_rounds = comms.size() / 2;
+  dn_begin.resize(n_rounds + 1, n_dns);
+
+  // Beginning of the values of rank r in the current round in the back
+  // transpose
+  auto const &permutation = basis.transpose_permutation_r();
+  std::vector<int64_t> segment(mpi_size);
+  for (int r = 0; r < mpi_size; ++r) {
+    segment[r] = basis.transpose_communicator_r().n_values_i_recv_offset(r);
+  }
+
+  std::vector<int64_t> offsets(mpi_size);
+  for (int64_t k = 0; k < n_rounds; ++k) {
+    mpi::Communicator const &com = comms[2 * k];
+    mpi::Communicator const &com_r = comms[2 * k + 1];
+    int64_t begin = dn_begin[k];
+    int64_t end = dn_begin[k + 1];
+    int64_t offset = block_begin(begin);
+    int64_t size = block_begin(end) - offset;
+
+    int64_t buffer_size =
+        std::max({com.send_buffer_size(), com.recv_buffer_size(),
+                  com_r.send_buffer_size(), com_r.recv_buffer_size(), size});
+    mpi::buffer.reserve<coeff_t>(buffer_size);
+    coeff_t *send_buffer = mpi::buffer.send<coeff_t>();
+    coeff_t *recv_buffer = mpi::buffer.recv<coeff_t>();
+
+    // Gather the values of the round and sort them into dn/up order
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (int r = 0; r < mpi_size; ++r) {
+      coeff_t *send = send_buffer + com.n_values_i_send_offset(r);
+      int64_t const *idces = permutation.data() + segment[r];
+      int64_t n = com.n_values_i_send(r);
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+      for (int64_t i = 0; i < n; ++i) {
+        send[i] = vec_in[idces[i]];
+      }
+    }
+    com.all_to_all(send_buffer, recv_buffer);
+    for (int r = 0; r < mpi_size; ++r) {
+      offsets[r] = com.n_values_i_recv_offset(r);
+    }
+    mpi::for_each_ordered(
+        end - begin, offsets,
+        [&](int64_t i, int64_t *counts) {
+          for (bit_t up : ups_for_dn(basis, begin + i)) {
+            ++counts[basis.rank(up)];
+          }
+        },
+        [&](int64_t i, int64_t *pos) {
+          int64_t idx = block_begin(begin + i) - offset;
+          for (bit_t up : ups_for_dn(basis, begin + i)) {
+            send_buffer[idx++] = recv_buffer[pos[basis.rank(up)]++];
+          }
+        });
+
+    // Apply the terms into the receive buffer
+    std::fill(recv_buffer, recv_buffer + size, coeff_t(0));
+    apply(send_buffer, recv_buffer, begin, end);
+
+    // Send the result back and add it to vec_out
+    for (int r = 0; r < mpi_size; ++r) {
+      offsets[r] = com_r.n_values_i_send_offset(r);
+    }
+    mpi::for_each_ordered(
+        end - begin, offsets,
+        [&](int64_t i, int64_t *counts) {
+          for (bit_t up : ups_for_dn(basis, begin + i)) {
+            ++counts[basis.rank(up)];
+          }
+        },
+        [&](int64_t i, int64_t *pos) {
+          int64_t idx = block_begin(begin + i) - offset;
+          for (bit_t up : ups_for_dn(basis, begin + i)) {
+            send_buffer[pos[basis.rank(up)]++] = recv_buffer[idx++];
+          }
+        });
+    com_r.all_to_all(send_buffer, recv_buffer);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (int r = 0; r < mpi_size; ++r) {
+      coeff_t const *recv = recv_buffer + com_r.n_values_i_recv_offset(r);
+      int64_t const *idces = permutation.data() + segment[r];
+      int64_t n = com_r.n_values_i_recv(r);
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+      for (int64_t i = 0; i < n; ++i) {
+        vec_out[idces[i]] += recv[i];
+      }
+    }
+    for (int r = 0; r < mpi_size; ++r) {
+      segment[r] += com_r.n_values_i_recv(r);
+    }
+  }
+}
+XDIAG_CATCH
+
+} // namespace xdiag::basis
+#endif
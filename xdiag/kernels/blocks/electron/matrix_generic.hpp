@@ -27,11 +27,18 @@ namespace xdiag::kernels::electron {
 
 template <typename coeff_t, typename basis_t, typename fill_f>
 void matrix_generic(OpSum const &ops, basis_t const &basis_in,
-                    basis_t const &basis_out, fill_f fill) try {
+                    basis_t const &basis_out, fill_f fill,
+                    bool compiled = false) try {
 
-  operators::check_valid(ops);
-  auto algebra = algebra::electron_implementation_algebra(basis_in.nsites());
-  auto ops_compiled = normal_order(ops.plain(), algebra);
+  // Get OpSum into format that can be processed, unless this has already
+  // been done when building a CompiledOpSum
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::electron_implementation_algebra(basis_in.nsites());
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
 
   for (auto const &[c, monomial] : ops_compiled) {
     // Products of elementary operators (e.g. S+ = Cdagup Cdn) are handled by the
@@ -17,6 +17,7 @@
 #include <xdiag/bits/popcount.hpp>
 #include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::electron {
 
@@ -117,20 +118,21 @@ void term_dns(basis_t const &basis_in, basis_t const &basis_out,
   // for a single Cdagdn / Cdn, Ndn changes so basis_out is a DIFFERENT (in
   // general smaller) sector. The input (row) index uses basis_in, the output
   // (column) index uses basis_out.
-  auto const &basis_up = basis_in.basis_up();
 
   // conjugation necessary for definition of projected states
   arma::Col<coeff_t> characters =
       arma::conj(basis_out.characters().template as<arma::Col<coeff_t>>());
 
+  utils::ThreadUtilization utilization("electron::term_dns");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-  auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+  auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
@@ -13,6 +13,7 @@
 #include <xdiag/basis/basis_electron_symmetric.hpp>
 #include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::electron {
 
@@ -33,20 +34,20 @@ void term_offdiag(basis_t const &basis_in, basis_t const &basis_out,
                   apply_f apply, fill_f fill) {
   using bit_t = typename basis_t::bit_t;
 
-  auto const &basis_up = basis_in.basis_up();
-
   // conjugation necessary for definition of projected states
   arma::Col<coeff_t> characters =
       arma::conj(basis_out.characters().template as<arma::Col<coeff_t>>());
 
+  utils::ThreadUtilization utilization("electron::term_offdiag");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_ups] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-  auto [begin_up, end_up, idx_ups] = utils::thread_range(basis_up, 0, 1);
+  auto [begin_up, end_up, idx_ups] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_ups) {
       bit_t ups = *it_up;
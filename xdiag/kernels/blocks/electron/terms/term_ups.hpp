@@ -16,6 +16,7 @@
 #include <xdiag/basis/basis_electron_symmetric.hpp>
 #include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::electron {
 
@@ -82,20 +83,20 @@ void term_ups(basis_t const &basis_in, basis_t const &basis_out,
               fill_f fill) {
   using bit_t = typename basis_t::bit_t;
 
-  auto const &basis_up_in = basis_in.basis_up();
-
   // conjugation necessary for definition of projected states
   arma::Col<coeff_t> characters =
       arma::conj(basis_out.characters().template as<arma::Col<coeff_t>>());
 
+  utils::ThreadUtilization utilization("electron::term_ups");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up_in] =
-        utils::thread_range(basis_up_in, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-  auto [begin_up, end_up, idx_up_in] = utils::thread_range(basis_up_in, 0, 1);
+  auto [begin_up, end_up, idx_up_in] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up_in) {
       bit_t ups_in = *it_up;
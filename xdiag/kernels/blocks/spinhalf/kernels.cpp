@@ -11,6 +11,7 @@
 #include <xdiag/combinatorics/combinations/lin_table.hpp>
 #include <xdiag/combinatorics/subsets/subsets.hpp>
 #include <xdiag/math/complex.hpp>
+#include <xdiag/kernels/blocks/spinhalf/matrix_fused.hpp>
 #include <xdiag/kernels/blocks/spinhalf/matrix_generic.hpp>
 #include <xdiag/kernels/kernels_generic.hpp>
 
@@ -21,8 +22,17 @@ namespace xdiag::kernels {
 template <> struct matrix_kernel<Spinhalf> {
   template <typename coeff_t, typename basis_t, typename fill_f>
   static void call(OpSum const &ops, basis_t const &basis_in,
-                   basis_t const &basis_out, fill_f &&fill) {
-    spinhalf::matrix_generic<coeff_t>(ops, basis_in, basis_out, fill);
+                   basis_t const &basis_out, fill_f &&fill,
+                   bool compiled = false) {
+    spinhalf::matrix_generic<coeff_t>(ops, basis_in, basis_out, fill, compiled);
+  }
+
+  static constexpr bool has_fused = true;
+  template <typename coeff_t, typename basis_t, typename fill_f>
+  static void call_fused(OpSum const &ops, basis_t const &basis_in,
+                         basis_t const &basis_out, fill_f &&fill,
+                         bool compiled = false) {
+    spinhalf::matrix_fused<coeff_t>(ops, basis_in, basis_out, fill, compiled);
   }
 };
 
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <xdiag/algebra/algebra.hpp>
+#include <xdiag/algebra/normal_order.hpp>
+#include <xdiag/bits/get_set.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/operators/valid.hpp>
+#include <xdiag/utils/error.hpp>
+
+#include <xdiag/kernels/blocks/spinhalf/matrix_generic.hpp>
+#include <xdiag/kernels/blocks/spinhalf/terms/term_fused.hpp>
+
+namespace xdiag::kernels::spinhalf {
+
+// Splits a normal ordered OpSum into the terms that can be applied in a single
+// sweep (Id, Sz, SzSz, Exchange, ExchangeAsym, S+, S-) and a remainder of
+// terms (ScalarChirality, Matrix) which are applied term by term.
+template <typename coeff_t, typename bit_t>
+FusedTerms<bit_t, coeff_t> compile_fused(OpSum const &ops_compiled,
+                                         OpSum &remainder) try {
+  FusedTerms<bit_t, coeff_t> terms;
+
+  for (auto const &[c, monomial] : ops_compiled) {
+    assert(monomial.size() == 1); // required for properly compiled ops
+
+    Op op = monomial[0];
+    std::string type = op.type();
+
+    if ((type == "ScalarChirality") || (type == "Matrix")) {
+      remainder += OpSum(c, op);
+      continue;
+    }
+
+    coeff_t J = c.scalar().template as<coeff_t>();
+    if (type == "Id") {
+      terms.has_diag = true;
+      terms.diag_const += J;
+    } else if ((type == "Exchange") || (type == "ExchangeAsym")) {
+      int64_t s1 = op[0];
+      int64_t s2 = op[1];
+      bit_t mask1 = bit_t();
+      bits::set(mask1, s1);
+      terms.has_diag |= (s1 == s2);
+      if ((s1 == s2) && (type == "Exchange")) {
+        terms.diag_const += J / 2.0;
+      } else if (s1 == s2) { // ExchangeAsym_ii = Sz_i
+        terms.diags.push_back({mask1, -J / 2.0, J / 2.0});
+      } else {
+        bit_t mask2 = bit_t();
+        bits::set(mask2, s2);
+        bit_t mask = mask1 | mask2;
+        // s1 up (S-_i S+_j branch) carries -J/2 for ExchangeAsym
+        coeff_t Jhalf = J / 2.0;
+        coeff_t Jhalf_up = (type == "Exchange") ? Jhalf : -Jhalf;
+        terms.flips.push_back({mask, mask1, Jhalf_up});
+        terms.flips.push_back({mask, mask2, Jhalf});
+      }
+    } else if (type == "SzSz") {
+      terms.has_diag = true;
+      if (op[0] == op[1]) {
+        terms.diag_const += J / 4.0;
+      } else {
+        bit_t mask = bit_t();
+        bits::set(mask, op[0]);
+        bits::set(mask, op[1]);
+        terms.diags.push_back({mask, J / 4.0, -J / 4.0});
+      }
+    } else if (type == "Sz") {
+      terms.has_diag = true;
+      bit_t mask = bit_t();
+      bits::set(mask, op[0]);
+      terms.diags.push_back({mask, -J / 2.0, J / 2.0});
+    } else if ((type == "S+") || (type == "S-")) {
+      bit_t mask = bit_t();
+      bits::set(mask, op[0]);
+      terms.flips.push_back({mask, (type == "S+") ? bit_t() : mask, J});
+    } else {
+      XDIAG_THROW(
+          fmt::format("Unknown Op type for Spinhalf basis \"{}\"", type));
+    }
+  }
+  return terms;
+}
+XDIAG_CATCH
+
+// Applies an OpSum with a single sweep over the input basis, where for every
+// input state all compiled terms are evaluated at once. This avoids iterating
+// over (and looking up indices in) the basis once per term. Only used if input
+// and output basis agree, otherwise falls back to matrix_generic.
+template <typename coeff_t, typename basis_t, typename fill_f>
+void matrix_fused(OpSum const &ops, basis_t const &basis_in,
+                  basis_t const &basis_out, fill_f fill,
+                  bool compiled = false) try {
+  using bit_t = typename basis_t::bit_t;
+
+  if (basis_in != basis_out) {
+    matrix_generic<coeff_t>(ops, basis_in, basis_out, fill, compiled);
+    return;
+  }
+
+  // Get OpSum into format that can be processed, unless this has already
+  // been done when building a CompiledOpSum
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::spinhalf_implementation_algebra(basis_in.nsites());
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
+
+  OpSum remainder;
+  auto terms = compile_fused<coeff_t, bit_t>(ops_compiled, remainder);
+  term_fused<coeff_t>(terms, basis_in, fill);
+
+  if (!remainder.empty()) { // remainder is normal ordered already
+    matrix_generic<coeff_t>(remainder, basis_in, basis_out, fill, true);
+  }
+}
+XDIAG_CATCH
+
+} // namespace xdiag::kernels::spinhalf
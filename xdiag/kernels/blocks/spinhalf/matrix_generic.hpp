@@ -25,11 +25,17 @@ namespace xdiag::kernels::spinhalf {
 
 template <typename coeff_t, typename basis_t, typename fill_f>
 void matrix_generic(OpSum const &ops, basis_t const &basis_in,
-                    basis_t const &basis_out, fill_f fill) try {
-  // Get OpSum into format that can be processed
-  operators::check_valid(ops);
-  auto algebra = algebra::spinhalf_implementation_algebra(basis_in.nsites());
-  auto ops_compiled = normal_order(ops.plain(), algebra);
+                    basis_t const &basis_out, fill_f fill,
+                    bool compiled = false) try {
+  // Get OpSum into format that can be processed, unless this has already
+  // been done when building a CompiledOpSum
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::spinhalf_implementation_algebra(basis_in.nsites());
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
 
   for (auto const &[c, monomial] : ops_compiled) {
     assert(monomial.size() == 1); // required for properly compiled ops
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/basis/basis_onthefly.hpp>
+#include <xdiag/basis/basis_sublattice.hpp>
+#include <xdiag/basis/basis_symmetric.hpp>
+#include <xdiag/bits/popcount.hpp>
+#include <xdiag/kernels/fill_functions.hpp>
+#include <xdiag/utils/likely.hpp>
+#include <xdiag/utils/thread_range.hpp>
+
+namespace xdiag::kernels::spinhalf {
+
+// Diagonal term whose value only depends on the parity of the spins in mask,
+// e.g. Sz_i (mask = i) or SzSz_ij (mask = i,j).
+template <typename bit_t, typename coeff_t> struct FusedDiagTerm {
+  bit_t mask;
+  coeff_t even;
+  coeff_t odd;
+};
+
+// Non-branching off-diagonal term: if (spins & mask) == match the state is
+// mapped to spins ^ mask with coefficient coeff. Exchange_ij is represented by
+// the two flips 01 -> 10 and 10 -> 01, S+_i and S-_i by a single flip.
+template <typename bit_t, typename coeff_t> struct FusedFlipTerm {
+  bit_t mask;
+  bit_t match;
+  coeff_t coeff;
+};
+
+// All terms of an OpSum which can be applied in a single sweep over the basis
+template <typename bit_t, typename coeff_t> struct FusedTerms {
+  bool has_diag = false;
+  coeff_t diag_const = 0.;
+  std::vector<FusedDiagTerm<bit_t, coeff_t>> diags;
+  std::vector<FusedFlipTerm<bit_t, coeff_t>> flips;
+};
+
+template <typename bit_t, typename coeff_t>
+inline coeff_t fused_diag_coeff(FusedTerms<bit_t, coeff_t> const &terms,
+                                bit_t spins) {
+  coeff_t coeff = terms.diag_const;
+  for (auto const &d : terms.diags) {
+    coeff += (bits::popcount(spins & d.mask) & 1) ? d.odd : d.even;
+  }
+  return coeff;
+}
+
+// Applies all terms for a single input state at once. Input and output basis
+// are required to be the same, such that the diagonal is well defined.
+template <typename coeff_t, typename enumeration_t, typename fill_f>
+void term_fused(
+    FusedTerms<typename enumeration_t::bit_t, coeff_t> const &terms,
+    basis::BasisOnTheFly<enumeration_t> const &basis, fill_f fill) {
+  using bit_t = typename enumeration_t::bit_t;
+
+#ifdef _OPENMP
+#pragma omp parallel
+  {
+    int num_thread = omp_get_thread_num();
+    auto [begin, end, idx_in] =
+        utils::thread_range(basis, num_thread, omp_get_num_threads());
+#else
+  auto [begin, end, idx_in] = utils::thread_range(basis, 0, 1);
+#endif
+    for (auto it = begin; it != end; ++it, ++idx_in) {
+      bit_t spins_in = *it;
+      if (terms.has_diag) {
+        coeff_t coeff = fused_diag_coeff(terms, spins_in);
+        XDIAG_FILL(idx_in, idx_in, coeff);
+      }
+      for (auto const &f : terms.flips) {
+        if ((spins_in & f.mask) == f.match) {
+          int64_t idx_out = basis.index(spins_in ^ f.mask);
+          XDIAG_FILL(idx_in, idx_out, f.coeff);
+        }
+      }
+    }
+#ifdef _OPENMP
+  }
+#endif
+}
+
+namespace detail {
+template <typename coeff_t, typename basis_t, typename fill_f>
+void term_fused_sym(FusedTerms<typename basis_t::bit_t, coeff_t> const &terms,
+                    basis_t const &basis, fill_f fill) {
+  using bit_t = typename basis_t::bit_t;
+
+  // conjugation necessary for definition of projected states
+  arma::Col<coeff_t> characters =
+      arma::conj(basis.characters().template as<arma::Col<coeff_t>>());
+
+#ifdef _OPENMP
+#pragma omp parallel
+  {
+    int num_thread = omp_get_thread_num();
+    auto [begin, end, idx_in] =
+        utils::thread_range(basis, num_thread, omp_get_num_threads());
+#else
+  auto [begin, end, idx_in] = utils::thread_range(basis, 0, 1);
+#endif
+    for (auto it = begin; it != end; ++it, ++idx_in) {
+      bit_t spins_in = *it;
+      if (terms.has_diag) {
+        coeff_t coeff = fused_diag_coeff(terms, spins_in);
+        XDIAG_FILL(idx_in, idx_in, coeff);
+      }
+      double inv_norm_in = basis.inv_norm(idx_in);
+      for (auto const &f : terms.flips) {
+        if ((spins_in & f.mask) == f.match) {
+          auto [raw_idx_out, sym, norm_out] = // raw_idx_out = idx_out + 1
+              basis.representative_data(spins_in ^ f.mask);
+          if (XDIAG_LIKELY(raw_idx_out)) { // raw_idx_out == 0 means 0-norm
+            coeff_t val = f.coeff * characters(sym) * norm_out * inv_norm_in;
+            XDIAG_FILL(idx_in, raw_idx_out - 1, val);
+          }
+        }
+      }
+    }
+#ifdef _OPENMP
+  }
+#endif
+}
+} // namespace detail
+
+template <typename coeff_t, typename enumeration_t, typename fill_f>
+void term_fused(
+    FusedTerms<typename enumeration_t::bit_t, coeff_t> const &terms,
+    basis::BasisSymmetric<enumeration_t> const &basis, fill_f fill) {
+  detail::term_fused_sym<coeff_t>(terms, basis, fill);
+}
+
+template <typename coeff_t, typename bit_t, int n_sublat, typename fill_f>
+void term_fused(FusedTerms<bit_t, coeff_t> const &terms,
+                basis::BasisSublattice<bit_t, n_sublat> const &basis,
+                fill_f fill) {
+  detail::term_fused_sym<coeff_t>(terms, basis, fill);
+}
+
+} // namespace xdiag::kernels::spinhalf
@@ -20,8 +20,9 @@ namespace xdiag::kernels {
 template <> struct matrix_kernel<tJ> {
   template <typename coeff_t, typename basis_t, typename fill_f>
   static void call(OpSum const &ops, basis_t const &basis_in,
-                   basis_t const &basis_out, fill_f &&fill) {
-    tj::matrix_generic<coeff_t>(ops, basis_in, basis_out, fill);
+                   basis_t const &basis_out, fill_f &&fill,
+                   bool compiled = false) {
+    tj::matrix_generic<coeff_t>(ops, basis_in, basis_out, fill, compiled);
   }
 };
 
@@ -57,15 +57,20 @@ struct is_symmetric_basis<
 // and Exchange (routed through the electron Cdag/C string kernel).
 template <typename coeff_t, typename basis_t, typename fill_f>
 void matrix_generic_symmetric(OpSum const &ops, basis_t const &basis_in,
-                              basis_t const &basis_out, fill_f fill) try {
+                              basis_t const &basis_out, fill_f fill,
+                              bool compiled = false) try {
   using bit_t = typename basis_t::bit_t;
 
-  operators::check_valid(ops);
   // No Exchange kernel for the symmetric basis: let it expand to (normal-ordered)
   // Cdag/C strings handled by the electron string kernel.
-  auto algebra = algebra::tj_implementation_algebra(basis_in.nsites(),
-                                                    /*exchange_as_kernel=*/false);
-  auto ops_compiled = normal_order(ops.plain(), algebra);
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::tj_implementation_algebra(
+        basis_in.nsites(), /*exchange_as_kernel=*/false);
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
 
   for (auto const &[c, monomial] : ops_compiled) {
     if (monomial.size() != 1) {
@@ -136,15 +141,23 @@ XDIAG_CATCH
 
 template <typename coeff_t, typename basis_t, typename fill_f>
 void matrix_generic(OpSum const &ops, basis_t const &basis_in,
-                    basis_t const &basis_out, fill_f fill) try {
+                    basis_t const &basis_out, fill_f fill,
+                    bool compiled = false) try {
 
   if constexpr (is_symmetric_basis<basis_t>::value) {
-    matrix_generic_symmetric<coeff_t>(ops, basis_in, basis_out, fill);
+    matrix_generic_symmetric<coeff_t>(ops, basis_in, basis_out, fill,
+                                      compiled);
   } else {
 
-  operators::check_valid(ops);
-  auto algebra = algebra::tj_implementation_algebra(basis_in.nsites());
-  auto ops_compiled = normal_order(ops.plain(), algebra);
+  // Get OpSum into format that can be processed, unless this has already
+  // been done when building a CompiledOpSum
+  OpSum ops_normal;
+  if (!compiled) {
+    operators::check_valid(ops);
+    auto algebra = algebra::tj_implementation_algebra(basis_in.nsites());
+    ops_normal = normal_order(ops.plain(), algebra);
+  }
+  OpSum const &ops_compiled = compiled ? ops : ops_normal;
 
   for (auto const &[c, monomial] : ops_compiled) {
     // Products of elementary operators are handled by the general Cdag/C string
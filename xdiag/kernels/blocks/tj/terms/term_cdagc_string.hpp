@@ -22,6 +22,7 @@
 #include <xdiag/operators/op.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::tj {
 
@@ -76,16 +77,16 @@ void term_cdagc_string(Coeff const &c, Monomial const &mono,
   CdagCString<bit_t> dn_str(nsites, Monomial(dn_ops), "Cdagdn", "Cdn");
   bool cross_when_odd_nup = (dn_ops.size() & 1);
 
-  auto const &basis_up = basis_in.basis_up();
-
+  utils::ThreadUtilization utilization("tj::term_cdagc_string");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
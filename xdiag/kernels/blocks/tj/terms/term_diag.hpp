@@ -15,6 +15,7 @@
 #include <xdiag/bits/popcount.hpp>
 #include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::tj {
 
@@ -51,16 +52,16 @@ void term_diag(basis::BasistJ<enumeration_t> const &basis_in,
     return;
   }
 
-  auto const &basis_up = basis_in.basis_up();
-
+  utils::ThreadUtilization utilization("tj::term_diag");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
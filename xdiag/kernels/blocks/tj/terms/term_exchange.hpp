@@ -21,6 +21,7 @@
 #include <xdiag/operators/op.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 namespace xdiag::kernels::tj {
 
@@ -59,16 +60,16 @@ void term_exchange(Coeff const &c, Op const &op,
   int64_t h = std::max(s1, s2);
   bit_t between = bits::bitmask<bit_t>(nsites, h - l - 1) << (l + 1);
 
-  auto const &basis_up = basis_in.basis_up();
-
+  utils::ThreadUtilization utilization("tj::term_exchange");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
@@ -20,6 +20,7 @@
 #include <xdiag/operators/op.hpp>
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/thread_range.hpp>
+#include <xdiag/utils/thread_utilization.hpp>
 
 // Single creation / annihilation operators on the tJ basis. They change Nup
 // (Cup/Cdagup) or Ndn (Cdn/Cdagdn) by one, so basis_in and basis_out are
@@ -50,16 +51,17 @@ void term_cdn(Coeff const &c, Op const &op,
   coeff_t cf = c.scalar().as<coeff_t>();
   int64_t s = op[0];
   bit_t sitesmask = bits::bitmask<bit_t>(nsites, nsites);
-  auto const &basis_up = basis_in.basis_up();
 
+  utils::ThreadUtilization utilization("tj::term_cdn");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
@@ -101,16 +103,17 @@ void term_cdagdn(Coeff const &c, Op const &op,
   coeff_t cf = c.scalar().as<coeff_t>();
   int64_t s = op[0];
   bit_t sitesmask = bits::bitmask<bit_t>(nsites, nsites);
-  auto const &basis_up = basis_in.basis_up();
 
+  utils::ThreadUtilization utilization("tj::term_cdagdn");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
@@ -155,16 +158,17 @@ void term_cup(Coeff const &c, Op const &op,
   bit_t mask = bits::zero<bit_t>(nsites);
   bits::set(mask, s);
   bit_t fermimask = bits::bitmask<bit_t>(nsites, s); // up below s
-  auto const &basis_up = basis_in.basis_up();
 
+  utils::ThreadUtilization utilization("tj::term_cup");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
@@ -209,16 +213,17 @@ void term_cdagup(Coeff const &c, Op const &op,
   bit_t mask = bits::zero<bit_t>(nsites);
   bits::set(mask, s);
   bit_t fermimask = bits::bitmask<bit_t>(nsites, s); // up below s
-  auto const &basis_up = basis_in.basis_up();
 
+  utils::ThreadUtilization utilization("tj::term_cdagup");
 #ifdef _OPENMP
 #pragma omp parallel
   {
     int num_thread = omp_get_thread_num();
+    auto timer = utilization.timer(num_thread);
     auto [begin_up, end_up, idx_up] =
-        utils::thread_range(basis_up, num_thread, omp_get_num_threads());
+        utils::thread_range_ups(basis_in, num_thread, omp_get_num_threads());
 #else
-    auto [begin_up, end_up, idx_up] = utils::thread_range(basis_up, 0, 1);
+    auto [begin_up, end_up, idx_up] = utils::thread_range_ups(basis_in, 0, 1);
 #endif
     for (auto it_up = begin_up; it_up != end_up; ++it_up, ++idx_up) {
       bit_t ups = *it_up;
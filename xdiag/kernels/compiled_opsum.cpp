@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "compiled_opsum.hpp"
+
+#include <chrono>
+#include <type_traits>
+#include <variant>
+
+#include <xdiag/algebra/algebra.hpp>
+#include <xdiag/algebra/ishermitian.hpp>
+#include <xdiag/algebra/normal_order.hpp>
+#include <xdiag/operators/valid.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/timing.hpp>
+
+namespace xdiag {
+
+CompiledOpSum compiled_opsum(OpSum const &ops, Block const &block,
+                             bool fused) try {
+  auto t0 = rightnow();
+  operators::check_valid(ops);
+  CompiledOpSum plan;
+  plan.ops = ops;
+  plan.block = block;
+  plan.fused = fused;
+  plan.isreal = ops.isreal();
+  // Determined in the algebra of the kernels, such that a plan can be built
+  // for every operator the apply of the block accepts
+  plan.ishermitian = ishermitian(ops, algebra::kernel_algebra(block));
+
+  // Distributed blocks normal order within their own apply, the plan then
+  // only caches the flags above.
+  bool distributed = std::visit(
+      [](auto const &b) { return is_distributed_v<std::decay_t<decltype(b)>>; },
+      block);
+  if (distributed) {
+    plan.ops_compiled = ops;
+  } else {
+    auto algebra = algebra::kernel_algebra(block);
+    plan.ops_compiled = normal_order(ops.plain(), algebra);
+  }
+
+  auto t1 = rightnow();
+  plan.build_time = std::chrono::duration<double>(t1 - t0).count();
+  Log(1, "CompiledOpSum: {} terms, {} terms normal ordered", ops.size(),
+      plan.ops_compiled.size());
+  timing(t0, t1, "CompiledOpSum build", 1);
+  return plan;
+}
+XDIAG_CATCH
+
+bool isreal(CompiledOpSum const &ops) { return ops.isreal; }
+bool ishermitian(CompiledOpSum const &ops) { return ops.ishermitian; }
+bool ishermitian(CompiledOpSum const &ops, Block const &, double) {
+  return ops.ishermitian;
+}
+
+} // namespace xdiag
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/utils/xdiag_api.hpp>
+
+namespace xdiag {
+
+// Execution plan of an OpSum on a given Block. Building the plan checks the
+// validity of ops, normal orders it with respect to the algebra the kernels of
+// the block operate in and determines whether ops is real and Hermitian. An
+// apply with a CompiledOpSum then skips these steps, which otherwise are redone
+// on every call, e.g. in every iteration of a Lanczos run or time evolution.
+struct XDIAG_API CompiledOpSum {
+  OpSum ops;          // original operator
+  OpSum ops_compiled; // ops normal ordered for the kernels of the block
+  Block block;        // block the plan has been built for
+  bool fused;         // apply all terms in a single sweep (see apply)
+  bool isreal;        // flag whether ops is real
+  bool ishermitian;   // flag whether ops is hermitian
+  double build_time;  // time in seconds it took to build the plan
+};
+
+// Builds the plan of ops on block. The plan can also be applied to other
+// blocks of the same type and number of sites (e.g. as the output block of a
+// non-conserving operator).
+XDIAG_API CompiledOpSum compiled_opsum(OpSum const &ops, Block const &block,
+                                       bool fused = false);
+
+XDIAG_API bool isreal(CompiledOpSum const &ops);
+XDIAG_API bool ishermitian(CompiledOpSum const &ops);
+
+// Block-aware overload, such that templated callers which may receive an OpSum
+// or a CompiledOpSum can invoke ishermitian(op, block) uniformly. The block and
+// tolerance are ignored.
+XDIAG_API bool ishermitian(CompiledOpSum const &ops, Block const &block,
+                           double tol = 1e-12);
+
+} // namespace xdiag
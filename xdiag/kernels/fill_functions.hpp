@@ -12,6 +12,7 @@
 #endif
 
 #include <xdiag/armadillo.hpp>
+#include <xdiag/kernels/sparse/entry_arena.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/lambda_details.hpp>
 
@@ -71,6 +72,37 @@ constexpr void fill_apply(arma::Mat<coeff_t> const &mat_in,
   }
 }
 
+// ---------------------------------------------------------------------------
+// Pull apply fill  (vec_out[idx_in] += conj(val) * vec_in[idx_out]).
+// Used for Hermitian operators where the kernel is run with input and output
+// basis exchanged, such that val = <idx_in|O|idx_out>^*. All kernels partition
+// their threads by the (here: output) index idx_in, so every element of
+// vec_out is written by a single thread and no atomics are needed.
+// ---------------------------------------------------------------------------
+
+template <typename coeff_t>
+inline void fill_apply_pull(coeff_t const *vec_in, coeff_t *vec_out,
+                            int64_t idx_in, int64_t idx_out, coeff_t val) {
+  vec_out[idx_in] += conj(val) * vec_in[idx_out];
+}
+
+template <typename coeff_t>
+constexpr void fill_apply_pull(arma::Col<coeff_t> const &vec_in,
+                               arma::Col<coeff_t> &vec_out, int64_t idx_in,
+                               int64_t idx_out, coeff_t val) {
+  fill_apply_pull(vec_in.memptr(), vec_out.memptr(), idx_in, idx_out, val);
+}
+
+template <typename coeff_t>
+constexpr void fill_apply_pull(arma::Mat<coeff_t> const &mat_in,
+                               arma::Mat<coeff_t> &mat_out, int64_t idx_in,
+                               int64_t idx_out, coeff_t val) {
+  for (int i = 0; i < mat_in.n_cols; i++) {
+    fill_apply_pull(mat_in.colptr(i), mat_out.colptr(i), idx_in, idx_out,
+                    val);
+  }
+}
+
 // ---------------------------------------------------------------------------
 // COO NNZ counting.
 // Two overloads: the compiler (via #ifdef _OPENMP in the caller) selects the
@@ -116,6 +148,22 @@ inline void fill_coo(idx_t *rows, idx_t *cols, coeff_t *data, int64_t &k,
 }
 #endif
 
+// ---------------------------------------------------------------------------
+// Stored triangle of the sparse builders. Hermitian matrices can be built with
+// only the entries on and above (upper) or on and below (lower) the diagonal.
+// The row of an entry is idx_out and its column idx_in, also for CSC.
+// ---------------------------------------------------------------------------
+
+constexpr int triangle_full = 0;
+constexpr int triangle_upper = 1;
+constexpr int triangle_lower = 2;
+
+inline bool in_triangle(int triangle, int64_t idx_in, int64_t idx_out) {
+  return (triangle == triangle_full) ||
+         ((triangle == triangle_upper) ? (idx_in >= idx_out)
+                                       : (idx_in <= idx_out));
+}
+
 // ---------------------------------------------------------------------------
 // CSR NNZ counting (per-row).
 // Uniform across OMP/serial: omp atomic update handles concurrent increments.
@@ -147,6 +195,23 @@ inline void fill_csr(std::vector<int64_t> &offset, idx_t *col, coeff_t *data,
   data[k] = val;
 }
 
+// ---------------------------------------------------------------------------
+// Single-pass CSR fill.
+// Counts the entry of its group (as fill_csr_count) and appends it to the
+// arena of the calling thread, which no other thread writes to.
+// ---------------------------------------------------------------------------
+
+template <typename coeff_t>
+inline void fill_csr_entry(EntryArenas<coeff_t> &arenas,
+                           std::vector<int64_t> &n_elements, int64_t idx_in,
+                           int64_t idx_out, coeff_t val, bool transpose,
+                           int num_thread) {
+  int64_t group = transpose ? idx_in : idx_out;
+  int64_t idx = transpose ? idx_out : idx_in;
+  fill_csr_count(n_elements, group);
+  arenas.push(num_thread, group, idx, val);
+}
+
 } // namespace xdiag::kernels
 
 // ---------------------------------------------------------------------------
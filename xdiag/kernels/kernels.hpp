@@ -23,9 +23,17 @@
 
 namespace xdiag::kernels {
 
+template <typename coeff_t> class EntryArenas;
+
+// With fused = true, blocks providing a fused kernel apply all terms in a
+// single sweep over the basis. Other blocks ignore the flag. With pull = true
+// the kernel iterates over basis_out and gathers from mat_in, which avoids
+// atomic updates but is only valid for Hermitian ops. With compiled = true,
+// ops must already be validated and normal ordered for the block.
 template <typename block_t, typename basis_t, typename mat_t>
 void apply(OpSum const &ops, basis_t const &basis_in, mat_t const &mat_in,
-           basis_t const &basis_out, mat_t &mat_out);
+           basis_t const &basis_out, mat_t &mat_out, bool fused = false,
+           bool pull = false, bool compiled = false);
 
 template <typename block_t, typename coeff_t, typename basis_t>
 void matrix(OpSum const &ops, basis_t const &basis_in, basis_t const &basis_out,
@@ -56,16 +64,30 @@ void coo_matrix_fill(OpSum const &ops, basis_t const &basis_in,
                      coeff_t *data, idx_t i0);
 #endif
 
+// The CSR builders only keep the entries within the given triangle
+// (triangle_full, triangle_upper or triangle_lower, cf. fill_functions.hpp).
 template <typename block_t, typename coeff_t, typename basis_t>
 std::vector<int64_t> csr_matrix_nnz(OpSum const &ops, basis_t const &basis_in,
                                     basis_t const &basis_out,
-                                    bool transpose = false);
+                                    bool transpose = false, int triangle = 0);
 
 template <typename block_t, typename coeff_t, typename basis_t,
           typename idx_t>
 void csr_matrix_fill(OpSum const &ops, basis_t const &basis_in,
                      basis_t const &basis_out, std::vector<int64_t> &offset,
                      idx_t *col, coeff_t *data, idx_t i0,
-                     bool transpose = false);
+                     bool transpose = false, int triangle = 0);
+
+// Single-pass alternative to csr_matrix_nnz / csr_matrix_fill: runs the kernel
+// once, appending every entry to the arena of the producing thread and
+// counting the entries per row (per column if transpose). The returned counts
+// are complete even if the arenas overflow their budget.
+template <typename block_t, typename coeff_t, typename basis_t>
+std::vector<int64_t> csr_matrix_entries(OpSum const &ops,
+                                        basis_t const &basis_in,
+                                        basis_t const &basis_out,
+                                        EntryArenas<coeff_t> &arenas,
+                                        bool transpose = false,
+                                        int triangle = 0);
 
 } // namespace xdiag::kernels
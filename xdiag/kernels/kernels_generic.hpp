@@ -6,10 +6,12 @@
 
 #include <functional>
 #include <numeric>
+#include <type_traits>
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/kernels/kernels.hpp>
+#include <xdiag/kernels/sparse/entry_arena.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/utils/error.hpp>
 
@@ -32,6 +34,16 @@ namespace xdiag::kernels {
 // specialization for its own block before instantiating the kernels below.
 template <typename block_t> struct matrix_kernel;
 
+// A block can additionally provide a fused kernel, matrix_kernel<Block>::
+// call_fused, which applies all terms of an OpSum in a single sweep over the
+// basis. It then sets matrix_kernel<Block>::has_fused = true.
+template <typename block_t, typename = void>
+struct has_fused_kernel : std::false_type {};
+template <typename block_t>
+struct has_fused_kernel<block_t,
+                        std::void_t<decltype(matrix_kernel<block_t>::has_fused)>>
+    : std::bool_constant<matrix_kernel<block_t>::has_fused> {};
+
 // Type-erased fill callbacks used by the one-shot matrix-construction paths
 // (matrix / coo / csr). Routing these through a single erased type collapses
 // the per-fill-variant instantiations of matrix_generic (and all term_*
@@ -43,16 +55,45 @@ using fill_t = std::function<void(int64_t, int64_t, coeff_t)>;
 template <typename coeff_t>
 using fill_omp_t = std::function<void(int64_t, int64_t, coeff_t, int)>;
 
+// Runs the fused kernel of a block if requested and available, otherwise the
+// term-by-term matrix_generic kernel. With compiled = true, ops is expected to
+// be validated and normal ordered already (see CompiledOpSum).
+template <typename block_t, typename coeff_t, typename basis_t,
+          typename fill_f>
+void call_matrix_kernel(OpSum const &ops, basis_t const &basis_in,
+                        basis_t const &basis_out, bool fused, bool compiled,
+                        fill_f &&fill) {
+  if constexpr (has_fused_kernel<block_t>::value) {
+    if (fused) {
+      matrix_kernel<block_t>::template call_fused<coeff_t>(
+          ops, basis_in, basis_out, fill, compiled);
+      return;
+    }
+  }
+  matrix_kernel<block_t>::template call<coeff_t>(ops, basis_in, basis_out,
+                                                 fill, compiled);
+}
+
 template <typename block_t, typename basis_t, typename mat_t>
 void apply(OpSum const &ops, basis_t const &basis_in, mat_t const &mat_in,
-           basis_t const &basis_out, mat_t &mat_out) try {
+           basis_t const &basis_out, mat_t &mat_out, bool fused, bool pull,
+           bool compiled) try {
   using coeff_t = typename mat_t::elem_type;
   mat_out.zeros();
-  matrix_kernel<block_t>::template call<coeff_t>(
-      ops, basis_in, basis_out,
-      [&](int64_t idx_in, int64_t idx_out, coeff_t val) {
-        fill_apply(mat_in, mat_out, idx_in, idx_out, val);
-      });
+  if (pull) {
+    // Hermitian ops: iterate over basis_out and gather from mat_in
+    call_matrix_kernel<block_t, coeff_t>(
+        ops, basis_out, basis_in, fused, compiled,
+        [&](int64_t idx_in, int64_t idx_out, coeff_t val) {
+          fill_apply_pull(mat_in, mat_out, idx_in, idx_out, val);
+        });
+  } else {
+    call_matrix_kernel<block_t, coeff_t>(
+        ops, basis_in, basis_out, fused, compiled,
+        [&](int64_t idx_in, int64_t idx_out, coeff_t val) {
+          fill_apply(mat_in, mat_out, idx_in, idx_out, val);
+        });
+  }
 }
 XDIAG_CATCH
 
@@ -137,22 +178,26 @@ XDIAG_CATCH
 
 template <typename block_t, typename coeff_t, typename basis_t>
 std::vector<int64_t> csr_matrix_nnz(OpSum const &ops, basis_t const &basis_in,
-                                    basis_t const &basis_out,
-                                    bool transpose) try {
+                                    basis_t const &basis_out, bool transpose,
+                                    int triangle) try {
   if (transpose) {
     std::vector<int64_t> n_elements(basis_in.size(), 0);
     matrix_kernel<block_t>::template call<coeff_t>(
         ops, basis_in, basis_out,
-        fill_t<coeff_t>([&](int64_t idx_in, int64_t, coeff_t) {
-          fill_csr_count(n_elements, idx_in);
+        fill_t<coeff_t>([&](int64_t idx_in, int64_t idx_out, coeff_t) {
+          if (in_triangle(triangle, idx_in, idx_out)) {
+            fill_csr_count(n_elements, idx_in);
+          }
         }));
     return n_elements;
   } else {
     std::vector<int64_t> n_elements(basis_out.size(), 0);
     matrix_kernel<block_t>::template call<coeff_t>(
         ops, basis_in, basis_out,
-        fill_t<coeff_t>([&](int64_t, int64_t idx_out, coeff_t) {
-          fill_csr_count(n_elements, idx_out);
+        fill_t<coeff_t>([&](int64_t idx_in, int64_t idx_out, coeff_t) {
+          if (in_triangle(triangle, idx_in, idx_out)) {
+            fill_csr_count(n_elements, idx_out);
+          }
         }));
     return n_elements;
   }
@@ -163,25 +208,63 @@ template <typename block_t, typename coeff_t, typename basis_t,
           typename idx_t>
 void csr_matrix_fill(OpSum const &ops, basis_t const &basis_in,
                      basis_t const &basis_out, std::vector<int64_t> &offset,
-                     idx_t *col, coeff_t *data, idx_t i0, bool transpose) try {
+                     idx_t *col, coeff_t *data, idx_t i0, bool transpose,
+                     int triangle) try {
   if (transpose) {
     // CSC: key by column (idx_in), store row (idx_out)
     matrix_kernel<block_t>::template call<coeff_t>(
         ops, basis_in, basis_out,
         fill_t<coeff_t>([&](int64_t idx_in, int64_t idx_out, coeff_t val) {
-          fill_csr(offset, col, data, idx_out, idx_in, val, i0);
+          if (in_triangle(triangle, idx_in, idx_out)) {
+            fill_csr(offset, col, data, idx_out, idx_in, val, i0);
+          }
         }));
   } else {
     // CSR: key by row (idx_out), store column (idx_in)
     matrix_kernel<block_t>::template call<coeff_t>(
         ops, basis_in, basis_out,
         fill_t<coeff_t>([&](int64_t idx_in, int64_t idx_out, coeff_t val) {
-          fill_csr(offset, col, data, idx_in, idx_out, val, i0);
+          if (in_triangle(triangle, idx_in, idx_out)) {
+            fill_csr(offset, col, data, idx_in, idx_out, val, i0);
+          }
         }));
   }
 }
 XDIAG_CATCH
 
+template <typename block_t, typename coeff_t, typename basis_t>
+std::vector<int64_t> csr_matrix_entries(OpSum const &ops,
+                                        basis_t const &basis_in,
+                                        basis_t const &basis_out,
+                                        EntryArenas<coeff_t> &arenas,
+                                        bool transpose, int triangle) try {
+  std::vector<int64_t> n_elements(transpose ? basis_in.size()
+                                            : basis_out.size(),
+                                  0);
+#ifdef _OPENMP
+  matrix_kernel<block_t>::template call<coeff_t>(
+      ops, basis_in, basis_out,
+      fill_omp_t<coeff_t>(
+          [&](int64_t idx_in, int64_t idx_out, coeff_t val, int num_thread) {
+            if (in_triangle(triangle, idx_in, idx_out)) {
+              fill_csr_entry(arenas, n_elements, idx_in, idx_out, val,
+                             transpose, num_thread);
+            }
+          }));
+#else
+  matrix_kernel<block_t>::template call<coeff_t>(
+      ops, basis_in, basis_out,
+      fill_t<coeff_t>([&](int64_t idx_in, int64_t idx_out, coeff_t val) {
+        if (in_triangle(triangle, idx_in, idx_out)) {
+          fill_csr_entry(arenas, n_elements, idx_in, idx_out, val, transpose,
+                         0);
+        }
+      }));
+#endif
+  return n_elements;
+}
+XDIAG_CATCH
+
 } // namespace xdiag::kernels
 
 // ---------------------------------------------------------------------------
@@ -193,7 +276,8 @@ XDIAG_CATCH
 
 #define XDIAG_INSTANTIATE_APPLY(BLOCK, BASIS, MAT)                                   \
   template void xdiag::kernels::apply<BLOCK, BASIS, MAT>(                     \
-      OpSum const &, BASIS const &, MAT const &, BASIS const &, MAT &);
+      OpSum const &, BASIS const &, MAT const &, BASIS const &, MAT &, bool,  \
+      bool, bool);
 
 #define XDIAG_INSTANTIATE_MATRIX(BLOCK, BASIS, COEFF)                                \
   template void xdiag::kernels::matrix<BLOCK, COEFF, BASIS>(                  \
@@ -224,12 +308,18 @@ XDIAG_CATCH
 #define XDIAG_INSTANTIATE_CSR_NNZ(BLOCK, BASIS, COEFF)                               \
   template std::vector<int64_t>                                                \
   xdiag::kernels::csr_matrix_nnz<BLOCK, COEFF, BASIS>(                        \
-      OpSum const &, BASIS const &, BASIS const &, bool);
+      OpSum const &, BASIS const &, BASIS const &, bool, int);
 #define XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, IDX, COEFF)                         \
   template void                                                                \
   xdiag::kernels::csr_matrix_fill<BLOCK, COEFF, BASIS, IDX>(                  \
       OpSum const &, BASIS const &, BASIS const &, std::vector<int64_t> &,     \
-      IDX *, COEFF *, IDX, bool);
+      IDX *, COEFF *, IDX, bool, int);
+
+#define XDIAG_INSTANTIATE_CSR_ENTRIES(BLOCK, BASIS, COEFF)                           \
+  template std::vector<int64_t>                                                \
+  xdiag::kernels::csr_matrix_entries<BLOCK, COEFF, BASIS>(                    \
+      OpSum const &, BASIS const &, BASIS const &,                            \
+      xdiag::kernels::EntryArenas<COEFF> &, bool, int);
 
 #define XDIAG_INSTANTIATE_KERNELS(BLOCK, BASIS)                                      \
   XDIAG_INSTANTIATE_APPLY(BLOCK, BASIS, vec)                                         \
@@ -249,7 +339,9 @@ XDIAG_CATCH
   XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, int32_t, double)                          \
   XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, int32_t, complex)                         \
   XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, int64_t, double)                          \
-  XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, int64_t, complex)
+  XDIAG_INSTANTIATE_CSR_FILL(BLOCK, BASIS, int64_t, complex)                         \
+  XDIAG_INSTANTIATE_CSR_ENTRIES(BLOCK, BASIS, double)                                \
+  XDIAG_INSTANTIATE_CSR_ENTRIES(BLOCK, BASIS, complex)
 
 // Boson bases share a set of BitArray / BitArrayLong backends for a given
 // (basis class, enumeration). Only the widths {1,2,3,4,8} are compiled; states
@@ -7,10 +7,18 @@
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/format.hpp>
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
 #ifdef XDIAG_USE_SPARSE_MKL
 #include <complex>
 #include <type_traits>
@@ -95,6 +103,45 @@ template arma::cx_mat apply(CSRMatrix<int32_t, double> const &spmat,
 template arma::cx_mat apply(CSRMatrix<int64_t, double> const &spmat,
                             arma::cx_mat const &mat_in);
 
+// Matrices storing only a triangle have to be square and Hermitian, and the
+// columns of every row have to be sorted (see apply_triangle)
+template <typename idx_t, typename coeff_t>
+static void check_triangle(CSRMatrix<idx_t, coeff_t> const &A) try {
+  if ((A.triangle != "full") && (A.triangle != "upper") &&
+      (A.triangle != "lower")) {
+    XDIAG_THROW(fmt::format("Invalid triangle \"{}\". Must be either "
+                            "\"full\", \"upper\" or \"lower\"",
+                            A.triangle));
+  }
+  if (A.triangle == "full") {
+    return;
+  }
+  if (!A.ishermitian || (A.nrows != A.ncols)) {
+    XDIAG_THROW(fmt::format(
+        "CSRMatrix storing only its {} triangle must be square and Hermitian",
+        A.triangle));
+  }
+  int64_t n = A.nrows;
+  idx_t const *rowptr = A.rowptr.memptr();
+  idx_t const *C = A.col.memptr() - A.i0;
+  bool sorted = true;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(&& : sorted)
+#endif
+  for (int64_t i = 0; i < n; ++i) {
+    for (idx_t jj = rowptr[i] + 1; jj < rowptr[i + 1]; ++jj) {
+      sorted = sorted && (C[jj - 1] < C[jj]);
+    }
+  }
+  if (!sorted) {
+    XDIAG_THROW(fmt::format("CSRMatrix storing only its {} triangle must have "
+                            "the columns of every row sorted in ascending "
+                            "order",
+                            A.triangle));
+  }
+}
+XDIAG_CATCH
+
 #ifdef XDIAG_USE_SPARSE_MKL
 template <typename coeff_t>
 static void apply_mkl(CSRMatrix<int64_t, coeff_t> const &A,
@@ -113,8 +160,12 @@ static void apply_mkl(CSRMatrix<int64_t, coeff_t> const &A,
   sparse_index_base_t i0 =
       (A.i0 == 0) ? SPARSE_INDEX_BASE_ZERO : SPARSE_INDEX_BASE_ONE;
 
+  // Hermitian matrices are read from the lower triangle, unless only the
+  // upper one is stored
+  check_triangle(A);
   matrix_descr descr;
-  descr.mode = SPARSE_FILL_MODE_LOWER;
+  descr.mode = (A.triangle == "upper") ? SPARSE_FILL_MODE_UPPER
+                                       : SPARSE_FILL_MODE_LOWER;
   descr.diag = SPARSE_DIAG_NON_UNIT;
 
   MKL_INT nrows = A.nrows;
@@ -192,6 +243,118 @@ template void apply_mkl(CSRMatrix<int64_t, complex> const &,
                         arma::cx_vec const &, arma::cx_vec &);
 #endif
 
+// Product of a Hermitian matrix of which only the upper or lower triangle,
+// including the diagonal, is stored with nvec vectors X (column-major, n rows).
+// Every stored off-diagonal entry A_ij also contributes conj(A_ij) X_i to Y_j.
+// The rows are split into one contiguous range per thread with balanced
+// numbers of entries. First, every range computes its rows of Y from its
+// stored entries and adds the adjoint entries falling into the range itself.
+// The adjoint entries of range r falling into range s are added in round m,
+// where s = r + m for the upper and s = r + m - nranges for the lower
+// triangle. The ranges written to in a round are distinct, such that neither
+// atomic updates nor buffers are needed. As the entries of a row are sorted by
+// column, every row keeps the position of its next adjoint entry in a cursor.
+template <typename idx_t, typename coeff_csr_t, typename coeff_vec_t>
+static void apply_triangle(CSRMatrix<idx_t, coeff_csr_t> const &A,
+                           coeff_vec_t const *X, coeff_vec_t *Y,
+                           int64_t nvec) try {
+  check_triangle(A);
+  bool upper = (A.triangle == "upper");
+  int64_t n = A.nrows;
+  idx_t i0 = A.i0;
+  idx_t const *rowptr = A.rowptr.memptr();
+  const coeff_csr_t *D = A.data.memptr() - i0;
+  const idx_t *C = A.col.memptr() - i0;
+
+  int64_t nranges = 1;
+#ifdef _OPENMP
+  nranges = std::max((int64_t)1, std::min((int64_t)omp_get_max_threads(), n));
+#endif
+  std::vector<int64_t> bounds(nranges + 1, n);
+  bounds[0] = 0;
+  int64_t nnz = rowptr[n] - rowptr[0];
+  for (int64_t r = 1; r < nranges; ++r) {
+    idx_t target = rowptr[0] + (idx_t)(nnz * r / nranges);
+    bounds[r] = std::lower_bound(rowptr, rowptr + n + 1, target) - rowptr;
+  }
+
+  std::vector<idx_t> cursor(n);
+  bool valid = true;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+#ifdef _OPENMP
+#pragma omp for schedule(static, 1) reduction(&& : valid)
+#endif
+    for (int64_t r = 0; r < nranges; ++r) {
+      int64_t begin = bounds[r];
+      int64_t end = bounds[r + 1];
+      for (int64_t vec = 0; vec < nvec; ++vec) {
+        std::fill(Y + vec * n + begin, Y + vec * n + end, coeff_vec_t(0.));
+      }
+      for (int64_t i = begin; i < end; ++i) {
+        cursor[i] = upper ? rowptr[i + 1] : rowptr[i];
+        for (idx_t jj = rowptr[i]; jj < rowptr[i + 1]; ++jj) {
+          int64_t j = C[jj] - i0;
+          coeff_vec_t val = (coeff_vec_t)D[jj];
+          if (j == i) {
+            for (int64_t vec = 0; vec < nvec; ++vec) {
+              Y[vec * n + i] += val * X[vec * n + i];
+            }
+            continue;
+          } else if (upper ? (j < i) : (j > i)) {
+            valid = false;
+            continue;
+          }
+          for (int64_t vec = 0; vec < nvec; ++vec) {
+            Y[vec * n + i] += val * X[vec * n + j];
+          }
+          if ((j >= begin) && (j < end)) {
+            coeff_vec_t valc = (coeff_vec_t)conj(D[jj]);
+            for (int64_t vec = 0; vec < nvec; ++vec) {
+              Y[vec * n + j] += valc * X[vec * n + i];
+            }
+          } else if (upper && (cursor[i] == rowptr[i + 1])) {
+            cursor[i] = jj;
+          }
+        }
+      }
+    }
+
+    // the ranges s of the later rounds increase for every range r
+    for (int64_t m = 1; m < nranges; ++m) {
+#ifdef _OPENMP
+#pragma omp for schedule(static, 1)
+#endif
+      for (int64_t r = 0; r < nranges; ++r) {
+        int64_t s = upper ? r + m : r + m - nranges;
+        if ((s < 0) || (s >= nranges)) {
+          continue;
+        }
+        idx_t last = (idx_t)(bounds[s + 1] + i0);
+        for (int64_t i = bounds[r]; i < bounds[r + 1]; ++i) {
+          idx_t jj = cursor[i];
+          for (; (jj < rowptr[i + 1]) && (C[jj] < last); ++jj) {
+            int64_t j = C[jj] - i0;
+            coeff_vec_t valc = (coeff_vec_t)conj(D[jj]);
+            for (int64_t vec = 0; vec < nvec; ++vec) {
+              Y[vec * n + j] += valc * X[vec * n + i];
+            }
+          }
+          cursor[i] = jj;
+        }
+      }
+    }
+  }
+  if (!valid) {
+    XDIAG_THROW(fmt::format("CSRMatrix storing only its {} triangle has an "
+                            "entry in the other triangle",
+                            A.triangle));
+  }
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_csr_t, typename coeff_vec_t>
 static void apply(CSRMatrix<idx_t, coeff_csr_t> const &A,
                   arma::Col<coeff_vec_t> const &vec_in,
@@ -215,6 +378,11 @@ static void apply(CSRMatrix<idx_t, coeff_csr_t> const &A,
         m, n, vec_in.n_rows, vec_out.n_rows))
   }
 
+  if (A.triangle != "full") {
+    apply_triangle(A, vec_in.memptr(), vec_out.memptr(), 1);
+    return;
+  }
+
   // Shift data/col pointers by i0 so the inner loop body is identical for
   // both 0-based (i0==0) and 1-based (i0==1) storage.
   const coeff_csr_t *D = A.data.memptr() - i0;
@@ -291,6 +459,12 @@ static void apply(CSRMatrix<idx_t, coeff_csr_t> const &A,
         m, n, mat_in.n_rows, mat_in.n_cols, mat_out.n_rows, mat_out.n_cols));
   }
 
+  if (A.triangle != "full") {
+    apply_triangle(A, mat_in.memptr(), mat_out.memptr(),
+                   (int64_t)mat_in.n_cols);
+    return;
+  }
+
   // implementation adapted from
   // https://stackoverflow.com/questions/76905042/what-is-wrong-with-my-sparse-matrix-multiple-vectors-spmm-product-function-for
   idx_t nvec = mat_out.n_cols;
@@ -349,4 +523,431 @@ template void apply(CSRMatrix<int32_t, double> const &, arma::cx_mat const &,
 template void apply(CSRMatrix<int64_t, double> const &, arma::cx_mat const &,
                     arma::cx_mat &);
 
+// Product of one chunk of a real SELL matrix with nvec real vectors, where the
+// chunk has C rows and width entries per row. Lanes of SIMD registers hold
+// consecutive rows, such that every step loads the entries and columns of all
+// lanes contiguously and gathers the corresponding vector entries.
+template <typename idx_t>
+static inline void sell_chunk_real(int64_t C, int64_t width, idx_t const *col,
+                                   double const *data, double const *X,
+                                   int64_t n, int64_t nvec, double *y) {
+  int64_t r = 0;
+#if defined(__AVX512F__)
+  auto gather = [](idx_t const *c, double const *x) {
+    if constexpr (sizeof(idx_t) == 4) {
+      __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(c));
+      return _mm512_i32gather_pd(idx, x, 8);
+    } else {
+      __m512i idx = _mm512_loadu_si512(c);
+      return _mm512_i64gather_pd(idx, x, 8);
+    }
+  };
+  for (; r + 8 <= C; r += 8) {
+    if (nvec == 1) {
+      __m512d acc = _mm512_setzero_pd();
+      for (int64_t j = 0; j < width; ++j) {
+        __m512d v = _mm512_loadu_pd(data + j * C + r);
+        acc = _mm512_fmadd_pd(v, gather(col + j * C + r, X), acc);
+      }
+      _mm512_storeu_pd(y + r, acc);
+    } else {
+      for (int64_t vec = 0; vec < nvec; ++vec) {
+        _mm512_storeu_pd(y + vec * C + r, _mm512_setzero_pd());
+      }
+      for (int64_t j = 0; j < width; ++j) {
+        __m512d v = _mm512_loadu_pd(data + j * C + r);
+        for (int64_t vec = 0; vec < nvec; ++vec) {
+          double *yv = y + vec * C + r;
+          __m512d xg = gather(col + j * C + r, X + vec * n);
+          _mm512_storeu_pd(yv, _mm512_fmadd_pd(v, xg, _mm512_loadu_pd(yv)));
+        }
+      }
+    }
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  auto gather = [](idx_t const *c, double const *x) {
+    if constexpr (sizeof(idx_t) == 4) {
+      __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const *>(c));
+      return _mm256_i32gather_pd(x, idx, 8);
+    } else {
+      __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(c));
+      return _mm256_i64gather_pd(x, idx, 8);
+    }
+  };
+  for (; r + 4 <= C; r += 4) {
+    if (nvec == 1) {
+      __m256d acc = _mm256_setzero_pd();
+      for (int64_t j = 0; j < width; ++j) {
+        __m256d v = _mm256_loadu_pd(data + j * C + r);
+        acc = _mm256_fmadd_pd(v, gather(col + j * C + r, X), acc);
+      }
+      _mm256_storeu_pd(y + r, acc);
+    } else {
+      for (int64_t vec = 0; vec < nvec; ++vec) {
+        _mm256_storeu_pd(y + vec * C + r, _mm256_setzero_pd());
+      }
+      for (int64_t j = 0; j < width; ++j) {
+        __m256d v = _mm256_loadu_pd(data + j * C + r);
+        for (int64_t vec = 0; vec < nvec; ++vec) {
+          double *yv = y + vec * C + r;
+          __m256d xg = gather(col + j * C + r, X + vec * n);
+          _mm256_storeu_pd(yv, _mm256_fmadd_pd(v, xg, _mm256_loadu_pd(yv)));
+        }
+      }
+    }
+  }
+#endif
+  // remaining lanes, or all lanes without SIMD support
+  if (r < C) {
+    for (int64_t vec = 0; vec < nvec; ++vec) {
+      std::fill(y + vec * C + r, y + vec * C + C, 0.);
+    }
+    for (int64_t j = 0; j < width; ++j) {
+      for (int64_t rr = r; rr < C; ++rr) {
+        double val = data[j * C + rr];
+        idx_t c = col[j * C + rr];
+        for (int64_t vec = 0; vec < nvec; ++vec) {
+          y[vec * C + rr] += val * X[vec * n + c];
+        }
+      }
+    }
+  }
+}
+
+// Y = A * X for a SELL matrix and nvec column-major vectors. Every thread
+// computes whole chunks into a local buffer and writes the rows back to their
+// original position.
+template <typename idx_t, typename coeff_sell_t, typename coeff_vec_t>
+static void apply_sell(SELLMatrix<idx_t, coeff_sell_t> const &A,
+                       coeff_vec_t const *X, coeff_vec_t *Y, int64_t nvec) {
+  int64_t m = A.nrows;
+  int64_t n = A.ncols;
+  int64_t C = A.C;
+  int64_t nchunks = (int64_t)A.chunkptr.n_elem - 1;
+  idx_t const *perm = A.perm.memptr();
+  idx_t const *chunkptr = A.chunkptr.memptr();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<coeff_vec_t> y(C * nvec);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+    for (int64_t k = 0; k < nchunks; ++k) {
+      int64_t start = chunkptr[k];
+      int64_t width = (chunkptr[k + 1] - start) / C;
+      idx_t const *col = A.col.memptr() + start;
+      coeff_sell_t const *data = A.data.memptr() + start;
+      if constexpr (std::is_same_v<coeff_sell_t, double> &&
+                    std::is_same_v<coeff_vec_t, double>) {
+        sell_chunk_real(C, width, col, data, X, n, nvec, y.data());
+      } else {
+        std::fill(y.begin(), y.end(), coeff_vec_t(0.));
+        for (int64_t j = 0; j < width; ++j) {
+          for (int64_t r = 0; r < C; ++r) {
+            coeff_vec_t val = (coeff_vec_t)data[j * C + r];
+            idx_t c = col[j * C + r];
+            for (int64_t vec = 0; vec < nvec; ++vec) {
+              y[vec * C + r] += val * X[vec * n + c];
+            }
+          }
+        }
+      }
+      int64_t nlanes = std::min(C, m - k * C);
+      for (int64_t r = 0; r < nlanes; ++r) {
+        int64_t row = perm[k * C + r];
+        for (int64_t vec = 0; vec < nvec; ++vec) {
+          Y[vec * m + row] = y[vec * C + r];
+        }
+      }
+    }
+  }
+}
+
+template <typename idx_t, typename coeff_sell_t, typename coeff_mat_t>
+static void apply(SELLMatrix<idx_t, coeff_sell_t> const &A,
+                  arma::Mat<coeff_mat_t> const &mat_in,
+                  arma::Mat<coeff_mat_t> &mat_out) try {
+  static_assert(!(isreal<coeff_mat_t>() && !isreal<coeff_sell_t>()));
+  int64_t m = A.nrows;
+  int64_t n = A.ncols;
+  if ((m != (int64_t)mat_out.n_rows) || (n != (int64_t)mat_in.n_rows) ||
+      (mat_in.n_cols != mat_out.n_cols)) {
+    XDIAG_THROW(fmt::format(
+        "Incompatible sparse matrix and matrix dimensions A*X=Y, sparse matrix "
+        "A: ({} x {}), X: ({} x {}), Y: ({} x {})",
+        m, n, mat_in.n_rows, mat_in.n_cols, mat_out.n_rows, mat_out.n_cols));
+  }
+  if ((A.C < 1) || ((int64_t)A.chunkptr.n_elem != (m + A.C - 1) / A.C + 1)) {
+    XDIAG_THROW(fmt::format(
+        "Number of chunkptr entries ({}) does not match number of rows ({}) "
+        "and chunk height ({})",
+        A.chunkptr.n_elem, m, A.C));
+  }
+  apply_sell(A, mat_in.memptr(), mat_out.memptr(), (int64_t)mat_in.n_cols);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_sell_t, typename coeff_vec_t>
+static void apply(SELLMatrix<idx_t, coeff_sell_t> const &A,
+                  arma::Col<coeff_vec_t> const &vec_in,
+                  arma::Col<coeff_vec_t> &vec_out) try {
+  // vectors are viewed as single column matrices without copying
+  arma::Mat<coeff_vec_t> mat_in(const_cast<coeff_vec_t *>(vec_in.memptr()),
+                                vec_in.n_rows, 1, false, true);
+  arma::Mat<coeff_vec_t> mat_out(vec_out.memptr(), vec_out.n_rows, 1, false,
+                                 true);
+  apply<idx_t, coeff_sell_t, coeff_vec_t>(A, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+arma::Col<coeff_t> apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                         arma::Col<coeff_t> const &vec_in) try {
+  auto vec_out = arma::Col<coeff_t>(spmat.nrows);
+  apply<idx_t, coeff_t, coeff_t>(spmat, vec_in, vec_out);
+  return vec_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+arma::Col<complex> apply(SELLMatrix<idx_t, double> const &spmat,
+                         arma::Col<complex> const &vec_in) try {
+  auto vec_out = arma::Col<complex>(spmat.nrows);
+  apply<idx_t, double, complex>(spmat, vec_in, vec_out);
+  return vec_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+arma::Mat<coeff_t> apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                         arma::Mat<coeff_t> const &mat_in) try {
+  auto mat_out = arma::Mat<coeff_t>(spmat.nrows, mat_in.n_cols);
+  apply<idx_t, coeff_t, coeff_t>(spmat, mat_in, mat_out);
+  return mat_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+arma::Mat<complex> apply(SELLMatrix<idx_t, double> const &spmat,
+                         arma::Mat<complex> const &mat_in) try {
+  auto mat_out = arma::Mat<complex>(spmat.nrows, mat_in.n_cols);
+  apply<idx_t, double, complex>(spmat, mat_in, mat_out);
+  return mat_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+void apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+           arma::Col<coeff_t> const &vec_in, arma::Col<coeff_t> &vec_out) try {
+  apply<idx_t, coeff_t, coeff_t>(spmat, vec_in, vec_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+void apply(SELLMatrix<idx_t, double> const &spmat,
+           arma::Col<complex> const &vec_in, arma::Col<complex> &vec_out) try {
+  apply<idx_t, double, complex>(spmat, vec_in, vec_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+void apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+           arma::Mat<coeff_t> const &mat_in, arma::Mat<coeff_t> &mat_out) try {
+  apply<idx_t, coeff_t, coeff_t>(spmat, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+void apply(SELLMatrix<idx_t, double> const &spmat,
+           arma::Mat<complex> const &mat_in, arma::Mat<complex> &mat_out) try {
+  apply<idx_t, double, complex>(spmat, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+// Y = A * X for a value-indexed CSR matrix and nvec column-major vectors
+template <typename idx_t, typename coeff_csr_t, typename coeff_vec_t,
+          typename validx_t>
+static void apply_csrvi(CSRVIMatrix<idx_t, coeff_csr_t> const &A,
+                        validx_t const *validx, coeff_vec_t const *X,
+                        coeff_vec_t *Y, int64_t nvec) {
+  int64_t m = A.nrows;
+  int64_t n = A.ncols;
+  idx_t const *rowptr = A.rowptr.memptr();
+  uint32_t const *coldelta = A.coldelta.memptr();
+  coeff_csr_t const *values = A.values.memptr();
+  if (nvec == 1) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int64_t i = 0; i < m; ++i) {
+      coeff_vec_t acc = 0.;
+      int64_t c = 0;
+      for (int64_t k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+        c += coldelta[k];
+        acc += (coeff_vec_t)values[validx[k]] * X[c];
+      }
+      Y[i] = acc;
+    }
+  } else {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t vec = 0; vec < nvec; ++vec) {
+        Y[vec * m + i] = 0.;
+      }
+      int64_t c = 0;
+      for (int64_t k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+        c += coldelta[k];
+        coeff_vec_t val = (coeff_vec_t)values[validx[k]];
+        for (int64_t vec = 0; vec < nvec; ++vec) {
+          Y[vec * m + i] += val * X[vec * n + c];
+        }
+      }
+    }
+  }
+}
+
+template <typename idx_t, typename coeff_csr_t, typename coeff_mat_t>
+static void apply(CSRVIMatrix<idx_t, coeff_csr_t> const &A,
+                  arma::Mat<coeff_mat_t> const &mat_in,
+                  arma::Mat<coeff_mat_t> &mat_out) try {
+  static_assert(!(isreal<coeff_mat_t>() && !isreal<coeff_csr_t>()));
+  int64_t m = A.nrows;
+  int64_t n = A.ncols;
+  if ((m != (int64_t)mat_out.n_rows) || (n != (int64_t)mat_in.n_rows) ||
+      (mat_in.n_cols != mat_out.n_cols)) {
+    XDIAG_THROW(fmt::format(
+        "Incompatible sparse matrix and matrix dimensions A*X=Y, sparse matrix "
+        "A: ({} x {}), X: ({} x {}), Y: ({} x {})",
+        m, n, mat_in.n_rows, mat_in.n_cols, mat_out.n_rows, mat_out.n_cols));
+  }
+  int64_t nnz = A.coldelta.n_elem;
+  bool small = A.values.n_elem <= 256;
+  int64_t nvalidx = small ? A.validx8.n_elem : A.validx16.n_elem;
+  if (((int64_t)A.rowptr.n_elem != m + 1) || (nvalidx != nnz)) {
+    XDIAG_THROW(fmt::format(
+        "Invalid CSRVIMatrix with {} rows, {} rowptr entries, {} entries and "
+        "{} value indices",
+        m, A.rowptr.n_elem, nnz, nvalidx));
+  }
+  int64_t nvec = mat_in.n_cols;
+  if (small) {
+    apply_csrvi(A, A.validx8.memptr(), mat_in.memptr(), mat_out.memptr(), nvec);
+  } else {
+    apply_csrvi(A, A.validx16.memptr(), mat_in.memptr(), mat_out.memptr(),
+                nvec);
+  }
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_csr_t, typename coeff_vec_t>
+static void apply(CSRVIMatrix<idx_t, coeff_csr_t> const &A,
+                  arma::Col<coeff_vec_t> const &vec_in,
+                  arma::Col<coeff_vec_t> &vec_out) try {
+  arma::Mat<coeff_vec_t> mat_in(const_cast<coeff_vec_t *>(vec_in.memptr()),
+                                vec_in.n_rows, 1, false, true);
+  arma::Mat<coeff_vec_t> mat_out(vec_out.memptr(), vec_out.n_rows, 1, false,
+                                 true);
+  apply<idx_t, coeff_csr_t, coeff_vec_t>(A, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+arma::Col<coeff_t> apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                         arma::Col<coeff_t> const &vec_in) try {
+  auto vec_out = arma::Col<coeff_t>(spmat.nrows);
+  apply<idx_t, coeff_t, coeff_t>(spmat, vec_in, vec_out);
+  return vec_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+arma::Col<complex> apply(CSRVIMatrix<idx_t, double> const &spmat,
+                         arma::Col<complex> const &vec_in) try {
+  auto vec_out = arma::Col<complex>(spmat.nrows);
+  apply<idx_t, double, complex>(spmat, vec_in, vec_out);
+  return vec_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+arma::Mat<coeff_t> apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                         arma::Mat<coeff_t> const &mat_in) try {
+  auto mat_out = arma::Mat<coeff_t>(spmat.nrows, mat_in.n_cols);
+  apply<idx_t, coeff_t, coeff_t>(spmat, mat_in, mat_out);
+  return mat_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+arma::Mat<complex> apply(CSRVIMatrix<idx_t, double> const &spmat,
+                         arma::Mat<complex> const &mat_in) try {
+  auto mat_out = arma::Mat<complex>(spmat.nrows, mat_in.n_cols);
+  apply<idx_t, double, complex>(spmat, mat_in, mat_out);
+  return mat_out;
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+void apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+           arma::Col<coeff_t> const &vec_in, arma::Col<coeff_t> &vec_out) try {
+  apply<idx_t, coeff_t, coeff_t>(spmat, vec_in, vec_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+void apply(CSRVIMatrix<idx_t, double> const &spmat,
+           arma::Col<complex> const &vec_in, arma::Col<complex> &vec_out) try {
+  apply<idx_t, double, complex>(spmat, vec_in, vec_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+void apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+           arma::Mat<coeff_t> const &mat_in, arma::Mat<coeff_t> &mat_out) try {
+  apply<idx_t, coeff_t, coeff_t>(spmat, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+template <typename idx_t>
+void apply(CSRVIMatrix<idx_t, double> const &spmat,
+           arma::Mat<complex> const &mat_in, arma::Mat<complex> &mat_out) try {
+  apply<idx_t, double, complex>(spmat, mat_in, mat_out);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX)                                                   \
+  template arma::vec apply(MAT<IDX, double> const &,                           \
+                           arma::vec const &);                                 \
+  template arma::cx_vec apply(MAT<IDX, complex> const &,                       \
+                              arma::cx_vec const &);                           \
+  template arma::cx_vec apply(MAT<IDX, double> const &,                        \
+                              arma::cx_vec const &);                           \
+  template arma::mat apply(MAT<IDX, double> const &,                           \
+                           arma::mat const &);                                 \
+  template arma::cx_mat apply(MAT<IDX, complex> const &,                       \
+                              arma::cx_mat const &);                           \
+  template arma::cx_mat apply(MAT<IDX, double> const &,                        \
+                              arma::cx_mat const &);                           \
+  template void apply(MAT<IDX, double> const &, arma::vec const &,             \
+                      arma::vec &);                                            \
+  template void apply(MAT<IDX, complex> const &, arma::cx_vec const &,         \
+                      arma::cx_vec &);                                         \
+  template void apply(MAT<IDX, double> const &, arma::cx_vec const &,          \
+                      arma::cx_vec &);                                         \
+  template void apply(MAT<IDX, double> const &, arma::mat const &,             \
+                      arma::mat &);                                            \
+  template void apply(MAT<IDX, complex> const &, arma::cx_mat const &,         \
+                      arma::cx_mat &);                                         \
+  template void apply(MAT<IDX, double> const &, arma::cx_mat const &,          \
+                      arma::cx_mat &);
+XDIAG_INST(SELLMatrix, int32_t)
+XDIAG_INST(SELLMatrix, int64_t)
+XDIAG_INST(CSRVIMatrix, int32_t)
+XDIAG_INST(CSRVIMatrix, int64_t)
+#undef XDIAG_INST
+
 } // namespace xdiag
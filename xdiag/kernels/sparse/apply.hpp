@@ -10,7 +10,8 @@
 #include <xdiag/utils/error.hpp>
 #include <xdiag/utils/xdiag_api.hpp>
 
-// Sparse matrix-vector and matrix-matrix products for CSRMatrix.
+// Sparse matrix-vector and matrix-matrix products for CSRMatrix, SELLMatrix
+// and CSRVIMatrix.
 //
 // Two calling conventions are provided:
 //   apply(A, x)         -> returns y = A*x  (allocates output)
@@ -19,9 +20,21 @@
 // Mixed-precision overloads allow a real CSRMatrix to be applied to a complex
 // vector/matrix (the matrix entries are implicitly promoted).
 //
+// CSRMatrix storing only the upper or lower triangle of a Hermitian matrix
+// applies every off-diagonal entry also as its adjoint. Contributions to rows
+// of other threads are collected in per-thread buffers instead of atomics.
+//
 // When compiled with XDIAG_USE_SPARSE_MKL and idx_t == int64_t the MKL
 // inspector-executor SpMV/SpMM routines are used for the real/complex cases.
 //
+// The SELLMatrix products of real matrices and vectors use AVX-512 or AVX2
+// gathers if the library is compiled for such a target (e.g. with
+// XDIAG_OPTIMIZE_FOR_NATIVE), and a portable loop over the rows of a chunk
+// otherwise. Products with several vectors read every chunk only once.
+//
+// The CSRVIMatrix products look up every entry in the dictionary of distinct
+// values, which is small enough to stay in cache.
+//
 // The four-argument overload (with two block arguments) is for internal use by
 // generic algorithms that pass blocks alongside the vectors; the blocks are
 // ignored and no quantum-number checking is performed.
@@ -58,6 +71,66 @@ XDIAG_API void apply(CSRMatrix<idx_t, double> const &spmat,
                      arma::Mat<complex> const &mat_in,
                      arma::Mat<complex> &mat_out);
 
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Col<coeff_t> apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                                   arma::Col<coeff_t> const &vec_in);
+template <typename idx_t>
+XDIAG_API arma::Col<complex> apply(SELLMatrix<idx_t, double> const &spmat,
+                                   arma::Col<complex> const &vec_in);
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Mat<coeff_t> apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                                   arma::Mat<coeff_t> const &mat_in);
+template <typename idx_t>
+XDIAG_API arma::Mat<complex> apply(SELLMatrix<idx_t, double> const &spmat,
+                                   arma::Mat<complex> const &mat_in);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API void apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                     arma::Col<coeff_t> const &vec_in,
+                     arma::Col<coeff_t> &vec_out);
+template <typename idx_t, typename coeff_t>
+XDIAG_API void apply(SELLMatrix<idx_t, coeff_t> const &spmat,
+                     arma::Mat<coeff_t> const &mat_in,
+                     arma::Mat<coeff_t> &mat_out);
+template <typename idx_t>
+XDIAG_API void apply(SELLMatrix<idx_t, double> const &spmat,
+                     arma::Col<complex> const &vec_in,
+                     arma::Col<complex> &vec_out);
+template <typename idx_t>
+XDIAG_API void apply(SELLMatrix<idx_t, double> const &spmat,
+                     arma::Mat<complex> const &mat_in,
+                     arma::Mat<complex> &mat_out);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Col<coeff_t> apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                                   arma::Col<coeff_t> const &vec_in);
+template <typename idx_t>
+XDIAG_API arma::Col<complex> apply(CSRVIMatrix<idx_t, double> const &spmat,
+                                   arma::Col<complex> const &vec_in);
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Mat<coeff_t> apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                                   arma::Mat<coeff_t> const &mat_in);
+template <typename idx_t>
+XDIAG_API arma::Mat<complex> apply(CSRVIMatrix<idx_t, double> const &spmat,
+                                   arma::Mat<complex> const &mat_in);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API void apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                     arma::Col<coeff_t> const &vec_in,
+                     arma::Col<coeff_t> &vec_out);
+template <typename idx_t, typename coeff_t>
+XDIAG_API void apply(CSRVIMatrix<idx_t, coeff_t> const &spmat,
+                     arma::Mat<coeff_t> const &mat_in,
+                     arma::Mat<coeff_t> &mat_out);
+template <typename idx_t>
+XDIAG_API void apply(CSRVIMatrix<idx_t, double> const &spmat,
+                     arma::Col<complex> const &vec_in,
+                     arma::Col<complex> &vec_out);
+template <typename idx_t>
+XDIAG_API void apply(CSRVIMatrix<idx_t, double> const &spmat,
+                     arma::Mat<complex> const &mat_in,
+                     arma::Mat<complex> &mat_out);
+
 // Internal: four-argument form used by generic algorithms (blocks ignored).
 template <typename idx_t, typename coeff_t, typename block_t, typename vec_t>
 inline void apply(CSRMatrix<idx_t, coeff_t> const &spmat, block_t const &,
@@ -70,4 +143,26 @@ inline void apply(CSRMatrix<idx_t, coeff_t> const &spmat, block_t const &,
 }
 XDIAG_CATCH
 
+template <typename idx_t, typename coeff_t, typename block_t, typename vec_t>
+inline void apply(SELLMatrix<idx_t, coeff_t> const &spmat, block_t const &,
+                  vec_t const &vec_in, block_t const &, vec_t &vec_out) try {
+  if constexpr (isreal<typename vec_t::elem_type>() && !isreal<coeff_t>()) {
+    XDIAG_THROW("Cannot apply a complex SELLMatrix to a real vector.");
+  } else {
+    return apply(spmat, vec_in, vec_out);
+  }
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t, typename block_t, typename vec_t>
+inline void apply(CSRVIMatrix<idx_t, coeff_t> const &spmat, block_t const &,
+                  vec_t const &vec_in, block_t const &, vec_t &vec_out) try {
+  if constexpr (isreal<typename vec_t::elem_type>() && !isreal<coeff_t>()) {
+    XDIAG_THROW("Cannot apply a complex CSRVIMatrix to a real vector.");
+  } else {
+    return apply(spmat, vec_in, vec_out);
+  }
+}
+XDIAG_CATCH
+
 } // namespace xdiag
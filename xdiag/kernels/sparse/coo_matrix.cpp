@@ -4,14 +4,15 @@
 
 #include "coo_matrix.hpp"
 
+#include <algorithm>
 #include <numeric>
+#include <vector>
 
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/armadillo.hpp>
 #include <xdiag/math/complex.hpp>
-#include <xdiag/kernels/blocks/dispatch_bases.hpp>
-#include <xdiag/kernels/kernels.hpp>
+#include <xdiag/kernels/sparse/sparse_build.hpp>
 #include <xdiag/kernels/sparse/valid.hpp>
 #include <xdiag/operators/hc.hpp>
 #include <xdiag/utils/error.hpp>
@@ -26,21 +27,16 @@
 //     visit_same_type unwraps both Block variants to their concrete type
 //     and calls coo_matrix_impl(OpSum, ConcreteBlock, ConcreteBlock, idx_t).
 //
-// Layer 2 — coo_matrix_impl<block_t>: one body for every block type. The
-//     block's dispatch_basis overload (kernels/blocks/<block>/dispatch_basis
-//     .hpp) resolves the shared_ptr<Basis> to a concrete BasisOnTheFly<...>
-//     via a type-id table. The numerical kernel is selected by block_t in
-//     kernels.cpp. A block type with no dispatch_basis overload is a compile
-//     error here, never a silent fallback. The basis-level two-pass build lives
-//     in coo_build:
-//       Pass 1: coo_matrix_nnz  — counts NNZ (per thread with OMP)
-//       Alloc:  allocates row/col/data arrays from the NNZ count
-//       Pass 2: coo_matrix_fill — fills the pre-allocated arrays
+// Layer 2 — coo_matrix_impl<block_t>: one body for every block type. It
+//     builds the CSR arrays with build_csr_arrays (sparse_build.cpp), which
+//     sorts every row and merges entries with equal (row, col), and expands
+//     the row pointers into row indices. The COO matrix is thus row-major
+//     ordered and free of duplicates.
 //
-// Kernels — kernels::coo_matrix_nnz / coo_matrix_fill<block_t> (kernels.cpp),
-//     instantiated per (block_t, basis type) via the instantiation-group
-//     mechanism. The two-pass split keeps the memory allocation at the block
-//     level so it is not repeated when new block types are added.
+// Caller-allocated path — coo_matrix_nnz / coo_matrix_fill below: the
+//     two-phase CSR build (build_csr_nnz / build_csr_fill) writes the merged
+//     columns and data into the caller's arrays; the row pointers are then
+//     expanded into the caller's row array, as in coo_matrix_impl.
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -48,56 +44,29 @@
 
 namespace xdiag {
 
-// Basis-level two-pass COO build, generic over the block type and
-// concrete BasisOnTheFly type. Shared by the block-generic Layer-2 below.
-template <typename idx_t, typename coeff_t, typename block_t, typename basis_t>
-static void coo_build(OpSum const &ops, basis_t const &basis_in,
-                      basis_t const &basis_out, idx_t i0,
-                      arma::Col<idx_t> &rows, arma::Col<idx_t> &cols,
-                      arma::Col<coeff_t> &data) {
-#ifdef _OPENMP
-  // Pass 1: count NNZ per thread.
-  auto nnz_thread =
-      kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
-  int64_t nnz =
-      std::accumulate(nnz_thread.begin(), nnz_thread.end(), (int64_t)0);
-  rows.resize(nnz);
-  cols.resize(nnz);
-  data.resize(nnz);
-  // Pass 2: fill using per-thread offsets.
-  kernels::coo_matrix_fill<block_t, coeff_t>(ops, basis_in, basis_out,
-                                               nnz_thread, rows.memptr(),
-                                               cols.memptr(), data.memptr(), i0);
-#else
-  // Pass 1: count total NNZ.
-  int64_t nnz =
-      kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
-  rows.resize(nnz);
-  cols.resize(nnz);
-  data.resize(nnz);
-  // Pass 2: fill sequentially.
-  kernels::coo_matrix_fill<block_t, coeff_t>(
-      ops, basis_in, basis_out, rows.memptr(), cols.memptr(), data.memptr(),
-      i0);
-#endif
-}
-
-// Layer 2: block-generic orchestration. The dispatch_basis overload supplies
-// the basis dispatch; a block with no overload is a compile error here, never a
-// silent fallback to the Block overload.
+// Layer 2: block-generic orchestration. The merged CSR arrays are built first,
+// only the row pointers are replaced by the row indices.
 template <typename idx_t, typename coeff_t, typename block_t>
 static COOMatrix<idx_t, coeff_t>
 coo_matrix_impl(OpSum const &ops, block_t const &block_in,
-                block_t const &block_out, idx_t i0) try {
+                block_t const &block_out, idx_t i0,
+                std::string const &assembly) try {
   idx_t nrows = (idx_t)size(block_out);
   idx_t ncols = (idx_t)size(block_in);
-  arma::Col<idx_t> rows, cols;
+  arma::Col<idx_t> rowptr, rows, cols;
   arma::Col<coeff_t> data;
-  kernels::dispatch_basis(
-      block_in, block_out, [&](auto const &basis_in, auto const &basis_out) {
-        coo_build<idx_t, coeff_t, block_t>(ops, basis_in, basis_out, i0, rows,
-                                           cols, data);
-      });
+  build_csr_arrays<idx_t, coeff_t, block_t>(ops, block_in, block_out, nrows,
+                                            i0, false, rowptr, cols, data,
+                                            "full", assembly);
+  rows.set_size(cols.n_elem);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+  for (idx_t row = 0; row < nrows; ++row) {
+    for (idx_t k = rowptr[row] - i0; k < rowptr[row + 1] - i0; ++k) {
+      rows[k] = row + i0;
+    }
+  }
   bool isherm = ishermitian(ops, block_in);
   return COOMatrix<idx_t, coeff_t>{nrows, ncols, rows, cols, data, i0, isherm};
 }
@@ -107,7 +76,8 @@ XDIAG_CATCH
 // block-generic Layer 2.
 template <typename idx_t, typename coeff_t>
 COOMatrix<idx_t, coeff_t> coo_matrix(OpSum const &ops, Block const &block_in,
-                                     Block const &block_out, idx_t i0) try {
+                                     Block const &block_out, idx_t i0,
+                                     std::string const &assembly) try {
   COOMatrix<idx_t, coeff_t> result;
   utils::visit_same_type(
       block_in, block_out,
@@ -119,7 +89,8 @@ COOMatrix<idx_t, coeff_t> coo_matrix(OpSum const &ops, Block const &block_in,
                       "apply(...) instead.");
         } else {
           check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bout, i0);
-          result = coo_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0);
+          result = coo_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0,
+                                                   assembly);
         }
       },
       "Type mismatch of Block types");
@@ -129,133 +100,130 @@ XDIAG_CATCH
 
 template <typename idx_t, typename coeff_t>
 COOMatrix<idx_t, coeff_t> coo_matrix(OpSum const &ops, Block const &blocki,
-                                     idx_t i0) try {
+                                     idx_t i0,
+                                     std::string const &assembly) try {
   auto blocko = block(ops, blocki);
-  return coo_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0);
+  return coo_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0, assembly);
 }
 XDIAG_CATCH
 
 template COOMatrix<int32_t, double>
-coo_matrix<int32_t, double>(OpSum const &, Block const &, int32_t);
+coo_matrix<int32_t, double>(OpSum const &, Block const &, int32_t,
+                            std::string const &);
 template COOMatrix<int32_t, complex>
-coo_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t);
+coo_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t,
+                             std::string const &);
 template COOMatrix<int64_t, double>
-coo_matrix<int64_t, double>(OpSum const &, Block const &, int64_t);
+coo_matrix<int64_t, double>(OpSum const &, Block const &, int64_t,
+                            std::string const &);
 template COOMatrix<int64_t, complex>
-coo_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t);
+coo_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t,
+                             std::string const &);
 
-template COOMatrix<int32_t, double> coo_matrix<int32_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int32_t);
-template COOMatrix<int32_t, complex> coo_matrix<int32_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int32_t);
-template COOMatrix<int64_t, double> coo_matrix<int64_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int64_t);
-template COOMatrix<int64_t, complex> coo_matrix<int64_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int64_t);
+template COOMatrix<int32_t, double>
+coo_matrix<int32_t, double>(OpSum const &, Block const &, Block const &,
+                            int32_t, std::string const &);
+template COOMatrix<int32_t, complex>
+coo_matrix<int32_t, complex>(OpSum const &, Block const &, Block const &,
+                             int32_t, std::string const &);
+template COOMatrix<int64_t, double>
+coo_matrix<int64_t, double>(OpSum const &, Block const &, Block const &,
+                            int64_t, std::string const &);
+template COOMatrix<int64_t, complex>
+coo_matrix<int64_t, complex>(OpSum const &, Block const &, Block const &,
+                             int64_t, std::string const &);
 
 // Named convenience wrappers (no template syntax at call sites).
 COOMatrix<int64_t, double> coo_matrix(OpSum const &ops, Block const &block,
-                                      int64_t i0) try {
-  return coo_matrix<int64_t, double>(ops, block, i0);
+                                      int64_t i0,
+                                      std::string const &assembly) try {
+  return coo_matrix<int64_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int64_t, double> coo_matrix(OpSum const &ops, Block const &block_in,
-                                      Block const &block_out, int64_t i0) try {
-  return coo_matrix<int64_t, double>(ops, block_in, block_out, i0);
+                                      Block const &block_out, int64_t i0,
+                                      std::string const &assembly) try {
+  return coo_matrix<int64_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int64_t, complex> coo_matrixC(OpSum const &ops, Block const &block,
-                                        int64_t i0) try {
-  return coo_matrix<int64_t, complex>(ops, block, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return coo_matrix<int64_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int64_t, complex> coo_matrixC(OpSum const &ops, Block const &block_in,
                                         Block const &block_out,
-                                        int64_t i0) try {
-  return coo_matrix<int64_t, complex>(ops, block_in, block_out, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return coo_matrix<int64_t, complex>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int32_t, double> coo_matrix_32(OpSum const &ops, Block const &block,
-                                         int32_t i0) try {
-  return coo_matrix<int32_t, double>(ops, block, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return coo_matrix<int32_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int32_t, double> coo_matrix_32(OpSum const &ops,
                                          Block const &block_in,
                                          Block const &block_out,
-                                         int32_t i0) try {
-  return coo_matrix<int32_t, double>(ops, block_in, block_out, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return coo_matrix<int32_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int32_t, complex> coo_matrixC_32(OpSum const &ops, Block const &block,
-                                           int32_t i0) try {
-  return coo_matrix<int32_t, complex>(ops, block, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return coo_matrix<int32_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 COOMatrix<int32_t, complex> coo_matrixC_32(OpSum const &ops,
                                            Block const &block_in,
                                            Block const &block_out,
-                                           int32_t i0) try {
-  return coo_matrix<int32_t, complex>(ops, block_in, block_out, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return coo_matrix<int32_t, complex>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 // Two-phase build into caller-owned storage (Julia wrapper). Phase 1 returns
-// the total nnz; phase 2 fills the caller's row/col/data (recomputing the
-// per-thread counts, guarded against a shrunk capacity). Distributed blocks
-// have no local sparse representation.
-template <typename coeff_t, typename block_t, typename basis_t>
-static int64_t coo_nnz_basis(OpSum const &ops, basis_t const &basis_in,
-                             basis_t const &basis_out) {
-#ifdef _OPENMP
-  auto nnz_thread =
-      kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
-  return std::accumulate(nnz_thread.begin(), nnz_thread.end(), (int64_t)0);
-#else
-  return kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
-#endif
-}
-
-template <typename idx_t, typename coeff_t, typename block_t, typename basis_t>
-static void coo_fill_basis(OpSum const &ops, basis_t const &basis_in,
-                           basis_t const &basis_out, int64_t nnz_capacity,
-                           idx_t *row, idx_t *col, coeff_t *data, idx_t i0) {
-#ifdef _OPENMP
-  auto nnz_thread =
-      kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
-  int64_t nnz =
-      std::accumulate(nnz_thread.begin(), nnz_thread.end(), (int64_t)0);
-  if (nnz > nnz_capacity) {
-    XDIAG_THROW("coo_matrix_fill: recomputed nnz exceeds the allocated capacity "
-                "(did the OpenMP thread count change between the nnz and fill "
-                "calls?)");
-  }
-  kernels::coo_matrix_fill<block_t, coeff_t>(ops, basis_in, basis_out,
-                                             nnz_thread, row, col, data, i0);
-#else
-  int64_t nnz =
-      kernels::coo_matrix_nnz<block_t, coeff_t>(ops, basis_in, basis_out);
+// the total nnz before merging; phase 2 fills the caller's col/data as CSR
+// arrays, merged like in coo_matrix, and expands the row pointers into the
+// caller's row array. Only the row pointers are held in temporary storage.
+// Distributed blocks have no local sparse representation.
+template <typename idx_t, typename coeff_t, typename block_t>
+static int64_t coo_fill_block(OpSum const &ops, block_t const &block_in,
+                              block_t const &block_out, int64_t nnz_capacity,
+                              idx_t *row, idx_t *col, coeff_t *data,
+                              idx_t i0) {
+  auto counts = build_csr_nnz<coeff_t, block_t>(ops, block_in, block_out);
+  int64_t nnz = std::accumulate(counts.begin(), counts.end(), (int64_t)0);
   if (nnz > nnz_capacity) {
-    XDIAG_THROW("coo_matrix_fill: recomputed nnz exceeds the allocated capacity");
+    XDIAG_THROW("coo_matrix_fill: recomputed nnz exceeds the allocated "
+                "capacity");
   }
-  kernels::coo_matrix_fill<block_t, coeff_t>(ops, basis_in, basis_out, row, col,
-                                             data, i0);
+  idx_t nrows = (idx_t)size(block_out);
+  std::vector<idx_t> rowptr(nrows + 1);
+  build_csr_fill<idx_t, coeff_t, block_t>(ops, block_in, block_out, counts,
+                                          rowptr.data(), col, data, i0);
+  int64_t nnz_merged = rowptr[nrows] - i0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
 #endif
+  for (idx_t r = 0; r < nrows; ++r) {
+    std::fill(row + rowptr[r] - i0, row + rowptr[r + 1] - i0, r + i0);
+  }
+  std::fill(row + nnz_merged, row + nnz, i0);
+  return nnz_merged;
 }
 
 template <typename coeff_t>
@@ -271,10 +239,8 @@ int64_t coo_matrix_nnz(OpSum const &ops, Block const &block_in,
                       "its Hilbert space is distributed across MPI ranks. Use "
                       "apply(...) instead.");
         } else {
-          kernels::dispatch_basis(
-              bin, bout, [&](auto const &basis_in, auto const &basis_out) {
-                nnz = coo_nnz_basis<coeff_t, block_t>(ops, basis_in, basis_out);
-              });
+          auto counts = build_csr_nnz<coeff_t, block_t>(ops, bin, bout);
+          nnz = std::accumulate(counts.begin(), counts.end(), (int64_t)0);
         }
       },
       "Type mismatch of Block types");
@@ -283,9 +249,10 @@ int64_t coo_matrix_nnz(OpSum const &ops, Block const &block_in,
 XDIAG_CATCH
 
 template <typename idx_t, typename coeff_t>
-void coo_matrix_fill(OpSum const &ops, Block const &block_in,
-                     Block const &block_out, int64_t nnz_capacity, idx_t *row,
-                     idx_t *col, coeff_t *data, idx_t i0) try {
+int64_t coo_matrix_fill(OpSum const &ops, Block const &block_in,
+                        Block const &block_out, int64_t nnz_capacity,
+                        idx_t *row, idx_t *col, coeff_t *data, idx_t i0) try {
+  int64_t nnz = 0;
   utils::visit_same_type(
       block_in, block_out,
       [&](auto const &bin, auto const &bout) {
@@ -296,14 +263,12 @@ void coo_matrix_fill(OpSum const &ops, Block const &block_in,
                       "apply(...) instead.");
         } else {
           check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bout, i0);
-          kernels::dispatch_basis(
-              bin, bout, [&](auto const &basis_in, auto const &basis_out) {
-                coo_fill_basis<idx_t, coeff_t, block_t>(
-                    ops, basis_in, basis_out, nnz_capacity, row, col, data, i0);
-              });
+          nnz = coo_fill_block<idx_t, coeff_t, block_t>(
+              ops, bin, bout, nnz_capacity, row, col, data, i0);
         }
       },
       "Type mismatch of Block types");
+  return nnz;
 }
 XDIAG_CATCH
 
@@ -311,19 +276,19 @@ template int64_t coo_matrix_nnz<double>(OpSum const &, Block const &,
                                         Block const &);
 template int64_t coo_matrix_nnz<complex>(OpSum const &, Block const &,
                                          Block const &);
-template void coo_matrix_fill<int32_t, double>(OpSum const &, Block const &,
+template int64_t coo_matrix_fill<int32_t, double>(OpSum const &, Block const &,
                                                Block const &, int64_t,
                                                int32_t *, int32_t *, double *,
                                                int32_t);
-template void coo_matrix_fill<int64_t, double>(OpSum const &, Block const &,
+template int64_t coo_matrix_fill<int64_t, double>(OpSum const &, Block const &,
                                                Block const &, int64_t,
                                                int64_t *, int64_t *, double *,
                                                int64_t);
-template void coo_matrix_fill<int32_t, complex>(OpSum const &, Block const &,
+template int64_t coo_matrix_fill<int32_t, complex>(OpSum const &, Block const &,
                                                 Block const &, int64_t,
                                                 int32_t *, int32_t *, complex *,
                                                 int32_t);
-template void coo_matrix_fill<int64_t, complex>(OpSum const &, Block const &,
+template int64_t coo_matrix_fill<int64_t, complex>(OpSum const &, Block const &,
                                                 Block const &, int64_t,
                                                 int64_t *, int64_t *, complex *,
                                                 int64_t);
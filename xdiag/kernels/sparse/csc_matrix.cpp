@@ -30,14 +30,15 @@ namespace xdiag {
 template <typename idx_t, typename coeff_t, typename block_t>
 static CSCMatrix<idx_t, coeff_t>
 csc_matrix_impl(OpSum const &ops, block_t const &block_in,
-                block_t const &block_out, idx_t i0) try {
+                block_t const &block_out, idx_t i0,
+                std::string const &assembly) try {
   idx_t nrows = (idx_t)size(block_out);
   idx_t ncols = (idx_t)size(block_in);
   arma::Col<idx_t> colptr, row;
   arma::Col<coeff_t> data;
   build_csr_arrays<idx_t, coeff_t, block_t>(ops, block_in, block_out, ncols, i0,
                                             /*transpose=*/true, colptr, row,
-                                            data);
+                                            data, "full", assembly);
   bool isherm = ishermitian(ops, block_in);
   return CSCMatrix<idx_t, coeff_t>{nrows, ncols, colptr, row, data, i0, isherm};
 }
@@ -46,7 +47,8 @@ XDIAG_CATCH
 // Layer 1: unwrap Block variant, then call the block-generic Layer 2.
 template <typename idx_t, typename coeff_t>
 CSCMatrix<idx_t, coeff_t> csc_matrix(OpSum const &ops, Block const &block_in,
-                                     Block const &block_out, idx_t i0) try {
+                                     Block const &block_out, idx_t i0,
+                                     std::string const &assembly) try {
   CSCMatrix<idx_t, coeff_t> result;
   utils::visit_same_type(
       block_in, block_out,
@@ -58,7 +60,8 @@ CSCMatrix<idx_t, coeff_t> csc_matrix(OpSum const &ops, Block const &block_in,
                       "apply(...) instead.");
         } else {
           check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bout, i0);
-          result = csc_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0);
+          result = csc_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0,
+                                                   assembly);
         }
       },
       "Type mismatch of Block types");
@@ -68,89 +71,98 @@ XDIAG_CATCH
 
 template <typename idx_t, typename coeff_t>
 CSCMatrix<idx_t, coeff_t> csc_matrix(OpSum const &ops, Block const &blocki,
-                                     idx_t i0) try {
+                                     idx_t i0,
+                                     std::string const &assembly) try {
   auto blocko = block(ops, blocki);
-  return csc_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0);
+  return csc_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0, assembly);
 }
 XDIAG_CATCH
 
 template CSCMatrix<int32_t, double>
-csc_matrix<int32_t, double>(OpSum const &, Block const &, int32_t);
+csc_matrix<int32_t, double>(OpSum const &, Block const &, int32_t,
+                            std::string const &);
 template CSCMatrix<int32_t, complex>
-csc_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t);
+csc_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t,
+                             std::string const &);
 template CSCMatrix<int64_t, double>
-csc_matrix<int64_t, double>(OpSum const &, Block const &, int64_t);
+csc_matrix<int64_t, double>(OpSum const &, Block const &, int64_t,
+                            std::string const &);
 template CSCMatrix<int64_t, complex>
-csc_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t);
-
-template CSCMatrix<int32_t, double> csc_matrix<int32_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int32_t);
-template CSCMatrix<int32_t, complex> csc_matrix<int32_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int32_t);
-template CSCMatrix<int64_t, double> csc_matrix<int64_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int64_t);
-template CSCMatrix<int64_t, complex> csc_matrix<int64_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int64_t);
+csc_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t,
+                             std::string const &);
+
+template CSCMatrix<int32_t, double>
+csc_matrix<int32_t, double>(OpSum const &, Block const &, Block const &,
+                            int32_t, std::string const &);
+template CSCMatrix<int32_t, complex>
+csc_matrix<int32_t, complex>(OpSum const &, Block const &, Block const &,
+                             int32_t, std::string const &);
+template CSCMatrix<int64_t, double>
+csc_matrix<int64_t, double>(OpSum const &, Block const &, Block const &,
+                            int64_t, std::string const &);
+template CSCMatrix<int64_t, complex>
+csc_matrix<int64_t, complex>(OpSum const &, Block const &, Block const &,
+                             int64_t, std::string const &);
 
 // Named convenience wrappers.
 CSCMatrix<int64_t, double> csc_matrix(OpSum const &ops, Block const &block,
-                                      int64_t i0) try {
-  return csc_matrix<int64_t, double>(ops, block, i0);
+                                      int64_t i0,
+                                      std::string const &assembly) try {
+  return csc_matrix<int64_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int64_t, double> csc_matrix(OpSum const &ops, Block const &block_in,
-                                      Block const &block_out, int64_t i0) try {
-  return csc_matrix<int64_t, double>(ops, block_in, block_out, i0);
+                                      Block const &block_out, int64_t i0,
+                                      std::string const &assembly) try {
+  return csc_matrix<int64_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int64_t, complex> csc_matrixC(OpSum const &ops, Block const &block,
-                                        int64_t i0) try {
-  return csc_matrix<int64_t, complex>(ops, block, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return csc_matrix<int64_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int64_t, complex> csc_matrixC(OpSum const &ops, Block const &block_in,
                                         Block const &block_out,
-                                        int64_t i0) try {
-  return csc_matrix<int64_t, complex>(ops, block_in, block_out, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return csc_matrix<int64_t, complex>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int32_t, double> csc_matrix_32(OpSum const &ops, Block const &block,
-                                         int32_t i0) try {
-  return csc_matrix<int32_t, double>(ops, block, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return csc_matrix<int32_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int32_t, double> csc_matrix_32(OpSum const &ops,
                                          Block const &block_in,
                                          Block const &block_out,
-                                         int32_t i0) try {
-  return csc_matrix<int32_t, double>(ops, block_in, block_out, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return csc_matrix<int32_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int32_t, complex> csc_matrixC_32(OpSum const &ops, Block const &block,
-                                           int32_t i0) try {
-  return csc_matrix<int32_t, complex>(ops, block, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return csc_matrix<int32_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSCMatrix<int32_t, complex> csc_matrixC_32(OpSum const &ops,
                                            Block const &block_in,
                                            Block const &block_out,
-                                           int32_t i0) try {
-  return csc_matrix<int32_t, complex>(ops, block_in, block_out, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return csc_matrix<int32_t, complex>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/op.hpp>
@@ -13,41 +15,42 @@ namespace xdiag {
 
 // int64_t, double
 XDIAG_API CSCMatrix<int64_t, double>
-csc_matrix(OpSum const &ops, Block const &block, int64_t i0 = 0);
-XDIAG_API CSCMatrix<int64_t, double> csc_matrix(OpSum const &ops,
-                                                Block const &block_in,
-                                                Block const &block_out,
-                                                int64_t i0 = 0);
+csc_matrix(OpSum const &ops, Block const &block, int64_t i0 = 0,
+           std::string const &assembly = "auto");
+XDIAG_API CSCMatrix<int64_t, double>
+csc_matrix(OpSum const &ops, Block const &block_in, Block const &block_out,
+           int64_t i0 = 0, std::string const &assembly = "auto");
 // int64_t, complex
 XDIAG_API CSCMatrix<int64_t, complex>
-csc_matrixC(OpSum const &ops, Block const &block, int64_t i0 = 0);
-XDIAG_API CSCMatrix<int64_t, complex> csc_matrixC(OpSum const &ops,
-                                                  Block const &block_in,
-                                                  Block const &block_out,
-                                                  int64_t i0 = 0);
+csc_matrixC(OpSum const &ops, Block const &block, int64_t i0 = 0,
+            std::string const &assembly = "auto");
+XDIAG_API CSCMatrix<int64_t, complex>
+csc_matrixC(OpSum const &ops, Block const &block_in, Block const &block_out,
+            int64_t i0 = 0, std::string const &assembly = "auto");
 // int32_t, double
 XDIAG_API CSCMatrix<int32_t, double>
-csc_matrix_32(OpSum const &ops, Block const &block, int32_t i0 = 0);
-XDIAG_API CSCMatrix<int32_t, double> csc_matrix_32(OpSum const &ops,
-                                                   Block const &block_in,
-                                                   Block const &block_out,
-                                                   int32_t i0 = 0);
+csc_matrix_32(OpSum const &ops, Block const &block, int32_t i0 = 0,
+              std::string const &assembly = "auto");
+XDIAG_API CSCMatrix<int32_t, double>
+csc_matrix_32(OpSum const &ops, Block const &block_in, Block const &block_out,
+              int32_t i0 = 0, std::string const &assembly = "auto");
 // int32_t, complex
 XDIAG_API CSCMatrix<int32_t, complex>
-csc_matrixC_32(OpSum const &ops, Block const &block, int32_t i0 = 0);
-XDIAG_API CSCMatrix<int32_t, complex> csc_matrixC_32(OpSum const &ops,
-                                                     Block const &block_in,
-                                                     Block const &block_out,
-                                                     int32_t i0 = 0);
+csc_matrixC_32(OpSum const &ops, Block const &block, int32_t i0 = 0,
+               std::string const &assembly = "auto");
+XDIAG_API CSCMatrix<int32_t, complex>
+csc_matrixC_32(OpSum const &ops, Block const &block_in, Block const &block_out,
+               int32_t i0 = 0, std::string const &assembly = "auto");
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API CSCMatrix<idx_t, coeff_t>
-csc_matrix(OpSum const &ops, Block const &block, idx_t i0 = 0);
+csc_matrix(OpSum const &ops, Block const &block, idx_t i0 = 0,
+           std::string const &assembly = "auto");
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API CSCMatrix<idx_t, coeff_t>
 csc_matrix(OpSum const &ops, Block const &block_in, Block const &block_out,
-           idx_t i0 = 0);
+           idx_t i0 = 0, std::string const &assembly = "auto");
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API arma::Mat<coeff_t> to_dense(CSCMatrix<idx_t, coeff_t> const &csc_mat);
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/blocks/blocks.hpp>
@@ -56,23 +57,27 @@ namespace xdiag {
 template <typename idx_t, typename coeff_t, typename block_t>
 static CSRMatrix<idx_t, coeff_t>
 csr_matrix_impl(OpSum const &ops, block_t const &block_in,
-                block_t const &block_out, idx_t i0) try {
+                block_t const &block_out, idx_t i0,
+                std::string const &triangle,
+                std::string const &assembly) try {
   idx_t nrows = (idx_t)size(block_out);
   idx_t ncols = (idx_t)size(block_in);
   arma::Col<idx_t> rowptr, col;
   arma::Col<coeff_t> data;
   build_csr_arrays<idx_t, coeff_t, block_t>(ops, block_in, block_out, nrows, i0,
                                             /*transpose=*/false, rowptr, col,
-                                            data);
+                                            data, triangle, assembly);
   bool isherm = ishermitian(ops, block_in);
-  return CSRMatrix<idx_t, coeff_t>{nrows, ncols, rowptr, col, data, i0, isherm};
+  return CSRMatrix<idx_t, coeff_t>{nrows, ncols, rowptr, col,
+                                   data, i0, isherm, triangle};
 }
 XDIAG_CATCH
 
 // Layer 1: unwrap Block variant, then call the block-generic Layer 2.
 template <typename idx_t, typename coeff_t>
 CSRMatrix<idx_t, coeff_t> csr_matrix(OpSum const &ops, Block const &block_in,
-                                     Block const &block_out, idx_t i0) try {
+                                     Block const &block_out, idx_t i0,
+                                     std::string const &assembly) try {
   CSRMatrix<idx_t, coeff_t> result;
   utils::visit_same_type(
       block_in, block_out,
@@ -84,7 +89,8 @@ CSRMatrix<idx_t, coeff_t> csr_matrix(OpSum const &ops, Block const &block_in,
                       "apply(...) instead.");
         } else {
           check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bout, i0);
-          result = csr_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0);
+          result = csr_matrix_impl<idx_t, coeff_t>(ops, bin, bout, i0,
+                                                   "full", assembly);
         }
       },
       "Type mismatch of Block types");
@@ -94,89 +100,188 @@ XDIAG_CATCH
 
 template <typename idx_t, typename coeff_t>
 CSRMatrix<idx_t, coeff_t> csr_matrix(OpSum const &ops, Block const &blocki,
-                                     idx_t i0) try {
+                                     idx_t i0,
+                                     std::string const &assembly) try {
   auto blocko = block(ops, blocki);
-  return csr_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0);
+  return csr_matrix<idx_t, coeff_t>(ops, blocki, blocko, i0, assembly);
 }
 XDIAG_CATCH
 
 template CSRMatrix<int32_t, double>
-csr_matrix<int32_t, double>(OpSum const &, Block const &, int32_t);
+csr_matrix<int32_t, double>(OpSum const &, Block const &, int32_t,
+                            std::string const &);
 template CSRMatrix<int32_t, complex>
-csr_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t);
+csr_matrix<int32_t, complex>(OpSum const &, Block const &, int32_t,
+                             std::string const &);
 template CSRMatrix<int64_t, double>
-csr_matrix<int64_t, double>(OpSum const &, Block const &, int64_t);
+csr_matrix<int64_t, double>(OpSum const &, Block const &, int64_t,
+                            std::string const &);
 template CSRMatrix<int64_t, complex>
-csr_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t);
-
-template CSRMatrix<int32_t, double> csr_matrix<int32_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int32_t);
-template CSRMatrix<int32_t, complex> csr_matrix<int32_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int32_t);
-template CSRMatrix<int64_t, double> csr_matrix<int64_t, double>(OpSum const &,
-                                                                Block const &,
-                                                                Block const &,
-                                                                int64_t);
-template CSRMatrix<int64_t, complex> csr_matrix<int64_t, complex>(OpSum const &,
-                                                                  Block const &,
-                                                                  Block const &,
-                                                                  int64_t);
+csr_matrix<int64_t, complex>(OpSum const &, Block const &, int64_t,
+                             std::string const &);
+
+template CSRMatrix<int32_t, double>
+csr_matrix<int32_t, double>(OpSum const &, Block const &, Block const &,
+                            int32_t, std::string const &);
+template CSRMatrix<int32_t, complex>
+csr_matrix<int32_t, complex>(OpSum const &, Block const &, Block const &,
+                             int32_t, std::string const &);
+template CSRMatrix<int64_t, double>
+csr_matrix<int64_t, double>(OpSum const &, Block const &, Block const &,
+                            int64_t, std::string const &);
+template CSRMatrix<int64_t, complex>
+csr_matrix<int64_t, complex>(OpSum const &, Block const &, Block const &,
+                             int64_t, std::string const &);
+
+// Hermitian half storage, the output block equals the input block
+template <typename idx_t, typename coeff_t>
+CSRMatrix<idx_t, coeff_t> csr_matrix_triangle(OpSum const &ops,
+                                              Block const &block,
+                                              std::string const &triangle,
+                                              idx_t i0,
+                                              std::string const &assembly) try {
+  if ((triangle != "upper") && (triangle != "lower")) {
+    XDIAG_THROW(fmt::format(
+        "Invalid triangle \"{}\". Must be either \"upper\" or \"lower\"",
+        triangle));
+  }
+  CSRMatrix<idx_t, coeff_t> result;
+  utils::visit_same_type(
+      block, block,
+      [&](auto const &bin, auto const &) {
+        using block_t = std::decay_t<decltype(bin)>;
+        if constexpr (is_distributed_v<block_t>) {
+          XDIAG_THROW("Cannot build a sparse matrix for a distributed block: "
+                      "its Hilbert space is distributed across MPI ranks. Use "
+                      "apply(...) instead.");
+        } else {
+          if (!ishermitian(ops, bin)) {
+            XDIAG_THROW("Cannot store only a triangle of the sparse matrix of "
+                        "an OpSum which is not Hermitian");
+          }
+          check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bin, i0);
+          result =
+              csr_matrix_impl<idx_t, coeff_t>(ops, bin, bin, i0, triangle,
+                                              assembly);
+        }
+      },
+      "Type mismatch of Block types");
+  return result;
+}
+XDIAG_CATCH
+
+template CSRMatrix<int32_t, double>
+csr_matrix_triangle<int32_t, double>(OpSum const &, Block const &,
+                                     std::string const &, int32_t,
+                                     std::string const &);
+template CSRMatrix<int32_t, complex>
+csr_matrix_triangle<int32_t, complex>(OpSum const &, Block const &,
+                                      std::string const &, int32_t,
+                                      std::string const &);
+template CSRMatrix<int64_t, double>
+csr_matrix_triangle<int64_t, double>(OpSum const &, Block const &,
+                                     std::string const &, int64_t,
+                                     std::string const &);
+template CSRMatrix<int64_t, complex>
+csr_matrix_triangle<int64_t, complex>(OpSum const &, Block const &,
+                                      std::string const &, int64_t,
+                                      std::string const &);
 
 // Named convenience wrappers.
 CSRMatrix<int64_t, double> csr_matrix(OpSum const &ops, Block const &block,
-                                      int64_t i0) try {
-  return csr_matrix<int64_t, double>(ops, block, i0);
+                                      int64_t i0,
+                                      std::string const &assembly) try {
+  return csr_matrix<int64_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int64_t, double> csr_matrix(OpSum const &ops, Block const &block_in,
-                                      Block const &block_out, int64_t i0) try {
-  return csr_matrix<int64_t, double>(ops, block_in, block_out, i0);
+                                      Block const &block_out, int64_t i0,
+                                      std::string const &assembly) try {
+  return csr_matrix<int64_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int64_t, complex> csr_matrixC(OpSum const &ops, Block const &block,
-                                        int64_t i0) try {
-  return csr_matrix<int64_t, complex>(ops, block, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return csr_matrix<int64_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int64_t, complex> csr_matrixC(OpSum const &ops, Block const &block_in,
                                         Block const &block_out,
-                                        int64_t i0) try {
-  return csr_matrix<int64_t, complex>(ops, block_in, block_out, i0);
+                                        int64_t i0,
+                                        std::string const &assembly) try {
+  return csr_matrix<int64_t, complex>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int32_t, double> csr_matrix_32(OpSum const &ops, Block const &block,
-                                         int32_t i0) try {
-  return csr_matrix<int32_t, double>(ops, block, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return csr_matrix<int32_t, double>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int32_t, double> csr_matrix_32(OpSum const &ops,
                                          Block const &block_in,
                                          Block const &block_out,
-                                         int32_t i0) try {
-  return csr_matrix<int32_t, double>(ops, block_in, block_out, i0);
+                                         int32_t i0,
+                                         std::string const &assembly) try {
+  return csr_matrix<int32_t, double>(ops, block_in, block_out, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int32_t, complex> csr_matrixC_32(OpSum const &ops, Block const &block,
-                                           int32_t i0) try {
-  return csr_matrix<int32_t, complex>(ops, block, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return csr_matrix<int32_t, complex>(ops, block, i0, assembly);
 }
 XDIAG_CATCH
 
 CSRMatrix<int32_t, complex> csr_matrixC_32(OpSum const &ops,
                                            Block const &block_in,
                                            Block const &block_out,
-                                           int32_t i0) try {
-  return csr_matrix<int32_t, complex>(ops, block_in, block_out, i0);
+                                           int32_t i0,
+                                           std::string const &assembly) try {
+  return csr_matrix<int32_t, complex>(ops, block_in, block_out, i0, assembly);
+}
+XDIAG_CATCH
+
+CSRMatrix<int64_t, double>
+csr_matrix_triangle(OpSum const &ops, Block const &block,
+                    std::string const &triangle, int64_t i0,
+                    std::string const &assembly) try {
+  return csr_matrix_triangle<int64_t, double>(ops, block, triangle, i0,
+                                              assembly);
+}
+XDIAG_CATCH
+
+CSRMatrix<int64_t, complex>
+csr_matrixC_triangle(OpSum const &ops, Block const &block,
+                     std::string const &triangle, int64_t i0,
+                     std::string const &assembly) try {
+  return csr_matrix_triangle<int64_t, complex>(ops, block, triangle, i0,
+                                               assembly);
+}
+XDIAG_CATCH
+
+CSRMatrix<int32_t, double>
+csr_matrix_triangle_32(OpSum const &ops, Block const &block,
+                       std::string const &triangle, int32_t i0,
+                       std::string const &assembly) try {
+  return csr_matrix_triangle<int32_t, double>(ops, block, triangle, i0,
+                                              assembly);
+}
+XDIAG_CATCH
+
+CSRMatrix<int32_t, complex>
+csr_matrixC_triangle_32(OpSum const &ops, Block const &block,
+                        std::string const &triangle, int32_t i0,
+                        std::string const &assembly) try {
+  return csr_matrix_triangle<int32_t, complex>(ops, block, triangle, i0,
+                                               assembly);
 }
 XDIAG_CATCH
 
@@ -221,9 +326,8 @@ void csr_matrix_fill(OpSum const &ops, Block const &block_in,
                       "apply(...) instead.");
         } else {
           check_valid_sparse_matrix<idx_t, coeff_t>(ops, bin, bout, i0);
-          build_csr_fill<idx_t, coeff_t, block_t>(ops, bin, bout,
-                                                  n_elements_in_row, rowptr, col,
-                                                  data, i0, transpose);
+build_csr_fill<idx_t, coeff_t, block_t>(ops, bin, bout, n_elements_in_row,
+                                        rowptr, col, data, i0, transpose);
         }
       },
       "Type mismatch of Block types");
@@ -273,6 +377,13 @@ arma::Mat<coeff_t> to_dense(CSRMatrix<idx_t, coeff_t> const &csr_mat) try {
         "Number of column entries does not match number of data entries");
   }
 
+  std::string const &triangle = csr_mat.triangle;
+  if ((triangle != "full") && (triangle != "upper") && (triangle != "lower")) {
+    XDIAG_THROW(fmt::format("Invalid triangle \"{}\". Must be either "
+                            "\"full\", \"upper\" or \"lower\"",
+                            triangle));
+  }
+
   arma::Mat<coeff_t> m(csr_mat.nrows, csr_mat.ncols, arma::fill::zeros);
 
   if (csr_mat.i0 == 0) {
@@ -297,6 +408,13 @@ arma::Mat<coeff_t> to_dense(CSRMatrix<idx_t, coeff_t> const &csr_mat) try {
         "Invalid zero index i0. Must be either 0 or 1, but got i0={}",
         csr_mat.i0));
   }
+
+  // the strict other triangle is the adjoint of the stored one
+  if (triangle != "full") {
+    arma::Mat<coeff_t> strict = m;
+    strict.diag().zeros();
+    m += strict.t();
+  }
   return m;
 }
 XDIAG_CATCH
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/op.hpp>
@@ -13,43 +15,72 @@ namespace xdiag {
 
 // int64_t, double
 XDIAG_API CSRMatrix<int64_t, double>
-csr_matrix(OpSum const &ops, Block const &block, int64_t i0 = 0);
-XDIAG_API CSRMatrix<int64_t, double> csr_matrix(OpSum const &ops,
-                                                Block const &block_in,
-                                                Block const &block_out,
-                                                int64_t i0 = 0);
+csr_matrix(OpSum const &ops, Block const &block, int64_t i0 = 0,
+           std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int64_t, double>
+csr_matrix(OpSum const &ops, Block const &block_in, Block const &block_out,
+           int64_t i0 = 0, std::string const &assembly = "auto");
 
 // int64_t, complex
 XDIAG_API CSRMatrix<int64_t, complex>
-csr_matrixC(OpSum const &ops, Block const &block, int64_t i0 = 0);
-XDIAG_API CSRMatrix<int64_t, complex> csr_matrixC(OpSum const &ops,
-                                                  Block const &block_in,
-                                                  Block const &block_out,
-                                                  int64_t i0 = 0);
+csr_matrixC(OpSum const &ops, Block const &block, int64_t i0 = 0,
+            std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int64_t, complex>
+csr_matrixC(OpSum const &ops, Block const &block_in, Block const &block_out,
+            int64_t i0 = 0, std::string const &assembly = "auto");
 // int32_t, double
 XDIAG_API CSRMatrix<int32_t, double>
-csr_matrix_32(OpSum const &ops, Block const &block, int32_t i0 = 0);
-XDIAG_API CSRMatrix<int32_t, double> csr_matrix_32(OpSum const &ops,
-                                                   Block const &block_in,
-                                                   Block const &block_out,
-                                                   int32_t i0 = 0);
+csr_matrix_32(OpSum const &ops, Block const &block, int32_t i0 = 0,
+              std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int32_t, double>
+csr_matrix_32(OpSum const &ops, Block const &block_in, Block const &block_out,
+              int32_t i0 = 0, std::string const &assembly = "auto");
 // int32_t, complex
 XDIAG_API CSRMatrix<int32_t, complex>
-csr_matrixC_32(OpSum const &ops, Block const &block, int32_t i0 = 0);
-XDIAG_API CSRMatrix<int32_t, complex> csr_matrixC_32(OpSum const &ops,
-                                                     Block const &block_in,
-                                                     Block const &block_out,
-                                                     int32_t i0 = 0);
+csr_matrixC_32(OpSum const &ops, Block const &block, int32_t i0 = 0,
+               std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int32_t, complex>
+csr_matrixC_32(OpSum const &ops, Block const &block_in, Block const &block_out,
+               int32_t i0 = 0, std::string const &assembly = "auto");
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API CSRMatrix<idx_t, coeff_t>
-csr_matrix(OpSum const &ops, Block const &block, idx_t i0 = 0);
+csr_matrix(OpSum const &ops, Block const &block, idx_t i0 = 0,
+           std::string const &assembly = "auto");
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API CSRMatrix<idx_t, coeff_t>
 csr_matrix(OpSum const &ops, Block const &block_in, Block const &block_out,
-           idx_t i0 = 0);
+           idx_t i0 = 0, std::string const &assembly = "auto");
+
+// Hermitian half storage: only the upper or lower triangle including the
+// diagonal is built, about half of the entries of csr_matrix. The OpSum has to
+// be Hermitian on the block. apply and the algorithms taking a CSRMatrix use
+// the implied other triangle.
+XDIAG_API CSRMatrix<int64_t, double>
+csr_matrix_triangle(OpSum const &ops, Block const &block,
+                    std::string const &triangle = "upper", int64_t i0 = 0,
+                    std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int64_t, complex>
+csr_matrixC_triangle(OpSum const &ops, Block const &block,
+                     std::string const &triangle = "upper", int64_t i0 = 0,
+                     std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int32_t, double>
+csr_matrix_triangle_32(OpSum const &ops, Block const &block,
+                       std::string const &triangle = "upper", int32_t i0 = 0,
+                       std::string const &assembly = "auto");
+XDIAG_API CSRMatrix<int32_t, complex>
+csr_matrixC_triangle_32(OpSum const &ops, Block const &block,
+                        std::string const &triangle = "upper", int32_t i0 = 0,
+                        std::string const &assembly = "auto");
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API CSRMatrix<idx_t, coeff_t>
+csr_matrix_triangle(OpSum const &ops, Block const &block,
+                    std::string const &triangle = "upper", idx_t i0 = 0,
+                    std::string const &assembly = "auto");
 
+// Triangular matrices are expanded to the full Hermitian matrix
 template <typename idx_t, typename coeff_t>
 XDIAG_API arma::Mat<coeff_t> to_dense(CSRMatrix<idx_t, coeff_t> const &csr_mat);
 
@@ -63,7 +94,10 @@ XDIAG_API arma::Mat<coeff_t> to_dense(CSRMatrix<idx_t, coeff_t> const &csr_mat);
 // Phase 2 — csr_matrix_fill: populates the caller's rowptr/col/data. The
 // phase-1 counts must be passed back in as n_elements_in_row (used to build
 // rowptr and the per-row write offsets, avoiding a second counting pass). i0
-// is the index base (0 or 1). Entries within each row are sorted by column.
+// is the index base (0 or 1). Entries within each row are sorted by column,
+// entries with equal column are summed and exact zeros are dropped. Hence the
+// merged nnz, rowptr[nrows] - i0, can be smaller than the sum of the counts;
+// the remaining entries of col/data are set to i0 and zero.
 // No pointer is retained past the call; the buffers must outlive it only.
 // coeff_t in {double, complex}; idx_t in {int32_t, int64_t}. Distributed
 // blocks throw.
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "csrvi_matrix.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace xdiag {
+
+static constexpr int64_t csrvi_max_values = 1 << 16;
+
+// strict weak ordering of real or complex values, real part first
+template <typename coeff_t> static bool value_less(coeff_t a, coeff_t b) {
+  if constexpr (isreal<coeff_t>()) {
+    return a < b;
+  } else {
+    return (a.real() < b.real()) ||
+           ((a.real() == b.real()) && (a.imag() < b.imag()));
+  }
+}
+
+template <typename validx_t, typename coeff_t>
+static void fill_validx(std::vector<coeff_t> const &values,
+                        arma::Col<coeff_t> const &data,
+                        arma::Col<validx_t> &validx) {
+  int64_t nnz = data.n_elem;
+  validx = arma::Col<validx_t>(nnz);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int64_t k = 0; k < nnz; ++k) {
+    auto it = std::lower_bound(values.begin(), values.end(), data(k),
+                               value_less<coeff_t>);
+    validx(k) = (validx_t)(it - values.begin());
+  }
+}
+
+template <typename idx_t, typename coeff_t>
+CSRVIMatrix<idx_t, coeff_t>
+csrvi_matrix(CSRMatrix<idx_t, coeff_t> const &csr_mat) try {
+  int64_t nrows = csr_mat.nrows;
+  int64_t nnz = csr_mat.data.n_elem;
+  idx_t i0 = csr_mat.i0;
+  if (!((i0 == 0) || (i0 == 1))) {
+    XDIAG_THROW(fmt::format(
+        "Invalid zero index i0. Must be either 0 or 1, but got i0={}", i0));
+  }
+  if (csr_mat.triangle != "full") {
+    XDIAG_THROW(fmt::format("Cannot convert a CSRMatrix storing only its {} "
+                            "triangle to the CSRVI format",
+                            csr_mat.triangle));
+  }
+  if ((int64_t)csr_mat.rowptr.n_elem != nrows + 1) {
+    XDIAG_THROW(fmt::format(
+        "Number of rowptr entries ({}) does not match number of rows (+1) ({})",
+        csr_mat.rowptr.n_elem, nrows + 1));
+  }
+  if ((int64_t)csr_mat.col.n_elem != nnz) {
+    XDIAG_THROW(fmt::format(
+        "Number of col entries ({}) does not match number of data entries ({})",
+        csr_mat.col.n_elem, nnz));
+  }
+
+  // Collect the distinct values per thread. Every thread keeps a sorted list,
+  // which stays small for the matrices this format is meant for.
+  std::vector<coeff_t> values;
+  coeff_t const *data = csr_mat.data.memptr();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<coeff_t> local;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int64_t k = 0; k < nnz; ++k) {
+      if ((int64_t)local.size() > csrvi_max_values) {
+        continue;
+      }
+      auto it = std::lower_bound(local.begin(), local.end(), data[k],
+                                 value_less<coeff_t>);
+      if ((it == local.end()) || !(*it == data[k])) {
+        local.insert(it, data[k]);
+      }
+    }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+    values.insert(values.end(), local.begin(), local.end());
+  }
+  std::sort(values.begin(), values.end(), value_less<coeff_t>);
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  if ((int64_t)values.size() > csrvi_max_values) {
+    XDIAG_THROW(fmt::format("Matrix has more than {} distinct entries, which "
+                            "cannot be stored with value indices",
+                            csrvi_max_values));
+  }
+
+  CSRVIMatrix<idx_t, coeff_t> csrvi_mat;
+  csrvi_mat.nrows = csr_mat.nrows;
+  csrvi_mat.ncols = csr_mat.ncols;
+  csrvi_mat.ishermitian = csr_mat.ishermitian;
+  csrvi_mat.values = arma::Col<coeff_t>(values);
+  csrvi_mat.rowptr = csr_mat.rowptr - i0;
+
+  // Columns are encoded as differences within every row
+  csrvi_mat.coldelta = arma::Col<uint32_t>(nnz);
+  constexpr int64_t max_delta = std::numeric_limits<uint32_t>::max();
+  bool valid = true;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(&& : valid)
+#endif
+  for (int64_t row = 0; row < nrows; ++row) {
+    int64_t prev = 0;
+    for (int64_t k = csr_mat.rowptr(row) - i0; k < csr_mat.rowptr(row + 1) - i0;
+         ++k) {
+      int64_t c = csr_mat.col(k) - i0;
+      int64_t delta = c - prev;
+      if ((delta < 0) || (delta > max_delta)) {
+        valid = false;
+        delta = 0;
+      }
+      csrvi_mat.coldelta(k) = (uint32_t)delta;
+      prev = c;
+    }
+  }
+  if (!valid) {
+    XDIAG_THROW("Columns of every row must be ascending and their differences "
+                "must fit into 32 bits to be stored in a CSRVIMatrix");
+  }
+
+  if ((int64_t)values.size() <= 256) {
+    fill_validx(values, csr_mat.data, csrvi_mat.validx8);
+  } else {
+    fill_validx(values, csr_mat.data, csrvi_mat.validx16);
+  }
+  Log(1, "CSRVI matrix: {} nonzeros with {} distinct values", nnz,
+      values.size());
+  return csrvi_mat;
+}
+XDIAG_CATCH
+
+template CSRVIMatrix<int32_t, double>
+csrvi_matrix(CSRMatrix<int32_t, double> const &);
+template CSRVIMatrix<int64_t, double>
+csrvi_matrix(CSRMatrix<int64_t, double> const &);
+template CSRVIMatrix<int32_t, complex>
+csrvi_matrix(CSRMatrix<int32_t, complex> const &);
+template CSRVIMatrix<int64_t, complex>
+csrvi_matrix(CSRMatrix<int64_t, complex> const &);
+
+template <typename idx_t, typename coeff_t>
+arma::Mat<coeff_t> to_dense(CSRVIMatrix<idx_t, coeff_t> const &csrvi_mat) try {
+  int64_t nrows = csrvi_mat.nrows;
+  int64_t nnz = csrvi_mat.coldelta.n_elem;
+  if ((int64_t)csrvi_mat.rowptr.n_elem != nrows + 1) {
+    XDIAG_THROW(fmt::format(
+        "Number of rowptr entries ({}) does not match number of rows (+1) ({})",
+        csrvi_mat.rowptr.n_elem, nrows + 1));
+  }
+  bool small = csrvi_mat.values.n_elem <= 256;
+  int64_t nvalidx =
+      small ? csrvi_mat.validx8.n_elem : csrvi_mat.validx16.n_elem;
+  if (nvalidx != nnz) {
+    XDIAG_THROW(fmt::format(
+        "Number of value indices ({}) does not match number of entries ({})",
+        nvalidx, nnz));
+  }
+
+  arma::Mat<coeff_t> mat(nrows, csrvi_mat.ncols, arma::fill::zeros);
+  for (int64_t row = 0; row < nrows; ++row) {
+    int64_t c = 0;
+    for (int64_t k = csrvi_mat.rowptr(row); k < csrvi_mat.rowptr(row + 1);
+         ++k) {
+      c += csrvi_mat.coldelta(k);
+      int64_t v = small ? csrvi_mat.validx8(k) : csrvi_mat.validx16(k);
+      mat(row, c) += csrvi_mat.values(v);
+    }
+  }
+  return mat;
+}
+XDIAG_CATCH
+
+template arma::mat to_dense(CSRVIMatrix<int32_t, double> const &);
+template arma::mat to_dense(CSRVIMatrix<int64_t, double> const &);
+template arma::cx_mat to_dense(CSRVIMatrix<int32_t, complex> const &);
+template arma::cx_mat to_dense(CSRVIMatrix<int64_t, complex> const &);
+
+} // namespace xdiag
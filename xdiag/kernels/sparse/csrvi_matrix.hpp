@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
+
+// Conversion of a CSRMatrix to the value-indexed CSRVIMatrix format.
+//
+// Entries are considered equal if they are bitwise equal, such that the
+// conversion is lossless. Matrices with more than 65536 distinct entries or
+// with column differences beyond 32 bits within a row cannot be converted and
+// throw an Error.
+
+namespace xdiag {
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API CSRVIMatrix<idx_t, coeff_t>
+csrvi_matrix(CSRMatrix<idx_t, coeff_t> const &csr_mat);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Mat<coeff_t>
+to_dense(CSRVIMatrix<idx_t, coeff_t> const &csrvi_mat);
+
+} // namespace xdiag
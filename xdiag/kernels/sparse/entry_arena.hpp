@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace xdiag::kernels {
+
+// A matrix entry as emitted by the kernels, keyed by its group: the row for
+// CSR and the column for CSC. idx is the column (CSR) or row (CSC).
+template <typename coeff_t> struct SparseEntry {
+  int64_t group;
+  int64_t idx;
+  coeff_t val;
+};
+
+// Growable per-thread storage of matrix entries for the single-pass sparse
+// assembly. Every thread appends to its own arena, which consists of chunks of
+// fixed size, such that growing never copies previous entries. All chunks are
+// drawn from a common memory budget in bytes (negative: unlimited). Once a
+// chunk would exceed it, the arenas overflow and further entries are dropped;
+// the caller then has to assemble the matrix in two passes instead.
+template <typename coeff_t> class EntryArenas {
+public:
+  using entry_t = SparseEntry<coeff_t>;
+  using chunk_t = std::vector<entry_t>;
+  static constexpr int64_t chunk_size = 1 << 14;
+
+  EntryArenas(int64_t narenas, int64_t budget)
+      : arenas_(narenas), unlimited_(budget < 0),
+        bytes_left_(unlimited_ ? 0 : budget), overflow_(false) {}
+
+  inline void push(int64_t arena, int64_t group, int64_t idx, coeff_t val) {
+    if (overflow_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    auto &chunks = arenas_[arena];
+    if (chunks.empty() || ((int64_t)chunks.back().size() == chunk_size)) {
+      int64_t nbytes = chunk_size * sizeof(entry_t);
+      if (!unlimited_ && (bytes_left_.fetch_sub(nbytes) < nbytes)) {
+        overflow_.store(true, std::memory_order_relaxed);
+        return;
+      }
+      chunks.emplace_back();
+      chunks.back().reserve(chunk_size);
+    }
+    chunks.back().push_back({group, idx, val});
+  }
+
+  int64_t narenas() const { return arenas_.size(); }
+  std::vector<chunk_t> &chunks(int64_t arena) { return arenas_[arena]; }
+  bool overflow() const { return overflow_.load(); }
+  void clear() {
+    for (auto &chunks : arenas_) {
+      std::vector<chunk_t>().swap(chunks);
+    }
+  }
+
+private:
+  std::vector<std::vector<chunk_t>> arenas_;
+  bool unlimited_;
+  std::atomic<int64_t> bytes_left_;
+  std::atomic<bool> overflow_;
+};
+
+} // namespace xdiag::kernels
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sell_matrix.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace xdiag {
+
+template <typename idx_t, typename coeff_t>
+SELLMatrix<idx_t, coeff_t> sell_matrix(CSRMatrix<idx_t, coeff_t> const &csr_mat,
+                                       int64_t C, int64_t sigma) try {
+  int64_t nrows = csr_mat.nrows;
+  idx_t i0 = csr_mat.i0;
+  if (!((i0 == 0) || (i0 == 1))) {
+    XDIAG_THROW(fmt::format(
+        "Invalid zero index i0. Must be either 0 or 1, but got i0={}", i0));
+  }
+  if (csr_mat.triangle != "full") {
+    XDIAG_THROW(fmt::format("Cannot convert a CSRMatrix storing only its {} "
+                            "triangle to the SELL-C-sigma format",
+                            csr_mat.triangle));
+  }
+  if ((int64_t)csr_mat.rowptr.n_elem != nrows + 1) {
+    XDIAG_THROW(fmt::format(
+        "Number of rowptr entries ({}) does not match number of rows (+1) ({})",
+        csr_mat.rowptr.n_elem, nrows + 1));
+  }
+  if (C < 1) {
+    XDIAG_THROW(fmt::format("Invalid chunk height C={}, must be positive", C));
+  }
+  if (sigma == 0) {
+    sigma = 32 * C;
+  } else if (sigma < 0) {
+    XDIAG_THROW(fmt::format(
+        "Invalid sorting window sigma={}, must be positive", sigma));
+  }
+
+  SELLMatrix<idx_t, coeff_t> sell_mat;
+  sell_mat.nrows = csr_mat.nrows;
+  sell_mat.ncols = csr_mat.ncols;
+  sell_mat.C = C;
+  sell_mat.sigma = sigma;
+  sell_mat.ishermitian = csr_mat.ishermitian;
+
+  // Sort rows by descending length within every window of sigma rows. The sort
+  // is stable, such that rows of equal length keep their order.
+  auto rowlen = [&csr_mat](int64_t row) -> int64_t {
+    return csr_mat.rowptr(row + 1) - csr_mat.rowptr(row);
+  };
+  std::vector<int64_t> perm(nrows);
+  std::iota(perm.begin(), perm.end(), 0);
+  for (int64_t start = 0; start < nrows; start += sigma) {
+    int64_t end = std::min(start + sigma, nrows);
+    std::stable_sort(
+        perm.begin() + start, perm.begin() + end,
+        [&rowlen](int64_t a, int64_t b) { return rowlen(a) > rowlen(b); });
+  }
+
+  // Every chunk is as wide as its longest row
+  int64_t nchunks = (nrows + C - 1) / C;
+  std::vector<int64_t> chunkptr(nchunks + 1, 0);
+  for (int64_t k = 0; k < nchunks; ++k) {
+    int64_t width = 0;
+    for (int64_t r = k * C; r < std::min((k + 1) * C, nrows); ++r) {
+      width = std::max(width, rowlen(perm[r]));
+    }
+    chunkptr[k + 1] = chunkptr[k] + width * C;
+  }
+  int64_t nnz_padded = chunkptr[nchunks];
+  if (nnz_padded > (int64_t)std::numeric_limits<idx_t>::max()) {
+    XDIAG_THROW(fmt::format("Number of padded entries ({}) exceeds the range "
+                            "of the index type",
+                            nnz_padded));
+  }
+  Log(1, "SELL-{}-{} matrix: {} nonzeros padded to {}", C, sigma,
+      csr_mat.data.n_elem, nnz_padded);
+
+  sell_mat.perm = arma::Col<idx_t>(nrows);
+  sell_mat.chunkptr = arma::Col<idx_t>(nchunks + 1);
+  sell_mat.col = arma::Col<idx_t>(nnz_padded);
+  sell_mat.data = arma::Col<coeff_t>(nnz_padded);
+  for (int64_t r = 0; r < nrows; ++r) {
+    sell_mat.perm(r) = (idx_t)perm[r];
+  }
+  for (int64_t k = 0; k <= nchunks; ++k) {
+    sell_mat.chunkptr(k) = (idx_t)chunkptr[k];
+  }
+
+  // Padding entries repeat the last column of their row, such that the SIMD
+  // gathers of padded lanes stay within cache lines already loaded
+  idx_t *col = sell_mat.col.memptr();
+  coeff_t *data = sell_mat.data.memptr();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int64_t k = 0; k < nchunks; ++k) {
+    int64_t width = (chunkptr[k + 1] - chunkptr[k]) / C;
+    for (int64_t r = 0; r < C; ++r) {
+      int64_t start = chunkptr[k] + r;
+      int64_t len = 0;
+      idx_t pad = 0;
+      if (k * C + r < nrows) {
+        int64_t row = perm[k * C + r];
+        int64_t begin = csr_mat.rowptr(row) - i0;
+        len = rowlen(row);
+        for (int64_t j = 0; j < len; ++j) {
+          col[start + j * C] = csr_mat.col(begin + j) - i0;
+          data[start + j * C] = csr_mat.data(begin + j);
+        }
+        if (len > 0) {
+          pad = csr_mat.col(begin + len - 1) - i0;
+        }
+      }
+      for (int64_t j = len; j < width; ++j) {
+        col[start + j * C] = pad;
+        data[start + j * C] = 0.;
+      }
+    }
+  }
+  return sell_mat;
+}
+XDIAG_CATCH
+
+template SELLMatrix<int32_t, double>
+sell_matrix(CSRMatrix<int32_t, double> const &, int64_t, int64_t);
+template SELLMatrix<int64_t, double>
+sell_matrix(CSRMatrix<int64_t, double> const &, int64_t, int64_t);
+template SELLMatrix<int32_t, complex>
+sell_matrix(CSRMatrix<int32_t, complex> const &, int64_t, int64_t);
+template SELLMatrix<int64_t, complex>
+sell_matrix(CSRMatrix<int64_t, complex> const &, int64_t, int64_t);
+
+template <typename idx_t, typename coeff_t>
+arma::Mat<coeff_t> to_dense(SELLMatrix<idx_t, coeff_t> const &sell_mat) try {
+  int64_t nrows = sell_mat.nrows;
+  int64_t C = sell_mat.C;
+  int64_t nchunks = (int64_t)sell_mat.chunkptr.n_elem - 1;
+  if ((C < 1) || (nchunks != (nrows + C - 1) / C)) {
+    XDIAG_THROW(fmt::format(
+        "Number of chunkptr entries ({}) does not match number of rows ({}) "
+        "and chunk height ({})",
+        sell_mat.chunkptr.n_elem, nrows, C));
+  }
+  if ((int64_t)sell_mat.perm.n_elem != nrows) {
+    XDIAG_THROW(fmt::format(
+        "Number of perm entries ({}) does not match number of rows ({})",
+        sell_mat.perm.n_elem, nrows));
+  }
+  if ((sell_mat.col.n_elem != sell_mat.data.n_elem) ||
+      ((int64_t)sell_mat.col.n_elem != sell_mat.chunkptr(nchunks))) {
+    XDIAG_THROW(fmt::format(
+        "Number of col entries ({}) and data entries ({}) must both equal the "
+        "number of padded entries ({})",
+        sell_mat.col.n_elem, sell_mat.data.n_elem, sell_mat.chunkptr(nchunks)));
+  }
+
+  arma::Mat<coeff_t> mat(nrows, sell_mat.ncols, arma::fill::zeros);
+  for (int64_t k = 0; k < nchunks; ++k) {
+    int64_t start = sell_mat.chunkptr(k);
+    int64_t width = (sell_mat.chunkptr(k + 1) - start) / C;
+    for (int64_t r = 0; r < std::min(C, nrows - k * C); ++r) {
+      int64_t row = sell_mat.perm(k * C + r);
+      for (int64_t j = 0; j < width; ++j) {
+        mat(row, sell_mat.col(start + j * C + r)) +=
+            sell_mat.data(start + j * C + r);
+      }
+    }
+  }
+  return mat;
+}
+XDIAG_CATCH
+
+template arma::mat to_dense(SELLMatrix<int32_t, double> const &);
+template arma::mat to_dense(SELLMatrix<int64_t, double> const &);
+template arma::cx_mat to_dense(SELLMatrix<int32_t, complex> const &);
+template arma::cx_mat to_dense(SELLMatrix<int64_t, complex> const &);
+
+} // namespace xdiag
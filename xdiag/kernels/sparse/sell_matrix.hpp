@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
+
+// Conversion of a CSRMatrix to the SELL-C-sigma format.
+//
+// The chunk height C should be a multiple of the SIMD width (4 doubles for
+// AVX2, 8 for AVX-512); the default of 8 suits both. Sorting rows within
+// windows of sigma rows reduces the padding of irregular matrices, at the
+// cost of scattering the output rows further apart. The default sorts within
+// windows of 32 chunks. sigma = 1 disables the sorting.
+
+namespace xdiag {
+
+constexpr int64_t sell_default_chunk_height = 8;
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API SELLMatrix<idx_t, coeff_t>
+sell_matrix(CSRMatrix<idx_t, coeff_t> const &csr_mat,
+            int64_t C = sell_default_chunk_height, int64_t sigma = 0);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API arma::Mat<coeff_t>
+to_dense(SELLMatrix<idx_t, coeff_t> const &sell_mat);
+
+} // namespace xdiag
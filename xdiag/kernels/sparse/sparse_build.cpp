@@ -5,13 +5,20 @@
 #include "sparse_build.hpp"
 
 #include <algorithm>
+#include <memory>
 #include <numeric>
+#include <string>
 
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/kernels/blocks/dispatch_bases.hpp>
+#include <xdiag/kernels/fill_functions.hpp>
 #include <xdiag/kernels/kernels.hpp>
+#include <xdiag/kernels/sparse/entry_arena.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+#include <xdiag/utils/memory.hpp>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -23,13 +30,31 @@ namespace xdiag {
 // Unified across CSR (transpose=false) and CSC (transpose=true): the transpose
 // flag is forwarded to the shared csr kernels, which key the fill by row (CSR)
 // or column (CSC); everything else (offset prefix sum, ptr construction,
-// per-group sort) is layout-agnostic. The arma path (build_csr_arrays) and the
-// caller-allocated path (build_csr_fill) both route through here.
+// per-group sort and merge) is layout-agnostic. The arma path
+// (build_csr_arrays) and the caller-allocated path (build_csr_fill) both route
+// through here.
+//
+// Only the entries within triangle (cf. fill_functions.hpp) are filled, the
+// counts have to be taken with the same triangle.
+//
+// If arenas is given, the entries collected by a single-pass run of the kernels
+// (cf. kernels::csr_matrix_entries) are scattered instead of running the
+// kernels a second time. Its chunks are released once they are written.
+//
+// The kernels emit one entry per term and matrix element, so a group can hold
+// the same index many times (e.g. one diagonal entry per Ising bond). These are
+// summed and entries which are exactly zero afterwards are dropped. The merge
+// is done in place: ptr is rewritten to the merged layout and the merged
+// number of nonzeros is returned; idx/data beyond it are left unspecified.
 template <typename idx_t, typename coeff_t, typename block_t, typename basis_t>
-static void sparse_fill_basis(OpSum const &ops, basis_t const &basis_in,
-                              basis_t const &basis_out, idx_t ndim, idx_t i0,
-                              bool transpose, std::vector<int64_t> const &counts,
-                              idx_t *ptr, idx_t *idx, coeff_t *data) {
+static int64_t sparse_fill_basis(OpSum const &ops, basis_t const &basis_in,
+                                 basis_t const &basis_out, idx_t ndim,
+                                 idx_t i0, bool transpose,
+                                 std::vector<int64_t> const &counts,
+                                 idx_t *ptr, idx_t *idx, coeff_t *data,
+                                 int triangle = kernels::triangle_full,
+                                 kernels::EntryArenas<coeff_t> *arenas =
+                                     nullptr) {
   int64_t nnz = std::accumulate(counts.begin(), counts.end(), (int64_t)0);
 
   // Build ptr (exclusive prefix sum + i0 shift) and the mutable offset array
@@ -43,29 +68,52 @@ static void sparse_fill_basis(OpSum const &ops, basis_t const &basis_in,
     ptr[ndim] = (idx_t)(nnz + i0);
   } else {
     ptr[0] = (idx_t)i0;
+    return 0;
   }
 
   // Pass 2: fill idx and data using atomic slot assignment.
-  kernels::csr_matrix_fill<block_t, coeff_t>(ops, basis_in, basis_out, offset,
-                                             idx, data, i0, transpose);
+  if (arenas) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int64_t a = 0; a < arenas->narenas(); ++a) {
+      for (auto &chunk : arenas->chunks(a)) {
+        for (auto const &entry : chunk) {
+          kernels::fill_csr(offset, idx, data, entry.idx, entry.group,
+                            entry.val, i0);
+        }
+        typename kernels::EntryArenas<coeff_t>::chunk_t().swap(chunk);
+      }
+    }
+  } else {
+    kernels::csr_matrix_fill<block_t, coeff_t>(ops, basis_in, basis_out,
+                                               offset, idx, data, i0,
+                                               transpose, triangle);
+  }
 
-  // Sort each group's entries by stored index (required for CSR/CSC validity).
-  int64_t max_elems =
-      counts.empty() ? 0 : *std::max_element(counts.begin(), counts.end());
+  // Sort and merge each group (required for CSR/CSC validity). The groups are
+  // split into one contiguous range per thread; every range is compacted
+  // towards its own start, so threads never write into each other's ranges.
+  int64_t max_elems = *std::max_element(counts.begin(), counts.end());
+  int64_t nranges = 1;
 #ifdef _OPENMP
-#pragma omp parallel
-  {
-    std::vector<int64_t> indices(max_elems);
-    std::vector<idx_t> idxtmp(max_elems);
-    std::vector<coeff_t> datatmp(max_elems);
-#pragma omp for
-#else
-  {
+  nranges = std::min((int64_t)omp_get_max_threads(), (int64_t)ndim);
+#endif
+  std::vector<int64_t> merged(ndim);
+  std::vector<int64_t> range_start(nranges);
+  std::vector<int64_t> range_nnz(nranges);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+  for (int64_t r = 0; r < nranges; ++r) {
     std::vector<int64_t> indices(max_elems);
     std::vector<idx_t> idxtmp(max_elems);
     std::vector<coeff_t> datatmp(max_elems);
-#endif
-    for (idx_t g = 0; g < ndim; ++g) {
+    int64_t gbegin = (int64_t)ndim * r / nranges;
+    int64_t gend = (int64_t)ndim * (r + 1) / nranges;
+    int64_t dst = (int64_t)(ptr[gbegin] - i0);
+    range_start[r] = dst;
+    for (int64_t g = gbegin; g < gend; ++g) {
       int64_t start = (int64_t)(ptr[g] - i0);
       int64_t end = (int64_t)(ptr[g + 1] - i0);
       int64_t nelems = end - start;
@@ -74,30 +122,121 @@ static void sparse_fill_basis(OpSum const &ops, basis_t const &basis_in,
       std::iota(indices.begin(), indices.begin() + nelems, (int64_t)0);
       std::sort(indices.begin(), indices.begin() + nelems,
                 [&](int64_t i, int64_t j) { return idxtmp[i] < idxtmp[j]; });
+
+      // dst <= start, and the group is read from the buffers
+      int64_t n = 0;
       for (int64_t i = 0; i < nelems; ++i) {
-        idx[start + i] = idxtmp[indices[i]];
-        data[start + i] = datatmp[indices[i]];
+        idx_t j = idxtmp[indices[i]];
+        coeff_t val = datatmp[indices[i]];
+        if ((n > 0) && (idx[dst + n - 1] == j)) {
+          data[dst + n - 1] += val;
+        } else {
+          if ((n > 0) && (data[dst + n - 1] == coeff_t(0.))) {
+            --n;
+          }
+          idx[dst + n] = j;
+          data[dst + n] = val;
+          ++n;
+        }
       }
+      if ((n > 0) && (data[dst + n - 1] == coeff_t(0.))) {
+        --n;
+      }
+      merged[g] = n;
+      dst += n;
     }
+    range_nnz[r] = dst - range_start[r];
+  }
+
+  // Close the gaps between the ranges. Every range only moves to the left,
+  // hence a forward copy in ascending order is safe.
+  int64_t nnz_merged = 0;
+  for (int64_t r = 0; r < nranges; ++r) {
+    if (range_start[r] != nnz_merged) {
+      std::copy(idx + range_start[r], idx + range_start[r] + range_nnz[r],
+                idx + nnz_merged);
+      std::copy(data + range_start[r], data + range_start[r] + range_nnz[r],
+                data + nnz_merged);
+    }
+    nnz_merged += range_nnz[r];
+  }
+  for (int64_t g = 0; g < ndim; ++g) {
+    ptr[g + 1] = (idx_t)(ptr[g] + merged[g]);
   }
+  Log(1, "sparse matrix: {} nonzeros merged to {}", nnz, nnz_merged);
+  return nnz_merged;
+}
+
+// Memory in bytes the arenas of the single-pass assembly may use (negative:
+// unlimited). In "auto" mode, the arenas and the arrays, which also hold every
+// entry, have to fit into half of the memory available to this process.
+template <typename idx_t, typename coeff_t>
+static int64_t single_pass_budget(std::string const &assembly) {
+  int64_t available = available_memory_per_process();
+  if ((assembly == "singlepass") || (available < 0)) {
+    return -1;
+  }
+  int64_t entry_bytes = sizeof(kernels::SparseEntry<coeff_t>);
+  int64_t array_bytes = sizeof(idx_t) + sizeof(coeff_t);
+  return available / 2 / (entry_bytes + array_bytes) * entry_bytes;
 }
 
 template <typename idx_t, typename coeff_t, typename block_t>
 void build_csr_arrays(OpSum const &ops, block_t const &block_in,
                       block_t const &block_out, idx_t ndim, idx_t i0,
                       bool transpose, arma::Col<idx_t> &ptr,
-                      arma::Col<idx_t> &idx, arma::Col<coeff_t> &data) try {
+                      arma::Col<idx_t> &idx, arma::Col<coeff_t> &data,
+                      std::string const &triangle,
+                      std::string const &assembly) try {
+  if ((assembly != "auto") && (assembly != "singlepass") &&
+      (assembly != "twopass")) {
+    XDIAG_THROW(fmt::format("Invalid sparse matrix assembly \"{}\". Must be "
+                            "either \"auto\", \"singlepass\" or \"twopass\"",
+                            assembly));
+  }
+  int tri = kernels::triangle_full;
+  if (triangle == "upper") {
+    tri = kernels::triangle_upper;
+  } else if (triangle == "lower") {
+    tri = kernels::triangle_lower;
+  } else if (triangle != "full") {
+    XDIAG_THROW(fmt::format("Invalid triangle \"{}\". Must be either "
+                            "\"full\", \"upper\" or \"lower\"",
+                            triangle));
+  }
   kernels::dispatch_basis(
       block_in, block_out, [&](auto const &basis_in, auto const &basis_out) {
-        auto counts = kernels::csr_matrix_nnz<block_t, coeff_t>(
-            ops, basis_in, basis_out, transpose);
+        std::vector<int64_t> counts;
+        std::unique_ptr<kernels::EntryArenas<coeff_t>> arenas;
+        if (assembly == "twopass") {
+          counts = kernels::csr_matrix_nnz<block_t, coeff_t>(
+              ops, basis_in, basis_out, transpose, tri);
+        } else {
+          int64_t nthreads = 1;
+#ifdef _OPENMP
+          nthreads = omp_get_max_threads();
+#endif
+          arenas = std::make_unique<kernels::EntryArenas<coeff_t>>(
+              nthreads, single_pass_budget<idx_t, coeff_t>(assembly));
+          counts = kernels::csr_matrix_entries<block_t, coeff_t>(
+              ops, basis_in, basis_out, *arenas, transpose, tri);
+          if (arenas->overflow()) {
+            Log(1, "sparse matrix: entries exceed the memory budget of the "
+                   "single pass, assembling in two passes");
+            arenas.reset();
+          }
+        }
         int64_t nnz = std::accumulate(counts.begin(), counts.end(), (int64_t)0);
         ptr.resize(ndim + 1);
         idx.resize(nnz);
         data.resize(nnz);
-        sparse_fill_basis<idx_t, coeff_t, block_t>(
+        int64_t nnz_merged = sparse_fill_basis<idx_t, coeff_t, block_t>(
             ops, basis_in, basis_out, ndim, i0, transpose, counts, ptr.memptr(),
-            idx.memptr(), data.memptr());
+            idx.memptr(), data.memptr(), tri, arenas.get());
+        if (nnz_merged < nnz) {
+          idx.resize(nnz_merged);
+          data.resize(nnz_merged);
+        }
       });
 }
 XDIAG_CATCH
@@ -118,7 +257,8 @@ std::vector<int64_t> build_csr_nnz(OpSum const &ops, block_t const &block_in,
 XDIAG_CATCH
 
 // Phase 2 (caller-allocated path): fill the caller's rowptr/col/data using the
-// counts returned by build_csr_nnz.
+// counts returned by build_csr_nnz. The caller's arrays cannot be shrunk, the
+// entries beyond the merged nnz are set to index i0 and value zero.
 template <typename idx_t, typename coeff_t, typename block_t>
 void build_csr_fill(OpSum const &ops, block_t const &block_in,
                     block_t const &block_out,
@@ -129,9 +269,13 @@ void build_csr_fill(OpSum const &ops, block_t const &block_in,
   idx_t ndim = (idx_t)(transpose ? size(block_in) : size(block_out));
   kernels::dispatch_basis(
       block_in, block_out, [&](auto const &basis_in, auto const &basis_out) {
-        sparse_fill_basis<idx_t, coeff_t, block_t>(
+        int64_t nnz = std::accumulate(n_elements_in_row.begin(),
+                                      n_elements_in_row.end(), (int64_t)0);
+        int64_t nnz_merged = sparse_fill_basis<idx_t, coeff_t, block_t>(
             ops, basis_in, basis_out, ndim, i0, transpose, n_elements_in_row,
             rowptr, col, data);
+        std::fill(col + nnz_merged, col + nnz, i0);
+        std::fill(data + nnz_merged, data + nnz, coeff_t(0.));
       });
 }
 XDIAG_CATCH
@@ -142,7 +286,8 @@ XDIAG_CATCH
 #define XDIAG_INST_BUILD_IC(BLOCK, IDX, COEFF)                                 \
   template void build_csr_arrays<IDX, COEFF, BLOCK>(                           \
       OpSum const &, BLOCK const &, BLOCK const &, IDX, IDX, bool,             \
-      arma::Col<IDX> &, arma::Col<IDX> &, arma::Col<COEFF> &);                 \
+      arma::Col<IDX> &, arma::Col<IDX> &, arma::Col<COEFF> &,                  \
+      std::string const &, std::string const &);                               \
   template void build_csr_fill<IDX, COEFF, BLOCK>(                             \
       OpSum const &, BLOCK const &, BLOCK const &,                            \
       std::vector<int64_t> const &, IDX *, IDX *, COEFF *, IDX, bool);
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <xdiag/armadillo.hpp>
 #include <xdiag/operators/opsum.hpp>
 
@@ -12,6 +14,12 @@ namespace xdiag {
 // Builds the CSR-style arrays (ptr of length ndim+1, idx, data) for a block.
 //   transpose == false -> CSR: ndim = nrows, groups are rows,    idx = columns
 //   transpose == true  -> CSC: ndim = ncols, groups are columns, idx = rows
+// Entries with equal (row, col) are summed and exact zeros dropped, idx and
+// data are shrunk to the merged number of nonzeros. Whether the kernels are
+// run once or twice is decided by assembly ("auto", "singlepass" or
+// "twopass"). With triangle
+// "upper" ("lower") only the entries on and above (below) the diagonal are
+// built, which describe a Hermitian matrix completely.
 // This is the single place the (expensive) per-basis-type dispatch is
 // instantiated; csr_matrix.cpp and csc_matrix.cpp both call it so the visitor
 // over all concrete basis types is compiled only once rather than in each.
@@ -19,14 +27,18 @@ template <typename idx_t, typename coeff_t, typename block_t>
 void build_csr_arrays(OpSum const &ops, block_t const &block_in,
                       block_t const &block_out, idx_t ndim, idx_t i0,
                       bool transpose, arma::Col<idx_t> &ptr,
-                      arma::Col<idx_t> &idx, arma::Col<coeff_t> &data);
+                      arma::Col<idx_t> &idx, arma::Col<coeff_t> &data,
+                      std::string const &triangle = "full",
+                      std::string const &assembly = "auto");
 
 // Two-phase CSR build into caller-owned storage (used by the Julia wrapper,
 // which allocates rowptr/col/data itself to avoid a copy). Phase 1 returns the
 // per-row nonzero counts (length size(block_out)); the caller sums them to get
 // nnz and allocates. Phase 2 fills the caller's arrays, building rowptr from the
-// same counts and sorting each row by column. Both go through the (single)
-// dispatch_basis instantiation here, shared with build_csr_arrays.
+// same counts, sorting each row by column and merging duplicates; rowptr then
+// describes the merged matrix, which may use less than the allocated nnz.
+// Both go through the (single) dispatch_basis instantiation here, shared with
+// build_csr_arrays.
 template <typename coeff_t, typename block_t>
 std::vector<int64_t> build_csr_nnz(OpSum const &ops, block_t const &block_in,
                                    block_t const &block_out,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <xdiag/armadillo.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/xdiag_api.hpp>
@@ -17,7 +19,9 @@ template <typename idx_t, typename coeff_t> struct XDIAG_API COOMatrix {
   bool ishermitian;        // flag whether matrix is hermitian/symmetric
 };
 
-// CSR format
+// CSR format. Hermitian matrices can be stored by their upper or lower
+// triangle including the diagonal only, indicated by triangle being "upper" or
+// "lower" instead of "full". The other triangle is implied by hermiticity.
 template <typename idx_t, typename coeff_t> struct XDIAG_API CSRMatrix {
   idx_t nrows;             // number of rows in the matrix
   idx_t ncols;             // number of columns in the matrix
@@ -26,6 +30,8 @@ template <typename idx_t, typename coeff_t> struct XDIAG_API CSRMatrix {
   arma::Col<coeff_t> data; // data entries each row consecutively
   idx_t i0;                // zero index, either 0 or 1
   bool ishermitian;        // flag whether matrix is hermitian/symmetric
+  // stored entries, either "full", "upper" or "lower" triangle
+  std::string triangle = "full";
 };
 
 // CSC format
@@ -39,6 +45,38 @@ template <typename idx_t, typename coeff_t> struct XDIAG_API CSCMatrix {
   bool ishermitian;        // flag whether matrix is hermitian/symmetric
 };
 
+// SELL-C-sigma format (sliced ELLPACK). Rows are sorted by their number of
+// entries within windows of sigma rows and grouped into chunks of C rows. Each
+// chunk is padded to its longest row and stored column-major, such that the C
+// rows of a chunk are processed in lockstep by SIMD units. Column indices are
+// zero-based, padding entries have a valid column and a zero value.
+template <typename idx_t, typename coeff_t> struct XDIAG_API SELLMatrix {
+  idx_t nrows;               // number of rows in the matrix
+  idx_t ncols;               // number of columns in the matrix
+  idx_t C;                   // chunk height, number of rows per chunk
+  idx_t sigma;               // sorting window, number of rows
+  arma::Col<idx_t> perm;     // original row of every sorted row (size: nrows)
+  arma::Col<idx_t> chunkptr; // pointer to elements of a chunk (size: nchunks+1)
+  arma::Col<idx_t> col;      // columns of every chunk, rows interleaved
+  arma::Col<coeff_t> data;   // data entries of every chunk, rows interleaved
+  bool ishermitian;          // flag whether matrix is hermitian/symmetric
+};
+
+// CSR format with value indices. Every distinct entry is stored once in
+// values, every nonzero only holds its 8-bit (at most 256 distinct values) or
+// 16-bit (at most 65536) index into it. Columns are stored as 32-bit
+// differences to the previous column of the row, starting from column zero.
+template <typename idx_t, typename coeff_t> struct XDIAG_API CSRVIMatrix {
+  idx_t nrows;                  // number of rows in the matrix
+  idx_t ncols;                  // number of columns in the matrix
+  arma::Col<idx_t> rowptr;      // pointer to elements of a row (size: nrows+1)
+  arma::Col<uint32_t> coldelta; // column differences, each row consecutively
+  arma::Col<coeff_t> values;    // distinct data entries
+  arma::Col<uint8_t> validx8;   // value indices if at most 256 values
+  arma::Col<uint16_t> validx16; // value indices if more than 256 values
+  bool ishermitian;             // flag whether matrix is hermitian/symmetric
+};
+
 template <typename idx_t, typename coeff_t>
 constexpr XDIAG_API bool isreal(CSRMatrix<idx_t, coeff_t> const &A) {
   (void)A; // need argument name for wrapper generator -> keep it
@@ -55,6 +93,18 @@ constexpr XDIAG_API bool isreal(COOMatrix<idx_t, coeff_t> const &A) {
   return isreal<coeff_t>();
 }
 
+template <typename idx_t, typename coeff_t>
+constexpr XDIAG_API bool isreal(SELLMatrix<idx_t, coeff_t> const &A) {
+  (void)A;
+  return isreal<coeff_t>();
+}
+
+template <typename idx_t, typename coeff_t>
+constexpr XDIAG_API bool isreal(CSRVIMatrix<idx_t, coeff_t> const &A) {
+  (void)A;
+  return isreal<coeff_t>();
+}
+
 template <typename idx_t, typename coeff_t>
 constexpr XDIAG_API bool ishermitian(CSRMatrix<idx_t, coeff_t> const &A) {
   return A.ishermitian;
@@ -67,5 +117,13 @@ template <typename idx_t, typename coeff_t>
 constexpr XDIAG_API bool ishermitian(COOMatrix<idx_t, coeff_t> const &A) {
   return A.ishermitian;
 }
+template <typename idx_t, typename coeff_t>
+constexpr XDIAG_API bool ishermitian(SELLMatrix<idx_t, coeff_t> const &A) {
+  return A.ishermitian;
+}
+template <typename idx_t, typename coeff_t>
+constexpr XDIAG_API bool ishermitian(CSRVIMatrix<idx_t, coeff_t> const &A) {
+  return A.ishermitian;
+}
 
 } // namespace xdiag
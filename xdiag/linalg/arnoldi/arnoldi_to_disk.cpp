@@ -5,14 +5,32 @@
 #include "arnoldi_to_disk.hpp"
 
 #include <xdiag/math/complex.hpp>
+#include <xdiag/utils/error.hpp>
 #include <xdiag/utils/read_vectors.hpp>
 
 namespace xdiag {
 
+std::string arnoldi_store_filename(std::string const &path_to_Avecs) {
+  return fmt::format("{}/Arnoldi.krylov", path_to_Avecs);
+}
+
 template <typename coeff_t>
-arma::Mat<coeff_t> read_arnoldi_vectors(std::string path_to_vecs, int n) {
-  return read_vectors<coeff_t>("Arnoldi", path_to_vecs, n);
+arma::Mat<coeff_t> read_arnoldi_vectors(std::string path_to_vecs, int n) try {
+  KrylovStore<coeff_t> store(arnoldi_store_filename(path_to_vecs));
+  if (n == 0) {
+    n = store.size();
+  } else if ((n < 0) || (n > store.size())) {
+    XDIAG_THROW(fmt::format("Invalid argument for number n of \"Arnoldi\" "
+                            "vectors, {} vectors are stored",
+                            store.size()));
+  }
+  arma::Mat<coeff_t> Avecs(store.dim(), n);
+  for (int k = 0; k < n; ++k) {
+    Avecs.col(k) = store.vector(k);
+  }
+  return Avecs;
 }
+XDIAG_CATCH
 
 template arma::Mat<double>
 read_arnoldi_vectors<double>(std::string path_to_vecs, int n);
@@ -10,15 +10,22 @@
 #include <utility>
 
 #include <xdiag/armadillo.hpp>
+#include <xdiag/linalg/arnoldi/krylov_store.hpp>
+#include <xdiag/utils/error.hpp>
 #include <xdiag/utils/format.hpp>
 #include <xdiag/utils/logger.hpp>
 #include <xdiag/utils/timing.hpp>
 
 namespace xdiag {
 
+// Name of the Krylov store (cf. krylov_store.hpp) in the directory
+// path_to_Avecs holding the Arnoldi vectors and the Hessenberg matrix
+std::string arnoldi_store_filename(std::string const &path_to_Avecs);
+
 template <typename mult, typename coeff_t>
 inline bool arnoldi_step(mult const &H, arma::Mat<coeff_t> &h,
-                         std::string path_to_Avecs, int k, double eps = 1e-12) {
+                         KrylovStore<coeff_t> &store, int k,
+                         double eps = 1e-12) {
   /*
    * Returns
    * -------
@@ -27,25 +34,16 @@ inline bool arnoldi_step(mult const &H, arma::Mat<coeff_t> &h,
   using namespace arma;
   using vec_t = Col<coeff_t>;
 
-  vec_t v_prev;
-  v_prev.load(fmt::format("{}/Arnoldi_{}.arm", path_to_Avecs, k - 1));
-  vec_t v(v_prev);
+  vec_t v_prev = store.vector(k - 1);
+  vec_t v(v_prev.n_elem);
   auto t0 = rightnow();
   H(v_prev, v);
-  timing(rightnow(), t0, "Arnoldi MVM", 2);
+  timing(t0, rightnow(), "Arnoldi MVM", 2);
 
+  // Gram-Schmidt (twice) in sequential sweeps through the store
   t0 = rightnow();
-  for (int j = 0; j < k; ++j) {
-    v_prev.load(fmt::format("{}/Arnoldi_{}.arm", path_to_Avecs, j));
-    h(j, k - 1) = cdot(v_prev, v);
-    v -= h(j, k - 1) * v_prev;
-  }
-  for (int j = 0; j < k; ++j) {
-    v_prev.load(fmt::format("{}/Arnoldi_{}.arm", path_to_Avecs, j));
-    auto temp = cdot(v_prev, v);
-    v -= temp * v_prev;
-  }
-  timing(rightnow(), t0, "Arnoldi ortho", 2);
+  h(span(0, k - 1), k - 1) = store.orthogonalize(v, 2);
+  timing(t0, rightnow(), "Arnoldi ortho", 2);
 
   h(k, k - 1) = norm(v);
   // check for breakdown
@@ -53,7 +51,7 @@ inline bool arnoldi_step(mult const &H, arma::Mat<coeff_t> &h,
     return true;
   }
   v /= h(k, k - 1);
-  v.save(fmt::format("{}/Arnoldi_{}.arm", path_to_Avecs, k));
+  store.push(v, h(span(0, k), k - 1));
 
   return false;
 }
@@ -61,7 +59,8 @@ inline bool arnoldi_step(mult const &H, arma::Mat<coeff_t> &h,
 template <typename mult, typename coeff_t>
 inline arma::Mat<coeff_t>
 arnoldi_iteration(mult const &H, arma::Col<coeff_t> const &q0,
-                  std::string path_to_Avecs, int n = 80, double eps = 1e-12) {
+                  std::string path_to_Avecs, int n = 80, double eps = 1e-12,
+                  bool resume = false) try {
   /* following from implementation on wikipedia:
    * https://en.wikipedia.org/wiki/Arnoldi_iteration with edits based on
    * Gram-Schmidt re-orthogonalisation:
@@ -71,7 +70,9 @@ arnoldi_iteration(mult const &H, arma::Col<coeff_t> const &q0,
    * stored as w) q0: initial vector for Arnoldi process (m,) path_to_Avecs:
    * where the Arnoldi vectors will be stored (abs.) n: number of iterations -
    * n.b. should stop if n> m-1 eps: deflation tolerance for stopping the
-   * process i.e. if beta < eps
+   * process i.e. if beta < eps resume: continue from the Arnoldi vectors
+   * stored in path_to_Avecs by a previous (e.g. interrupted) run with the same
+   * n and q0
    *
    * Returns:
    * --------
@@ -84,20 +85,25 @@ arnoldi_iteration(mult const &H, arma::Col<coeff_t> const &q0,
   using vec_t = Col<coeff_t>;
 
   mat_t h(n + 1, n, fill::zeros);
-
-  // normalise q0 and add to Q
-  double norm_0 = norm(q0);
-  if (norm_0 == 0) {
-    Log.err("initial vector norm is zero");
-    exit(1);
+  KrylovStore<coeff_t> store(arnoldi_store_filename(path_to_Avecs), q0.n_elem,
+                             n + 1, resume);
+
+  if (store.size() == 0) {
+    // normalise q0 and add to Q
+    double norm_0 = norm(q0);
+    if (norm_0 == 0) {
+      XDIAG_THROW("initial vector norm is zero");
+    }
+    vec_t v = q0 / norm_0;
+    store.push(v, vec_t());
+  } else {
+    h = store.projection().submat(0, 0, n, n - 1);
   }
-  vec_t v = q0 / norm(q0);
-  v.save(fmt::format("{}/Arnoldi_{}.arm", path_to_Avecs, 0));
 
   bool breakdown = false;
   // Arnoldi iterations
-  for (int k = 1; k < n + 1; ++k) {
-    breakdown = arnoldi_step(H, h, path_to_Avecs, k, eps);
+  for (int k = store.size(); k < n + 1; ++k) {
+    breakdown = arnoldi_step(H, h, store, k, eps);
     if (breakdown) {
       return h(span(0, k), span(0, k - 1));
     }
@@ -105,22 +111,26 @@ arnoldi_iteration(mult const &H, arma::Col<coeff_t> const &q0,
 
   return h;
 }
+XDIAG_CATCH
 
 template <typename mult, typename coeff_t>
 inline std::pair<arma::Col<coeff_t>, arma::Mat<coeff_t>>
 arnoldi(mult const &H, arma::Col<coeff_t> const &q0, std::string path_to_vecs,
         int n, double eps = 1e-12, bool is_hermitian = false,
-        bool build_ritz_vecs = true) {
+        bool build_ritz_vecs = true, bool resume = false) try {
   /* Arnoldi scheme for eigenvector decomposition
    * Parameters
    * ----------
    * H: matrix to be diagonalised
    * q0: starting vector for Arnoldi scheme (see krylov space)
-   * path_to_vecs: for storage of eigenvectors and Arnoldi vectors
+   * path_to_vecs: for storage of eigenvectors and Arnoldi vecs
    * n: iterations for Arnoldi
    * eps: breakdown tolerance of Arnoldi
    * is_hermitian: if H is hermitian option for eig_sym in algorithm for
-   * improved performance Returns
+   * improved performance
+   * build_ritz_vecs: whether Ritz vectors are computed
+   * resume: continue from the Arnoldi vectors stored by a previous run
+   * Returns
    * -------
    * eigvals: vec
    * n.b. eigvecs will be stored along with Arnoldi vecs in path_to_vecs
@@ -131,11 +141,10 @@ arnoldi(mult const &H, arma::Col<coeff_t> const &q0, std::string path_to_vecs,
   using mat_t = Mat<coeff_t>;
   using vec_t = Col<coeff_t>;
 
-  auto h = arnoldi_iteration(H, q0, path_to_vecs, n, eps);
+  auto h = arnoldi_iteration(H, q0, path_to_vecs, n, eps, resume);
 
   // krylov space dimension
   int M = h.n_cols; // krylov space dim
-  uword m = q0.n_elem;
   h = h(span(0, M - 1), span(0, M - 1));
   vec_t ritz_eigvals;
 
@@ -145,34 +154,21 @@ arnoldi(mult const &H, arma::Col<coeff_t> const &q0, std::string path_to_vecs,
       vec eigs_real;
       eig_sym(eigs_real, ritz_eigvecs_Abasis, h);
       ritz_eigvals = conv_to<vec_t>::from(eigs_real);
-      // need to build up each eigenvector
-      for (int i = 0; i < M; ++i) {
-        vec_t eig_vec_i(m);
-        vec_t arnoldi_k(m);
-        for (int k = 0; k < M; ++k) {
-          arnoldi_k.load(fmt::format("{}/Arnoldi_{}.arm", path_to_vecs, k));
-          eig_vec_i += arnoldi_k * ritz_eigvecs_Abasis(k, i);
-        }
-        eig_vec_i.save(fmt::format("{}/Ritz_{}.arm", path_to_vecs, i));
-      }
-      return {ritz_eigvals, h};
+    } else {
+      eig_gen(ritz_eigvals, ritz_eigvecs_Abasis, h);
     }
 
-    eig_gen(ritz_eigvals, ritz_eigvecs_Abasis, h);
-    // need to build up each eigenvector
+    // every eigenvector is built in one sweep through the Arnoldi vectors
+    KrylovStore<coeff_t> store(arnoldi_store_filename(path_to_vecs));
     for (int i = 0; i < M; ++i) {
-      vec_t eig_vec_i(m);
-      vec_t arnoldi_k(m);
-      for (int k = 0; k < M; ++k) {
-        arnoldi_k.load(fmt::format("{}/Arnoldi_{}.arm", path_to_vecs, k));
-        eig_vec_i += arnoldi_k * ritz_eigvecs_Abasis(k, i);
-      }
+      vec_t eig_vec_i = store.combine(ritz_eigvecs_Abasis.col(i));
       eig_vec_i.save(fmt::format("{}/Ritz_{}.arm", path_to_vecs, i));
     }
   }
 
   return {ritz_eigvals, h};
 }
+XDIAG_CATCH
 
 template <typename coeff_t>
 arma::Mat<coeff_t> read_arnoldi_vectors(std::string path_to_vecs, int n = 0);
@@ -0,0 +1,318 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "krylov_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <xdiag/math/complex.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+#include <xdiag/utils/logger.hpp>
+
+namespace xdiag {
+
+// File layout: header | projection | vectors, each section starting at a
+// multiple of the alignment
+static constexpr int64_t alignment = 4096;
+static constexpr int64_t block_bytes = 64 * 1024 * 1024;
+static constexpr char magic[8] = {'X', 'D', 'K', 'R', 'Y', 'L', 'O', 'V'};
+static constexpr int64_t version = 1;
+
+struct krylov_header_t {
+  char magic[8];
+  int64_t version;
+  int64_t iscomplex;
+  int64_t dim;
+  int64_t capacity;
+  int64_t size;
+};
+
+static int64_t align_up(int64_t x) {
+  return ((x + alignment - 1) / alignment) * alignment;
+}
+
+static const int64_t projection_offset = align_up(sizeof(krylov_header_t));
+
+template <typename coeff_t> static int64_t vectors_offset(int64_t capacity) {
+  return projection_offset +
+         align_up(capacity * capacity * (int64_t)sizeof(coeff_t));
+}
+
+static std::string error_string() { return std::string(std::strerror(errno)); }
+
+// Writes the pages containing [begin, begin + length) back to the file
+static void sync(char *map, char *begin, int64_t length,
+                 std::string const &filename) try {
+  char *aligned = map + ((begin - map) / alignment) * alignment;
+  if (msync(aligned, (begin - aligned) + length, MS_SYNC) != 0) {
+    XDIAG_THROW(fmt::format("Unable to write to Krylov store \"{}\": {}",
+                            filename, error_string()));
+  }
+}
+XDIAG_CATCH
+
+template <typename coeff_t>
+KrylovStore<coeff_t>::KrylovStore(std::string const &filename, int64_t dim,
+                                  int64_t capacity, bool resume) try
+    : filename_(filename), dim_(dim), capacity_(capacity), fd_(-1),
+      length_(0), map_(nullptr) {
+  if ((dim < 1) || (capacity < 1)) {
+    XDIAG_THROW("Dimension and capacity of a KrylovStore must be positive");
+  }
+  struct stat st;
+  if (resume && (stat(filename.c_str(), &st) == 0)) {
+    open_existing();
+    if ((dim_ != dim) || (capacity_ != capacity)) {
+      XDIAG_THROW(fmt::format(
+          "Krylov store \"{}\" has been created with a different dimension or "
+          "capacity (dim: {}, capacity: {})",
+          filename, dim_, capacity_));
+    }
+    Log(1, "Resuming from Krylov store \"{}\" with {} vectors", filename,
+        size());
+    return;
+  }
+
+  fd_ = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    XDIAG_THROW(fmt::format("Unable to create Krylov store \"{}\": {}",
+                            filename, error_string()));
+  }
+  length_ = vectors_offset<coeff_t>(capacity) +
+            capacity * dim * (int64_t)sizeof(coeff_t);
+  if (ftruncate(fd_, (off_t)length_) != 0) {
+    XDIAG_THROW(fmt::format("Unable to allocate {:.1f} MB for Krylov store "
+                            "\"{}\": {}",
+                            (double)length_ / 1e6, filename, error_string()));
+  }
+  krylov_header_t header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.iscomplex = !isreal<coeff_t>();
+  header.dim = dim;
+  header.capacity = capacity;
+  header.size = 0;
+  if (pwrite(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+    XDIAG_THROW(fmt::format("Unable to write header of Krylov store \"{}\"",
+                            filename));
+  }
+  map();
+}
+XDIAG_CATCH
+
+template <typename coeff_t>
+KrylovStore<coeff_t>::KrylovStore(std::string const &filename) try
+    : filename_(filename), dim_(0), capacity_(0), fd_(-1), length_(0),
+      map_(nullptr) {
+  open_existing();
+}
+XDIAG_CATCH
+
+template <typename coeff_t> void KrylovStore<coeff_t>::open_existing() try {
+  fd_ = open(filename_.c_str(), O_RDWR);
+  if (fd_ < 0) {
+    XDIAG_THROW(fmt::format("Unable to open Krylov store \"{}\": {}",
+                            filename_, error_string()));
+  }
+  krylov_header_t header;
+  if (pread(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+    XDIAG_THROW(fmt::format("Unable to read header of Krylov store \"{}\"",
+                            filename_));
+  }
+  if ((std::memcmp(header.magic, magic, sizeof(magic)) != 0) ||
+      (header.version != version)) {
+    XDIAG_THROW(
+        fmt::format("File \"{}\" is not a valid Krylov store", filename_));
+  }
+  if (header.iscomplex != (int64_t)!isreal<coeff_t>()) {
+    XDIAG_THROW(fmt::format("Krylov store \"{}\" holds {} vectors", filename_,
+                            header.iscomplex ? "complex" : "real"));
+  }
+  dim_ = header.dim;
+  capacity_ = header.capacity;
+  length_ = vectors_offset<coeff_t>(capacity_) +
+            capacity_ * dim_ * (int64_t)sizeof(coeff_t);
+  struct stat st;
+  if ((fstat(fd_, &st) != 0) || ((int64_t)st.st_size < (int64_t)length_)) {
+    XDIAG_THROW(fmt::format("Krylov store \"{}\" is truncated", filename_));
+  }
+  map();
+}
+XDIAG_CATCH
+
+template <typename coeff_t> void KrylovStore<coeff_t>::map() try {
+  block_ =
+      std::max((int64_t)1, block_bytes / (dim_ * (int64_t)sizeof(coeff_t)));
+  void *map =
+      mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    XDIAG_THROW(fmt::format("Unable to memory-map Krylov store \"{}\": {}",
+                            filename_, error_string()));
+  }
+  map_ = static_cast<char *>(map);
+  madvise(map_, length_, MADV_SEQUENTIAL);
+}
+XDIAG_CATCH
+
+template <typename coeff_t> KrylovStore<coeff_t>::~KrylovStore() {
+  if (map_) {
+    munmap(map_, length_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+template <typename coeff_t>
+std::string const &KrylovStore<coeff_t>::filename() const {
+  return filename_;
+}
+template <typename coeff_t> int64_t KrylovStore<coeff_t>::dim() const {
+  return dim_;
+}
+template <typename coeff_t> int64_t KrylovStore<coeff_t>::capacity() const {
+  return capacity_;
+}
+template <typename coeff_t> int64_t KrylovStore<coeff_t>::size() const {
+  return reinterpret_cast<krylov_header_t const *>(map_)->size;
+}
+
+template <typename coeff_t>
+coeff_t *KrylovStore<coeff_t>::column(int64_t k) const {
+  return reinterpret_cast<coeff_t *>(map_ + vectors_offset<coeff_t>(capacity_)) +
+         k * dim_;
+}
+
+template <typename coeff_t>
+coeff_t *KrylovStore<coeff_t>::projection_data() const {
+  return reinterpret_cast<coeff_t *>(map_ + projection_offset);
+}
+
+template <typename coeff_t>
+arma::Col<coeff_t> KrylovStore<coeff_t>::vector(int64_t k) const try {
+  if ((k < 0) || (k >= size())) {
+    XDIAG_THROW(fmt::format("Cannot access vector {} of Krylov store holding "
+                            "{} vectors",
+                            k, size()));
+  }
+  return arma::Col<coeff_t>(column(k), dim_);
+}
+XDIAG_CATCH
+
+template <typename coeff_t>
+arma::Mat<coeff_t> KrylovStore<coeff_t>::projection() const {
+  return arma::Mat<coeff_t>(projection_data(), capacity_, capacity_);
+}
+
+// Asks the operating system to read vectors k0, ..., k1 - 1 asynchronously
+template <typename coeff_t>
+void KrylovStore<coeff_t>::prefetch(int64_t k0, int64_t k1) const {
+  if (k0 >= k1) {
+    return;
+  }
+  char *begin = reinterpret_cast<char *>(column(k0));
+  char *end = reinterpret_cast<char *>(column(k1));
+  char *aligned = map_ + ((begin - map_) / alignment) * alignment;
+  madvise(aligned, end - aligned, MADV_WILLNEED);
+}
+
+// Calls f(k0, Q) for consecutive blocks Q = [v_k0, ..., v_{k0 + nk - 1}]
+// of the first n vectors, while the next block is prefetched
+template <typename coeff_t>
+template <class function_f>
+void KrylovStore<coeff_t>::sweep(int64_t n, function_f &&f) const {
+  prefetch(0, std::min(block_, n));
+  for (int64_t k0 = 0; k0 < n; k0 += block_) {
+    int64_t k1 = std::min(k0 + block_, n);
+    prefetch(k1, std::min(k1 + block_, n));
+    arma::Mat<coeff_t> Q(column(k0), dim_, k1 - k0, false, true);
+    f(k0, Q);
+  }
+}
+
+template <typename coeff_t>
+void KrylovStore<coeff_t>::push(arma::Col<coeff_t> const &v,
+                                arma::Col<coeff_t> const &h) try {
+  int64_t k = size();
+  if (k >= capacity_) {
+    XDIAG_THROW(fmt::format("Krylov store is full (capacity: {})", capacity_));
+  }
+  if ((int64_t)v.n_elem != dim_) {
+    XDIAG_THROW(fmt::format("Vector of dimension {} cannot be stored in Krylov "
+                            "store of dimension {}",
+                            v.n_elem, dim_));
+  }
+  if ((int64_t)h.n_elem > capacity_) {
+    XDIAG_THROW("Projection exceeds the capacity of the Krylov store");
+  }
+  if ((k == 0) && (h.n_elem > 0)) {
+    XDIAG_THROW("The first vector of a Krylov store has no projection column");
+  }
+  std::memcpy(column(k), v.memptr(), dim_ * sizeof(coeff_t));
+
+  // Data is written back before the header, such that the header always
+  // refers to complete vectors
+  sync(map_, reinterpret_cast<char *>(column(k)), dim_ * sizeof(coeff_t),
+       filename_);
+  if (k > 0) {
+    coeff_t *col = projection_data() + (k - 1) * capacity_;
+    std::fill(col, col + capacity_, coeff_t(0.));
+    std::copy(h.begin(), h.end(), col);
+    sync(map_, reinterpret_cast<char *>(col), capacity_ * sizeof(coeff_t),
+         filename_);
+  }
+  reinterpret_cast<krylov_header_t *>(map_)->size = k + 1;
+  sync(map_, map_, sizeof(krylov_header_t), filename_);
+}
+XDIAG_CATCH
+
+// Every pass is a single sweep through the store. The overlaps of a block are
+// taken with the copy w of v from the start of the pass, such that the result
+// equals classical Gram-Schmidt independent of the block size.
+template <typename coeff_t>
+arma::Col<coeff_t> KrylovStore<coeff_t>::orthogonalize(arma::Col<coeff_t> &v,
+                                                       int npasses) const try {
+  int64_t n = size();
+  arma::Col<coeff_t> coeffs(n, arma::fill::zeros);
+  for (int pass = 0; pass < npasses; ++pass) {
+    arma::Col<coeff_t> w = v;
+    sweep(n, [&](int64_t k0, arma::Mat<coeff_t> const &Q) {
+      arma::Col<coeff_t> h = Q.t() * w;
+      v -= Q * h;
+      coeffs.subvec(k0, k0 + Q.n_cols - 1) += h;
+    });
+  }
+  return coeffs;
+}
+XDIAG_CATCH
+
+template <typename coeff_t>
+arma::Col<coeff_t>
+KrylovStore<coeff_t>::combine(arma::Col<coeff_t> const &y) const try {
+  int64_t n = y.n_elem;
+  if (n > size()) {
+    XDIAG_THROW(fmt::format("Cannot combine {} vectors of Krylov store holding "
+                            "{} vectors",
+                            n, size()));
+  }
+  arma::Col<coeff_t> r(dim_, arma::fill::zeros);
+  sweep(n, [&](int64_t k0, arma::Mat<coeff_t> const &Q) {
+    r += Q * y.subvec(k0, k0 + Q.n_cols - 1);
+  });
+  return r;
+}
+XDIAG_CATCH
+
+template class KrylovStore<double>;
+template class KrylovStore<complex>;
+
+} // namespace xdiag
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <xdiag/armadillo.hpp>
+
+namespace xdiag {
+
+// Stores the vectors of a Krylov basis and the projection of the operator
+// onto it in a single memory-mapped file. The vectors are stored
+// contiguously, such that Gram-Schmidt orthogonalization against all stored
+// vectors and linear combinations of them are performed in a few sequential
+// sweeps through the file. During a sweep, the next block of vectors is
+// prefetched by the operating system while the current block is processed.
+//
+// A vector is only counted as stored once it and the projection have been
+// written back to the file. Hence, after a crash, a store can be reopened with
+// resume = true and the computation continues from the last complete step.
+template <typename coeff_t> class KrylovStore {
+public:
+  // Opens the store at "filename" holding up to "capacity" vectors of
+  // dimension "dim". The projection is a capacity x capacity matrix. If resume
+  // is true and the file exists, the stored vectors are kept. Otherwise, the
+  // file is (re)created.
+  KrylovStore(std::string const &filename, int64_t dim, int64_t capacity,
+              bool resume = false);
+
+  // Opens an existing store
+  explicit KrylovStore(std::string const &filename);
+  KrylovStore(KrylovStore const &) = delete;
+  KrylovStore &operator=(KrylovStore const &) = delete;
+  ~KrylovStore();
+
+  std::string const &filename() const;
+  int64_t dim() const;
+  int64_t capacity() const;
+  int64_t size() const;
+
+  arma::Col<coeff_t> vector(int64_t k) const;
+  arma::Mat<coeff_t> projection() const;
+
+  // Appends v as vector k = size() and stores h as column k - 1 of the
+  // projection (h is empty for k = 0), then commits both to disk. Only the
+  // new vector and column are written.
+  void push(arma::Col<coeff_t> const &v, arma::Col<coeff_t> const &h);
+
+  // Classical Gram-Schmidt of v against all stored vectors, repeated
+  // "npasses" times with one sweep through the store each. Returns the
+  // accumulated coefficients.
+  arma::Col<coeff_t> orthogonalize(arma::Col<coeff_t> &v,
+                                   int npasses = 2) const;
+
+  // Returns sum_k y(k) v_k over the first y.n_elem stored vectors
+  arma::Col<coeff_t> combine(arma::Col<coeff_t> const &y) const;
+
+private:
+  std::string filename_;
+  int64_t dim_;
+  int64_t capacity_;
+  int fd_;
+  std::size_t length_;
+  char *map_;
+  int64_t block_; // number of vectors per prefetched block
+
+  void open_existing();
+  void map();
+  coeff_t *column(int64_t k) const;
+  coeff_t *projection_data() const;
+  void prefetch(int64_t k0, int64_t k1) const;
+  template <class function_f> void sweep(int64_t n, function_f &&f) const;
+};
+
+} // namespace xdiag
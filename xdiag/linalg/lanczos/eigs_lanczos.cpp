@@ -4,60 +4,163 @@
 
 #include "eigs_lanczos.hpp"
 
+#include <type_traits>
+
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/sparse/apply.hpp>
 #include <xdiag/linalg/lanczos/eigvals_lanczos.hpp>
 #include <xdiag/linalg/lanczos/lanczos.hpp>
 #include <xdiag/linalg/lanczos/lanczos_convergence.hpp>
+#include <xdiag/linalg/lanczos/lanczos_vectors.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/math/dot.hpp>
 #include <xdiag/states/fill.hpp>
 #include <xdiag/states/random_state.hpp>
 #include <xdiag/utils/error.hpp>
+#include <xdiag/utils/memory.hpp>
 #include <xdiag/utils/timing.hpp>
 
 namespace xdiag {
 
-// Re-runs the Lanczos iteration for a given coefficient type, accumulating the
-// eigenvectors on the fly via the "operation" callback. The tridiagonal
-// eigenvectors "revecs" project each Lanczos vector onto the wanted Ritz
-// vectors. Shared by the real (coeff_t = double) and complex code paths.
+// Matrix-vector multiplication used in the Lanczos runs below
 template <typename coeff_t, typename op_t>
-static void run_eigs_lanczos(op_t const &ops, Block const &block,
-                             arma::Col<coeff_t> &v0, arma::mat const &revecs,
-                             int64_t neigvals, int64_t max_iterations,
-                             double deflation_tol, State &eigenvectors) {
-  int64_t iter = 1;
-  auto mult = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> &w) {
+static auto lanczos_mult(op_t const &ops, Block const &block, bool fused,
+                         int64_t &iter) {
+  return [&ops, &block, fused, &iter](arma::Col<coeff_t> const &v,
+                                      arma::Col<coeff_t> &w) {
     auto ta = rightnow();
-    apply(ops, block, v, block, w);
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(ops, block, v, block, w, fused, "pull"); // ops is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(ops, block, v, block, w, "pull"); // ops is Hermitian
+    } else {
+      apply(ops, block, v, block, w);
+    }
     Log(1, "Lanczos iteration {}", iter);
     timing(ta, rightnow(), "MVM", 1);
     ++iter;
   };
+}
+
+// Diagonalizes the T-matrix of a run, whose eigenvectors "revecs" project each
+// Lanczos vector onto the wanted Ritz vectors.
+static arma::mat tmatrix_eigenvectors(arma::vec const &alphas,
+                                      arma::vec const &betas) try {
+  Tmatrix tmatrix(arma::conv_to<std::vector<double>>::from(alphas),
+                  arma::conv_to<std::vector<double>>::from(betas));
+  arma::mat tmat = tmatrix.mat();
+  arma::vec reigs;
+  arma::mat revecs;
+  try {
+    arma::eig_sym(reigs, revecs, tmat);
+  } catch (...) {
+    XDIAG_THROW("Error diagonalizing tridiagonal matrix");
+  }
+  return revecs;
+}
+XDIAG_CATCH
+
+template <typename coeff_t>
+static void add_ritz_contribution(arma::Col<coeff_t> const &v, int64_t k,
+                                  arma::mat const &revecs, int64_t neigvals,
+                                  State &eigenvectors) {
+  auto coeffs = revecs.submat(k, 0, k, neigvals - 1);
+  if constexpr (isreal<coeff_t>()) {
+    eigenvectors.matrix(false) += arma::kron(v, coeffs);
+  } else {
+    eigenvectors.matrixC(false) += arma::kron(v, coeffs);
+  }
+}
+
+// Re-runs the Lanczos iteration for a given coefficient type, accumulating the
+// eigenvectors on the fly via the "operation" callback. Shared by the real
+// (coeff_t = double) and complex code paths.
+template <typename coeff_t, typename op_t>
+static void run_eigs_lanczos(op_t const &ops, Block const &block,
+                             arma::Col<coeff_t> &v0, arma::mat const &revecs,
+                             int64_t neigvals, int64_t max_iterations,
+                             double deflation_tol, bool fused,
+                             bool fused_recurrence, State &eigenvectors) {
+  int64_t iter = 1;
+  auto mult = lanczos_mult<coeff_t>(ops, block, fused, iter);
   auto dotf = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> const &w) {
     return math::dot(block, v, w);
   };
   auto operation = [&](arma::Col<coeff_t> const &v) {
-    auto coeffs = revecs.submat(iter - 1, 0, iter - 1, neigvals - 1);
-    if constexpr (isreal<coeff_t>()) {
-      eigenvectors.matrix(false) += arma::kron(v, coeffs);
-    } else {
-      eigenvectors.matrixC(false) += arma::kron(v, coeffs);
-    }
+    add_ritz_contribution(v, iter - 1, revecs, neigvals, eigenvectors);
   };
   // no convergence check: perform a fixed number of iterations
   auto converged = [](Tmatrix const &) -> bool { return false; };
+  auto reduce = [&block](double *sums, int64_t n) {
+    math::allreduce_sum(block, sums, n);
+  };
   lanczos::lanczos(mult, dotf, converged, operation, v0, max_iterations,
-                   deflation_tol);
+                   deflation_tol, reduce, fused_recurrence);
 }
 
+// Single Lanczos run which stores the Lanczos vectors, such that the
+// eigenvectors are formed without repeating the recurrence.
+template <typename coeff_t, typename op_t>
+static lanczos::lanczos_result_t
+run_eigs_lanczos_stored(op_t const &ops, Block const &block,
+                        arma::Col<coeff_t> &v0, int64_t neigvals,
+                        double precision, int64_t max_iterations,
+                        double deflation_tol, bool fused,
+                        bool fused_recurrence, std::string store,
+                        State &eigenvectors) try {
+  // In automatic mode, the vectors are kept in memory if the maximal number
+  // of iterations fits into half of the memory available to this process.
+  // Otherwise, they are moved to disk as soon as they exceed this budget.
+  int64_t budget = -1;
+  if (store == "auto") {
+    int64_t available = available_memory_per_process();
+    int64_t required = max_iterations * (int64_t)v0.n_elem * sizeof(coeff_t);
+    if ((available >= 0) && (required > available / 2)) {
+      budget = available / 2;
+    }
+  }
+  lanczos::LanczosVectors<coeff_t> vectors(store, budget);
+
+  int64_t iter = 1;
+  auto mult = lanczos_mult<coeff_t>(ops, block, fused, iter);
+  auto dotf = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> const &w) {
+    return math::dot(block, v, w);
+  };
+  auto operation = [&](arma::Col<coeff_t> const &v) { vectors.push(v); };
+  auto converged = [neigvals, precision](Tmatrix const &tmat) -> bool {
+    return lanczos::converged_eigenvalues(tmat, neigvals, precision);
+  };
+  auto reduce = [&block](double *sums, int64_t n) {
+    math::allreduce_sum(block, sums, n);
+  };
+  auto r = lanczos::lanczos(mult, dotf, converged, operation, v0,
+                            max_iterations, deflation_tol, reduce,
+                            fused_recurrence);
+  if (r.niterations == 0) {
+    return r;
+  }
+
+  auto ta = rightnow();
+  arma::mat revecs = tmatrix_eigenvectors(r.alphas, r.betas);
+  vectors.for_each([&](int64_t k, arma::Col<coeff_t> const &v) {
+    add_ritz_contribution(v, k, revecs, neigvals, eigenvectors);
+  });
+  Log(1, "Lanczos eigenvectors formed from {} stored vectors ({}), {} MVMs "
+         "saved",
+      vectors.size(), vectors.ondisk() ? "disk" : "memory", r.niterations);
+  timing(ta, rightnow(), "Ritz vectors", 1);
+  return r;
+}
+XDIAG_CATCH
+
 template <typename op_t>
 static EigsLanczosResult eigs_lanczos(op_t const &ops, State const &state0,
                                       int64_t neigvals, double precision,
                                       int64_t max_iterations,
-                                      double deflation_tol) try {
+                                      double deflation_tol, std::string store,
+                                      std::string const &recurrence,
+                                      bool fused) try {
   if (dim(state0) == 0) {
     Log.warn("Warning: initial state zero dimensional in eigs_lanczos");
     return EigsLanczosResult();
@@ -75,41 +178,67 @@ static EigsLanczosResult eigs_lanczos(op_t const &ops, State const &state0,
   if (!ishermitian(ops, state0.block())) {
     XDIAG_THROW("Input OpSum is not Hermitian");
   }
+  if ((store != "auto") && (store != "memory") && (store != "disk") &&
+      (store != "rerun")) {
+    XDIAG_THROW(fmt::format("Invalid argument \"store\": \"{}\". Must be "
+                            "\"auto\", \"memory\", \"disk\" or \"rerun\"",
+                            store));
+  }
+  bool fused_recurrence = lanczos::fused_recurrence(recurrence);
+
+  auto const &block = state0.block();
+  bool real = isreal(ops) && isreal(block) && isreal(state0);
+  State eigenvectors(block, real, neigvals);
+
+  // Single run storing the Lanczos vectors
+  if (store != "rerun") {
+    lanczos::lanczos_result_t r;
+    if (real) { // Real Lanczos
+      arma::vec v0 = state0.vector(0, true);
+      r = run_eigs_lanczos_stored(ops, block, v0, neigvals, precision,
+                                  max_iterations, deflation_tol, fused,
+                                  fused_recurrence, store, eigenvectors);
+    } else { // Complex Lanczos
+      State state1 = state0;
+      state1.make_complex();
+      arma::cx_vec v0 = state1.vectorC(0, false);
+      r = run_eigs_lanczos_stored(ops, block, v0, neigvals, precision,
+                                  max_iterations, deflation_tol, fused,
+                                  fused_recurrence, store, eigenvectors);
+    }
+    return {r.alphas,     r.betas,       r.eigenvalues,
+            eigenvectors, r.niterations, r.criterion};
+  }
 
   // store initial state, such that it can be used again in second run
   State state1 = state0;
 
   // Perform first run to compute eigenvalues
-  auto r = eigvals_lanczos_inplace(ops, state1, neigvals, precision,
-                                   max_iterations, deflation_tol);
+  EigvalsLanczosResult r;
+  if constexpr (std::is_same_v<op_t, OpSum>) {
+    r = eigvals_lanczos_inplace(ops, state1, neigvals, precision,
+                                max_iterations, deflation_tol, recurrence,
+                                fused);
+  } else {
+    r = eigvals_lanczos_inplace(ops, state1, neigvals, precision,
+                                max_iterations, deflation_tol, recurrence);
+  }
 
   // Perform second run to compute the eigenvectors. The tridiagonal T-matrix
   // is reconstructed from the recurrence coefficients (cf. Tmatrix::mat()).
-  Tmatrix tmatrix(arma::conv_to<std::vector<double>>::from(r.alphas),
-                  arma::conv_to<std::vector<double>>::from(r.betas));
-  arma::mat tmat = tmatrix.mat();
-
-  arma::vec reigs;
-  arma::mat revecs;
-  try {
-    arma::eig_sym(reigs, revecs, tmat);
-  } catch (...) {
-    XDIAG_THROW("Error diagonalizing tridiagonal matrix");
-  }
+  arma::mat revecs = tmatrix_eigenvectors(r.alphas, r.betas);
 
   // Second run: no convergence is checked, just a fixed number of iterations
-  auto const &block = state0.block();
-  State eigenvectors(block, isreal(ops), neigvals);
   state1 = state0;
-
-  if (isreal(ops) && isreal(block) && isreal(state1)) { // Real Lanczos
+  if (real) { // Real Lanczos
     arma::vec v0 = state1.vector(0, false);
     run_eigs_lanczos(ops, block, v0, revecs, neigvals, r.niterations,
-                     deflation_tol, eigenvectors);
+                     deflation_tol, fused, fused_recurrence, eigenvectors);
   } else { // Complex Lanczos
+    state1.make_complex();
     arma::cx_vec v0 = state1.vectorC(0, false);
     run_eigs_lanczos(ops, block, v0, revecs, neigvals, r.niterations,
-                     deflation_tol, eigenvectors);
+                     deflation_tol, fused, fused_recurrence, eigenvectors);
   }
 
   return {r.alphas,     r.betas,       r.eigenvalues,
@@ -121,21 +250,35 @@ template <typename op_t>
 static EigsLanczosResult
 eigs_lanczos(op_t const &ops, Block const &block, int64_t neigvals,
              double precision, int64_t max_iterations, double deflation_tol,
-             int64_t random_seed) try {
+             int64_t random_seed, std::string store,
+             std::string const &recurrence, bool fused) try {
   bool real = isreal(ops) && isreal(block);
   State state0(block, real);
   fill(state0, RandomState(random_seed));
-  return eigs_lanczos(ops, state0, neigvals, precision, max_iterations,
-                      deflation_tol);
+  return eigs_lanczos<op_t>(ops, state0, neigvals, precision, max_iterations,
+                            deflation_tol, store, recurrence, fused);
 }
 XDIAG_CATCH
 
 EigsLanczosResult eigs_lanczos(OpSum const &ops, Block const &block,
                                int64_t neigvals, double precision,
                                int64_t max_iterations, double deflation_tol,
-                               int64_t random_seed) try {
+                               int64_t random_seed, std::string store,
+                               std::string recurrence, bool fused) try {
   return eigs_lanczos<OpSum>(ops, block, neigvals, precision, max_iterations,
-                             deflation_tol, random_seed);
+                             deflation_tol, random_seed, store, recurrence,
+                             fused);
+}
+XDIAG_CATCH
+
+EigsLanczosResult eigs_lanczos(CompiledOpSum const &ops, Block const &block,
+                               int64_t neigvals, double precision,
+                               int64_t max_iterations, double deflation_tol,
+                               int64_t random_seed, std::string store,
+                               std::string recurrence) try {
+  return eigs_lanczos<CompiledOpSum>(ops, block, neigvals, precision,
+                                     max_iterations, deflation_tol, random_seed,
+                                     store, recurrence, ops.fused);
 }
 XDIAG_CATCH
 
@@ -143,10 +286,35 @@ template <typename idx_t, typename coeff_t>
 EigsLanczosResult eigs_lanczos(CSRMatrix<idx_t, coeff_t> const &ops,
                                Block const &block, int64_t neigvals,
                                double precision, int64_t max_iterations,
-                               double deflation_tol, int64_t random_seed) try {
-  return eigs_lanczos<CSRMatrix<idx_t, coeff_t>>(ops, block, neigvals,
-                                                 precision, max_iterations,
-                                                 deflation_tol, random_seed);
+                               double deflation_tol, int64_t random_seed,
+                               std::string store, std::string recurrence) try {
+  return eigs_lanczos<CSRMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, store, recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsLanczosResult eigs_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                               Block const &block, int64_t neigvals,
+                               double precision, int64_t max_iterations,
+                               double deflation_tol, int64_t random_seed,
+                               std::string store, std::string recurrence) try {
+  return eigs_lanczos<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, store, recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsLanczosResult eigs_lanczos(SELLMatrix<idx_t, coeff_t> const &ops,
+                               Block const &block, int64_t neigvals,
+                               double precision, int64_t max_iterations,
+                               double deflation_tol, int64_t random_seed,
+                               std::string store, std::string recurrence) try {
+  return eigs_lanczos<SELLMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, store, recurrence, false);
 }
 XDIAG_CATCH
 
@@ -154,10 +322,21 @@ XDIAG_CATCH
 // Routine with random state initialization
 EigsLanczosResult eigs_lanczos(OpSum const &ops, State const &state0,
                                int64_t neigvals, double precision,
-                               int64_t max_iterations,
-                               double deflation_tol) try {
+                               int64_t max_iterations, double deflation_tol,
+                               std::string store, std::string recurrence,
+                               bool fused) try {
   return eigs_lanczos<OpSum>(ops, state0, neigvals, precision, max_iterations,
-                             deflation_tol);
+                             deflation_tol, store, recurrence, fused);
+}
+XDIAG_CATCH
+
+EigsLanczosResult eigs_lanczos(CompiledOpSum const &ops, State const &state0,
+                               int64_t neigvals, double precision,
+                               int64_t max_iterations, double deflation_tol,
+                               std::string store, std::string recurrence) try {
+  return eigs_lanczos<CompiledOpSum>(ops, state0, neigvals, precision,
+                                     max_iterations, deflation_tol, store,
+                                     recurrence, ops.fused);
 }
 XDIAG_CATCH
 
@@ -165,25 +344,61 @@ template <typename idx_t, typename coeff_t>
 EigsLanczosResult eigs_lanczos(CSRMatrix<idx_t, coeff_t> const &ops,
                                State const &state0, int64_t neigvals,
                                double precision, int64_t max_iterations,
-                               double deflation_tol) try {
+                               double deflation_tol, std::string store,
+                               std::string recurrence) try {
   return eigs_lanczos<CSRMatrix<idx_t, coeff_t>>(
-      ops, state0, neigvals, precision, max_iterations, deflation_tol);
+      ops, state0, neigvals, precision, max_iterations, deflation_tol, store,
+      recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsLanczosResult eigs_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                               State const &state0, int64_t neigvals,
+                               double precision, int64_t max_iterations,
+                               double deflation_tol, std::string store,
+                               std::string recurrence) try {
+  return eigs_lanczos<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, state0, neigvals, precision, max_iterations, deflation_tol, store,
+      recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsLanczosResult eigs_lanczos(SELLMatrix<idx_t, coeff_t> const &ops,
+                               State const &state0, int64_t neigvals,
+                               double precision, int64_t max_iterations,
+                               double deflation_tol, std::string store,
+                               std::string recurrence) try {
+  return eigs_lanczos<SELLMatrix<idx_t, coeff_t>>(
+      ops, state0, neigvals, precision, max_iterations, deflation_tol, store,
+      recurrence, false);
 }
 XDIAG_CATCH
 
 // Template instantiations for every (idx_t, coeff_t) sparse-matrix combination
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template EigsLanczosResult eigs_lanczos(CSRMatrix<IDX, COEFF> const &,       \
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template EigsLanczosResult eigs_lanczos(MAT<IDX, COEFF> const &,             \
                                           Block const &, int64_t, double,      \
-                                          int64_t, double, int64_t);           \
-  template EigsLanczosResult eigs_lanczos(CSRMatrix<IDX, COEFF> const &,       \
+                                          int64_t, double, int64_t,            \
+                                          std::string, std::string);           \
+  template EigsLanczosResult eigs_lanczos(MAT<IDX, COEFF> const &,             \
                                           State const &, int64_t, double,      \
-                                          int64_t, double);
+                                          int64_t, double, std::string,        \
+                                          std::string);
 
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
@@ -5,9 +5,11 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/states/state.hpp>
@@ -24,16 +26,40 @@ struct XDIAG_API EigsLanczosResult {
   std::string criterion;
 };
 
+// The eigenvectors are formed from the Lanczos vectors. By default
+// (store = "rerun") no vectors are stored, and the Lanczos recurrence is run a
+// second time from the same initial state instead, which doubles the number of
+// MVMs but keeps the memory at a few vectors. Storing the vectors during a
+// single run is opt-in: store = "memory" or "disk" forces the storage,
+// store = "auto" keeps them in memory as long as they fit into half of the
+// memory available to this process and moves them to a scratch file beyond.
+// recurrence = "fused" updates the Lanczos vectors in two passes with a single
+// reduction per iteration (see lanczos_step_fused) instead of "standard".
+
 ///////////////////////////////////////////////////////////////
 // Routine with random state initialization
 
-// on-the-fly
+// on-the-fly, fused = true applies all terms in a single sweep (see apply)
 XDIAG_API EigsLanczosResult eigs_lanczos(OpSum const &ops, Block const &block,
                                          int64_t neigvals = 1,
                                          double precision = 1e-12,
                                          int64_t max_iterations = 1000,
                                          double deflation_tol = 1e-7,
-                                         int64_t random_seed = 42);
+                                         int64_t random_seed = 42,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard",
+                                         bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigsLanczosResult eigs_lanczos(CompiledOpSum const &ops,
+                                         Block const &block,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         int64_t random_seed = 42,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
 
 // sparse matrix
 template <typename idx_t, typename coeff_t>
@@ -43,7 +69,29 @@ XDIAG_API EigsLanczosResult eigs_lanczos(CSRMatrix<idx_t, coeff_t> const &ops,
                                          double precision = 1e-12,
                                          int64_t max_iterations = 1000,
                                          double deflation_tol = 1e-7,
-                                         int64_t random_seed = 42);
+                                         int64_t random_seed = 42,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLanczosResult eigs_lanczos(SELLMatrix<idx_t, coeff_t> const &ops,
+                                         Block const &block,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         int64_t random_seed = 42,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLanczosResult eigs_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                                         Block const &block,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         int64_t random_seed = 42,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
 
 ///////////////////////////////////////////////////////////////
 // Routine with given starting state which is copied
@@ -53,7 +101,20 @@ XDIAG_API EigsLanczosResult eigs_lanczos(OpSum const &ops, State const &state0,
                                          int64_t neigvals = 1,
                                          double precision = 1e-12,
                                          int64_t max_iterations = 1000,
-                                         double deflation_tol = 1e-7);
+                                         double deflation_tol = 1e-7,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard",
+                                         bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigsLanczosResult eigs_lanczos(CompiledOpSum const &ops,
+                                         State const &state0,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
 
 // sparse
 template <typename idx_t, typename coeff_t>
@@ -62,6 +123,26 @@ XDIAG_API EigsLanczosResult eigs_lanczos(CSRMatrix<idx_t, coeff_t> const &ops,
                                          int64_t neigvals = 1,
                                          double precision = 1e-12,
                                          int64_t max_iterations = 1000,
-                                         double deflation_tol = 1e-7);
+                                         double deflation_tol = 1e-7,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLanczosResult eigs_lanczos(SELLMatrix<idx_t, coeff_t> const &ops,
+                                         State const &state0,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLanczosResult eigs_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                                         State const &state0,
+                                         int64_t neigvals = 1,
+                                         double precision = 1e-12,
+                                         int64_t max_iterations = 1000,
+                                         double deflation_tol = 1e-7,
+                                         std::string store = "rerun",
+                                         std::string recurrence = "standard");
 
 } // namespace xdiag
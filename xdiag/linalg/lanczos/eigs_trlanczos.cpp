@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "eigs_trlanczos.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+#include <xdiag/algebra/ishermitian.hpp>
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/linalg/lanczos/trlanczos.hpp>
+#include <xdiag/math/complex.hpp>
+#include <xdiag/math/dot.hpp>
+#include <xdiag/states/fill.hpp>
+#include <xdiag/states/random_state.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/timing.hpp>
+
+namespace xdiag {
+
+template <typename coeff_t, typename op_t>
+static EigsTRLanczosResult
+run_eigs_trlanczos(op_t const &ops, Block const &block, int64_t neigvals,
+                   int64_t nbasis, double precision, int64_t max_iterations,
+                   int64_t random_seed, bool fused) try {
+  State state0(block, isreal<coeff_t>());
+  fill(state0, RandomState(random_seed));
+
+  arma::Mat<coeff_t> V;
+  try {
+    if constexpr (isreal<coeff_t>()) {
+      V.set_size(state0.vector(0, false).n_elem, nbasis);
+      V.col(0) = state0.vector(0, false);
+    } else {
+      V.set_size(state0.vectorC(0, false).n_elem, nbasis);
+      V.col(0) = state0.vectorC(0, false);
+    }
+  } catch (...) {
+    XDIAG_THROW(fmt::format("Cannot allocate {} Lanczos vectors", nbasis));
+  }
+
+  int64_t iter = 1;
+  auto mult = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> &w) {
+    auto ta = rightnow();
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(ops, block, v, block, w, fused, "pull"); // ops is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(ops, block, v, block, w, "pull"); // ops is Hermitian
+    } else {
+      apply(ops, block, v, block, w);
+    }
+    Log(2, "Lanczos iteration {}", iter);
+    timing(ta, rightnow(), "MVM", 2);
+    ++iter;
+  };
+  auto mdot = [&block](arma::Mat<coeff_t> const &A,
+                       arma::Mat<coeff_t> const &B) {
+    return math::matrix_dot(block, A, B);
+  };
+
+  auto r = lanczos::trlanczos(mult, mdot, V, neigvals, precision,
+                              max_iterations, dim(block), 1e-12, random_seed);
+
+  // eigenvalues are sorted ascendingly, locked ones come first
+  int64_t nfound = r.eigenvalues.n_elem;
+  arma::uvec order = arma::sort_index(r.eigenvalues);
+  State eigenvectors(block, isreal<coeff_t>(), nfound);
+  for (int64_t i = 0; i < nfound; ++i) {
+    if constexpr (isreal<coeff_t>()) {
+      eigenvectors.matrix(false).col(i) = V.col(order(i));
+    } else {
+      eigenvectors.matrixC(false).col(i) = V.col(order(i));
+    }
+  }
+
+  arma::vec alphas = r.tmat.diag();
+  arma::vec betas =
+      (r.tmat.n_rows > 1) ? arma::vec(r.tmat.diag(-1)) : arma::vec();
+  return {alphas,
+          betas,
+          arma::vec(r.eigenvalues(order)),
+          eigenvectors,
+          r.niterations,
+          r.criterion,
+          arma::vec(r.residual_norms(order)),
+          r.nrestarts,
+          r.nreorthogonalizations};
+}
+XDIAG_CATCH
+
+template <typename op_t>
+static EigsTRLanczosResult
+eigs_trlanczos(op_t const &ops, Block const &block, int64_t neigvals,
+               int64_t nbasis, double precision, int64_t max_iterations,
+               int64_t random_seed, bool fused) try {
+  int64_t d = dim(block);
+  if (d == 0) {
+    Log.warn("Warning: block is zero dimensional in eigs_trlanczos");
+    return EigsTRLanczosResult();
+  }
+  if (neigvals < 1) {
+    XDIAG_THROW("Argument \"neigvals\" needs to be >= 1");
+  }
+  if (nbasis < 0) {
+    XDIAG_THROW("Argument \"nbasis\" needs to be >= 0");
+  } else if (nbasis == 0) {
+    nbasis = std::max(2 * neigvals, neigvals + 20);
+  } else if (nbasis <= neigvals) {
+    XDIAG_THROW("Argument \"nbasis\" needs to be larger than \"neigvals\"");
+  }
+  if (!ishermitian(ops, block)) {
+    XDIAG_THROW("Input operator is not Hermitian. The Lanczos algorithm can "
+                "only be applied to Hermitian operators.");
+  }
+
+  // Small blocks: the basis spans the full space
+  neigvals = std::min(neigvals, d);
+  nbasis = std::min(nbasis, d);
+  if (nbasis == neigvals) {
+    nbasis = neigvals + 1;
+  }
+
+  bool real = isreal(ops) && isreal(block);
+  if (real) {
+    return run_eigs_trlanczos<double>(ops, block, neigvals, nbasis, precision,
+                                      max_iterations, random_seed, fused);
+  } else {
+    return run_eigs_trlanczos<complex>(ops, block, neigvals, nbasis, precision,
+                                       max_iterations, random_seed, fused);
+  }
+}
+XDIAG_CATCH
+
+EigsTRLanczosResult eigs_trlanczos(OpSum const &ops, Block const &block,
+                                   int64_t neigvals, int64_t nbasis,
+                                   double precision, int64_t max_iterations,
+                                   int64_t random_seed, bool fused) try {
+  return eigs_trlanczos<OpSum>(ops, block, neigvals, nbasis, precision,
+                               max_iterations, random_seed, fused);
+}
+XDIAG_CATCH
+
+EigsTRLanczosResult eigs_trlanczos(CompiledOpSum const &ops,
+                                   Block const &block, int64_t neigvals,
+                                   int64_t nbasis, double precision,
+                                   int64_t max_iterations,
+                                   int64_t random_seed) try {
+  return eigs_trlanczos<CompiledOpSum>(ops, block, neigvals, nbasis, precision,
+                                       max_iterations, random_seed, ops.fused);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsTRLanczosResult eigs_trlanczos(CSRMatrix<idx_t, coeff_t> const &ops,
+                                   Block const &block, int64_t neigvals,
+                                   int64_t nbasis, double precision,
+                                   int64_t max_iterations,
+                                   int64_t random_seed) try {
+  return eigs_trlanczos<CSRMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, nbasis, precision, max_iterations, random_seed,
+      false);
+}
+XDIAG_CATCH
+
+// Template instantiations for every (idx_t, coeff_t) sparse-matrix combination
+#define XDIAG_INST(IDX, COEFF)                                                 \
+  template EigsTRLanczosResult eigs_trlanczos(CSRMatrix<IDX, COEFF> const &,   \
+                                              Block const &, int64_t, int64_t, \
+                                              double, int64_t, int64_t);
+XDIAG_INST(int32_t, double)
+XDIAG_INST(int32_t, complex)
+XDIAG_INST(int64_t, double)
+XDIAG_INST(int64_t, complex)
+#undef XDIAG_INST
+
+} // namespace xdiag
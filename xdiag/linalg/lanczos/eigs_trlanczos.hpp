@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
+#include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/states/state.hpp>
+#include <xdiag/utils/xdiag_api.hpp>
+
+namespace xdiag {
+
+// Result of eigs_trlanczos. The entries agree with EigsLanczosResult, where
+// alphas and betas hold the diagonal and first off-diagonal of the projected
+// matrix of the final cycle (which is not tridiagonal after a restart).
+struct XDIAG_API EigsTRLanczosResult {
+  arma::vec alphas;
+  arma::vec betas;
+  arma::vec eigenvalues;
+  State eigenvectors;
+  int64_t niterations;
+  std::string criterion;
+  arma::vec residual_norms;
+  int64_t nrestarts;
+  int64_t nreorthogonalizations;
+};
+
+// Computes the "neigvals" lowest eigenpairs of a Hermitian operator with the
+// thick-restart Lanczos algorithm. At most "nbasis" Lanczos vectors are held
+// in memory (default: max(2 * neigvals, neigvals + 20)), converged eigenpairs
+// are locked and orthogonality is maintained by partial reorthogonalization.
+// Convergence is reached once the residual norms of all eigenpairs are below
+// precision * max(1, |eigenvalue|). "max_iterations" bounds the total number
+// of MVMs. The initial vector is a (seeded) random vector.
+
+// on-the-fly, fused = true applies all terms in a single sweep (see apply)
+XDIAG_API EigsTRLanczosResult
+eigs_trlanczos(OpSum const &ops, Block const &block, int64_t neigvals = 1,
+               int64_t nbasis = 0, double precision = 1e-10,
+               int64_t max_iterations = 10000, int64_t random_seed = 42,
+               bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigsTRLanczosResult
+eigs_trlanczos(CompiledOpSum const &ops, Block const &block,
+               int64_t neigvals = 1, int64_t nbasis = 0,
+               double precision = 1e-10, int64_t max_iterations = 10000,
+               int64_t random_seed = 42);
+
+// sparse matrix
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsTRLanczosResult
+eigs_trlanczos(CSRMatrix<idx_t, coeff_t> const &ops, Block const &block,
+               int64_t neigvals = 1, int64_t nbasis = 0,
+               double precision = 1e-10, int64_t max_iterations = 10000,
+               int64_t random_seed = 42);
+
+} // namespace xdiag
@@ -4,6 +4,8 @@
 
 #include "eigvals_lanczos.hpp"
 
+#include <type_traits>
+
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/sparse/apply.hpp>
@@ -28,11 +30,17 @@ template <typename coeff_t, typename op_t, typename converged_f>
 static lanczos::lanczos_result_t
 run_eigvals_lanczos(op_t const &ops, Block const &block, arma::Col<coeff_t> &v0,
                     converged_f converged, int64_t max_iterations,
-                    double deflation_tol) {
+                    double deflation_tol, bool fused, bool fused_recurrence) {
   int64_t iter = 1;
   auto mult = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> &w) {
     auto ta = rightnow();
-    apply(ops, block, v, block, w);
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(ops, block, v, block, w, fused, "pull"); // ops is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(ops, block, v, block, w, "pull"); // ops is Hermitian
+    } else {
+      apply(ops, block, v, block, w);
+    }
     Log(1, "Lanczos iteration {}", iter);
     timing(ta, rightnow(), "MVM", 1);
     ++iter;
@@ -42,10 +50,20 @@ run_eigvals_lanczos(op_t const &ops, Block const &block, arma::Col<coeff_t> &v0,
   auto dotf = [&](arma::Col<coeff_t> const &v, arma::Col<coeff_t> const &w) {
     return math::dot(block, v, w);
   };
+  auto reduce = [&block](double *sums, int64_t n) {
+    math::allreduce_sum(block, sums, n);
+  };
   return lanczos::lanczos(mult, dotf, converged, operation, v0, max_iterations,
-                          deflation_tol);
+                          deflation_tol, reduce, fused_recurrence);
 }
 
+template <typename op_t>
+static EigvalsLanczosResult
+eigvals_lanczos_inplace(op_t const &ops, State &psi0, int64_t neigvals,
+                        double precision, int64_t max_iterations,
+                        double deflation_tol, std::string const &recurrence,
+                        bool fused);
+
 ///////////////////////////////////////////////////////////////
 // Routine with random state initialization
 
@@ -53,12 +71,14 @@ template <typename op_t>
 static EigvalsLanczosResult
 eigvals_lanczos(op_t const &ops, Block const &block, int64_t neigvals,
                 double precision, int64_t max_iterations, double deflation_tol,
-                int64_t random_seed) try {
+                int64_t random_seed, std::string const &recurrence,
+                bool fused) try {
   bool real = isreal(ops) && isreal(block);
   State state0(block, real);
   fill(state0, RandomState(random_seed));
-  return eigvals_lanczos_inplace(ops, state0, neigvals, precision,
-                                 max_iterations, deflation_tol);
+  return eigvals_lanczos_inplace<op_t>(ops, state0, neigvals, precision,
+                                       max_iterations, deflation_tol,
+                                       recurrence, fused);
 }
 XDIAG_CATCH
 
@@ -66,9 +86,21 @@ EigvalsLanczosResult eigvals_lanczos(OpSum const &ops, Block const &block,
                                      int64_t neigvals, double precision,
                                      int64_t max_iterations,
                                      double deflation_tol,
-                                     int64_t random_seed) try {
+                                     int64_t random_seed,
+                                     std::string recurrence, bool fused) try {
   return eigvals_lanczos<OpSum>(ops, block, neigvals, precision, max_iterations,
-                                deflation_tol, random_seed);
+                                deflation_tol, random_seed, recurrence, fused);
+}
+XDIAG_CATCH
+
+EigvalsLanczosResult eigvals_lanczos(CompiledOpSum const &ops,
+                                     Block const &block, int64_t neigvals,
+                                     double precision, int64_t max_iterations,
+                                     double deflation_tol, int64_t random_seed,
+                                     std::string recurrence) try {
+  return eigvals_lanczos<CompiledOpSum>(ops, block, neigvals, precision,
+                                        max_iterations, deflation_tol,
+                                        random_seed, recurrence, ops.fused);
 }
 XDIAG_CATCH
 
@@ -76,10 +108,35 @@ template <typename idx_t, typename coeff_t>
 EigvalsLanczosResult
 eigvals_lanczos(CSRMatrix<idx_t, coeff_t> const &ops, Block const &block,
                 int64_t neigvals, double precision, int64_t max_iterations,
-                double deflation_tol, int64_t random_seed) try {
-  return eigvals_lanczos<CSRMatrix<idx_t, coeff_t>>(ops, block, neigvals,
-                                                    precision, max_iterations,
-                                                    deflation_tol, random_seed);
+                double deflation_tol, int64_t random_seed,
+                std::string recurrence) try {
+  return eigvals_lanczos<CSRMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult
+eigvals_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                int64_t neigvals, double precision, int64_t max_iterations,
+                double deflation_tol, int64_t random_seed,
+                std::string recurrence) try {
+  return eigvals_lanczos<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, recurrence, false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult
+eigvals_lanczos(SELLMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                int64_t neigvals, double precision, int64_t max_iterations,
+                double deflation_tol, int64_t random_seed,
+                std::string recurrence) try {
+  return eigvals_lanczos<SELLMatrix<idx_t, coeff_t>>(
+      ops, block, neigvals, precision, max_iterations, deflation_tol,
+      random_seed, recurrence, false);
 }
 XDIAG_CATCH
 
@@ -89,9 +146,20 @@ XDIAG_CATCH
 EigvalsLanczosResult eigvals_lanczos(OpSum const &ops, State psi0,
                                      int64_t neigvals, double precision,
                                      int64_t max_iterations,
-                                     double deflation_tol) try {
+                                     double deflation_tol,
+                                     std::string recurrence, bool fused) try {
+  return eigvals_lanczos_inplace(ops, psi0, neigvals, precision, max_iterations,
+                                 deflation_tol, recurrence, fused);
+}
+XDIAG_CATCH
+
+EigvalsLanczosResult eigvals_lanczos(CompiledOpSum const &ops, State psi0,
+                                     int64_t neigvals, double precision,
+                                     int64_t max_iterations,
+                                     double deflation_tol,
+                                     std::string recurrence) try {
   return eigvals_lanczos_inplace(ops, psi0, neigvals, precision, max_iterations,
-                                 deflation_tol);
+                                 deflation_tol, recurrence);
 }
 XDIAG_CATCH
 
@@ -99,9 +167,32 @@ template <typename idx_t, typename coeff_t>
 EigvalsLanczosResult eigvals_lanczos(CSRMatrix<idx_t, coeff_t> const &ops,
                                      State psi0, int64_t neigvals,
                                      double precision, int64_t max_iterations,
-                                     double deflation_tol) try {
+                                     double deflation_tol,
+                                     std::string recurrence) try {
+  return eigvals_lanczos_inplace(ops, psi0, neigvals, precision, max_iterations,
+                                 deflation_tol, recurrence);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult eigvals_lanczos(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                                     State psi0, int64_t neigvals,
+                                     double precision, int64_t max_iterations,
+                                     double deflation_tol,
+                                     std::string recurrence) try {
+  return eigvals_lanczos_inplace(ops, psi0, neigvals, precision, max_iterations,
+                                 deflation_tol, recurrence);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult eigvals_lanczos(SELLMatrix<idx_t, coeff_t> const &ops,
+                                     State psi0, int64_t neigvals,
+                                     double precision, int64_t max_iterations,
+                                     double deflation_tol,
+                                     std::string recurrence) try {
   return eigvals_lanczos_inplace(ops, psi0, neigvals, precision, max_iterations,
-                                 deflation_tol);
+                                 deflation_tol, recurrence);
 }
 XDIAG_CATCH
 
@@ -112,7 +203,8 @@ template <typename op_t>
 static EigvalsLanczosResult
 eigvals_lanczos_inplace(op_t const &ops, State &psi0, int64_t neigvals,
                         double precision, int64_t max_iterations,
-                        double deflation_tol) try {
+                        double deflation_tol, std::string const &recurrence,
+                        bool fused) try {
 
   if (dim(psi0) == 0) {
     Log.warn(
@@ -136,6 +228,7 @@ eigvals_lanczos_inplace(op_t const &ops, State &psi0, int64_t neigvals,
                 "only be applied to Hermitian operators.");
   }
 
+  bool fused_recurrence = lanczos::fused_recurrence(recurrence);
   auto const &block = psi0.block();
   bool real = isreal(ops) && isreal(block) && isreal(psi0);
 
@@ -147,12 +240,12 @@ eigvals_lanczos_inplace(op_t const &ops, State &psi0, int64_t neigvals,
   if (real) {                             // Real Lanczos algorithm
     arma::vec v0 = psi0.vector(0, false); // not copied
     r = run_eigvals_lanczos(ops, block, v0, converged, max_iterations,
-                            deflation_tol);
+                            deflation_tol, fused, fused_recurrence);
   } else { // Complex Lanczos algorithm
     psi0.make_complex();
     arma::cx_vec v0 = psi0.vectorC(0, false); // not copied
     r = run_eigvals_lanczos(ops, block, v0, converged, max_iterations,
-                            deflation_tol);
+                            deflation_tol, fused, fused_recurrence);
   }
   return {r.alphas, r.betas, r.eigenvalues, r.niterations, r.criterion};
 }
@@ -161,9 +254,24 @@ XDIAG_CATCH
 EigvalsLanczosResult eigvals_lanczos_inplace(OpSum const &ops, State &psi0,
                                              int64_t neigvals, double precision,
                                              int64_t max_iterations,
-                                             double deflation_tol) try {
+                                             double deflation_tol,
+                                             std::string recurrence,
+                                             bool fused) try {
   return eigvals_lanczos_inplace<OpSum>(ops, psi0, neigvals, precision,
-                                        max_iterations, deflation_tol);
+                                        max_iterations, deflation_tol,
+                                        recurrence, fused);
+}
+XDIAG_CATCH
+
+EigvalsLanczosResult eigvals_lanczos_inplace(CompiledOpSum const &ops,
+                                             State &psi0, int64_t neigvals,
+                                             double precision,
+                                             int64_t max_iterations,
+                                             double deflation_tol,
+                                             std::string recurrence) try {
+  return eigvals_lanczos_inplace<CompiledOpSum>(ops, psi0, neigvals, precision,
+                                                max_iterations, deflation_tol,
+                                                recurrence, ops.fused);
 }
 XDIAG_CATCH
 
@@ -171,27 +279,62 @@ template <typename idx_t, typename coeff_t>
 EigvalsLanczosResult
 eigvals_lanczos_inplace(CSRMatrix<idx_t, coeff_t> const &ops, State &psi0,
                         int64_t neigvals, double precision,
-                        int64_t max_iterations, double deflation_tol) try {
+                        int64_t max_iterations, double deflation_tol,
+                        std::string recurrence) try {
   return eigvals_lanczos_inplace<CSRMatrix<idx_t, coeff_t>>(
-      ops, psi0, neigvals, precision, max_iterations, deflation_tol);
+      ops, psi0, neigvals, precision, max_iterations, deflation_tol, recurrence,
+      false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult
+eigvals_lanczos_inplace(CSRVIMatrix<idx_t, coeff_t> const &ops, State &psi0,
+                        int64_t neigvals, double precision,
+                        int64_t max_iterations, double deflation_tol,
+                        std::string recurrence) try {
+  return eigvals_lanczos_inplace<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, psi0, neigvals, precision, max_iterations, deflation_tol, recurrence,
+      false);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigvalsLanczosResult
+eigvals_lanczos_inplace(SELLMatrix<idx_t, coeff_t> const &ops, State &psi0,
+                        int64_t neigvals, double precision,
+                        int64_t max_iterations, double deflation_tol,
+                        std::string recurrence) try {
+  return eigvals_lanczos_inplace<SELLMatrix<idx_t, coeff_t>>(
+      ops, psi0, neigvals, precision, max_iterations, deflation_tol, recurrence,
+      false);
 }
 XDIAG_CATCH
 
 // Template instantiations for every (idx_t, coeff_t) sparse-matrix combination
-#define XDIAG_INST(IDX, COEFF)                                                 \
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
   template EigvalsLanczosResult eigvals_lanczos(                               \
-      CSRMatrix<IDX, COEFF> const &, Block const &, int64_t, double, int64_t,  \
-      double, int64_t);                                                        \
+      MAT<IDX, COEFF> const &, Block const &, int64_t, double, int64_t,        \
+      double, int64_t, std::string);                                           \
   template EigvalsLanczosResult eigvals_lanczos(                               \
-      CSRMatrix<IDX, COEFF> const &, State, int64_t, double, int64_t, double); \
+      MAT<IDX, COEFF> const &, State, int64_t, double, int64_t, double,        \
+      std::string);                                                            \
   template EigvalsLanczosResult eigvals_lanczos_inplace(                       \
-      CSRMatrix<IDX, COEFF> const &, State &, int64_t, double, int64_t,        \
-      double);
+      MAT<IDX, COEFF> const &, State &, int64_t, double, int64_t, double,      \
+      std::string);
 
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
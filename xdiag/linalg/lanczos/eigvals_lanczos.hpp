@@ -5,9 +5,11 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/states/state.hpp>
@@ -23,14 +25,25 @@ struct XDIAG_API EigvalsLanczosResult {
   std::string criterion;
 };
 
+// recurrence = "fused" updates the Lanczos vectors in two passes with a single
+// reduction per iteration (see lanczos_step_fused) instead of "standard".
+
 ///////////////////////////////////////////////////////////////
 // Routine with random state initialization
 
-// on-the-fly
+// on-the-fly, fused = true applies all terms in a single sweep (see apply)
 XDIAG_API EigvalsLanczosResult
 eigvals_lanczos(OpSum const &ops, Block const &block, int64_t neigvals = 1,
                 double precision = 1e-12, int64_t max_iterations = 1000,
-                double deflation_tol = 1e-7, int64_t random_seed = 42);
+                double deflation_tol = 1e-7, int64_t random_seed = 42,
+                std::string recurrence = "standard", bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(CompiledOpSum const &ops, Block const &block,
+                int64_t neigvals = 1, double precision = 1e-12,
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                int64_t random_seed = 42, std::string recurrence = "standard");
 
 // sparse matrix
 template <typename idx_t, typename coeff_t>
@@ -38,23 +51,56 @@ XDIAG_API EigvalsLanczosResult
 eigvals_lanczos(CSRMatrix<idx_t, coeff_t> const &A, Block const &block,
                 int64_t neigvals = 1, double precision = 1e-12,
                 int64_t max_iterations = 1000, double deflation_tol = 1e-7,
-                int64_t random_seed = 42);
+                int64_t random_seed = 42, std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(SELLMatrix<idx_t, coeff_t> const &A, Block const &block,
+                int64_t neigvals = 1, double precision = 1e-12,
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                int64_t random_seed = 42, std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(CSRVIMatrix<idx_t, coeff_t> const &A, Block const &block,
+                int64_t neigvals = 1, double precision = 1e-12,
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                int64_t random_seed = 42, std::string recurrence = "standard");
 
 ///////////////////////////////////////////////////////////////
 // Routine with given starting state which is copied
 
 // on-the-fly
-XDIAG_API EigvalsLanczosResult eigvals_lanczos(OpSum const &ops, State psi0,
-                                               int64_t neigvals = 1,
-                                               double precision = 1e-12,
-                                               int64_t max_iterations = 1000,
-                                               double deflation_tol = 1e-7);
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(OpSum const &ops, State psi0, int64_t neigvals = 1,
+                double precision = 1e-12, int64_t max_iterations = 1000,
+                double deflation_tol = 1e-7,
+                std::string recurrence = "standard", bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(CompiledOpSum const &ops, State psi0, int64_t neigvals = 1,
+                double precision = 1e-12, int64_t max_iterations = 1000,
+                double deflation_tol = 1e-7,
+                std::string recurrence = "standard");
+
 // sparse matrix
 template <typename idx_t, typename coeff_t>
 XDIAG_API EigvalsLanczosResult
 eigvals_lanczos(CSRMatrix<idx_t, coeff_t> const &A, State psi0,
                 int64_t neigvals = 1, double precision = 1e-12,
-                int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(SELLMatrix<idx_t, coeff_t> const &A, State psi0,
+                int64_t neigvals = 1, double precision = 1e-12,
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos(CSRVIMatrix<idx_t, coeff_t> const &A, State psi0,
+                int64_t neigvals = 1, double precision = 1e-12,
+                int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+                std::string recurrence = "standard");
 
 ///////////////////////////////////////////////////////////////
 // Routine with given starting state which is overwritten
@@ -63,13 +109,33 @@ eigvals_lanczos(CSRMatrix<idx_t, coeff_t> const &A, State psi0,
 XDIAG_API EigvalsLanczosResult
 eigvals_lanczos_inplace(OpSum const &ops, State &psi0, int64_t neigvals = 1,
                         double precision = 1e-12, int64_t max_iterations = 1000,
-                        double deflation_tol = 1e-7);
+                        double deflation_tol = 1e-7,
+                        std::string recurrence = "standard",
+                        bool fused = false);
+
+// on-the-fly, with a precompiled operator
+XDIAG_API EigvalsLanczosResult
+eigvals_lanczos_inplace(CompiledOpSum const &ops, State &psi0,
+                        int64_t neigvals = 1, double precision = 1e-12,
+                        int64_t max_iterations = 1000,
+                        double deflation_tol = 1e-7,
+                        std::string recurrence = "standard");
 
 // sparse matrix
 template <typename idx_t, typename coeff_t>
 XDIAG_API EigvalsLanczosResult eigvals_lanczos_inplace(
     CSRMatrix<idx_t, coeff_t> const &A, State &psi0, int64_t neigvals = 1,
     double precision = 1e-12, int64_t max_iterations = 1000,
-    double deflation_tol = 1e-7);
+    double deflation_tol = 1e-7, std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult eigvals_lanczos_inplace(
+    SELLMatrix<idx_t, coeff_t> const &A, State &psi0, int64_t neigvals = 1,
+    double precision = 1e-12, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7, std::string recurrence = "standard");
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigvalsLanczosResult eigvals_lanczos_inplace(
+    CSRVIMatrix<idx_t, coeff_t> const &A, State &psi0, int64_t neigvals = 1,
+    double precision = 1e-12, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7, std::string recurrence = "standard");
 
 } // namespace xdiag
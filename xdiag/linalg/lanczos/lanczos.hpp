@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
 #include <xdiag/linalg/lanczos/lanczos_step.hpp>
 #include <xdiag/linalg/lanczos/tmatrix.hpp>
 #include <xdiag/armadillo.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
 #include <xdiag/utils/logger.hpp>
 
 namespace xdiag::lanczos {
@@ -19,12 +25,30 @@ struct lanczos_result_t {
   std::string criterion;
 };
 
+// Whether the recurrence argument of the Lanczos routines, either "standard"
+// or "fused", selects the fused recurrence (lanczos_step_fused)
+inline bool fused_recurrence(std::string const &recurrence) try {
+  if ((recurrence != "standard") && (recurrence != "fused")) {
+    XDIAG_THROW(fmt::format("Invalid argument \"recurrence\": \"{}\". Must be "
+                            "either \"standard\" or \"fused\"",
+                            recurrence));
+  }
+  return recurrence == "fused";
+}
+XDIAG_CATCH
+
+// If reduce(sums, n) is given, which adds up partial sums over all processes
+// holding a part of the vectors, the fused recurrence (lanczos_step_fused) is
+// used if fused is set. The iteration stops once the number of iterations
+// reaches the dimension of the vectors, since the Krylov space is exhausted
+// then. Beyond, only rounding errors would be iterated, whose size and
+// continuation depend on the recurrence used.
 template <class coeff_t, class mult_f, class dot_f, class converged_f,
-          class operation_f>
+          class operation_f, class reduce_f = std::nullptr_t>
 lanczos_result_t lanczos(mult_f mult, dot_f dot, converged_f converged,
                          operation_f operation, arma::Col<coeff_t> &v0,
-                         int max_iterations = 1000,
-                         double deflation_tol = 1e-7) try {
+                         int max_iterations = 1000, double deflation_tol = 1e-7,
+                         reduce_f reduce = nullptr, bool fused = false) try {
   // Below this norm the start vector is treated as zero (unusable). This is a
   // separate notion from deflation_tol, which detects an exhausted sequence.
   constexpr double start_vector_tol = 1e-12;
@@ -52,23 +76,47 @@ lanczos_result_t lanczos(mult_f mult, dot_f dot, converged_f converged,
     return lanczos_result_t();
   }
 
+  // Dimension of the (possibly distributed) vectors
+  double dim = v1.n_elem;
+  if constexpr (!std::is_same_v<reduce_f, std::nullptr_t>) {
+    reduce(&dim, 1);
+  } else {
+    fused = false;
+  }
+
   // Main Lanczos loop
+
   int64_t iteration = 0;
   std::string criterion;
   while (!converged(tmatrix)) {
     operation(v1);
-    lanczos_step(v0, v1, w, alpha, beta, mult, dot);
+    if constexpr (!std::is_same_v<reduce_f, std::nullptr_t>) {
+      if (fused) { // v1 is normalized by lanczos_step_fused
+        lanczos_step_fused(v0, v1, w, alpha, beta, mult, reduce,
+                           deflation_tol);
+      } else {
+        lanczos_step(v0, v1, w, alpha, beta, mult, dot);
+      }
+    } else {
+      lanczos_step(v0, v1, w, alpha, beta, mult, dot);
+    }
     tmatrix.append(alpha, beta);
     tmatrix.print_log();
     ++iteration;
 
     // Finish if Lanczos sequence is exhausted
     if (std::abs(beta) > deflation_tol) {
-      v1 /= beta;
+      if (!fused) {
+        v1 /= beta;
+      }
     } else {
       criterion = "deflated";
       break;
     }
+    if (iteration >= dim) {
+      criterion = "deflated";
+      break;
+    }
     if (iteration >= max_iterations) {
       criterion = "maxiterations";
       break;
@@ -3,6 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <limits>
 #include <random>
 
@@ -90,6 +93,32 @@ inline arma::mat compute_omega(arma::vec const &alpha, arma::vec const &beta,
   return omega;
 }
 
+// Estimates the overlaps of the next Lanczos vector v_{j+1} with the vectors
+// v_0, ..., v_j by the recurrence of compute_omega, for a general symmetric
+// projection "tmat" of the operator onto v_0, ..., v_j. Besides the
+// tridiagonal case, this covers the arrowhead structure obtained after a thick
+// restart (cf. eigs_trlanczos). "omega" holds the estimated overlaps of
+// v_0, ..., v_j and "beta" is the norm of the new residual.
+inline arma::vec omega_next(arma::mat const &omega, arma::mat const &tmat,
+                            double beta, int64_t dim,
+                            std::mt19937_64 &generator) {
+  using namespace arma;
+  double eps = std::numeric_limits<double>::epsilon();
+  std::normal_distribution<double> dist1(0.0, 0.3);
+  std::normal_distribution<double> dist2(0.0, 0.6);
+
+  int64_t j = omega.n_rows - 1;
+  vec onext = trans(omega.row(j) * tmat) - omega * tmat.col(j);
+  for (int64_t i = 0; i < j; ++i) {
+    double beta_i = std::sqrt(std::max(
+        0.0, dot(tmat.col(i), tmat.col(i)) - tmat(i, i) * tmat(i, i)));
+    onext(i) += eps * (beta_i + beta) * dist1(generator);
+    onext(i) /= beta;
+  }
+  onext(j) = eps * sqrt((double)dim) * dist2(generator);
+  return onext;
+}
+
 // Generic Lanczos implementation building multiple vectors
 template <class coeff_t, class multiply_f, class convergence_f>
 inline lanczos_pro_result<coeff_t>
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+
 #include <xdiag/linalg/gram_schmidt/orthogonalize.hpp>
 #include <xdiag/linalg/lanczos/tmatrix.hpp>
 #include <xdiag/armadillo.hpp>
+#include <xdiag/math/complex.hpp>
 #include <xdiag/utils/error.hpp>
 
 namespace xdiag {
@@ -34,6 +38,79 @@ inline void lanczos_step(arma::Col<coeff_t> &v0, arma::Col<coeff_t> &v1,
 }
 XDIAG_CATCH
 
+// Fused variant of lanczos_step with two passes over the vectors and a single
+// reduction. The first pass subtracts beta * v0 from w, copies v1 to v0, and
+// accumulates <v1, w>, <w, w> and <v1, v1> (alpha is taken after the beta
+// update, as in Paige's variant of the recurrence). The new beta then follows
+// from |w - alpha v1|^2 = <w, w> - <v1, w>^2 / <v1, v1>. Using the actual norm
+// of v1 instead of 1 keeps its rounding errors from being amplified in the
+// following steps. The second pass subtracts alpha * v1 and normalizes the
+// result into v1 if beta > deflation_tol. If the subtraction cancels most of
+// <w, w>, the norm is computed explicitly instead. reduce(sums, n) adds up n
+// partial sums over all processes holding a part of the vectors (a no-op for
+// vectors that are not distributed).
+template <typename coeff_t, class multiply_f, class reduce_f>
+inline void lanczos_step_fused(arma::Col<coeff_t> &v0, arma::Col<coeff_t> &v1,
+                               arma::Col<coeff_t> &w, double &alpha,
+                               double &beta, multiply_f mult, reduce_f reduce,
+                               double deflation_tol) try {
+  // relative size of beta^2 below which it is recomputed explicitly
+  constexpr double cancellation_tol = 1e-2;
+
+  mult(v1, w); // MVM
+  int64_t size = w.n_elem;
+  coeff_t *pv0 = v0.memptr();
+  coeff_t const *pv1 = v1.memptr();
+  coeff_t *pw = w.memptr();
+
+  double v1w = 0.;
+  double ww = 0.;
+  double v1v1 = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : v1w, ww, v1v1)
+#endif
+  for (int64_t i = 0; i < size; ++i) {
+    coeff_t wi = pw[i] - beta * pv0[i];
+    coeff_t vi = pv1[i];
+    pw[i] = wi;
+    pv0[i] = vi;
+    v1w += xdiag::real(xdiag::conj(vi) * wi);
+    ww += xdiag::real(xdiag::conj(wi) * wi);
+    v1v1 += xdiag::real(xdiag::conj(vi) * vi);
+  }
+  double sums[3] = {v1w, ww, v1v1};
+  reduce(sums, 3);
+  alpha = sums[0] / sums[2];
+  double beta2 = sums[1] - alpha * sums[0];
+
+  if (beta2 > cancellation_tol * sums[1]) {
+    beta = std::sqrt(beta2);
+    double scale = (beta > deflation_tol) ? 1.0 / beta : 1.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int64_t i = 0; i < size; ++i) {
+      pw[i] = (pw[i] - alpha * pv0[i]) * scale;
+    }
+  } else {
+    double nrm2 = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : nrm2)
+#endif
+    for (int64_t i = 0; i < size; ++i) {
+      pw[i] -= alpha * pv0[i];
+      nrm2 += xdiag::real(xdiag::conj(pw[i]) * pw[i]);
+    }
+    reduce(&nrm2, 1);
+    beta = std::sqrt(nrm2);
+    if (beta > deflation_tol) {
+      w /= beta;
+    }
+  }
+  v1.swap(w);
+}
+XDIAG_CATCH
+
 template <typename coeff_t, class multiply_f, class dot_f>
 inline void lanczos_step_ortho(arma::Col<coeff_t> &v0, arma::Col<coeff_t> &v1,
                                arma::Col<coeff_t> &w, double &alpha,
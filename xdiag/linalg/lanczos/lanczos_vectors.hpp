@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+namespace xdiag::lanczos {
+
+// Stores the Lanczos vectors v_0, v_1, ... of a run, such that Ritz vectors
+// can be formed after a single Lanczos run instead of repeating the recurrence.
+// The vectors are kept either in memory or in an unnamed scratch file, which
+// is removed automatically once closed. With mode "auto" the vectors are kept
+// in memory as long as they fit into "budget" bytes; once the next vector
+// would exceed the budget all vectors are moved to the scratch file.
+template <typename coeff_t> class LanczosVectors {
+public:
+  LanczosVectors(std::string const &mode, int64_t budget = -1) try
+      : ondisk_(mode == "disk"), automatic_(mode == "auto"), budget_(budget) {
+    if ((mode != "memory") && (mode != "disk") && (mode != "auto")) {
+      XDIAG_THROW(fmt::format("Invalid storage mode for Lanczos vectors: "
+                              "\"{}\". Must be \"memory\", \"disk\" or "
+                              "\"auto\"",
+                              mode));
+    }
+    if (ondisk_) {
+      open();
+    }
+  }
+  XDIAG_CATCH
+
+  LanczosVectors(LanczosVectors const &) = delete;
+  LanczosVectors &operator=(LanczosVectors const &) = delete;
+  ~LanczosVectors() {
+    if (file_) {
+      std::fclose(file_);
+    }
+  }
+
+  int64_t size() const { return size_; }
+  bool ondisk() const { return ondisk_; }
+  int64_t memory() const { return memory_; }
+
+  void push(arma::Col<coeff_t> const &v) try {
+    if ((size_ > 0) && ((int64_t)v.n_elem != dim_)) {
+      XDIAG_THROW("Lanczos vectors of different dimension cannot be stored");
+    }
+    dim_ = v.n_elem;
+    int64_t bytes = dim_ * (int64_t)sizeof(coeff_t);
+    if (!ondisk_ && automatic_ && (budget_ >= 0) &&
+        (memory_ + bytes > budget_)) {
+      Log(1, "Lanczos vectors exceed memory budget of {:.1f} MB, moving {} "
+             "vectors to scratch file",
+          (double)budget_ / 1e6, size_);
+      spill();
+    }
+    if (ondisk_) {
+      write(v);
+    } else {
+      vectors_.push_back(v);
+      memory_ += bytes;
+    }
+    ++size_;
+  }
+  XDIAG_CATCH
+
+  // Calls f(k, v_k) for all stored vectors in the order they have been pushed
+  template <class function_f> void for_each(function_f &&f) try {
+    if (ondisk_) {
+      std::fflush(file_);
+      std::rewind(file_);
+      arma::Col<coeff_t> v(dim_);
+      for (int64_t k = 0; k < size_; ++k) {
+        if (std::fread(v.memptr(), sizeof(coeff_t), dim_, file_) !=
+            (std::size_t)dim_) {
+          XDIAG_THROW("Unable to read Lanczos vector from scratch file");
+        }
+        f(k, v);
+      }
+      std::fseek(file_, 0, SEEK_END);
+    } else {
+      for (int64_t k = 0; k < size_; ++k) {
+        f(k, vectors_[k]);
+      }
+    }
+  }
+  XDIAG_CATCH
+
+private:
+  bool ondisk_;
+  bool automatic_;
+  int64_t budget_;
+  int64_t dim_ = 0;
+  int64_t size_ = 0;
+  int64_t memory_ = 0;
+  std::vector<arma::Col<coeff_t>> vectors_;
+  std::FILE *file_ = nullptr;
+
+  void open() try {
+    file_ = std::tmpfile();
+    if (!file_) {
+      XDIAG_THROW("Unable to open scratch file for Lanczos vectors");
+    }
+  }
+  XDIAG_CATCH
+
+  void write(arma::Col<coeff_t> const &v) try {
+    if (std::fwrite(v.memptr(), sizeof(coeff_t), v.n_elem, file_) !=
+        (std::size_t)v.n_elem) {
+      XDIAG_THROW("Unable to write Lanczos vector to scratch file (disk full?)");
+    }
+  }
+  XDIAG_CATCH
+
+  void spill() try {
+    open();
+    ondisk_ = true;
+    for (auto const &v : vectors_) {
+      write(v);
+    }
+    vectors_.clear();
+    vectors_.shrink_to_fit();
+    memory_ = 0;
+  }
+  XDIAG_CATCH
+};
+
+} // namespace xdiag::lanczos
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/linalg/lanczos/lanczos_pro.hpp>
+#include <xdiag/math/complex.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/logger.hpp>
+
+namespace xdiag::lanczos {
+
+struct trlanczos_result_t {
+  arma::vec eigenvalues;
+  arma::vec residual_norms;
+  arma::mat tmat;
+  int64_t niterations;
+  int64_t nrestarts;
+  int64_t nreorthogonalizations;
+  std::string criterion;
+};
+
+// Replaces the columns a, ..., a + Y.n_cols - 1 of V by V.cols(a, a + n - 1) *
+// Y, where n = Y.n_rows. The product is formed in chunks of rows, such that
+// only a small temporary is required instead of a second basis.
+template <typename coeff_t>
+void rotate_basis(arma::Mat<coeff_t> &V, int64_t a, arma::mat const &Y) {
+  constexpr int64_t chunk = 1024;
+  int64_t n = Y.n_rows;
+  int64_t k = Y.n_cols;
+  if ((n == 0) || (k == 0)) {
+    return;
+  }
+  arma::Mat<coeff_t> Yc = arma::conv_to<arma::Mat<coeff_t>>::from(Y);
+  arma::Mat<coeff_t> tmp;
+  for (int64_t r0 = 0; r0 < (int64_t)V.n_rows; r0 += chunk) {
+    int64_t r1 = std::min((int64_t)V.n_rows, r0 + chunk) - 1;
+    tmp = V.submat(r0, a, r1, a + n - 1) * Yc;
+    V.submat(r0, a, r1, a + k - 1) = tmp;
+  }
+}
+
+// Thick-restart Lanczos algorithm (K. Wu and H. Simon, SIAM J. Matrix Anal.
+// Appl. 22, 602 (2000)) computing the "neigvals" lowest eigenpairs with a
+// basis of fixed size V.n_cols.
+//
+// mult(v, w):  computes w = A v
+// mdot(V, W):  computes V^H W (possibly distributed)
+// V:           basis of fixed size, column 0 holds the initial vector. On
+//              exit, the first neigvals columns hold the eigenvectors.
+// dim:         dimension of the full vector space
+//
+// After every cycle, the Ritz pairs of the lowest Ritz values are kept, and
+// the Lanczos recurrence is continued from the residual vector. The projection
+// of A then has arrowhead structure. Converged Ritz pairs are locked, i.e.
+// they are removed from the projection and all following Lanczos vectors are
+// orthogonalized against them. Orthogonality among the new Lanczos vectors of a
+// cycle is monitored with the recurrence of Simon (cf. lanczos_pro) and
+// restored by reorthogonalization only when the estimated level exceeds
+// "orthogonality_level".
+template <typename coeff_t, class mult_f, class mdot_f>
+trlanczos_result_t trlanczos(mult_f mult, mdot_f mdot, arma::Mat<coeff_t> &V,
+                             int64_t neigvals, double precision,
+                             int64_t max_iterations, int64_t dim,
+                             double orthogonality_level = 1e-12,
+                             int64_t random_seed = 42) try {
+  using namespace arma;
+  double eps = std::numeric_limits<double>::epsilon();
+  int64_t n = V.n_rows;
+  int64_t m = V.n_cols;
+  if (neigvals >= m) {
+    XDIAG_THROW("Basis size of thick-restart Lanczos must be larger than the "
+                "number of eigenvalues");
+  }
+
+  // non-owning views on columns of V and on single vectors
+  auto cols = [&V, n](int64_t c0, int64_t ncols) {
+    return Mat<coeff_t>(V.colptr(c0), n, ncols, false, true);
+  };
+  auto asmat = [n](Col<coeff_t> &v) {
+    return Mat<coeff_t>(v.memptr(), n, 1, false, true);
+  };
+  auto norm = [&](Col<coeff_t> &v) {
+    auto vm = asmat(v);
+    return std::sqrt(xdiag::real(mdot(vm, vm)(0, 0)));
+  };
+  // classical Gram-Schmidt against columns c0, ..., c0 + ncols - 1
+  auto orthogonalize = [&](Col<coeff_t> &v, int64_t c0, int64_t ncols,
+                           int iterations) {
+    if (ncols > 0) {
+      auto Q = cols(c0, ncols);
+      auto vm = asmat(v);
+      for (int iter = 0; iter < iterations; ++iter) {
+        vm -= Q * mdot(Q, vm);
+      }
+    }
+  };
+
+  trlanczos_result_t res;
+  res.niterations = 0;
+  res.nrestarts = 0;
+  res.nreorthogonalizations = 0;
+
+  Col<coeff_t> w(n);
+  double beta = std::sqrt(xdiag::real(mdot(cols(0, 1), cols(0, 1))(0, 0)));
+  if (beta < 1e-12) {
+    res.criterion = "v0zero";
+    return res;
+  }
+  V.col(0) /= beta;
+
+  std::mt19937_64 generator(random_seed);
+  std::normal_distribution<double> noise(0.0, 1.5);
+
+  mat T(m, m, fill::zeros);         // projection of A onto the basis
+  mat omega(m + 1, m + 1, fill::eye); // estimated overlaps of the basis
+  vec locked_eigenvalues;
+  vec locked_residuals;
+
+  int64_t nlock = 0;     // locked vectors v_0, ..., v_{nlock-1}
+  int64_t first_new = 0; // first Lanczos vector after the kept vectors
+  int64_t j = 0;         // current Lanczos vector
+  int64_t nselect = 0;   // selective orthogonalization against v_0, ...
+  bool reortho_next = false;
+  bool exhausted = false;
+
+  while (true) {
+
+    // Expand the basis by Lanczos steps
+    int64_t jend = m;
+    for (; j < m; ++j) {
+      Col<coeff_t> vj(V.colptr(j), n, false, true);
+      mult(vj, w);
+      ++res.niterations;
+      double alpha = xdiag::real(mdot(cols(j, 1), asmat(w))(0, 0));
+      T(j, j) = alpha;
+      w -= alpha * vj;
+      if (j == first_new) { // arrowhead couplings to the kept vectors
+        int64_t nkept = first_new - nlock;
+        if (nkept > 0) {
+          vec s = T.submat(nlock, j, first_new - 1, j);
+          asmat(w) -= cols(nlock, nkept) * conv_to<Mat<coeff_t>>::from(s);
+        }
+      } else {
+        w -= T(j - 1, j) * V.col(j - 1);
+      }
+      orthogonalize(w, 0, nselect, 1);
+      beta = norm(w);
+
+      // Partial reorthogonalization of the active vectors
+      bool reortho = reortho_next;
+      reortho_next = false;
+      if (!reortho && (j > nselect) && (beta > 0.)) {
+        vec onext =
+            omega_next(omega.submat(nlock, nlock, j, j),
+                       T.submat(nlock, nlock, j, j), beta, dim, generator);
+        for (int64_t i = nlock; i < nselect; ++i) {
+          onext(i - nlock) = eps * noise(generator);
+        }
+        omega.submat(j + 1, nlock, j + 1, j) = onext.t();
+        omega.submat(nlock, j + 1, j, j + 1) = onext;
+        double level = max(abs(onext.head(j - nlock)));
+        if (level > orthogonality_level) {
+          Log(2, "  ortho level estimated: {}, reorthogonalizing", level);
+          reortho = true;
+          reortho_next = true;
+        }
+      }
+      if (reortho) {
+        orthogonalize(w, 0, j + 1, 2);
+        beta = norm(w);
+        ++res.nreorthogonalizations;
+        for (int64_t i = nlock; i <= j; ++i) {
+          omega(j + 1, i) = omega(i, j + 1) = eps * noise(generator);
+        }
+      }
+
+      // Basis spans the full space
+      if (j + 1 >= dim) {
+        exhausted = true;
+        beta = 0.;
+        jend = j + 1;
+        break;
+      }
+
+      // Invariant subspace: continue with a random orthogonal vector
+      if (beta < 1e-12 * std::max(1.0, std::abs(alpha))) {
+        if (j + 1 >= m) {
+          beta = 0.;
+          jend = j + 1;
+          break;
+        }
+        Log(1, "Thick-restart Lanczos: invariant subspace of dimension {} "
+               "found, continuing with random vector",
+            j + 1);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (int64_t i = 0; i < n; ++i) {
+          w(i) = normal(generator);
+        }
+        orthogonalize(w, 0, j + 1, 2);
+        w /= norm(w);
+        beta = 0.;
+      } else {
+        w /= beta;
+      }
+      if (j + 1 < m) {
+        T(j, j + 1) = T(j + 1, j) = beta;
+        V.col(j + 1) = w;
+      }
+      if (res.niterations >= max_iterations) {
+        jend = j + 1;
+        break;
+      }
+    }
+
+    // Rayleigh-Ritz on the active part of the basis
+    int64_t a = nlock;
+    int64_t na = jend - a;
+    vec theta;
+    mat Y;
+    try {
+      eig_sym(theta, Y, T.submat(a, a, jend - 1, jend - 1));
+    } catch (...) {
+      XDIAG_THROW("Error diagonalizing projected matrix");
+    }
+    vec residuals = abs(beta * Y.row(na - 1).t());
+    int64_t nwant = std::min(neigvals - nlock, na);
+    int64_t nconv = 0;
+    while ((nconv < nwant) &&
+           (residuals(nconv) <= precision * std::max(1.0, std::abs(theta(nconv))))) {
+      ++nconv;
+    }
+    Log(1,
+        "Thick-restart Lanczos cycle {}: {} MVMs, {} locked, {} of {} "
+        "converged",
+        res.nrestarts + 1, res.niterations, nlock, nconv, nwant);
+
+    // Finalize: eigenvectors are written to the first columns of V
+    bool maxiter = (res.niterations >= max_iterations) && (jend == j + 1);
+    if ((nconv == nwant) || exhausted || maxiter) {
+      rotate_basis(V, a, Y.head_cols(nwant));
+      res.eigenvalues = join_cols(locked_eigenvalues, theta.head(nwant));
+      res.residual_norms = join_cols(locked_residuals, residuals.head(nwant));
+      res.tmat = T.submat(0, 0, jend - 1, jend - 1);
+      res.criterion = ((nconv == nwant) || exhausted) ? "converged"
+                                                       : "maxiterations";
+      return res;
+    }
+
+    // Thick restart: lock converged and keep the lowest Ritz vectors
+    int64_t nkeep = std::min(na - 1, nwant + (na - nwant) / 2);
+    rotate_basis(V, a, Y.head_cols(nkeep));
+    T.submat(a, a, m - 1, m - 1).zeros();
+    for (int64_t i = 0; i < nkeep; ++i) {
+      T(a + i, a + i) = theta(i);
+      if (i >= nconv) { // locked vectors are decoupled
+        T(a + nkeep, a + i) = T(a + i, a + nkeep) = beta * Y(na - 1, i);
+      }
+    }
+    locked_eigenvalues = join_cols(locked_eigenvalues, theta.head(nconv));
+    locked_residuals = join_cols(locked_residuals, residuals.head(nconv));
+    nlock += nconv;
+    first_new = a + nkeep;
+    j = first_new;
+
+    // The residual vector is reorthogonalized once per cycle. As the Lanczos
+    // vectors lose orthogonality predominantly in the direction of (almost)
+    // converged Ritz vectors, selective orthogonalization (Parlett and Scott)
+    // against the locked and kept vectors is performed in every step of the
+    // next cycle.
+    orthogonalize(w, 0, first_new, 2);
+    w /= norm(w);
+    V.col(first_new) = w; // residual vector is the next Lanczos vector
+    nselect = first_new;
+    omega.eye();
+    for (int64_t i = nlock; i <= first_new; ++i) {
+      for (int64_t k = nlock; k < i; ++k) {
+        omega(i, k) = omega(k, i) = eps * noise(generator);
+      }
+    }
+    reortho_next = false;
+    ++res.nrestarts;
+  }
+}
+XDIAG_CATCH
+
+} // namespace xdiag::lanczos
@@ -5,6 +5,7 @@
 #include "eigs_lobpcg.hpp"
 
 #include <algorithm>
+#include <type_traits>
 
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/kernels/apply.hpp>
@@ -44,7 +45,13 @@ static EigsLobpcgResult run_eigs_lobpcg(op_t const &ops, Block const &block,
 
   auto multiplyA = [&ops, &block](arma::Mat<coeff_t> const &V,
                                   arma::Mat<coeff_t> &W) {
-    apply(ops, block, V, block, W);
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(ops, block, V, block, W, false, "pull"); // ops is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(ops, block, V, block, W, "pull"); // ops is Hermitian
+    } else {
+      apply(ops, block, V, block, W);
+    }
   };
   auto dot = [&block](arma::Mat<coeff_t> const &V,
                       arma::Mat<coeff_t> const &W) {
@@ -122,6 +129,14 @@ EigsLobpcgResult eigs_lobpcg(OpSum const &ops, Block const &block,
 }
 XDIAG_CATCH
 
+EigsLobpcgResult eigs_lobpcg(CompiledOpSum const &ops, Block const &block,
+                             int64_t neigs, int64_t guard, double tol,
+                             int64_t max_iterations, int64_t random_seed) try {
+  return eigs_lobpcg<CompiledOpSum>(ops, block, neigs, guard, tol,
+                                    max_iterations, random_seed);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 EigsLobpcgResult eigs_lobpcg(CSRMatrix<idx_t, coeff_t> const &ops,
                              Block const &block, int64_t neigs, int64_t guard,
@@ -132,15 +147,43 @@ EigsLobpcgResult eigs_lobpcg(CSRMatrix<idx_t, coeff_t> const &ops,
 }
 XDIAG_CATCH
 
+template <typename idx_t, typename coeff_t>
+EigsLobpcgResult eigs_lobpcg(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                             Block const &block, int64_t neigs, int64_t guard,
+                             double tol, int64_t max_iterations,
+                             int64_t random_seed) try {
+  return eigs_lobpcg<CSRVIMatrix<idx_t, coeff_t>>(ops, block, neigs, guard, tol,
+                                                  max_iterations, random_seed);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EigsLobpcgResult eigs_lobpcg(SELLMatrix<idx_t, coeff_t> const &ops,
+                             Block const &block, int64_t neigs, int64_t guard,
+                             double tol, int64_t max_iterations,
+                             int64_t random_seed) try {
+  return eigs_lobpcg<SELLMatrix<idx_t, coeff_t>>(ops, block, neigs, guard, tol,
+                                                 max_iterations, random_seed);
+}
+XDIAG_CATCH
+
 // Template instantiations for every (idx_t, coeff_t) sparse-matrix combination
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template EigsLobpcgResult eigs_lobpcg(CSRMatrix<IDX, COEFF> const &,         \
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template EigsLobpcgResult eigs_lobpcg(MAT<IDX, COEFF> const &,               \
                                         Block const &, int64_t, int64_t,       \
                                         double, int64_t, int64_t);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
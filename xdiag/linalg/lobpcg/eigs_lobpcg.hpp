@@ -8,6 +8,7 @@
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/states/state.hpp>
@@ -38,6 +39,13 @@ XDIAG_API EigsLobpcgResult eigs_lobpcg(OpSum const &ops, Block const &block,
                                        int64_t max_iterations = 1000,
                                        int64_t random_seed = 42);
 
+// on-the-fly, with a precompiled operator
+XDIAG_API EigsLobpcgResult eigs_lobpcg(CompiledOpSum const &ops,
+                                       Block const &block, int64_t neigs = 1,
+                                       int64_t guard = 2, double tol = 1e-10,
+                                       int64_t max_iterations = 1000,
+                                       int64_t random_seed = 42);
+
 // sparse matrix
 template <typename idx_t, typename coeff_t>
 XDIAG_API EigsLobpcgResult eigs_lobpcg(CSRMatrix<idx_t, coeff_t> const &A,
@@ -45,5 +53,17 @@ XDIAG_API EigsLobpcgResult eigs_lobpcg(CSRMatrix<idx_t, coeff_t> const &A,
                                        int64_t guard = 2, double tol = 1e-10,
                                        int64_t max_iterations = 1000,
                                        int64_t random_seed = 42);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLobpcgResult eigs_lobpcg(SELLMatrix<idx_t, coeff_t> const &A,
+                                       Block const &block, int64_t neigs = 1,
+                                       int64_t guard = 2, double tol = 1e-10,
+                                       int64_t max_iterations = 1000,
+                                       int64_t random_seed = 42);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EigsLobpcgResult eigs_lobpcg(CSRVIMatrix<idx_t, coeff_t> const &A,
+                                       Block const &block, int64_t neigs = 1,
+                                       int64_t guard = 2, double tol = 1e-10,
+                                       int64_t max_iterations = 1000,
+                                       int64_t random_seed = 42);
 
 } // namespace xdiag
@@ -169,6 +169,12 @@ double norm_estimate(OpSum const &ops, Block const &block,
 }
 XDIAG_CATCH
 
+double norm_estimate(CompiledOpSum const &ops, Block const &block,
+                     int64_t n_max_attempts, uint64_t seed) try {
+  return norm_estimate<CompiledOpSum>(ops, block, n_max_attempts, seed);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 double norm_estimate(CSRMatrix<idx_t, coeff_t> const &ops, Block const &block,
                      int64_t n_max_attempts, uint64_t seed) try {
@@ -177,6 +183,22 @@ double norm_estimate(CSRMatrix<idx_t, coeff_t> const &ops, Block const &block,
 }
 XDIAG_CATCH
 
+template <typename idx_t, typename coeff_t>
+double norm_estimate(CSRVIMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                     int64_t n_max_attempts, uint64_t seed) try {
+  return norm_estimate<CSRVIMatrix<idx_t, coeff_t>>(ops, block, n_max_attempts,
+                                                    seed);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+double norm_estimate(SELLMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                     int64_t n_max_attempts, uint64_t seed) try {
+  return norm_estimate<SELLMatrix<idx_t, coeff_t>>(ops, block, n_max_attempts,
+                                                   seed);
+}
+XDIAG_CATCH
+
 template double norm_estimate(CSRMatrix<int32_t, double> const &, Block const &,
                               int64_t, uint64_t);
 template double norm_estimate(CSRMatrix<int32_t, complex> const &,
@@ -185,6 +207,22 @@ template double norm_estimate(CSRMatrix<int64_t, double> const &, Block const &,
                               int64_t, uint64_t);
 template double norm_estimate(CSRMatrix<int64_t, complex> const &,
                               Block const &, int64_t, uint64_t);
+template double norm_estimate(SELLMatrix<int32_t, double> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(SELLMatrix<int32_t, complex> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(SELLMatrix<int64_t, double> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(SELLMatrix<int64_t, complex> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(CSRVIMatrix<int32_t, double> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(CSRVIMatrix<int32_t, complex> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(CSRVIMatrix<int64_t, double> const &,
+                              Block const &, int64_t, uint64_t);
+template double norm_estimate(CSRVIMatrix<int64_t, complex> const &,
+                              Block const &, int64_t, uint64_t);
 
 template <typename coeff_t>
 double norm_estimate(arma::Mat<coeff_t> const &A, int64_t n_max_attempts,
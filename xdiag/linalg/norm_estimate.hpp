@@ -8,6 +8,7 @@
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/blocks/blocks.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 
@@ -19,9 +20,18 @@ namespace xdiag {
 double norm_estimate(OpSum const &ops, Block const &block,
                      int64_t n_max_attempts = 5, uint64_t seed = 42);
 
+double norm_estimate(CompiledOpSum const &ops, Block const &block,
+                     int64_t n_max_attempts = 5, uint64_t seed = 42);
+
 template <typename idx_t, typename coeff_t>
 double norm_estimate(CSRMatrix<idx_t, coeff_t> const &ops, Block const &block,
                      int64_t n_max_attempts = 5, uint64_t seed = 42);
+template <typename idx_t, typename coeff_t>
+double norm_estimate(SELLMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                     int64_t n_max_attempts = 5, uint64_t seed = 42);
+template <typename idx_t, typename coeff_t>
+double norm_estimate(CSRVIMatrix<idx_t, coeff_t> const &ops, Block const &block,
+                     int64_t n_max_attempts = 5, uint64_t seed = 42);
 
 template <typename coeff_t>
 double norm_estimate(arma::Mat<coeff_t> const &A, int64_t n_max_attempts = 5,
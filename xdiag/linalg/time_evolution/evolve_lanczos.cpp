@@ -4,6 +4,8 @@
 
 #include "evolve_lanczos.hpp"
 
+#include <type_traits>
+
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/sparse/apply.hpp>
@@ -28,7 +30,13 @@ run_exp_sym_v(op_t const &H, Block const &block, arma::Col<coeff_t> &v,
   auto mult = [&iter, &H, &block](arma::Col<coeff_t> const &v,
                                   arma::Col<coeff_t> &w) {
     auto ta = rightnow();
-    apply(H, block, v, block, w);
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(H, block, v, block, w, false, "pull"); // H is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(H, block, v, block, w, "pull"); // H is Hermitian
+    } else {
+      apply(H, block, v, block, w);
+    }
     Log(2, "Lanczos iteration {}", iter);
     timing(ta, rightnow(), "MVM", 1);
     ++iter;
@@ -37,8 +45,17 @@ run_exp_sym_v(op_t const &H, Block const &block, arma::Col<coeff_t> &v,
                         arma::Col<coeff_t> const &w) {
     return math::dot(block, v, w);
   };
-  exp_sym_v_result_t r = exp_sym_v(mult, dot_f, v, tau, precision, shift,
-                                   normalize, max_iterations, deflation_tol);
+  auto reduce = [&block](double *sums, int64_t n) {
+    math::allreduce_sum(block, sums, n);
+  };
+  // the fused recurrence is used along with the fused kernels
+  bool fused = false;
+  if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+    fused = H.fused;
+  }
+  exp_sym_v_result_t r =
+      exp_sym_v(mult, dot_f, v, tau, precision, shift, normalize,
+                max_iterations, deflation_tol, reduce, fused);
   return {r.alphas, r.betas, r.eigenvalues, r.niterations, r.criterion};
 }
 
@@ -63,6 +80,16 @@ EvolveLanczosResult evolve_lanczos(OpSum const &H, State psi, double tau,
 }
 XDIAG_CATCH
 
+EvolveLanczosResult evolve_lanczos(CompiledOpSum const &H, State psi,
+                                   double tau, double precision, double shift,
+                                   bool normalize, int64_t max_iterations,
+                                   double deflation_tol) try {
+
+  return evolve_lanczos<CompiledOpSum>(H, psi, tau, precision, shift, normalize,
+                                       max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 EvolveLanczosResult
 evolve_lanczos(CSRMatrix<idx_t, coeff_t> const &H, State psi, double tau,
@@ -74,14 +101,44 @@ evolve_lanczos(CSRMatrix<idx_t, coeff_t> const &H, State psi, double tau,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template EvolveLanczosResult evolve_lanczos(CSRMatrix<IDX, COEFF> const &,   \
+template <typename idx_t, typename coeff_t>
+EvolveLanczosResult
+evolve_lanczos(CSRVIMatrix<idx_t, coeff_t> const &H, State psi, double tau,
+               double precision, double shift, bool normalize,
+               int64_t max_iterations, double deflation_tol) try {
+
+  return evolve_lanczos<CSRVIMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EvolveLanczosResult
+evolve_lanczos(SELLMatrix<idx_t, coeff_t> const &H, State psi, double tau,
+               double precision, double shift, bool normalize,
+               int64_t max_iterations, double deflation_tol) try {
+
+  return evolve_lanczos<SELLMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template EvolveLanczosResult evolve_lanczos(MAT<IDX, COEFF> const &,         \
                                               State, double, double, double,   \
                                               bool, int64_t, double);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 template <typename op_t>
@@ -104,6 +161,15 @@ EvolveLanczosResult evolve_lanczos(OpSum const &H, State psi, complex tau,
 }
 XDIAG_CATCH
 
+EvolveLanczosResult evolve_lanczos(CompiledOpSum const &H, State psi,
+                                   complex tau, double precision, double shift,
+                                   bool normalize, int64_t max_iterations,
+                                   double deflation_tol) try {
+  return evolve_lanczos<CompiledOpSum>(H, psi, tau, precision, shift, normalize,
+                                       max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 EvolveLanczosResult
 evolve_lanczos(CSRMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
@@ -114,14 +180,42 @@ evolve_lanczos(CSRMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template EvolveLanczosResult evolve_lanczos(CSRMatrix<IDX, COEFF> const &,   \
+template <typename idx_t, typename coeff_t>
+EvolveLanczosResult
+evolve_lanczos(CSRVIMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
+               double precision, double shift, bool normalize,
+               int64_t max_iterations, double deflation_tol) try {
+  return evolve_lanczos<CSRVIMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EvolveLanczosResult
+evolve_lanczos(SELLMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
+               double precision, double shift, bool normalize,
+               int64_t max_iterations, double deflation_tol) try {
+  return evolve_lanczos<SELLMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template EvolveLanczosResult evolve_lanczos(MAT<IDX, COEFF> const &,         \
                                               State, complex, double, double,  \
                                               bool, int64_t, double);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 template <typename op_t>
@@ -173,6 +267,16 @@ EvolveLanczosInplaceResult evolve_lanczos_inplace(OpSum const &H, State &psi,
 }
 XDIAG_CATCH
 
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(CompiledOpSum const &H, State &psi, double tau,
+                       double precision, double shift, bool normalize,
+                       int64_t max_iterations, double deflation_tol) try {
+  return evolve_lanczos_inplace<CompiledOpSum>(H, psi, tau, precision, shift,
+                                               normalize, max_iterations,
+                                               deflation_tol);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 EvolveLanczosInplaceResult
 evolve_lanczos_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
@@ -184,14 +288,44 @@ evolve_lanczos_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
+template <typename idx_t, typename coeff_t>
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(CSRVIMatrix<idx_t, coeff_t> const &H, State &psi,
+                       double tau, double precision, double shift,
+                       bool normalize, int64_t max_iterations,
+                       double deflation_tol) try {
+  return evolve_lanczos_inplace<CSRVIMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(SELLMatrix<idx_t, coeff_t> const &H, State &psi,
+                       double tau, double precision, double shift,
+                       bool normalize, int64_t max_iterations,
+                       double deflation_tol) try {
+  return evolve_lanczos_inplace<SELLMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
   template EvolveLanczosInplaceResult evolve_lanczos_inplace(                  \
-      CSRMatrix<IDX, COEFF> const &, State &, double, double, double, bool,    \
+      MAT<IDX, COEFF> const &, State &, double, double, double, bool,          \
       int64_t, double);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 template <typename op_t>
@@ -239,6 +373,16 @@ EvolveLanczosInplaceResult evolve_lanczos_inplace(OpSum const &H, State &psi,
 }
 XDIAG_CATCH
 
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(CompiledOpSum const &H, State &psi, complex tau,
+                       double precision, double shift, bool normalize,
+                       int64_t max_iterations, double deflation_tol) try {
+  return evolve_lanczos_inplace<CompiledOpSum>(H, psi, tau, precision, shift,
+                                               normalize, max_iterations,
+                                               deflation_tol);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 EvolveLanczosInplaceResult
 evolve_lanczos_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
@@ -250,14 +394,44 @@ evolve_lanczos_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
+template <typename idx_t, typename coeff_t>
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(CSRVIMatrix<idx_t, coeff_t> const &H, State &psi,
+                       complex tau, double precision, double shift,
+                       bool normalize, int64_t max_iterations,
+                       double deflation_tol) try {
+  return evolve_lanczos_inplace<CSRVIMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+EvolveLanczosInplaceResult
+evolve_lanczos_inplace(SELLMatrix<idx_t, coeff_t> const &H, State &psi,
+                       complex tau, double precision, double shift,
+                       bool normalize, int64_t max_iterations,
+                       double deflation_tol) try {
+  return evolve_lanczos_inplace<SELLMatrix<idx_t, coeff_t>>(
+      H, psi, tau, precision, shift, normalize, max_iterations, deflation_tol);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
   template EvolveLanczosInplaceResult evolve_lanczos_inplace(                  \
-      CSRMatrix<IDX, COEFF> const &, State &, complex, double, double, bool,   \
+      MAT<IDX, COEFF> const &, State &, complex, double, double, bool,         \
       int64_t, double);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
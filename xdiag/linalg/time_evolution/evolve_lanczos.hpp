@@ -8,6 +8,7 @@
 #include <string>
 
 #include <xdiag/armadillo.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/operators/opsum.hpp>
@@ -35,17 +36,47 @@ evolve_lanczos(OpSum const &H, State psi, complex tau, double precision = 1e-12,
                double shift = 0., bool normalize = false,
                int64_t max_iterations = 1000, double deflation_tol = 1e-7);
 
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    CompiledOpSum const &H, State psi, double tau, double precision = 1e-12,
+    double shift = 0., bool normalize = false, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7);
+
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    CompiledOpSum const &H, State psi, complex tau, double precision = 1e-12,
+    double shift = 0., bool normalize = false, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7);
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API EvolveLanczosResult evolve_lanczos(
     CSRMatrix<idx_t, coeff_t> const &H, State psi, double tau,
     double precision = 1e-12, double shift = 0., bool normalize = false,
     int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    SELLMatrix<idx_t, coeff_t> const &H, State psi, double tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    CSRVIMatrix<idx_t, coeff_t> const &H, State psi, double tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API EvolveLanczosResult evolve_lanczos(
     CSRMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
     double precision = 1e-12, double shift = 0., bool normalize = false,
     int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    SELLMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosResult evolve_lanczos(
+    CSRVIMatrix<idx_t, coeff_t> const &H, State psi, complex tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
 
 struct XDIAG_API EvolveLanczosInplaceResult {
   arma::vec alphas;
@@ -65,16 +96,46 @@ XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
     double shift = 0., bool normalize = false, int64_t max_iterations = 1000,
     double deflation_tol = 1e-7);
 
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    CompiledOpSum const &H, State &psi, double tau, double precision = 1e-12,
+    double shift = 0., bool normalize = false, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7);
+
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    CompiledOpSum const &H, State &psi, complex tau, double precision = 1e-12,
+    double shift = 0., bool normalize = false, int64_t max_iterations = 1000,
+    double deflation_tol = 1e-7);
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
     CSRMatrix<idx_t, coeff_t> const &H, State &psi, double tau,
     double precision = 1e-12, double shift = 0., bool normalize = false,
     int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    SELLMatrix<idx_t, coeff_t> const &H, State &psi, double tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    CSRVIMatrix<idx_t, coeff_t> const &H, State &psi, double tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
 
 template <typename idx_t, typename coeff_t>
 XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
     CSRMatrix<idx_t, coeff_t> const &H, State &psi, complex tau,
     double precision = 1e-12, double shift = 0., bool normalize = false,
     int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    SELLMatrix<idx_t, coeff_t> const &H, State &psi, complex tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
+template <typename idx_t, typename coeff_t>
+XDIAG_API EvolveLanczosInplaceResult evolve_lanczos_inplace(
+    CSRVIMatrix<idx_t, coeff_t> const &H, State &psi, complex tau,
+    double precision = 1e-12, double shift = 0., bool normalize = false,
+    int64_t max_iterations = 1000, double deflation_tol = 1e-7);
 
 } // namespace xdiag
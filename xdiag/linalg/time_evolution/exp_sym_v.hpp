@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <xdiag/linalg/lanczos/eigvals_lanczos.hpp>
 #include <xdiag/linalg/lanczos/lanczos.hpp>
 #include <xdiag/linalg/lanczos/lanczos_convergence.hpp>
@@ -19,11 +21,14 @@ struct exp_sym_v_result_t {
   std::string criterion;
 };
 
-template <typename coeff_t, class multiply_f, class dot_f>
+// reduce, fused: optional, select the fused recurrence (cf. lanczos::lanczos)
+template <typename coeff_t, class multiply_f, class dot_f,
+          class reduce_f = std::nullptr_t>
 exp_sym_v_result_t
 exp_sym_v(multiply_f mult, dot_f dot, arma::Col<coeff_t> &X, coeff_t tau,
           double precision = 1e-12, double shift = 0, bool normalize = false,
-          int64_t max_iterations = 1000, double deflation_tol = 1e-7) try {
+          int64_t max_iterations = 1000, double deflation_tol = 1e-7,
+          reduce_f reduce = nullptr, bool fused = false) try {
 
   double nrm = lanczos_norm(X, dot);
   arma::Col<coeff_t> v0 = X;
@@ -34,8 +39,9 @@ exp_sym_v(multiply_f mult, dot_f dot, arma::Col<coeff_t> &X, coeff_t tau,
 
   auto operation_void = [](arma::Col<coeff_t> const &) {};
 
-  lanczos::lanczos_result_t r = lanczos::lanczos(
-      mult, dot, converged, operation_void, v0, max_iterations, deflation_tol);
+  lanczos::lanczos_result_t r =
+      lanczos::lanczos(mult, dot, converged, operation_void, v0,
+                       max_iterations, deflation_tol, reduce, fused);
 
   // Reconstruct the tridiagonal matrix from the recurrence coefficients
   Tmatrix tmatrix(arma::conv_to<std::vector<double>>::from(r.alphas),
@@ -65,7 +71,7 @@ exp_sym_v(multiply_f mult, dot_f dot, arma::Col<coeff_t> &X, coeff_t tau,
   };
 
   lanczos::lanczos(mult2, dot, converged, operation, v0, max_iterations,
-                   deflation_tol);
+                   deflation_tol, reduce, fused);
 
   if (!normalize) {
     X *= nrm;
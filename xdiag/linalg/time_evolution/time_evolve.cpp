@@ -25,6 +25,12 @@ State time_evolve(OpSum const &H, State psi, double time, double precision,
 }
 XDIAG_CATCH
 
+State time_evolve(CompiledOpSum const &H, State psi, double time,
+                  double precision, std::string algorithm) try {
+  return time_evolve<CompiledOpSum>(H, psi, time, precision, algorithm);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 State time_evolve(CSRMatrix<idx_t, coeff_t> const &H, State psi, double time,
                   double precision, std::string algorithm) try {
@@ -33,13 +39,37 @@ State time_evolve(CSRMatrix<idx_t, coeff_t> const &H, State psi, double time,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template State time_evolve(CSRMatrix<IDX, COEFF> const &, State, double,     \
+template <typename idx_t, typename coeff_t>
+State time_evolve(CSRVIMatrix<idx_t, coeff_t> const &H, State psi, double time,
+                  double precision, std::string algorithm) try {
+  return time_evolve<CSRVIMatrix<idx_t, coeff_t>>(H, psi, time, precision,
+                                                  algorithm);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+State time_evolve(SELLMatrix<idx_t, coeff_t> const &H, State psi, double time,
+                  double precision, std::string algorithm) try {
+  return time_evolve<SELLMatrix<idx_t, coeff_t>>(H, psi, time, precision,
+                                                 algorithm);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template State time_evolve(MAT<IDX, COEFF> const &, State, double,           \
                              double, std::string);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 template <typename op_t>
@@ -66,6 +96,12 @@ void time_evolve_inplace(OpSum const &H, State &psi, double time,
 }
 XDIAG_CATCH
 
+void time_evolve_inplace(CompiledOpSum const &H, State &psi, double time,
+                         double precision, std::string algorithm) try {
+  time_evolve_inplace<CompiledOpSum>(H, psi, time, precision, algorithm);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 void time_evolve_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
                          double time, double precision,
@@ -75,13 +111,39 @@ void time_evolve_inplace(CSRMatrix<idx_t, coeff_t> const &H, State &psi,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
-  template void time_evolve_inplace(CSRMatrix<IDX, COEFF> const &, State &,    \
+template <typename idx_t, typename coeff_t>
+void time_evolve_inplace(CSRVIMatrix<idx_t, coeff_t> const &H, State &psi,
+                         double time, double precision,
+                         std::string algorithm) try {
+  time_evolve_inplace<CSRVIMatrix<idx_t, coeff_t>>(H, psi, time, precision,
+                                                   algorithm);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+void time_evolve_inplace(SELLMatrix<idx_t, coeff_t> const &H, State &psi,
+                         double time, double precision,
+                         std::string algorithm) try {
+  time_evolve_inplace<SELLMatrix<idx_t, coeff_t>>(H, psi, time, precision,
+                                                  algorithm);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
+  template void time_evolve_inplace(MAT<IDX, COEFF> const &, State &,          \
                                     double, double, std::string);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/states/state.hpp>
@@ -17,19 +18,45 @@ XDIAG_API State time_evolve(OpSum const &H, State psi, double time,
                             double precision = 1e-12,
                             std::string algorithm = "lanczos");
 
+XDIAG_API State time_evolve(CompiledOpSum const &H, State psi, double time,
+                            double precision = 1e-12,
+                            std::string algorithm = "lanczos");
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API State time_evolve(CSRMatrix<idx_t, coeff_t> const &H, State psi,
                             double time, double precision = 1e-12,
                             std::string algorithm = "lanczos");
+template <typename idx_t, typename coeff_t>
+XDIAG_API State time_evolve(SELLMatrix<idx_t, coeff_t> const &H, State psi,
+                            double time, double precision = 1e-12,
+                            std::string algorithm = "lanczos");
+template <typename idx_t, typename coeff_t>
+XDIAG_API State time_evolve(CSRVIMatrix<idx_t, coeff_t> const &H, State psi,
+                            double time, double precision = 1e-12,
+                            std::string algorithm = "lanczos");
 
 XDIAG_API void time_evolve_inplace(OpSum const &H, State &psi, double time,
                                    double precision = 1e-12,
                                    std::string algorithm = "lanczos");
 
+XDIAG_API void time_evolve_inplace(CompiledOpSum const &H, State &psi,
+                                   double time, double precision = 1e-12,
+                                   std::string algorithm = "lanczos");
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API void time_evolve_inplace(CSRMatrix<idx_t, coeff_t> const &H,
                                    State &psi, double time,
                                    double precision = 1e-12,
                                    std::string algorithm = "lanczos");
+template <typename idx_t, typename coeff_t>
+XDIAG_API void time_evolve_inplace(SELLMatrix<idx_t, coeff_t> const &H,
+                                   State &psi, double time,
+                                   double precision = 1e-12,
+                                   std::string algorithm = "lanczos");
+template <typename idx_t, typename coeff_t>
+XDIAG_API void time_evolve_inplace(CSRVIMatrix<idx_t, coeff_t> const &H,
+                                   State &psi, double time,
+                                   double precision = 1e-12,
+                                   std::string algorithm = "lanczos");
 
 } // namespace xdiag
@@ -4,6 +4,8 @@
 
 #include "time_evolve_expokit.hpp"
 
+#include <type_traits>
+
 #include <xdiag/algebra/ishermitian.hpp>
 #include <xdiag/kernels/apply.hpp>
 #include <xdiag/kernels/sparse/apply.hpp>
@@ -35,6 +37,15 @@ TimeEvolveExpokitResult time_evolve_expokit(OpSum const &ops, State state,
 }
 XDIAG_CATCH
 
+TimeEvolveExpokitResult time_evolve_expokit(CompiledOpSum const &ops,
+                                            State state, double time,
+                                            double precision, int64_t m,
+                                            double anorm, int64_t nnorm) try {
+  return time_evolve_expokit<CompiledOpSum>(ops, state, time, precision, m,
+                                            anorm, nnorm);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 TimeEvolveExpokitResult
 time_evolve_expokit(CSRMatrix<idx_t, coeff_t> const &ops, State state,
@@ -45,14 +56,42 @@ time_evolve_expokit(CSRMatrix<idx_t, coeff_t> const &ops, State state,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
+template <typename idx_t, typename coeff_t>
+TimeEvolveExpokitResult
+time_evolve_expokit(CSRVIMatrix<idx_t, coeff_t> const &ops, State state,
+                    double time, double precision, int64_t m, double anorm,
+                    int64_t nnorm) try {
+  return time_evolve_expokit<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, state, time, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+TimeEvolveExpokitResult
+time_evolve_expokit(SELLMatrix<idx_t, coeff_t> const &ops, State state,
+                    double time, double precision, int64_t m, double anorm,
+                    int64_t nnorm) try {
+  return time_evolve_expokit<SELLMatrix<idx_t, coeff_t>>(
+      ops, state, time, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
   template TimeEvolveExpokitResult time_evolve_expokit(                        \
-      CSRMatrix<IDX, COEFF> const &, State, double, double, int64_t, double,   \
+      MAT<IDX, COEFF> const &, State, double, double, int64_t, double,         \
       int64_t);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 template <typename op_t>
@@ -99,7 +138,13 @@ time_evolve_expokit_inplace(op_t const &ops, State &state, double time,
   auto apply_A = [&iter, &ops, &block](arma::cx_vec const &v) {
     auto ta = rightnow();
     auto w = arma::cx_vec(v.n_rows, arma::fill::zeros);
-    apply(ops, block, v, block, w);
+    if constexpr (std::is_same_v<op_t, OpSum>) {
+      apply(ops, block, v, block, w, false, "pull"); // ops is Hermitian
+    } else if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+      apply(ops, block, v, block, w, "pull"); // ops is Hermitian
+    } else {
+      apply(ops, block, v, block, w);
+    }
     w *= complex(0.0, -1.0);
     Log(2, "Lanczos iteration {}", iter);
     timing(ta, rightnow(), "MVM", 2);
@@ -130,6 +175,15 @@ time_evolve_expokit_inplace(OpSum const &ops, State &state, double time,
 }
 XDIAG_CATCH
 
+TimeEvolveExpokitInplaceResult
+time_evolve_expokit_inplace(CompiledOpSum const &ops, State &state,
+                            double time, double precision, int64_t m,
+                            double anorm, int64_t nnorm) try {
+  return time_evolve_expokit_inplace<CompiledOpSum>(ops, state, time, precision,
+                                                    m, anorm, nnorm);
+}
+XDIAG_CATCH
+
 template <typename idx_t, typename coeff_t>
 TimeEvolveExpokitInplaceResult
 time_evolve_expokit_inplace(CSRMatrix<idx_t, coeff_t> const &ops, State &state,
@@ -140,14 +194,42 @@ time_evolve_expokit_inplace(CSRMatrix<idx_t, coeff_t> const &ops, State &state,
 }
 XDIAG_CATCH
 
-#define XDIAG_INST(IDX, COEFF)                                                 \
+template <typename idx_t, typename coeff_t>
+TimeEvolveExpokitInplaceResult
+time_evolve_expokit_inplace(CSRVIMatrix<idx_t, coeff_t> const &ops,
+                            State &state, double time, double precision,
+                            int64_t m, double anorm, int64_t nnorm) try {
+  return time_evolve_expokit_inplace<CSRVIMatrix<idx_t, coeff_t>>(
+      ops, state, time, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+TimeEvolveExpokitInplaceResult
+time_evolve_expokit_inplace(SELLMatrix<idx_t, coeff_t> const &ops, State &state,
+                            double time, double precision, int64_t m,
+                            double anorm, int64_t nnorm) try {
+  return time_evolve_expokit_inplace<SELLMatrix<idx_t, coeff_t>>(
+      ops, state, time, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(MAT, IDX, COEFF)                                            \
   template TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(         \
-      CSRMatrix<IDX, COEFF> const &, State &, double, double, int64_t, double, \
+      MAT<IDX, COEFF> const &, State &, double, double, int64_t, double,       \
       int64_t);
-XDIAG_INST(int32_t, double)
-XDIAG_INST(int32_t, complex)
-XDIAG_INST(int64_t, double)
-XDIAG_INST(int64_t, complex)
+XDIAG_INST(CSRMatrix, int32_t, double)
+XDIAG_INST(CSRMatrix, int32_t, complex)
+XDIAG_INST(CSRMatrix, int64_t, double)
+XDIAG_INST(CSRMatrix, int64_t, complex)
+XDIAG_INST(SELLMatrix, int32_t, double)
+XDIAG_INST(SELLMatrix, int32_t, complex)
+XDIAG_INST(SELLMatrix, int64_t, double)
+XDIAG_INST(SELLMatrix, int64_t, complex)
+XDIAG_INST(CSRVIMatrix, int32_t, double)
+XDIAG_INST(CSRVIMatrix, int32_t, complex)
+XDIAG_INST(CSRVIMatrix, int64_t, double)
+XDIAG_INST(CSRVIMatrix, int64_t, complex)
 #undef XDIAG_INST
 
 } // namespace xdiag
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 
+#include <xdiag/kernels/compiled_opsum.hpp>
 #include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
 #include <xdiag/operators/opsum.hpp>
 #include <xdiag/states/state.hpp>
@@ -23,11 +24,25 @@ XDIAG_API TimeEvolveExpokitResult time_evolve_expokit(
     OpSum const &H, State psi0, double time, double precision = 1e-12,
     int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
 
+XDIAG_API TimeEvolveExpokitResult time_evolve_expokit(
+    CompiledOpSum const &H, State psi0, double time, double precision = 1e-12,
+    int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API TimeEvolveExpokitResult
 time_evolve_expokit(CSRMatrix<idx_t, coeff_t> const &H, State psi0, double time,
                     double precision = 1e-12, int64_t m = 30, double anorm = 0.,
                     int64_t nnorm = 2);
+template <typename idx_t, typename coeff_t>
+XDIAG_API TimeEvolveExpokitResult
+time_evolve_expokit(SELLMatrix<idx_t, coeff_t> const &H, State psi0,
+                    double time, double precision = 1e-12, int64_t m = 30,
+                    double anorm = 0., int64_t nnorm = 2);
+template <typename idx_t, typename coeff_t>
+XDIAG_API TimeEvolveExpokitResult
+time_evolve_expokit(CSRVIMatrix<idx_t, coeff_t> const &H, State psi0,
+                    double time, double precision = 1e-12, int64_t m = 30,
+                    double anorm = 0., int64_t nnorm = 2);
 
 struct XDIAG_API TimeEvolveExpokitInplaceResult {
   double error;
@@ -38,10 +53,24 @@ XDIAG_API TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(
     OpSum const &H, State &psi, double time, double precision = 1e-12,
     int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
 
+XDIAG_API TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(
+    CompiledOpSum const &H, State &psi, double time, double precision = 1e-12,
+    int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
+
 template <typename idx_t, typename coeff_t>
 XDIAG_API TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(
     CSRMatrix<idx_t, coeff_t> const &H, State &psi, double time,
     double precision = 1e-12, int64_t m = 30, double anorm = 0.,
     int64_t nnorm = 2);
+template <typename idx_t, typename coeff_t>
+XDIAG_API TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(
+    SELLMatrix<idx_t, coeff_t> const &H, State &psi, double time,
+    double precision = 1e-12, int64_t m = 30, double anorm = 0.,
+    int64_t nnorm = 2);
+template <typename idx_t, typename coeff_t>
+XDIAG_API TimeEvolveExpokitInplaceResult time_evolve_expokit_inplace(
+    CSRVIMatrix<idx_t, coeff_t> const &H, State &psi, double time,
+    double precision = 1e-12, int64_t m = 30, double anorm = 0.,
+    int64_t nnorm = 2);
 
 } // namespace xdiag
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "time_evolve_trajectory.hpp"
+
+#include <type_traits>
+
+#include <xdiag/algebra/ishermitian.hpp>
+#include <xdiag/kernels/apply.hpp>
+#include <xdiag/kernels/sparse/apply.hpp>
+#include <xdiag/linalg/norm_estimate.hpp>
+#include <xdiag/linalg/time_evolution/zahexpv.hpp>
+#include <xdiag/math/dot.hpp>
+#include <xdiag/states/norm.hpp>
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/timing.hpp>
+
+namespace xdiag {
+
+template <typename op_t>
+static TimeEvolveTrajectoryResult
+time_evolve_trajectory(op_t const &H, State psi0,
+                       std::vector<double> const &times,
+                       std::vector<OpSum> const &observables,
+                       trajectory_callback_t const &callback, double precision,
+                       int64_t m, double anorm, int64_t nnorm) try {
+  int64_t ntimes = times.size();
+  int64_t nobs = observables.size();
+  for (int64_t i = 0; i < ntimes; ++i) {
+    if ((times[i] < 0.) || ((i > 0) && (times[i] < times[i - 1]))) {
+      XDIAG_THROW("Times of a trajectory must be non-negative and ascending");
+    }
+  }
+  if (!isvalid(psi0)) {
+    XDIAG_THROW("Initial state must be a valid state (i.e. not default "
+                "constructed by e.g. an annihilation operator)");
+  }
+
+  // Normal ordering and checks of H are done once for the whole trajectory
+  if constexpr (std::is_same_v<op_t, OpSum>) {
+    return time_evolve_trajectory(compiled_opsum(H, psi0.block()), psi0,
+                                  times, observables, callback, precision, m,
+                                  anorm, nnorm);
+  } else {
+    TimeEvolveTrajectoryResult res;
+    res.times = arma::vec(times);
+    res.measurements = arma::cx_mat(ntimes, nobs, arma::fill::zeros);
+    res.error = 0.;
+    res.hump = 0.;
+    res.nmvm = 0;
+    res.state = psi0;
+    if ((dim(psi0) == 0) || (ntimes == 0)) {
+      Log.warn("Warning: initial state zero dimensional or no times given in "
+               "time_evolve_trajectory");
+      return res;
+    }
+    if (!ishermitian(H, psi0.block())) {
+      XDIAG_THROW("Input operator is not hermitian. Evolution using the "
+                  "expokit algorithm requires the operator to be hermitian.");
+    }
+    if (norm(psi0) == 0.) {
+      XDIAG_THROW("Initial state has zero norm");
+    }
+
+    State &state = res.state;
+    if (state.isreal()) {
+      state.make_complex();
+    }
+    auto const &block = state.block();
+
+    // Observables mapping to a different block have zero expectation values
+    std::vector<CompiledOpSum> obs_compiled;
+    std::vector<bool> obs_conserved;
+    for (auto const &obs : observables) {
+      obs_compiled.push_back(compiled_opsum(obs, block));
+      obs_conserved.push_back(isapprox(xdiag::block(obs, block), block));
+    }
+
+    if (anorm == 0.) { // if anorm is default value 0., compute an estimate
+      for (int64_t j = 0; j < nnorm; ++j) {
+        double anormj = norm_estimate(H, block);
+        if (anormj > anorm) {
+          anorm = anormj;
+        }
+      }
+      Log(1, "norm estimate: {}", anorm);
+    }
+
+    auto apply_A = [&res, &H, &block](arma::cx_vec const &v) {
+      auto ta = rightnow();
+      auto w = arma::cx_vec(v.n_rows, arma::fill::zeros);
+      if constexpr (std::is_same_v<op_t, CompiledOpSum>) {
+        apply(H, block, v, block, w, "pull"); // H is Hermitian
+      } else {
+        apply(H, block, v, block, w);
+      }
+      w *= complex(0.0, -1.0);
+      ++res.nmvm;
+      Log(2, "Lanczos iteration {}", res.nmvm);
+      timing(ta, rightnow(), "MVM", 2);
+      return w;
+    };
+    auto dot_f = [&block](arma::cx_vec const &v, arma::cx_vec const &w) {
+      return math::dot(block, v, w);
+    };
+
+    // Measurements are streamed out, states at intermediate times are never
+    // stored
+    auto v0 = state.vectorC(0, false);
+    arma::cx_vec Ow(v0.n_rows, arma::fill::zeros);
+    auto output = [&](int64_t i, arma::cx_vec const &w) {
+      for (int64_t j = 0; j < nobs; ++j) {
+        if (obs_conserved[j]) {
+          Ow.zeros();
+          apply(obs_compiled[j], block, w, block, Ow);
+          res.measurements(i, j) = math::dot(block, w, Ow);
+        }
+      }
+      if (callback) {
+        callback(times[i], State(block, w));
+      }
+    };
+
+    auto t0 = rightnow();
+    double tmax = times.back();
+    double tol = (tmax > 0.) ? precision / tmax : precision;
+    auto [err, hump] =
+        zahexpv(1, times, apply_A, dot_f, v0, anorm, tol, m, output);
+    res.error = err;
+    res.hump = hump;
+    timing(t0, rightnow(), "Time evolve trajectory time", 1);
+    return res;
+  }
+}
+XDIAG_CATCH
+
+TimeEvolveTrajectoryResult
+time_evolve_trajectory(OpSum const &H, State psi0,
+                       std::vector<double> const &times,
+                       std::vector<OpSum> const &observables,
+                       trajectory_callback_t const &callback, double precision,
+                       int64_t m, double anorm, int64_t nnorm) try {
+  return time_evolve_trajectory<OpSum>(H, psi0, times, observables, callback,
+                                       precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+TimeEvolveTrajectoryResult
+time_evolve_trajectory(CompiledOpSum const &H, State psi0,
+                       std::vector<double> const &times,
+                       std::vector<OpSum> const &observables,
+                       trajectory_callback_t const &callback, double precision,
+                       int64_t m, double anorm, int64_t nnorm) try {
+  return time_evolve_trajectory<CompiledOpSum>(
+      H, psi0, times, observables, callback, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+template <typename idx_t, typename coeff_t>
+TimeEvolveTrajectoryResult
+time_evolve_trajectory(CSRMatrix<idx_t, coeff_t> const &H, State psi0,
+                       std::vector<double> const &times,
+                       std::vector<OpSum> const &observables,
+                       trajectory_callback_t const &callback, double precision,
+                       int64_t m, double anorm, int64_t nnorm) try {
+  return time_evolve_trajectory<CSRMatrix<idx_t, coeff_t>>(
+      H, psi0, times, observables, callback, precision, m, anorm, nnorm);
+}
+XDIAG_CATCH
+
+#define XDIAG_INST(IDX, COEFF)                                                 \
+  template TimeEvolveTrajectoryResult time_evolve_trajectory(                  \
+      CSRMatrix<IDX, COEFF> const &, State, std::vector<double> const &,       \
+      std::vector<OpSum> const &, trajectory_callback_t const &, double,       \
+      int64_t, double, int64_t);
+XDIAG_INST(int32_t, double)
+XDIAG_INST(int32_t, complex)
+XDIAG_INST(int64_t, double)
+XDIAG_INST(int64_t, complex)
+#undef XDIAG_INST
+
+} // namespace xdiag
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <xdiag/armadillo.hpp>
+#include <xdiag/kernels/compiled_opsum.hpp>
+#include <xdiag/kernels/sparse/sparse_matrix_types.hpp>
+#include <xdiag/operators/opsum.hpp>
+#include <xdiag/states/state.hpp>
+#include <xdiag/utils/xdiag_api.hpp>
+
+namespace xdiag {
+
+// Called with every time of the trajectory and the state at this time. The
+// state is only valid during the call.
+using trajectory_callback_t = std::function<void(double, State const &)>;
+
+struct XDIAG_API TimeEvolveTrajectoryResult {
+  arma::vec times;
+  arma::cx_mat measurements; // <psi(times(i))| observables[j] |psi(times(i))>
+  double error;
+  double hump;
+  int64_t nmvm;
+  State state; // state at the final time
+};
+
+// Evolves psi0 to the ascending non-negative times in a single Expokit run.
+// Output times within a Krylov step reuse its Krylov basis, such that the
+// number of matrix-vector multiplications only depends on the final time and
+// the precision, not on the number of output times.
+XDIAG_API TimeEvolveTrajectoryResult time_evolve_trajectory(
+    OpSum const &H, State psi0, std::vector<double> const &times,
+    std::vector<OpSum> const &observables = {},
+    trajectory_callback_t const &callback = nullptr, double precision = 1e-12,
+    int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
+
+XDIAG_API TimeEvolveTrajectoryResult time_evolve_trajectory(
+    CompiledOpSum const &H, State psi0, std::vector<double> const &times,
+    std::vector<OpSum> const &observables = {},
+    trajectory_callback_t const &callback = nullptr, double precision = 1e-12,
+    int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
+
+template <typename idx_t, typename coeff_t>
+XDIAG_API TimeEvolveTrajectoryResult time_evolve_trajectory(
+    CSRMatrix<idx_t, coeff_t> const &H, State psi0,
+    std::vector<double> const &times,
+    std::vector<OpSum> const &observables = {},
+    trajectory_callback_t const &callback = nullptr, double precision = 1e-12,
+    int64_t m = 30, double anorm = 0., int64_t nnorm = 2);
+
+} // namespace xdiag
@@ -8,7 +8,9 @@
 //
 
 #include <cmath>
+#include <limits>
 #include <tuple>
+#include <vector>
 
 #include <xdiag/armadillo.hpp>
 #include <xdiag/linalg/norm_estimate.hpp>
@@ -19,10 +21,17 @@
 
 namespace xdiag {
 
-template <typename apply_A_f, typename dot_f>
+// Evolves w to the ascending, non-negative times and calls output(i, w_i)
+// with the state w_i = exp(sgn * times[i] * A) w. Output times within a Krylov
+// step are evaluated from the Krylov basis of that step, which costs one small
+// dense exponential but no further application of A. The step size is only
+// limited by the error estimate, not by the spacing of the output times. On
+// exit w holds the state at times.back().
+template <typename apply_A_f, typename dot_f, typename output_f>
 inline std::tuple<double, double>
-zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
-        double anorm, double tol = 1e-12, int m = 30) try {
+zahexpv(int sgn, std::vector<double> const &times, apply_A_f &&apply_A,
+        dot_f &&dot, arma::cx_vec &w, double anorm, double tol, int m,
+        output_f &&output) try {
 
   /* perform the time evolution via mat exponential applied to vector as
   outlined in expokit paper i.e. returns w = eˆ(At)*v, where A is anti-hermitian
@@ -46,7 +55,7 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
   double gamma = 0.9;
   double delta = 1.2; // recommended but can be adjusted
   int mb = m;
-  double t_out = std::abs(time);
+  double t_out = times.empty() ? 0. : times.back();
   double nstep = 0;
   double t_new = 0;
   double t_now = 0;
@@ -76,9 +85,18 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
 
   double s = std::pow(10, floor(log10(t_new)) - 1);
   t_new = ceil(t_new / s) * s;
-  int sgn = arma::sign(time);
   nstep = 0;
 
+  // outputs at times already reached with the current w
+  int64_t n_out = 0;
+  auto output_reached = [&](double t) {
+    while ((n_out < (int64_t)times.size()) && (times[n_out] <= t)) {
+      output(n_out, w);
+      ++n_out;
+    }
+  };
+  output_reached(t_now);
+
   // hump determines if the matrix is conditioned or not ( <1 => well
   // conditioned ) expokit paper still stipulates algorithm can work even if if
   // hump > 1
@@ -180,6 +198,19 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
       // if happy - breakdown size of H and F taken as m, and m+1 otherwise
 
     mx = mb + std::max(0, k1 - 1);
+
+    // outputs within the step from the same Krylov basis
+    while ((n_out < (int64_t)times.size()) &&
+           (times[n_out] < t_now + t_step)) {
+      arma::mat Fi = expm(arma::mat(sgn * (times[n_out] - t_now) *
+                                    H.submat(0, 0, mb + k1 - 1, mb + k1 - 1)));
+      arma::vec Fi0 = Fi(arma::span(0, mx - 1), 0);
+      arma::cx_vec wi =
+          beta * V(arma::span(0, n - 1), arma::span(0, mx - 1)) * Fi0;
+      output(n_out, wi);
+      ++n_out;
+    }
+
     // get first column of F := F0
     arma::vec F0 = F(arma::span(0, mx - 1), 0);
     w.zeros();
@@ -188,6 +219,7 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
     hump = std::max(hump, beta);
 
     t_now += t_step;
+    output_reached(t_now);
 
     t_new = gamma * t_step * std::pow(t_step * tol / err_loc, xm);
     s = std::pow(10, floor(log10(t_new)) - 1);
@@ -197,6 +229,9 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
     s_error = s_error + err_loc;
   } // end of full time evolution
 
+  // remaining outputs at t_out up to rounding of the step sizes
+  output_reached(std::numeric_limits<double>::infinity());
+
   double err = s_error;
   hump = hump / normv;
   Log(1, "zaexph finished: # steps = {}, # MVM = {}, est. error: {}, hump: {}",
@@ -205,4 +240,15 @@ zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
 }
 XDIAG_CATCH
 
+template <typename apply_A_f, typename dot_f>
+inline std::tuple<double, double>
+zahexpv(double time, apply_A_f &&apply_A, dot_f &&dot, arma::cx_vec &w,
+        double anorm, double tol = 1e-12, int m = 30) try {
+  return zahexpv(
+      arma::sign(time), {std::abs(time)}, std::forward<apply_A_f>(apply_A),
+      std::forward<dot_f>(dot), w, anorm, tol, m,
+      [](int64_t, arma::cx_vec const &) {});
+}
+XDIAG_CATCH
+
 } // namespace xdiag
@@ -44,6 +44,20 @@ complex dot(Block const &block, arma::cx_vec const &v,
 }
 XDIAG_CATCH
 
+void allreduce_sum(Block const &block, double *values, int64_t n) try {
+#ifdef XDIAG_DISTRIBUTED
+  if (isdistributed(block)) {
+    mpi::Allreduce((double *)MPI_IN_PLACE, values, (int)n, MPI_SUM,
+                   MPI_COMM_WORLD);
+  }
+#else
+  (void)block;
+  (void)values;
+  (void)n;
+#endif
+}
+XDIAG_CATCH
+
 template <typename coeff_t>
 arma::Mat<coeff_t> matrix_dot(Block const &block, arma::Mat<coeff_t> const &V,
                               arma::Mat<coeff_t> const &W) try {
@@ -14,6 +14,10 @@ namespace xdiag::math {
 double dot(Block const &block, arma::vec const &v, arma::vec const &w);
 complex dot(Block const &block, arma::cx_vec const &v, arma::cx_vec const &w);
 
+// Adds up n partial sums over the processes of a distributed block in a single
+// reduction (no-op for other blocks)
+void allreduce_sum(Block const &block, double *values, int64_t n);
+
 template <typename coeff_t>
 arma::Mat<coeff_t> matrix_dot(Block const &block, arma::Mat<coeff_t> const &V,
                               arma::Mat<coeff_t> const &W);
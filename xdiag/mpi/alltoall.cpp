@@ -4,10 +4,14 @@
 
 #include "alltoall.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #include <xdiag/math/complex.hpp>
 #include <xdiag/mpi/datatype.hpp>
+#include <xdiag/utils/error.hpp>
 
 namespace xdiag::mpi {
 
@@ -53,18 +57,18 @@ template int Alltoall<double>(double *sendbuf, int sendcount, double *recvbuf,
 
 
 template <>
-int Alltoall<complex>(complex *sendbuf, int sendcounts, complex *recvbuf,
-                      int recvcounts, MPI_Comm comm) {
-  int n_mpi_tasks, ret;
-  MPI_Comm_size(MPI_COMM_WORLD, &n_mpi_tasks);
-  sendcounts <<= 1;
-  recvcounts <<= 1;
-  ret = MPI_Alltoall(sendbuf, sendcounts, MPI_DOUBLE, recvbuf, recvcounts,
-                     MPI_DOUBLE, comm);
-  sendcounts >>= 1;
-  recvcounts >>= 1;
-  return ret;
+int Alltoall<complex>(complex *sendbuf, int sendcount, complex *recvbuf,
+                      int recvcount, MPI_Comm comm) try {
+  // complex numbers are sent as pairs of doubles
+  int max_count = std::numeric_limits<int>::max() / 2;
+  if ((sendcount > max_count) || (recvcount > max_count)) {
+    XDIAG_THROW("Number of complex values exceeds the maximum count of "
+                "MPI_Alltoall");
+  }
+  return MPI_Alltoall(sendbuf, 2 * sendcount, MPI_DOUBLE, recvbuf,
+                      2 * recvcount, MPI_DOUBLE, comm);
 }
+XDIAG_CATCH
 
 ///////////////////////////////////////////
 // Alltoallv
@@ -139,4 +143,264 @@ int Alltoallv<complex>(complex *sendbuf, int *sendcounts, int *sdispls,
                        rdispls_2.data(), MPI_DOUBLE, comm);
 }
 
+///////////////////////////////////////////
+// Ialltoallv
+template <class coeff_t>
+int Ialltoallv(coeff_t *sendbuf, int *sendcounts, int *sdispls,
+               coeff_t *recvbuf, int *recvcounts, int *rdispls, MPI_Comm comm,
+               MPI_Request *request) {
+  MPI_Datatype type = mpi::datatype<coeff_t>();
+  return MPI_Ialltoallv(sendbuf, sendcounts, sdispls, type, recvbuf,
+                        recvcounts, rdispls, type, comm, request);
+}
+
+template int Ialltoallv<char>(char *sendbuf, int *sendcounts, int *sdispls,
+                              char *recvbuf, int *recvcounts, int *rdispls,
+                              MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<short>(short *sendbuf, int *sendcounts, int *sdispls,
+                               short *recvbuf, int *recvcounts, int *rdispls,
+                               MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<int>(int *sendbuf, int *sendcounts, int *sdispls,
+                             int *recvbuf, int *recvcounts, int *rdispls,
+                             MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<long>(long *sendbuf, int *sendcounts, int *sdispls,
+                              long *recvbuf, int *recvcounts, int *rdispls,
+                              MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<long long>(long long *sendbuf, int *sendcounts,
+                                   int *sdispls, long long *recvbuf,
+                                   int *recvcounts, int *rdispls, MPI_Comm comm,
+                                   MPI_Request *request);
+template int Ialltoallv<unsigned char>(unsigned char *sendbuf, int *sendcounts,
+                                       int *sdispls, unsigned char *recvbuf,
+                                       int *recvcounts, int *rdispls,
+                                       MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<unsigned short>(unsigned short *sendbuf,
+                                        int *sendcounts, int *sdispls,
+                                        unsigned short *recvbuf,
+                                        int *recvcounts, int *rdispls,
+                                        MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<unsigned int>(unsigned int *sendbuf, int *sendcounts,
+                                      int *sdispls, unsigned int *recvbuf,
+                                      int *recvcounts, int *rdispls,
+                                      MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<unsigned long>(unsigned long *sendbuf, int *sendcounts,
+                                       int *sdispls, unsigned long *recvbuf,
+                                       int *recvcounts, int *rdispls,
+                                       MPI_Comm comm, MPI_Request *request);
+template int Ialltoallv<unsigned long long>(unsigned long long *sendbuf,
+                                            int *sendcounts, int *sdispls,
+                                            unsigned long long *recvbuf,
+                                            int *recvcounts, int *rdispls,
+                                            MPI_Comm comm,
+                                            MPI_Request *request);
+template int Ialltoallv<double>(double *sendbuf, int *sendcounts, int *sdispls,
+                                double *recvbuf, int *recvcounts, int *rdispls,
+                                MPI_Comm comm, MPI_Request *request);
+
+
+///////////////////////////////////////////
+// Chunked Alltoallv
+
+// Tag of the point-to-point messages. Messages between two ranks are matched
+// in the order they are posted, which agrees on all ranks as the exchanges
+// are collective.
+static constexpr int chunk_tag = 4711;
+
+// Largest chunk size such that the count of a message fits into an int.
+// Complex numbers are sent as pairs of doubles.
+template <class coeff_t> static int64_t max_chunk_size(int64_t chunk_size) {
+  constexpr int64_t factor = std::is_same_v<coeff_t, complex> ? 2 : 1;
+  return std::min(chunk_size,
+                  (int64_t)std::numeric_limits<int>::max() / factor);
+}
+
+// Posts the messages of chunks [chunk_begin, chunk_end) of every segment to
+// and from the other ranks. Complex numbers are sent as pairs of doubles.
+template <class coeff_t>
+static void post_chunks(const coeff_t *sendbuf, int64_t const *sendcounts,
+                        int64_t const *sdispls, coeff_t *recvbuf,
+                        int64_t const *recvcounts, int64_t const *rdispls,
+                        int64_t chunk_size, int64_t chunk_begin,
+                        int64_t chunk_end, MPI_Comm comm,
+                        std::vector<MPI_Request> &requests) {
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(comm, &mpi_rank);
+  MPI_Comm_size(comm, &mpi_size);
+  constexpr bool cplx = std::is_same_v<coeff_t, complex>;
+  MPI_Datatype type = cplx ? MPI_DOUBLE : mpi::datatype<coeff_t>();
+  int factor = cplx ? 2 : 1;
+
+  for (int64_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+    int64_t begin = chunk * chunk_size;
+    for (int r = 0; r < mpi_size; ++r) {
+      if ((r != mpi_rank) && (recvcounts[r] > begin)) {
+        int count = (int)(std::min(chunk_size, recvcounts[r] - begin) * factor);
+        requests.emplace_back();
+        MPI_Irecv(recvbuf + rdispls[r] + begin, count, type, r, chunk_tag,
+                  comm, &requests.back());
+      }
+    }
+    for (int r = 0; r < mpi_size; ++r) {
+      if ((r != mpi_rank) && (sendcounts[r] > begin)) {
+        int count = (int)(std::min(chunk_size, sendcounts[r] - begin) * factor);
+        requests.emplace_back();
+        MPI_Isend(const_cast<coeff_t *>(sendbuf) + sdispls[r] + begin, count,
+                  type, r, chunk_tag, comm, &requests.back());
+      }
+    }
+  }
+}
+
+template <class coeff_t>
+void Alltoallv_chunked(const coeff_t *sendbuf, int64_t const *sendcounts,
+                       int64_t const *sdispls, coeff_t *recvbuf,
+                       int64_t const *recvcounts, int64_t const *rdispls,
+                       int64_t chunk_size, MPI_Comm comm) {
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(comm, &mpi_rank);
+  MPI_Comm_size(comm, &mpi_size);
+  std::copy(sendbuf + sdispls[mpi_rank],
+            sendbuf + sdispls[mpi_rank] + sendcounts[mpi_rank],
+            recvbuf + rdispls[mpi_rank]);
+
+  int64_t max_count = 0;
+  for (int r = 0; r < mpi_size; ++r) {
+    max_count = std::max({max_count, sendcounts[r], recvcounts[r]});
+  }
+  chunk_size = max_chunk_size<coeff_t>(chunk_size);
+  int64_t nchunks = (max_count + chunk_size - 1) / chunk_size;
+  std::vector<MPI_Request> requests;
+  for (int64_t chunk = 0; chunk < nchunks; ++chunk) {
+    requests.clear();
+    post_chunks(sendbuf, sendcounts, sdispls, recvbuf, recvcounts, rdispls,
+                chunk_size, chunk, chunk + 1, comm, requests);
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  }
+}
+
+template <class coeff_t>
+std::vector<MPI_Request>
+Ialltoallv_chunked(const coeff_t *sendbuf, int64_t const *sendcounts,
+                   int64_t const *sdispls, coeff_t *recvbuf,
+                   int64_t const *recvcounts, int64_t const *rdispls,
+                   int64_t chunk_size, MPI_Comm comm) {
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(comm, &mpi_rank);
+  MPI_Comm_size(comm, &mpi_size);
+  std::copy(sendbuf + sdispls[mpi_rank],
+            sendbuf + sdispls[mpi_rank] + sendcounts[mpi_rank],
+            recvbuf + rdispls[mpi_rank]);
+
+  int64_t max_count = 0;
+  for (int r = 0; r < mpi_size; ++r) {
+    max_count = std::max({max_count, sendcounts[r], recvcounts[r]});
+  }
+  chunk_size = max_chunk_size<coeff_t>(chunk_size);
+  int64_t nchunks = (max_count + chunk_size - 1) / chunk_size;
+  std::vector<MPI_Request> requests;
+  post_chunks(sendbuf, sendcounts, sdispls, recvbuf, recvcounts, rdispls,
+              chunk_size, 0, nchunks, comm, requests);
+  return requests;
+}
+
+template void Alltoallv_chunked<char>(
+    const char *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    char *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<short>(
+    const short *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    short *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<int>(
+    const int *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    int *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<long>(
+    const long *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    long *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<long long>(
+    const long long *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    long long *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<unsigned char>(
+    const unsigned char *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned char *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<unsigned short>(
+    const unsigned short *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned short *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<unsigned int>(
+    const unsigned int *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned int *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<unsigned long>(
+    const unsigned long *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned long *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<unsigned long long>(
+    const unsigned long long *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned long long *recvbuf,
+    int64_t const *recvcounts, int64_t const *rdispls, int64_t chunk_size,
+    MPI_Comm comm);
+template void Alltoallv_chunked<double>(
+    const double *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    double *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template void Alltoallv_chunked<complex>(
+    const complex *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    complex *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+
+template std::vector<MPI_Request> Ialltoallv_chunked<char>(
+    const char *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    char *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<short>(
+    const short *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    short *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<int>(
+    const int *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    int *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<long>(
+    const long *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    long *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<long long>(
+    const long long *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    long long *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<unsigned char>(
+    const unsigned char *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned char *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<unsigned short>(
+    const unsigned short *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned short *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<unsigned int>(
+    const unsigned int *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned int *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<unsigned long>(
+    const unsigned long *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned long *recvbuf, int64_t const *recvcounts,
+    int64_t const *rdispls, int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<unsigned long long>(
+    const unsigned long long *sendbuf, int64_t const *sendcounts,
+    int64_t const *sdispls, unsigned long long *recvbuf,
+    int64_t const *recvcounts, int64_t const *rdispls, int64_t chunk_size,
+    MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<double>(
+    const double *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    double *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+template std::vector<MPI_Request> Ialltoallv_chunked<complex>(
+    const complex *sendbuf, int64_t const *sendcounts, int64_t const *sdispls,
+    complex *recvbuf, int64_t const *recvcounts, int64_t const *rdispls,
+    int64_t chunk_size, MPI_Comm comm);
+
 } // namespace xdiag::mpi
@@ -4,6 +4,9 @@
 
 #pragma once
 #ifdef XDIAG_DISTRIBUTED
+#include <cstdint>
+#include <vector>
+
 #include <mpi.h>
 
 namespace xdiag::mpi {
@@ -16,5 +19,34 @@ template <class coeff_t>
 int Alltoallv(coeff_t *sendbuf, int *sendcounts, int *sdispls, coeff_t *recvbuf,
               int *recvcounts, int *rdispls, MPI_Comm comm);
 
+// Non-blocking Alltoallv. The counts and displacements must stay valid until
+// the request has completed, hence no complex specialization is provided
+// (use the double version with doubled counts instead).
+template <class coeff_t>
+int Ialltoallv(coeff_t *sendbuf, int *sendcounts, int *sdispls,
+               coeff_t *recvbuf, int *recvcounts, int *rdispls, MPI_Comm comm,
+               MPI_Request *request);
+
+// Alltoallv with 64-bit counts and displacements, where the segments are
+// exchanged by point-to-point messages of at most chunk_size values each. The
+// exchange proceeds in rounds of one message per pair of ranks, such that
+// arbitrarily large exchanges only require a bounded number of pending
+// messages. chunk_size is reduced such that the count of every message fits
+// into an int, i.e. to at most INT_MAX / 2 for complex numbers.
+template <class coeff_t>
+void Alltoallv_chunked(const coeff_t *sendbuf, int64_t const *sendcounts,
+                       int64_t const *sdispls, coeff_t *recvbuf,
+                       int64_t const *recvcounts, int64_t const *rdispls,
+                       int64_t chunk_size, MPI_Comm comm);
+
+// Non-blocking version of Alltoallv_chunked, all messages are posted at once.
+// The segment for the own rank is copied immediately.
+template <class coeff_t>
+std::vector<MPI_Request>
+Ialltoallv_chunked(const coeff_t *sendbuf, int64_t const *sendcounts,
+                   int64_t const *sdispls, coeff_t *recvbuf,
+                   int64_t const *recvcounts, int64_t const *rdispls,
+                   int64_t chunk_size, MPI_Comm comm);
+
 } // namespace xdiag::mpi
 #endif
@@ -16,4 +16,13 @@ void Buffer::clean() {
 void Buffer::clean_send() { std::fill(send_.begin(), send_.end(), 0); }
 void Buffer::clean_recv() { std::fill(recv_.begin(), recv_.end(), 0); }
 void Buffer::swap() { std::swap(send_, recv_); }
+
+int64_t Buffer::memory() const {
+  return (int64_t)(send_.capacity() + recv_.capacity());
+}
+
+void Buffer::release() {
+  std::vector<char>().swap(send_);
+  std::vector<char>().swap(recv_);
+}
 } // namespace xdiag::mpi
@@ -46,6 +46,13 @@ public:
   void clean_send();
   void clean_recv();
   void swap();
+
+  // Number of bytes held by the send and receive buffer
+  int64_t memory() const;
+
+  // Frees the memory of the buffers, they grow again on the next reserve
+  void release();
+
 private:
   std::vector<char> send_;
   std::vector<char> recv_;
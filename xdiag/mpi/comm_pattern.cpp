@@ -41,4 +41,62 @@ void CommPattern::append(Op const &op, Communicator const &comm) {
   comms_.push_back(comm);
 }
 
+bool CommPattern::contains(Op const &op, int64_t round_size) const {
+  for (std::size_t idx = 0; idx < round_ops_.size(); ++idx) {
+    if ((round_ops_[idx] == op) && (round_ops_sizes_[idx] == round_size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<Communicator> const &CommPattern::rounds(Op const &op,
+                                                     int64_t round_size) const
+    try {
+  for (std::size_t idx = 0; idx < round_ops_.size(); ++idx) {
+    if ((round_ops_[idx] == op) && (round_ops_sizes_[idx] == round_size)) {
+      return round_ops_comms_[idx];
+    }
+  }
+  XDIAG_THROW("Cannot find communicators of rounds for Op");
+}
+XDIAG_CATCH
+
+void CommPattern::append(Op const &op, int64_t round_size,
+                         std::vector<Communicator> const &comms) {
+  round_ops_.push_back(op);
+  round_ops_sizes_.push_back(round_size);
+  round_ops_comms_.push_back(comms);
+}
+
+bool CommPattern::contains(std::string const &name, int64_t round_size) const {
+  for (std::size_t idx = 0; idx < round_names_.size(); ++idx) {
+    if ((round_names_[idx] == name) &&
+        (round_names_sizes_[idx] == round_size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<Communicator> const &
+CommPattern::rounds(std::string const &name, int64_t round_size) const try {
+  for (std::size_t idx = 0; idx < round_names_.size(); ++idx) {
+    if ((round_names_[idx] == name) &&
+        (round_names_sizes_[idx] == round_size)) {
+      return round_names_comms_[idx];
+    }
+  }
+  XDIAG_THROW(std::string("Cannot find communicators of rounds for \"") +
+              name + "\"");
+}
+XDIAG_CATCH
+
+void CommPattern::append(std::string const &name, int64_t round_size,
+                         std::vector<Communicator> const &comms) {
+  round_names_.push_back(name);
+  round_names_sizes_.push_back(round_size);
+  round_names_comms_.push_back(comms);
+}
+
 } // namespace xdiag::mpi
@@ -5,6 +5,7 @@
 #pragma once
 #ifdef XDIAG_DISTRIBUTED
 
+#include <string>
 #include <vector>
 
 #include <xdiag/operators/op.hpp>
@@ -18,9 +19,33 @@ public:
   bool contains(Op const &op) const;
   Communicator const &operator[](Op const &op) const;
   void append(Op const& op, Communicator const& comm);
+
+  // Patterns of an Op applied in rounds of round_size values, one
+  // communicator per round
+  bool contains(Op const &op, int64_t round_size) const;
+  std::vector<Communicator> const &rounds(Op const &op,
+                                          int64_t round_size) const;
+  void append(Op const &op, int64_t round_size,
+              std::vector<Communicator> const &comms);
+
+  // Patterns of other exchanges in rounds (e.g. transposes), by name
+  bool contains(std::string const &name, int64_t round_size) const;
+  std::vector<Communicator> const &rounds(std::string const &name,
+                                          int64_t round_size) const;
+  void append(std::string const &name, int64_t round_size,
+              std::vector<Communicator> const &comms);
+
 private:
   std::vector<Op> ops_;
   std::vector<Communicator> comms_;
+
+  std::vector<Op> round_ops_;
+  std::vector<int64_t> round_ops_sizes_;
+  std::vector<std::vector<Communicator>> round_ops_comms_;
+
+  std::vector<std::string> round_names_;
+  std::vector<int64_t> round_names_sizes_;
+  std::vector<std::vector<Communicator>> round_names_comms_;
 };
 
 } // namespace xdiag::mpi
@@ -11,34 +11,73 @@
 
 #include <mpi.h>
 
+#include <xdiag/mpi/exchange.hpp>
+
 namespace xdiag::mpi {
 
 Communicator::Communicator(std::vector<int64_t> const &n_values_i_send)
     : n_values_prepared_(n_values_i_send.size(), 0),
+      n_values_i_send_(n_values_i_send),
       n_values_i_recv_(n_values_i_send.size(), 0),
       n_values_i_send_offsets_(n_values_i_send.size(), 0),
       n_values_i_recv_offsets_(n_values_i_send.size(), 0) {
 
-  for (auto num : n_values_i_send) {
-    n_values_i_send_.push_back((int)num);
-  }
   MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank_);
   MPI_Comm_size(MPI_COMM_WORLD, &mpi_size_);
   assert((int)n_values_i_send.size() == mpi_size_);
 
-  MPI_Alltoall(n_values_i_send_.data(), 1, MPI_INT, n_values_i_recv_.data(), 1,
-               MPI_INT, MPI_COMM_WORLD);
+  MPI_Alltoall(n_values_i_send_.data(), 1, MPI_INT64_T,
+               n_values_i_recv_.data(), 1, MPI_INT64_T, MPI_COMM_WORLD);
+  compute_offsets();
+
+  // The chunking has to be decided identically on all ranks
+  int64_t buffer_size = std::max(send_buffer_size_, recv_buffer_size_);
+  MPI_Allreduce(&buffer_size, &buffer_size_max_, 1, MPI_INT64_T, MPI_MAX,
+                MPI_COMM_WORLD);
+  set_chunk_size();
+}
+
+Communicator::Communicator(std::vector<Communicator> const &comms) {
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank_);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size_);
+  n_values_prepared_.assign(mpi_size_, 0);
+  n_values_i_send_.assign(mpi_size_, 0);
+  n_values_i_recv_.assign(mpi_size_, 0);
+  n_values_i_send_offsets_.assign(mpi_size_, 0);
+  n_values_i_recv_offsets_.assign(mpi_size_, 0);
+  for (auto const &comm : comms) {
+    for (int i = 0; i < mpi_size_; ++i) {
+      n_values_i_send_[i] += comm.n_values_i_send_[i];
+      n_values_i_recv_[i] += comm.n_values_i_recv_[i];
+    }
+    buffer_size_max_ += comm.buffer_size_max_;
+  }
+  compute_offsets();
+  set_chunk_size();
+}
 
+// Computes offsets and buffer sizes
+void Communicator::compute_offsets() {
   for (int i = 0; i < mpi_size_; ++i) {
     n_values_i_send_offsets_[i] = std::accumulate(
-        n_values_i_send_.begin(), n_values_i_send_.begin() + i, 0);
+        n_values_i_send_.begin(), n_values_i_send_.begin() + i, (int64_t)0);
     n_values_i_recv_offsets_[i] = std::accumulate(
-        n_values_i_recv_.begin(), n_values_i_recv_.begin() + i, 0);
+        n_values_i_recv_.begin(), n_values_i_recv_.begin() + i, (int64_t)0);
   }
-  send_buffer_size_ =
-      std::accumulate(n_values_i_send_.begin(), n_values_i_send_.end(), 0);
-  recv_buffer_size_ =
-      std::accumulate(n_values_i_recv_.begin(), n_values_i_recv_.end(), 0);
+  send_buffer_size_ = std::accumulate(n_values_i_send_.begin(),
+                                      n_values_i_send_.end(), (int64_t)0);
+  recv_buffer_size_ = std::accumulate(n_values_i_recv_.begin(),
+                                      n_values_i_recv_.end(), (int64_t)0);
+}
+
+// If the buffer of any rank might reach the maximal chunk size, the counts
+// might not fit into the int arguments of MPI_Alltoallv and the exchange is
+// split into chunks
+void Communicator::set_chunk_size() {
+  int64_t max_chunk_size = exchange_settings.max_chunk_size;
+  max_chunk_size = std::clamp(max_chunk_size, (int64_t)1,
+                              ExchangeSettings::max_chunk_size_limit);
+  chunk_size_ = (buffer_size_max_ >= max_chunk_size) ? max_chunk_size : 0;
 }
 
 int64_t Communicator::n_values_i_send(int mpi_rank) const {
@@ -62,6 +101,8 @@ int64_t Communicator::n_values_prepared(int mpi_rank) const {
   return n_values_prepared_[mpi_rank];
 }
 
+int64_t Communicator::chunk_size() const { return chunk_size_; }
+
 void Communicator::flush() {
   std::fill(n_values_prepared_.begin(), n_values_prepared_.end(), 0);
 }
@@ -5,7 +5,9 @@
 #pragma once
 #ifdef XDIAG_DISTRIBUTED
 
+#include <cstdint>
 #include <vector>
+
 #include <mpi.h>
 
 #include <xdiag/math/complex.hpp>
@@ -19,6 +21,13 @@ public:
   Communicator() = default;
   Communicator(std::vector<int64_t> const &n_values_i_send);
 
+  // Pattern of several exchanges combined into a single all-to-all. The
+  // values for every rank are laid out as the values of comms[0], comms[1],
+  // ... for this rank. No communication is required: the chunking is decided
+  // from the sum of the global maximal buffer sizes of the parts, an upper
+  // bound known to all ranks.
+  Communicator(std::vector<Communicator> const &comms);
+
   int64_t n_values_i_send(int mpi_rank) const;
   int64_t n_values_i_recv(int mpi_rank) const;
 
@@ -30,6 +39,11 @@ public:
 
   int64_t n_values_prepared(int mpi_rank) const;
 
+  // Maximal number of values per message if the exchange is split into
+  // point-to-point messages, 0 if a single MPI_Alltoallv is used. This is
+  // decided once, when the pattern is created.
+  int64_t chunk_size() const;
+
   void flush();
 
   template <class T>
@@ -42,28 +56,45 @@ public:
 
   template <class T>
   inline void all_to_all(const T *send_buffer, T *recv_buffer) const {
-    Alltoallv<T>(const_cast<T *>(send_buffer),
-                 const_cast<int *>(n_values_i_send_.data()),
-                 const_cast<int *>(n_values_i_send_offsets_.data()),
-                 const_cast<T *>(recv_buffer),
-                 const_cast<int *>(n_values_i_recv_.data()),
-                 const_cast<int *>(n_values_i_recv_offsets_.data()),
-                 MPI_COMM_WORLD);
+    if (chunk_size_ > 0) {
+      Alltoallv_chunked<T>(send_buffer, n_values_i_send_.data(),
+                           n_values_i_send_offsets_.data(), recv_buffer,
+                           n_values_i_recv_.data(),
+                           n_values_i_recv_offsets_.data(), chunk_size_,
+                           MPI_COMM_WORLD);
+    } else { // all counts and offsets fit into an int
+      std::vector<int> send_counts(n_values_i_send_.begin(),
+                                   n_values_i_send_.end());
+      std::vector<int> send_offsets(n_values_i_send_offsets_.begin(),
+                                    n_values_i_send_offsets_.end());
+      std::vector<int> recv_counts(n_values_i_recv_.begin(),
+                                   n_values_i_recv_.end());
+      std::vector<int> recv_offsets(n_values_i_recv_offsets_.begin(),
+                                    n_values_i_recv_offsets_.end());
+      Alltoallv<T>(const_cast<T *>(send_buffer), send_counts.data(),
+                   send_offsets.data(), recv_buffer, recv_counts.data(),
+                   recv_offsets.data(), MPI_COMM_WORLD);
+    }
   }
 
 private:
   int mpi_rank_;
   int mpi_size_;
 
-  mutable std::vector<int> n_values_prepared_;
+  mutable std::vector<int64_t> n_values_prepared_;
 
-  std::vector<int> n_values_i_send_;
-  std::vector<int> n_values_i_recv_;
-  std::vector<int> n_values_i_send_offsets_;
-  std::vector<int> n_values_i_recv_offsets_;
+  std::vector<int64_t> n_values_i_send_;
+  std::vector<int64_t> n_values_i_recv_;
+  std::vector<int64_t> n_values_i_send_offsets_;
+  std::vector<int64_t> n_values_i_recv_offsets_;
 
   int64_t send_buffer_size_;
   int64_t recv_buffer_size_;
+  int64_t buffer_size_max_ = 0; // (bound of the) maximal size on any rank
+  int64_t chunk_size_ = 0;
+
+  void compute_offsets();
+  void set_chunk_size();
 };
 
 } // namespace xdiag::mpi
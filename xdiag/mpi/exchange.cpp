@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "exchange.hpp"
+
+#include <algorithm>
+
+namespace xdiag::mpi {
+
+void Exchange::set_counts(Communicator const &comm, int64_t factor) {
+  int mpi_size;
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+  send_counts_.resize(mpi_size);
+  send_offsets_.resize(mpi_size);
+  recv_counts_.resize(mpi_size);
+  recv_offsets_.resize(mpi_size);
+  for (int r = 0; r < mpi_size; ++r) {
+    send_counts_[r] = factor * comm.n_values_i_send(r);
+    send_offsets_[r] = factor * comm.n_values_i_send_offset(r);
+    recv_counts_[r] = factor * comm.n_values_i_recv(r);
+    recv_offsets_[r] = factor * comm.n_values_i_recv_offset(r);
+  }
+}
+
+bool Exchange::test() {
+  int flag = 1;
+  if (!requests_.empty()) {
+    MPI_Testall(requests_.size(), requests_.data(), &flag,
+                MPI_STATUSES_IGNORE);
+  }
+  return flag;
+}
+
+void Exchange::wait() {
+  if (!requests_.empty()) {
+    MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+  }
+  requests_.clear();
+}
+
+bool Exchange::active() const {
+  return std::any_of(requests_.begin(), requests_.end(),
+                     [](MPI_Request r) { return r != MPI_REQUEST_NULL; });
+}
+
+int64_t buffer_memory() {
+  int64_t memory = buffer.memory();
+  for (auto const &b : exchange_buffers) {
+    memory += b.memory();
+  }
+  return memory;
+}
+
+void release_buffers() {
+  buffer.release();
+  exchange_buffers.clear();
+  exchange_buffers.shrink_to_fit();
+}
+
+} // namespace xdiag::mpi
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifdef XDIAG_DISTRIBUTED
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include <xdiag/math/complex.hpp>
+#include <xdiag/mpi/alltoall.hpp>
+#include <xdiag/mpi/buffer.hpp>
+#include <xdiag/mpi/communicator.hpp>
+
+namespace xdiag::mpi {
+
+// Non-blocking all-to-all exchange following the pattern of a Communicator.
+// The buffers must not be touched until the exchange has completed. Large
+// exchanges are split into point-to-point messages (cf. Communicator).
+class Exchange {
+public:
+  Exchange() = default;
+
+  template <class T>
+  void start(Communicator const &comm, const T *send_buffer, T *recv_buffer) {
+    requests_.clear();
+    if (comm.chunk_size() > 0) {
+      set_counts(comm, 1);
+      requests_ = Ialltoallv_chunked<T>(
+          send_buffer, send_counts_.data(), send_offsets_.data(), recv_buffer,
+          recv_counts_.data(), recv_offsets_.data(), comm.chunk_size(),
+          MPI_COMM_WORLD);
+    } else {
+      // complex numbers are sent as pairs of doubles
+      constexpr bool cplx = std::is_same_v<T, complex>;
+      set_counts(comm, cplx ? 2 : 1);
+      send_counts_int_.assign(send_counts_.begin(), send_counts_.end());
+      send_offsets_int_.assign(send_offsets_.begin(), send_offsets_.end());
+      recv_counts_int_.assign(recv_counts_.begin(), recv_counts_.end());
+      recv_offsets_int_.assign(recv_offsets_.begin(), recv_offsets_.end());
+      requests_.emplace_back();
+      if constexpr (cplx) {
+        Ialltoallv<double>(
+            reinterpret_cast<double *>(const_cast<T *>(send_buffer)),
+            send_counts_int_.data(), send_offsets_int_.data(),
+            reinterpret_cast<double *>(recv_buffer), recv_counts_int_.data(),
+            recv_offsets_int_.data(), MPI_COMM_WORLD, &requests_.back());
+      } else {
+        Ialltoallv<T>(const_cast<T *>(send_buffer), send_counts_int_.data(),
+                      send_offsets_int_.data(), recv_buffer,
+                      recv_counts_int_.data(), recv_offsets_int_.data(),
+                      MPI_COMM_WORLD, &requests_.back());
+      }
+    }
+  }
+
+  // Progresses the exchange, returns true if it has completed
+  bool test();
+  void wait();
+  bool active() const;
+
+private:
+  std::vector<MPI_Request> requests_;
+  std::vector<int64_t> send_counts_;
+  std::vector<int64_t> send_offsets_;
+  std::vector<int64_t> recv_counts_;
+  std::vector<int64_t> recv_offsets_;
+  std::vector<int> send_counts_int_;
+  std::vector<int> send_offsets_int_;
+  std::vector<int> recv_counts_int_;
+  std::vector<int> recv_offsets_int_;
+  void set_counts(Communicator const &comm, int64_t factor);
+};
+
+// Settings for the exchange of the mixed prefix/postfix terms of the
+// distributed kernels. Several terms can be sent in a single exchange, and
+// several exchanges can be in flight while the local terms are applied and
+// the next exchanges are packed. Every exchange in flight holds its own send
+// and receive buffer of roughly terms_per_exchange / 2 local vectors each.
+// The defaults (one term per exchange, one exchange in flight) keep this at
+// about one local vector, while the first exchange still overlaps with the
+// local terms. Larger values give fewer, larger messages and more overlap,
+// which pays off if the latency dominates and the memory allows for it.
+//
+// MPI counts are of type int. If the buffer of any rank holds
+// max_chunk_size values or more, the exchanges are split into messages of at
+// most max_chunk_size values. The limit INT_MAX / 2 ensures that the counts
+// of complex numbers, which are sent as pairs of doubles, fit into an int.
+//
+// If round_size is positive, the transposes of the prefix terms and the
+// exchanges of the mixed terms (SpinhalfDistributed), as well as the
+// transposes of the up hoppings (tJDistributed, ElectronDistributed) are
+// performed in rounds. In every round, a process sends and receives about
+// round_size values, such that the global buffers hold a few times round_size
+// values instead of whole local vectors.
+struct ExchangeSettings {
+  static constexpr int64_t max_chunk_size_limit =
+      std::numeric_limits<int>::max() / 2;
+  int64_t terms_per_exchange = 1;
+  int64_t exchanges_in_flight = 1;
+  int64_t max_chunk_size = max_chunk_size_limit;
+  int64_t round_size = 0;
+};
+inline ExchangeSettings exchange_settings;
+inline std::vector<Buffer> exchange_buffers;
+
+// Number of bytes held by the global buffers (buffer and exchange_buffers) of
+// this process
+int64_t buffer_memory();
+
+// Frees the memory of the global buffers of this process
+void release_buffers();
+
+} // namespace xdiag::mpi
+#endif
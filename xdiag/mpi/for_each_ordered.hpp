@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifdef XDIAG_DISTRIBUTED
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace xdiag::mpi {
+
+// Processes the items 0, ..., n - 1 in parallel, where every item reads or
+// writes a consecutive run of values in the segments of an MPI send or
+// receive buffer. The segment of rank r begins at offsets[r]. The runs are
+// laid out in the order of the items, i.e. exactly as if the items were
+// processed sequentially (as with Communicator::add_to_send_buffer).
+//
+// count(i, counts):    adds the number of values of item i for rank r to
+//                      counts[r]
+// process(i, pos):     processes item i, where pos[r] is the position of its
+//                      first value in the segment of rank r. It has to advance
+//                      pos[r] by the number of values used.
+//
+// Every thread handles a contiguous range of items. The items are counted in a
+// first pass, such that every thread knows the positions its range starts at.
+template <class count_f, class process_f>
+void for_each_ordered(int64_t n, std::vector<int64_t> const &offsets,
+                      count_f &&count, process_f &&process) {
+  int64_t nranks = offsets.size();
+#ifdef _OPENMP
+  int nthreads = (n > 1) ? omp_get_max_threads() : 1;
+  if (nthreads > n) {
+    nthreads = (int)n;
+  }
+#else
+  int nthreads = 1;
+#endif
+
+  if (nthreads == 1) {
+    std::vector<int64_t> pos(offsets);
+    for (int64_t i = 0; i < n; ++i) {
+      process(i, pos.data());
+    }
+    return;
+  }
+
+#ifdef _OPENMP
+  std::vector<int64_t> counts;
+#pragma omp parallel num_threads(nthreads)
+  {
+    int nt = omp_get_num_threads();
+    int t = omp_get_thread_num();
+#pragma omp single
+    counts.assign(nt * nranks, 0);
+
+    int64_t begin = n * t / nt;
+    int64_t end = n * (t + 1) / nt;
+    int64_t *my_counts = counts.data() + t * nranks;
+    for (int64_t i = begin; i < end; ++i) {
+      count(i, my_counts);
+    }
+#pragma omp barrier
+
+    std::vector<int64_t> pos(offsets);
+    for (int s = 0; s < t; ++s) {
+      for (int64_t r = 0; r < nranks; ++r) {
+        pos[r] += counts[s * nranks + r];
+      }
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      process(i, pos.data());
+    }
+  }
+#endif
+}
+
+} // namespace xdiag::mpi
+#endif
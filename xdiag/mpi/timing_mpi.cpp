@@ -32,4 +32,24 @@ void tic_mpi(bool begin, std::string msg, int verbosity) {
 
 void toc_mpi(std::string msg, int verbosity) { tic_mpi(false, msg, verbosity); }
 
+static std::map<std::string, double> phase_times;
+
+void add_phase_time_mpi(std::string const &phase, double seconds) {
+  phase_times[phase] += seconds;
+}
+
+std::map<std::string, double> const &phase_times_mpi() { return phase_times; }
+
+void reset_phase_times_mpi() { phase_times.clear(); }
+
+void print_phase_times_mpi(int verbosity) {
+  // All ranks record the same phases, as the kernels are collective
+  for (auto const &[phase, t] : phase_times) {
+    double t_local = t;
+    double t_max = 0.;
+    MPI_Allreduce(&t_local, &t_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    LogMPI.out(verbosity, "{}: {:.6f} secs", phase, t_max);
+  }
+}
+
 } // namespace xdiag
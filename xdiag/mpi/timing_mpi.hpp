@@ -5,6 +5,7 @@
 #pragma once
 #ifdef XDIAG_DISTRIBUTED
 
+#include <map>
 #include <string>
 #include <mpi.h>
 
@@ -18,5 +19,14 @@ void timing_mpi(double const &t0, double const &t1, std::string msg = "",
 void tic_mpi(bool begin = true, std::string msg = "", int verbosity = 1);
 void toc_mpi(std::string msg = "", int verbosity = 1);
 
+// Wall times accumulated per phase (e.g. "pack", "exchange", "unpack") of the
+// distributed kernels on this rank
+void add_phase_time_mpi(std::string const &phase, double seconds);
+std::map<std::string, double> const &phase_times_mpi();
+void reset_phase_times_mpi();
+
+// Logs the maximum of the accumulated phase times over all ranks
+void print_phase_times_mpi(int verbosity = 1);
+
 } // namespace xdiag
 #endif
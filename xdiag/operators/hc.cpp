@@ -20,7 +20,8 @@ namespace xdiag {
 //
 // where {phase, partner} is looked up below. Self-adjoint types map to
 // themselves with phase +1; raising/lowering and creation/annihilation types
-// map to their counterpart; ExchangeAsym is anti-hermitian and carries -1.
+// map to their counterpart; ExchangeAsym is anti-hermitian and carries -1,
+// except on a single site where it equals Sz.
 //
 // Types absent from this table have no well-defined hermitian conjugate, and
 // hc() throws on them. The "Matrix" type is handled separately (its stored
@@ -98,6 +99,10 @@ OpSum hc(Op const &op) try {
 
   auto const &[phase, partner] = it->second;
   if (op.hassites()) {
+    // ExchangeAsym_{ii} = (S+_i S-_i - S-_i S+_i) / 2 = Sz_i is hermitian
+    if ((op.type() == "ExchangeAsym") && (op[0] == op[1])) {
+      return OpSum(Op(partner, op.sites()));
+    }
     return OpSum(phase, Op(partner, op.sites()));
   } else {
     return OpSum(phase, Op(partner));
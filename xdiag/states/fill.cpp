@@ -4,8 +4,13 @@
 
 #include "fill.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <memory>
 #include <variant>
+#include <vector>
 
+#include <xdiag/basis/basis.hpp>
 #include <xdiag/blocks/blocks.hpp>
 #include <xdiag/random/hash.hpp>
 #include <xdiag/random/hash_functions.hpp>
@@ -13,18 +18,105 @@
 #include <xdiag/states/norm.hpp>
 #include <xdiag/utils/error.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDIAG_DISTRIBUTED
 #include <mpi.h>
 #endif
 
 namespace xdiag {
 
-template <typename coeff_t, class block_t, class coeff_f>
-void fill(block_t const &block, arma::Col<coeff_t> &vec, coeff_f coeff) try {
-  int64_t idx = 0;
-  for (auto const &pstate : block) {
-    vec(idx++) = coeff(pstate);
+// number of chunks per thread for the dynamic scheduling of the fill
+static constexpr int64_t chunks_per_thread = 16;
+
+// Number of product states passed to a batched coefficient function at once
+static constexpr int64_t fill_batch_size = 1024;
+
+// Calls fill_chunk(it, begin, end) for chunks [begin, end) of the (rank-local)
+// basis of the block in parallel, where it is positioned at begin. Exceptions
+// thrown on a thread are rethrown after the parallel region.
+template <class fill_chunk_f>
+static void for_each_chunk(Block const &block, fill_chunk_f fill_chunk) try {
+  auto const &basis =
+      std::visit([](auto const &b) -> std::shared_ptr<basis::Basis> const & {
+        return b.basis();
+      }, block);
+  int64_t size = basis->size();
+  if (size == 0) {
+    return;
+  }
+#ifdef _OPENMP
+  int64_t nthreads = omp_get_max_threads();
+#else
+  int64_t nthreads = 1;
+#endif
+  int64_t nchunks = std::min(size, chunks_per_thread * nthreads);
+  std::vector<int64_t> starts(nchunks);
+  for (int64_t c = 0; c < nchunks; ++c) {
+    starts[c] = (size * c) / nchunks;
+  }
+  auto iterators = basis->product_state_iterators(starts);
+
+  std::exception_ptr error = nullptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t c = 0; c < nchunks; ++c) {
+    try {
+      int64_t end = (c + 1 < nchunks) ? starts[c + 1] : size;
+      fill_chunk(*iterators[c], starts[c], end);
+    } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
   }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+XDIAG_CATCH
+
+template <typename coeff_t, class coeff_f>
+static void fill(Block const &block, int64_t nsites, arma::Col<coeff_t> &vec,
+                 coeff_f const &coeff) try {
+  coeff_t *data = vec.memptr();
+  for_each_chunk(block, [&](basis::BasisIterator &it, int64_t begin,
+                            int64_t end) {
+    ProductState pstate(nsites);
+    for (int64_t idx = begin; idx < end; ++idx) {
+      it.product_state(pstate);
+      data[idx] = coeff(pstate);
+      it.advance();
+    }
+  });
+}
+XDIAG_CATCH
+
+template <typename coeff_t, class coeffs_f>
+static void fill_batched(Block const &block, int64_t nsites,
+                         arma::Col<coeff_t> &vec, coeffs_f const &coeffs) try {
+  coeff_t *data = vec.memptr();
+  for_each_chunk(block, [&](basis::BasisIterator &it, int64_t begin,
+                            int64_t end) {
+    std::vector<ProductState> pstates;
+    for (int64_t batch = begin; batch < end; batch += fill_batch_size) {
+      int64_t n = std::min(fill_batch_size, end - batch);
+      pstates.resize(n, ProductState(nsites));
+      for (int64_t i = 0; i < n; ++i) {
+        it.product_state(pstates[i]);
+        it.advance();
+      }
+      // coefficients are written directly into the vector of the state
+      arma::Col<coeff_t> out(data + batch, n, false, true);
+      coeffs(pstates, out);
+    }
+  });
 }
 XDIAG_CATCH
 
@@ -33,13 +125,13 @@ void fill(State &state, std::function<double(ProductState const &)> coeff_f,
   auto const &block = state.block();
   if (state.isreal()) {
     arma::vec v = state.vector(col, false);
-    std::visit([&](auto &&block) { fill(block, v, coeff_f); }, block);
+    fill(block, state.nsites(), v, coeff_f);
   } else {
     arma::cx_vec v = state.vectorC(col, false);
     auto coeff_f_c = [&](ProductState const &pstate) {
       return (complex)coeff_f(pstate);
     };
-    std::visit([&](auto &&block) { fill(block, v, coeff_f_c); }, block);
+    fill(block, state.nsites(), v, coeff_f_c);
   }
 }
 XDIAG_CATCH
@@ -52,7 +144,44 @@ void fill(State &state, std::function<complex(ProductState const &)> coeff_f,
                 "\"make_complex\" first?");
   } else {
     arma::cx_vec v = state.vectorC(col, false);
-    std::visit([&](auto &&block) { fill(block, v, coeff_f); }, block);
+    fill(block, state.nsites(), v, coeff_f);
+  }
+}
+XDIAG_CATCH
+
+void fill(State &state,
+          std::function<void(std::vector<ProductState> const &, arma::vec &)>
+              coeffs_f,
+          int64_t col) try {
+  auto const &block = state.block();
+  if (state.isreal()) {
+    arma::vec v = state.vector(col, false);
+    fill_batched(block, state.nsites(), v, coeffs_f);
+  } else {
+    arma::cx_vec v = state.vectorC(col, false);
+    auto coeffs_f_c = [&](std::vector<ProductState> const &pstates,
+                          arma::cx_vec &coeffs) {
+      arma::vec coeffs_real(coeffs.n_elem);
+      coeffs_f(pstates, coeffs_real);
+      coeffs = arma::conv_to<arma::cx_vec>::from(coeffs_real);
+    };
+    fill_batched(block, state.nsites(), v, coeffs_f_c);
+  }
+}
+XDIAG_CATCH
+
+void fill(State &state,
+          std::function<void(std::vector<ProductState> const &,
+                             arma::cx_vec &)>
+              coeffs_f,
+          int64_t col) try {
+  auto const &block = state.block();
+  if (state.isreal()) {
+    XDIAG_THROW("Cannot fill real state with complex coefficients. Maybe use "
+                "\"make_complex\" first?");
+  } else {
+    arma::cx_vec v = state.vectorC(col, false);
+    fill_batched(block, state.nsites(), v, coeffs_f);
   }
 }
 XDIAG_CATCH
@@ -5,7 +5,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
+#include <xdiag/armadillo.hpp>
 #include <xdiag/states/gpwf.hpp>
 #include <xdiag/states/product_state.hpp>
 #include <xdiag/states/random_state.hpp>
@@ -13,6 +16,10 @@
 
 namespace xdiag {
 
+// Sets the coefficients of the basis states to coeff_f(pstate). The basis is
+// iterated in chunks in parallel, hence coeff_f is called concurrently from
+// several threads and must be thread safe. For distributed blocks every rank
+// fills its local part of the vector.
 XDIAG_API void fill(State &state,
                     std::function<double(ProductState const &)> coeff_f,
                     int64_t col = 0);
@@ -20,6 +27,20 @@ XDIAG_API void fill(State &state,
                     std::function<complex(ProductState const &)> coeff_f,
                     int64_t col = 0);
 
+// Batched variant: coeffs_f(pstates, coeffs) sets coeffs(i) to the coefficient
+// of pstates[i] for consecutive batches of basis states. coeffs is a view of
+// the vector of the state and must not be resized.
+XDIAG_API void
+fill(State &state,
+     std::function<void(std::vector<ProductState> const &, arma::vec &)>
+         coeffs_f,
+     int64_t col = 0);
+XDIAG_API void
+fill(State &state,
+     std::function<void(std::vector<ProductState> const &, arma::cx_vec &)>
+         coeffs_f,
+     int64_t col = 0);
+
 XDIAG_API void fill(State &state, RandomState const &rstate, int64_t col = 0);
 XDIAG_API void fill(State &state, ProductState const &pstate, int64_t col = 0);
 XDIAG_API void fill(State &state, GPWF const &gpwf, int64_t col = 0);
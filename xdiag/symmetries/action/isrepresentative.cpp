@@ -5,22 +5,36 @@
 #include "isrepresentative.hpp"
 
 #include <cstdint>
+#include <type_traits>
 
 #include <xdiag/bits/bitarray.hpp>
 #include <xdiag/bits/bitset.hpp>
+#include <xdiag/symmetries/action/orbit.hpp>
 
 namespace xdiag::symmetries {
 
 // determines whether a state is a representative
 template <typename bit_t>
 bool isrepresentative(bit_t state, SitePermutation const &action) {
-  for (int64_t sym = 0; sym < action.size(); ++sym) {
-    bit_t tstate = action.apply(sym, state);
-    if (tstate < state) {
-      return false;
+  if constexpr (std::is_integral_v<bit_t>) {
+    bool isrep = true;
+    for_each_orbit_chunk(state, action,
+                         [&](int64_t, int64_t n, bit_t const *orbit) {
+                           uint64_t match;
+                           isrep = !(orbit_min_match(orbit, n, state, match) <
+                                     state);
+                           return isrep;
+                         });
+    return isrep;
+  } else {
+    for (int64_t sym = 0; sym < action.size(); ++sym) {
+      bit_t tstate = action.apply(sym, state);
+      if (tstate < state) {
+        return false;
+      }
     }
+    return true;
   }
-  return true;
 }
 
 #define INSTANTIATE_ISREPRESENTATIVE(BIT_TYPE)                                 \
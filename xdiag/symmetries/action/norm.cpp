@@ -6,9 +6,11 @@
 
 #include <cmath>
 #include <cstdint>
+#include <type_traits>
 
 #include <xdiag/bits/bitarray.hpp>
 #include <xdiag/bits/bitset.hpp>
+#include <xdiag/symmetries/action/orbit.hpp>
 #include <xdiag/symmetries/action/site_permutation.hpp>
 #include <xdiag/symmetries/action/site_permutation_sublattice.hpp>
 
@@ -18,9 +20,52 @@ template <typename bit_t, typename coeff_t, typename action_t>
 double norm(bit_t state, action_t const &action,
             arma::Col<coeff_t> const &characters) {
   coeff_t amplitude = 0.0;
-  for (int64_t sym = 0; sym < action.size(); ++sym) {
-    if (action.apply(sym, state) == state) {
-      amplitude += characters(sym);
+  if constexpr (std::is_integral_v<bit_t>) {
+    for_each_orbit_chunk(
+        state, action, [&](int64_t sym_begin, int64_t n, bit_t const *orbit) {
+          uint64_t match;
+          orbit_min_match(orbit, n, state, match);
+          for (; match; match &= match - 1) {
+            amplitude += characters(sym_begin + __builtin_ctzll(match));
+          }
+          return true;
+        });
+  } else {
+    for (int64_t sym = 0; sym < action.size(); ++sym) {
+      if (action.apply(sym, state) == state) {
+        amplitude += characters(sym);
+      }
+    }
+  }
+  return std::sqrt(std::abs(amplitude));
+}
+
+template <typename bit_t, typename coeff_t, typename action_t>
+double representative_norm(bit_t state, action_t const &action,
+                           arma::Col<coeff_t> const &characters) {
+  coeff_t amplitude = 0.0;
+  if constexpr (std::is_integral_v<bit_t>) {
+    bool isrep = true;
+    for_each_orbit_chunk(
+        state, action, [&](int64_t sym_begin, int64_t n, bit_t const *orbit) {
+          uint64_t match;
+          isrep = !(orbit_min_match(orbit, n, state, match) < state);
+          for (; match; match &= match - 1) {
+            amplitude += characters(sym_begin + __builtin_ctzll(match));
+          }
+          return isrep;
+        });
+    if (!isrep) {
+      return 0.;
+    }
+  } else {
+    for (int64_t sym = 0; sym < action.size(); ++sym) {
+      bit_t tstate = action.apply(sym, state);
+      if (tstate < state) {
+        return 0.;
+      } else if (tstate == state) {
+        amplitude += characters(sym);
+      }
     }
   }
   return std::sqrt(std::abs(amplitude));
@@ -32,6 +77,10 @@ double norm(bit_t state, action_t const &action,
   template double norm(BIT_TYPE, SitePermutation const &, arma::vec const &); \
   template double norm(BIT_TYPE, SitePermutation const &,                      \
                        arma::cx_vec const &);                                  \
+  template double representative_norm(BIT_TYPE, SitePermutation const &,       \
+                                      arma::vec const &);                      \
+  template double representative_norm(BIT_TYPE, SitePermutation const &,       \
+                                      arma::cx_vec const &);                   \
   using namespace bits;
 
 INSTANTIATE_NORM_SP(uint32_t);
@@ -64,7 +113,13 @@ INSTANTIATE_NORM_SP(BitArrayLong8);
                        arma::vec const &);                                     \
   template double norm(BIT_TYPE,                                               \
                        SitePermutationSublattice<BIT_TYPE, N_SUBLAT> const &,  \
-                       arma::cx_vec const &);
+                       arma::cx_vec const &);                                  \
+  template double representative_norm(                                         \
+      BIT_TYPE, SitePermutationSublattice<BIT_TYPE, N_SUBLAT> const &,         \
+      arma::vec const &);                                                      \
+  template double representative_norm(                                         \
+      BIT_TYPE, SitePermutationSublattice<BIT_TYPE, N_SUBLAT> const &,         \
+      arma::cx_vec const &);
 
 INSTANTIATE_NORM_SPS(uint32_t, 1);
 INSTANTIATE_NORM_SPS(uint32_t, 2);
@@ -16,4 +16,12 @@ template <typename bit_t, typename coeff_t, typename action_t>
 double norm(bit_t state, action_t const &action,
             arma::Col<coeff_t> const &characters);
 
+// Norm of the symmetrized state if state is the representative of its orbit,
+// and zero otherwise. Both are determined in a single scan of the orbit, which
+// stops at the first chunk of symmetries yielding a smaller state. The norm is
+// given by the sum of the characters over the stabilizer of state.
+template <typename bit_t, typename coeff_t, typename action_t>
+double representative_norm(bit_t state, action_t const &action,
+                           arma::Col<coeff_t> const &characters);
+
 } // namespace xdiag::symmetries
@@ -14,21 +14,39 @@
 
 namespace xdiag::symmetries {
 
-template <typename bit_t, typename coeff_t, typename action_t>
-double norm_fermionic(bit_t state, action_t const &action,
-                      arma::Col<coeff_t> const &characters) {
-  auto const &group = action.group();
-  int64_t nsites = group.nsites();
+template <typename bit_t, typename coeff_t, typename action_t,
+          typename fermi_f>
+static double norm_fermionic_with(bit_t state, action_t const &action,
+                                  arma::Col<coeff_t> const &characters,
+                                  fermi_f &&fermi_bool) {
   coeff_t amplitude = 0.0;
   for (int64_t sym = 0; sym < action.size(); ++sym) {
     if (action.apply(sym, state) == state) {
-      bool fermi = fermi_bool_of_permutation(state, group.ptr(sym), nsites);
-      amplitude += fermi ? -characters(sym) : characters(sym);
+      amplitude += fermi_bool(sym) ? -characters(sym) : characters(sym);
     }
   }
   return std::sqrt(std::abs(amplitude));
 }
 
+template <typename bit_t, typename coeff_t, typename action_t>
+double norm_fermionic(bit_t state, action_t const &action,
+                      arma::Col<coeff_t> const &characters) {
+  auto const &group = action.group();
+  int64_t nsites = group.nsites();
+  return norm_fermionic_with(state, action, characters, [&](int64_t sym) {
+    return fermi_bool_of_permutation(state, group.ptr(sym), nsites);
+  });
+}
+
+template <typename bit_t, typename coeff_t, typename action_t>
+double norm_fermionic(bit_t state, action_t const &action,
+                      arma::Col<coeff_t> const &characters,
+                      FermiBlockTable const &fermi_blocks) {
+  return norm_fermionic_with(state, action, characters, [&](int64_t sym) {
+    return fermi_blocks.sign(sym, (uint64_t)state);
+  });
+}
+
 #define INSTANTIATE_NORM_FERMIONIC_SP(BIT_TYPE)                                \
   template double norm_fermionic(BIT_TYPE, SitePermutation const &,            \
                                  arma::vec const &);                           \
@@ -45,4 +63,16 @@ INSTANTIATE_NORM_FERMIONIC_SP(BitsetStatic4);
 INSTANTIATE_NORM_FERMIONIC_SP(BitsetStatic8);
 
 #undef INSTANTIATE_NORM_FERMIONIC_SP
+
+#define INSTANTIATE_NORM_FERMIONIC_BLOCKS(BIT_TYPE)                            \
+  template double norm_fermionic(BIT_TYPE, SitePermutation const &,            \
+                                 arma::vec const &, FermiBlockTable const &);  \
+  template double norm_fermionic(BIT_TYPE, SitePermutation const &,            \
+                                 arma::cx_vec const &,                         \
+                                 FermiBlockTable const &);
+
+INSTANTIATE_NORM_FERMIONIC_BLOCKS(uint32_t);
+INSTANTIATE_NORM_FERMIONIC_BLOCKS(uint64_t);
+
+#undef INSTANTIATE_NORM_FERMIONIC_BLOCKS
 } // namespace xdiag::symmetries
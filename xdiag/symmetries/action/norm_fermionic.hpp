@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <xdiag/armadillo.hpp>
+#include <xdiag/symmetries/tables/fermi_block_table.hpp>
 
 namespace xdiag::symmetries {
 
@@ -17,4 +20,11 @@ template <typename bit_t, typename coeff_t, typename action_t>
 double norm_fermionic(bit_t state, action_t const &action,
                       arma::Col<coeff_t> const &characters);
 
+// Same as above for states on at most 64 sites, with the fermi signs taken
+// from a FermiBlockTable of the group of the action.
+template <typename bit_t, typename coeff_t, typename action_t>
+double norm_fermionic(bit_t state, action_t const &action,
+                      arma::Col<coeff_t> const &characters,
+                      FermiBlockTable const &fermi_blocks);
+
 } // namespace xdiag::symmetries
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace xdiag::symmetries {
+
+// Number of symmetries applied at once by for_each_orbit_chunk
+constexpr int64_t orbit_chunk_size = 64;
+
+// Computes the orbit of a native integer state in chunks of orbit_chunk_size
+// symmetries using action.apply_range(sym_begin, sym_end, state, orbit) and
+// calls f(sym_begin, n, orbit) on every chunk, where orbit[k] is the image of
+// state under symmetry sym_begin + k for k < n. The scan stops early once f
+// returns false. action_t is SitePermutation or SitePermutationSublattice.
+template <typename bit_t, typename action_t, typename F>
+inline void for_each_orbit_chunk(bit_t state, action_t const &action, F &&f) {
+  bit_t orbit[orbit_chunk_size];
+  int64_t size = action.size();
+  for (int64_t sym_begin = 0; sym_begin < size;
+       sym_begin += orbit_chunk_size) {
+    int64_t sym_end = std::min(sym_begin + orbit_chunk_size, size);
+    action.apply_range(sym_begin, sym_end, state, orbit);
+    if (!f(sym_begin, sym_end - sym_begin, (bit_t const *)orbit)) {
+      return;
+    }
+  }
+}
+
+// Scans a chunk orbit[0], ..., orbit[n - 1] of at most orbit_chunk_size
+// images of state. Returns the minimum of the chunk and sets bit k of match
+// if orbit[k] == state, i.e. if the symmetry belongs to the stabilizer of
+// state. For 32 and 64 bit states the scan uses AVX-512 or AVX2 if the
+// library is compiled for these instruction sets (e.g. with
+// XDIAG_OPTIMIZE_FOR_NATIVE), and a portable loop otherwise.
+template <typename bit_t>
+inline bit_t orbit_min_match(bit_t const *orbit, int64_t n, bit_t state,
+                             uint64_t &match) {
+  bit_t min = orbit[0];
+  match = 0;
+  int64_t k = 0;
+#if defined(__AVX512F__)
+  if constexpr (std::is_same_v<bit_t, uint64_t>) {
+    __m512i vstate = _mm512_set1_epi64((long long)state);
+    __m512i vmin = _mm512_set1_epi64(-1);
+    for (; k + 8 <= n; k += 8) {
+      __m512i v = _mm512_loadu_si512(orbit + k);
+      vmin = _mm512_min_epu64(vmin, v);
+      match |= (uint64_t)_mm512_cmpeq_epu64_mask(v, vstate) << k;
+    }
+    min = std::min(min, (bit_t)_mm512_reduce_min_epu64(vmin));
+  } else if constexpr (std::is_same_v<bit_t, uint32_t>) {
+    __m512i vstate = _mm512_set1_epi32((int)state);
+    __m512i vmin = _mm512_set1_epi32(-1);
+    for (; k + 16 <= n; k += 16) {
+      __m512i v = _mm512_loadu_si512(orbit + k);
+      vmin = _mm512_min_epu32(vmin, v);
+      match |= (uint64_t)_mm512_cmpeq_epu32_mask(v, vstate) << k;
+    }
+    min = std::min(min, (bit_t)_mm512_reduce_min_epu32(vmin));
+  }
+#elif defined(__AVX2__)
+  if constexpr (std::is_same_v<bit_t, uint64_t>) {
+    // AVX2 only compares signed 64 bit integers, so the sign bit is flipped
+    __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+    __m256i vstate = _mm256_set1_epi64x((long long)state);
+    __m256i vmin = _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL);
+    for (; k + 4 <= n; k += 4) {
+      auto ptr = reinterpret_cast<__m256i const *>(orbit + k);
+      __m256i v = _mm256_loadu_si256(ptr);
+      __m256i vb = _mm256_xor_si256(v, bias);
+      vmin = _mm256_blendv_epi8(vmin, vb, _mm256_cmpgt_epi64(vmin, vb));
+      __m256i eq = _mm256_cmpeq_epi64(v, vstate);
+      match |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(eq)) << k;
+    }
+    alignas(32) uint64_t mins[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(mins),
+                       _mm256_xor_si256(vmin, bias));
+    for (uint64_t m : mins) {
+      min = std::min(min, (bit_t)m);
+    }
+  } else if constexpr (std::is_same_v<bit_t, uint32_t>) {
+    __m256i vstate = _mm256_set1_epi32((int)state);
+    __m256i vmin = _mm256_set1_epi32(-1);
+    for (; k + 8 <= n; k += 8) {
+      auto ptr = reinterpret_cast<__m256i const *>(orbit + k);
+      __m256i v = _mm256_loadu_si256(ptr);
+      vmin = _mm256_min_epu32(vmin, v);
+      __m256i eq = _mm256_cmpeq_epi32(v, vstate);
+      match |= (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq)) << k;
+    }
+    alignas(32) uint32_t mins[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(mins), vmin);
+    for (uint32_t m : mins) {
+      min = std::min(min, (bit_t)m);
+    }
+  }
+#endif
+  for (; k < n; ++k) {
+    min = (orbit[k] < min) ? orbit[k] : min;
+    match |= (uint64_t)(orbit[k] == state) << k;
+  }
+  return min;
+}
+
+} // namespace xdiag::symmetries
@@ -4,19 +4,24 @@
 
 #include "representative.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include <xdiag/bits/bitset.hpp>
+#include <xdiag/symmetries/action/orbit.hpp>
 
 namespace xdiag::symmetries {
 
 template <typename bit_t>
 bit_t representative(bit_t state, SitePermutation const &action) {
   bit_t rep = std::numeric_limits<bit_t>::max();
-  for (int64_t sym = 0; sym < action.size(); ++sym) {
-    bit_t trans = action.apply(sym, state);
-    if (trans < rep) {
-      rep = trans;
-    }
-  }
+  for_each_orbit_chunk(state, action,
+                       [&](int64_t, int64_t n, bit_t const *orbit) {
+                         uint64_t match;
+                         bit_t min = orbit_min_match(orbit, n, state, match);
+                         rep = (min < rep) ? min : rep;
+                         return true;
+                       });
   return rep;
 }
 
@@ -28,13 +33,16 @@ std::pair<bit_t, int64_t> representative_sym(bit_t state,
                                              SitePermutation const &action) {
   bit_t rep = std::numeric_limits<bit_t>::max();
   int64_t idx = 0;
-  for (int64_t sym = 0; sym < action.size(); ++sym) {
-    bit_t trans = action.apply(sym, state);
-    if (trans < rep) {
-      rep = trans;
-      idx = sym;
-    }
-  }
+  for_each_orbit_chunk(
+      state, action, [&](int64_t sym_begin, int64_t n, bit_t const *orbit) {
+        uint64_t match;
+        bit_t min = orbit_min_match(orbit, n, state, match);
+        if (min < rep) {
+          rep = min;
+          idx = sym_begin + (std::find(orbit, orbit + n, min) - orbit);
+        }
+        return true;
+      });
   return {rep, idx};
 }
 
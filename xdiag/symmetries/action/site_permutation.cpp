@@ -4,6 +4,8 @@
 
 #include "site_permutation.hpp"
 
+#include <algorithm>
+#include <map>
 #include <type_traits>
 
 #include <xdiag/bits/bitarray.hpp>
@@ -13,12 +15,63 @@
 namespace xdiag::symmetries {
 
 SitePermutation::SitePermutation(PermutationGroup const &group)
-    : group_(group), nsites_(group.nsites()) {}
+    : group_(group), nsites_(group.nsites()) {
+  if (nsites_ > 64) {
+    return;
+  }
+  size_ = group_.size();
+  nbytes_ = (nsites_ + 7) / 8;
+  nshifts_.resize(size_);
+  shift_offsets_.resize(size_);
+  tables_.resize(nbytes_ * 256 * size_, 0);
+  for (int64_t sym = 0; sym < size_; ++sym) {
+    const int64_t *permutation = group_.ptr(sym);
+
+    // lookup tables
+    for (int64_t b = 0; b < nbytes_; ++b) {
+      for (int64_t byte = 0; byte < 256; ++byte) {
+        uint64_t bitsr = 0;
+        for (int64_t j = 0; j < 8; ++j) {
+          int64_t i = 8 * b + j;
+          if ((i < nsites_) && ((byte >> j) & 1)) {
+            bitsr |= (uint64_t)1 << permutation[i];
+          }
+        }
+        tables_[((b << 8) | byte) * size_ + sym] = bitsr;
+      }
+    }
+
+    // group the sites by their displacement
+    std::map<int64_t, uint64_t> masks;
+    for (int64_t i = 0; i < nsites_; ++i) {
+      masks[permutation[i] - i] |= (uint64_t)1 << i;
+    }
+    if ((int64_t)masks.size() <= std::max(nbytes_, (int64_t)2)) {
+      nshifts_[sym] = masks.size();
+      shift_offsets_[sym] = shift_masks_.size();
+      for (auto [d, mask] : masks) {
+        shift_masks_.push_back(mask);
+        shifts_left_.push_back(d > 0 ? d : 0);
+        shifts_right_.push_back(d < 0 ? -d : 0);
+      }
+    } else {
+      nshifts_[sym] = -1;
+      shift_offsets_[sym] = -1;
+    }
+  }
+}
 
 int64_t SitePermutation::size() const { return group_.size(); }
 int64_t SitePermutation::nsites() const { return group_.nsites(); }
 PermutationGroup const &SitePermutation::group() const { return group_; }
 
+int64_t SitePermutation::memory() const {
+  return (int64_t)(tables_.size() * sizeof(uint64_t) +
+                   shift_masks_.size() * sizeof(uint64_t) +
+                   (nshifts_.size() + shift_offsets_.size()) * sizeof(int64_t) +
+                   shifts_left_.size() + shifts_right_.size());
+}
+
 bool SitePermutation::operator==(SitePermutation const &rhs) const {
   return group_ == rhs.group_;
 }
@@ -27,7 +80,7 @@ bool SitePermutation::operator!=(SitePermutation const &rhs) const {
 }
 
 template <typename bit_t>
-bit_t SitePermutation::apply(int64_t sym, bit_t const &bits) const {
+bit_t SitePermutation::apply_generic(int64_t sym, bit_t const &bits) const {
   bit_t bitsr;
   if constexpr (std::is_same_v<bit_t, bits::BitsetDynamic>) {
     bitsr = bits::BitsetDynamic(nsites_);
@@ -55,10 +108,12 @@ SitePermutation::apply(int64_t sym,
   }
   return bitsr;
 }
+
 using namespace bits;
 
 #define INSTANTIATE_APPLY(BIT_TYPE)                                            \
-  template BIT_TYPE SitePermutation::apply(int64_t, BIT_TYPE const &) const;
+  template BIT_TYPE SitePermutation::apply_generic(int64_t, BIT_TYPE const &)  \
+      const;
 
 INSTANTIATE_APPLY(uint32_t);
 INSTANTIATE_APPLY(uint64_t);
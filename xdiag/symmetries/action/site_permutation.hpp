@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
 #include <xdiag/bits/bitarray.hpp>
 #include <xdiag/symmetries/permutation_group.hpp>
 #include <xdiag/utils/xdiag_api.hpp>
@@ -13,6 +17,19 @@ namespace xdiag::symmetries {
 // Applies site permutations from a PermutationGroup to bit states.
 // apply(sym, bits) moves the bit at site i to site p[i], where p is the
 // sym-th permutation. Supports native integers (uint16/32/64_t) and BitArray.
+//
+// For native integers (nsites <= 64) every permutation is precompiled on
+// construction into one of two forms:
+//  - shift-and-mask: the sites are grouped by their displacement d = p[i] - i
+//    and the permutation is evaluated as OR_d (bits & mask_d) << d. This is
+//    used whenever the number of distinct displacements is small, e.g. for
+//    translations, which need at most two (a rotation) per lattice direction.
+//  - byte lookup tables: for every byte of the input a table of 256 words
+//    holding the permuted bits, such that the permutation is evaluated by
+//    ceil(nsites / 8) lookups.
+// The lookup tables store the images under all symmetries contiguously, such
+// that apply_range can apply many symmetries at once in vector registers.
+// Other bit types use the generic bit-by-bit permutation.
 class SitePermutation {
 public:
   SitePermutation() = default;
@@ -21,18 +38,81 @@ public:
   int64_t size() const;
   int64_t nsites() const;
   PermutationGroup const &group() const;
+  int64_t memory() const; // memory occupied by the precompiled tables in bytes
   bool operator==(SitePermutation const &rhs) const;
   bool operator!=(SitePermutation const &rhs) const;
 
-  template <typename bit_t> bit_t apply(int64_t sym, bit_t const &bits) const;
+  template <typename bit_t>
+  inline bit_t apply(int64_t sym, bit_t const &bits) const {
+    if constexpr (std::is_integral_v<bit_t>) {
+      return (bit_t)apply_word(sym, (uint64_t)bits);
+    } else {
+      return apply_generic(sym, bits);
+    }
+  }
 
   template <typename bit_t, int nbits>
   bits::BitArray<bit_t, nbits>
   apply(int64_t sym, bits::BitArray<bit_t, nbits> const &bits) const;
 
+  // Applies the symmetries sym_begin, ..., sym_end - 1 to a native integer
+  // state and writes the images to orbit[0], ..., orbit[sym_end - sym_begin -
+  // 1]. The inner loops run over contiguous table rows and are vectorized.
+  template <typename bit_t>
+  inline void apply_range(int64_t sym_begin, int64_t sym_end, bit_t bits,
+                          bit_t *orbit) const {
+    int64_t n = sym_end - sym_begin;
+    for (int64_t k = 0; k < n; ++k) {
+      orbit[k] = 0;
+    }
+    for (int64_t b = 0; b < nbytes_; ++b) {
+      int64_t row = (b << 8) | (int64_t)((bits >> (b << 3)) & 0xFF);
+      uint64_t const *images = tables_.data() + row * size_ + sym_begin;
+      for (int64_t k = 0; k < n; ++k) {
+        orbit[k] |= (bit_t)images[k];
+      }
+    }
+  }
+
+  // Bit-by-bit reference implementation, valid for all bit types
+  template <typename bit_t>
+  bit_t apply_generic(int64_t sym, bit_t const &bits) const;
+
 private:
   PermutationGroup group_;
   int64_t nsites_;
+
+  // Precompiled permutations for native integers. For every sym, nshifts_[sym]
+  // is the number of (mask, left shift, right shift) triples starting at
+  // shift_offsets_[sym] or -1 if the lookup tables are used instead. The
+  // image of byte value v at byte b under sym is tables_[(b * 256 + v) * size_
+  // + sym].
+  int64_t size_ = 0;
+  int64_t nbytes_ = 0;
+  std::vector<int64_t> nshifts_;
+  std::vector<int64_t> shift_offsets_;
+  std::vector<uint64_t> shift_masks_;
+  std::vector<uint8_t> shifts_left_;
+  std::vector<uint8_t> shifts_right_;
+  std::vector<uint64_t> tables_;
+
+  inline uint64_t apply_word(int64_t sym, uint64_t bits) const {
+    uint64_t bitsr = 0;
+    int64_t nshifts = nshifts_[sym];
+    if (nshifts >= 0) {
+      int64_t offset = shift_offsets_[sym];
+      for (int64_t k = offset; k < offset + nshifts; ++k) {
+        bitsr |= ((bits & shift_masks_[k]) << shifts_left_[k]) >>
+                 shifts_right_[k];
+      }
+    } else {
+      for (int64_t b = 0; b < nbytes_; ++b) {
+        int64_t row = (b << 8) | (int64_t)((bits >> (b << 3)) & 0xFF);
+        bitsr |= tables_[row * size_ + sym];
+      }
+    }
+    return bitsr;
+  }
 };
 
 } // namespace xdiag::symmetries
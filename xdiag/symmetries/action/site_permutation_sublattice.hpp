@@ -29,6 +29,23 @@ public:
   }
 
   bit_t apply(int64_t sym, bit_t state) const;
+
+  // Applies the symmetries sym_begin, ..., sym_end - 1 at once, see
+  // SitePermutation::apply_range
+  inline void apply_range(int64_t sym_begin, int64_t sym_end, bit_t state,
+                          bit_t *orbit) const {
+    int64_t n = sym_end - sym_begin;
+    for (int64_t k = 0; k < n; ++k) {
+      orbit[k] = 0;
+    }
+    for (int sublat = 0; sublat < n_sublat; ++sublat) {
+      half_bit_t substate = (state >> sublat_shift_[sublat]) & sublat_mask_;
+      bit_t const *images = &sym_action(sublat, sym_begin, substate);
+      for (int64_t k = 0; k < n; ++k) {
+        orbit[k] |= images[k];
+      }
+    }
+  }
   bit_t representative(bit_t state) const;
   std::pair<bit_t, int64_t> representative_sym(bit_t state) const;
   std::pair<bit_t, gsl::span<int64_t const>>
@@ -5,6 +5,7 @@
 #include "fermi_sign.hpp"
 
 #include <cstdint>
+#include <type_traits>
 
 #include <xdiag/bits/bitmask.hpp>
 #include <xdiag/bits/get_set.hpp>
@@ -20,7 +21,22 @@ bool fermi_bool_of_permutation(bit_t const &state, int64_t const *perm,
   // We walk the sites in increasing order; the inversions contributed by a
   // newly occupied site's image v are exactly the already-seen images greater
   // than v. Tracking the seen images in a bitmask makes that an O(1) popcount
-  // per site, so the whole routine is O(nsites) instead of O(nfermion^2).
+  // per site, so the whole routine is O(nsites) instead of O(nfermion^2). For
+  // native integers only the occupied sites are visited, O(nfermion).
+  if constexpr (std::is_integral_v<bit_t>) {
+    uint64_t occupied = (uint64_t)state;
+    uint64_t seen = 0;
+    int fermi = 0;
+    while (occupied) {
+      int64_t v = perm[__builtin_ctzll(occupied)];
+      occupied &= occupied - 1;
+      uint64_t above = (v >= 63) ? 0 : (~(uint64_t)0 << (v + 1));
+      fermi ^= bits::popcount(seen & above);
+      seen |= (uint64_t)1 << v;
+    }
+    return fermi & 1;
+  }
+
   bit_t seen = bits::zero<bit_t>(nsites);
   int64_t n_seen = 0;
   bool fermi = false;
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "fermi_block_table.hpp"
+
+#include <xdiag/utils/error.hpp>
+#include <xdiag/utils/format.hpp>
+
+namespace xdiag::symmetries {
+
+static inline uint64_t sites_above(int64_t site) {
+  return (site >= 63) ? 0 : (~(uint64_t)0 << (site + 1));
+}
+
+FermiBlockTable::FermiBlockTable(PermutationGroup const &group) try {
+  int64_t nsites = group.nsites();
+  if (nsites > max_nsites) {
+    XDIAG_THROW(fmt::format("FermiBlockTable supports at most {} sites, got {}",
+                            max_nsites, nsites));
+  }
+  nblocks_ = (nsites + 7) / 8;
+  int64_t nsyms = group.size();
+  entries_.resize(nsyms * nblocks_ * 256);
+
+  for (int64_t sym = 0; sym < nsyms; ++sym) {
+    int64_t const *perm = group.ptr(sym);
+    for (int64_t block = 0; block < nblocks_; ++block) {
+      for (int64_t pattern = 0; pattern < 256; ++pattern) {
+        Entry e{0, 0, 0};
+        for (int64_t i = 0; i < 8; ++i) {
+          int64_t site = 8 * block + i;
+          if ((site < nsites) && ((pattern >> i) & 1)) {
+            int64_t image = perm[site];
+            e.intra ^= bits::popcount(e.images & sites_above(image)) & 1;
+            e.images |= (uint64_t)1 << image;
+            e.above ^= sites_above(image);
+          }
+        }
+        entries_[(sym * nblocks_ + block) * 256 + pattern] = e;
+      }
+    }
+  }
+}
+XDIAG_CATCH
+
+int64_t FermiBlockTable::memory() const {
+  return entries_.size() * sizeof(Entry);
+}
+
+} // namespace xdiag::symmetries
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <xdiag/bits/popcount.hpp>
+#include <xdiag/symmetries/permutation_group.hpp>
+
+namespace xdiag::symmetries {
+
+// Fermi signs of the permutations of a group evaluated from small tables over
+// blocks of 8 sites: sign(sym, state) == fermi_bool_of_permutation(state,
+// group[sym]) for states on at most 64 sites.
+//
+// For every permutation, block and 8-bit occupation pattern of the block the
+// table stores the images of the occupied sites, the parity of the inversions
+// within the block, and the XOR of the masks of all sites above the images.
+// The inversions between a block and the images of the blocks before it then
+// have the parity of a single popcount, such that a sign costs nsites / 8
+// lookups. The memory is |group| x nsites / 8 x 256 entries, independent of
+// the number of states, which makes it an alternative to the dense FermiTable
+// for large enumerations.
+class FermiBlockTable {
+public:
+  static constexpr int64_t max_nsites = 64;
+
+  FermiBlockTable() = default;
+  explicit FermiBlockTable(PermutationGroup const &group);
+
+  inline bool sign(int64_t sym, uint64_t state) const {
+    Entry const *entries = entries_.data() + sym * nblocks_ * 256;
+    uint64_t seen = 0;
+    int fermi = 0;
+    for (int64_t block = 0; block < nblocks_; ++block) {
+      Entry const &e = entries[block * 256 + ((state >> (8 * block)) & 0xFF)];
+      fermi ^= e.intra ^ bits::popcount(seen & e.above);
+      seen |= e.images;
+    }
+    return fermi & 1;
+  }
+
+  int64_t memory() const; // memory occupied by the table in bytes
+
+private:
+  struct Entry {
+    uint64_t images; // images of the occupied sites of the block
+    uint64_t above;  // XOR of the masks of the sites above each image
+    int intra;       // parity of the inversions within the block
+  };
+  int64_t nblocks_ = 0;
+  std::vector<Entry> entries_;
+};
+
+} // namespace xdiag::symmetries
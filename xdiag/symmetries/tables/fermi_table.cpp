@@ -15,13 +15,24 @@ namespace xdiag::symmetries {
 
 template <typename enumeration_t>
 FermiTable<enumeration_t>::FermiTable(enumeration_t const &enumeration,
-                                      PermutationGroup const &group) try
+                                      PermutationGroup const &group,
+                                      int64_t max_memory) try
     : enumeration_(enumeration), size_(enumeration.size()) {
   if (enumeration.n() != group.nsites()) {
     XDIAG_THROW("nsites of the enumeration does not match the nsites of the "
                 "PermutationGroup");
   }
   int64_t nsyms = group.size();
+  if ((nsyms * size_ + 7) / 8 > max_memory) {
+    dense_ = false;
+    if (std::is_integral_v<bit_t> &&
+        (group.nsites() <= FermiBlockTable::max_nsites)) {
+      blocks_ = FermiBlockTable(group);
+    } else {
+      group_ = group;
+    }
+    return;
+  }
   table_.resize(nsyms * size_);
 
   // Filled serially: std::vector<bool> is bit-packed, so concurrent writes to
@@ -42,6 +53,11 @@ FermiTable<enumeration_t>::FermiTable(enumeration_t const &enumeration,
 }
 XDIAG_CATCH
 
+template <typename enumeration_t>
+int64_t FermiTable<enumeration_t>::memory() const {
+  return table_.size() / 8 + blocks_.memory();
+}
+
 } // namespace xdiag::symmetries
 
 using namespace xdiag;
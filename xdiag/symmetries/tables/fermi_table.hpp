@@ -6,9 +6,12 @@
 
 #include <cstdint>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include <xdiag/symmetries/fermi_sign.hpp>
 #include <xdiag/symmetries/permutation_group.hpp>
+#include <xdiag/symmetries/tables/fermi_block_table.hpp>
 #include <xdiag/utils/type_name.hpp>
 
 namespace xdiag::symmetries {
@@ -21,6 +24,15 @@ namespace xdiag::symmetries {
 // |group| x |enumeration| bits of one-time storage for an O(1) lookup (plus the
 // enumeration's own index(), O(1) for the LinTable enumerations the symmetric
 // blocks use). Templated on the enumeration, like RepresentativeTable.
+//
+// The dense table grows with the enumeration, e.g. to several GB for the up
+// sector of 32 sites with 16 electrons and 128 symmetries. If it would exceed
+// max_memory bytes, the signs are instead evaluated from a FermiBlockTable
+// (for at most 64 sites), or with fermi_bool_of_permutation otherwise. Once
+// the dense table is much larger than the caches its random lookups are
+// slower than the block tables, hence the small default.
+inline int64_t fermi_table_max_memory = 8 * 1024 * 1024;
+
 template <typename enumeration_tt> class FermiTable {
 public:
   using enumeration_t = enumeration_tt;
@@ -29,16 +41,30 @@ public:
       utils::get_type_name<FermiTable<enumeration_t>>();
 
   FermiTable() = default;
-  FermiTable(enumeration_t const &enumeration, PermutationGroup const &group);
+  FermiTable(enumeration_t const &enumeration, PermutationGroup const &group,
+             int64_t max_memory = fermi_table_max_memory);
 
   inline bool sign(int64_t sym, bit_t state) const {
-    return table_[sym * size_ + enumeration_.index(state)];
+    if (dense_) {
+      return table_[sym * size_ + enumeration_.index(state)];
+    } else if constexpr (std::is_integral_v<bit_t>) {
+      return blocks_.sign(sym, (uint64_t)state);
+    } else {
+      return fermi_bool_of_permutation(state, group_.ptr(sym),
+                                       group_.nsites());
+    }
   }
 
+  bool dense() const { return dense_; }
+  int64_t memory() const; // memory occupied by the table in bytes
+
 private:
   enumeration_t enumeration_;
   int64_t size_ = 0; // number of states in the enumeration
+  bool dense_ = true;
   std::vector<bool> table_;
+  FermiBlockTable blocks_;
+  PermutationGroup group_;
 };
 
 } // namespace xdiag::symmetries
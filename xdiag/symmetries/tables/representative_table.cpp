@@ -7,7 +7,6 @@
 #include <algorithm>
 #include <cstdint>
 #include <numeric>
-#include <set>
 #include <type_traits>
 
 #ifdef _OPENMP
@@ -17,6 +16,7 @@
 #include <xdiag/bits/bitarray.hpp>
 #include <xdiag/bits/bitset.hpp>
 #include <xdiag/bits/nbits.hpp>
+#include <xdiag/bits/to_string.hpp>
 #include <xdiag/combinatorics/bounded_multisets/bounded_multisets.hpp>
 #include <xdiag/combinatorics/bounded_partitions/bounded_partitions.hpp>
 #include <xdiag/combinatorics/bounded_partitions/schaefer_table.hpp>
@@ -33,13 +33,29 @@
 #include <xdiag/utils/logger.hpp>
 #include <xdiag/utils/thread_range.hpp>
 #include <xdiag/utils/timing.hpp>
+#include <xdiag/utils/type_name.hpp>
 
 namespace xdiag::symmetries {
 
+// Memory in bytes of a BitVector<uint64_t> with size entries of nbits bits
+static int64_t bitvector_memory(int64_t size, int64_t nbits) {
+  return ((size * nbits + 63) / 64) * (int64_t)sizeof(uint64_t);
+}
+
+// Number of leading bits by which compact tables bucket the representatives,
+// giving about one bucket per four representatives
+static int64_t compact_prefix_bits(int64_t nreps, int64_t nsites) {
+  int64_t n_prefix_bits =
+      std::max((int64_t)math::ceillog2(nreps + 1) - 2, (int64_t)0);
+  return std::min(n_prefix_bits, std::min(nsites, (int64_t)32));
+}
+
+// With compact = true, compact is reset to false if the compact tables would
+// not take less memory than the full ones.
 template <bool fermionic, typename enumeration_t, typename coeff_t>
 static void representative_table_initialize(
     enumeration_t const &enumeration, SitePermutation const &action,
-    arma::Col<coeff_t> const &characters,
+    arma::Col<coeff_t> const &characters, bool &compact,
     // bits::BitVector<typename enumeration_t::bit_t> &representative,
     std::vector<typename enumeration_t::bit_t> &representative,
     bits::BitVector<uint64_t> &representative_index,
@@ -53,11 +69,34 @@ static void representative_table_initialize(
   // Orbit norm of a state: bosonic sqrt(|sum_{g:g(s)=s} chi(g)|), or the
   // fermi-sign-weighted version that can reduce/cancel the weight. The branch
   // is resolved at compile time so the bosonic path keeps its original code.
-  auto orbit_norm = [&](bit_t state) {
+  // Fermi signs of states on at most 64 sites are taken from block tables.
+  FermiBlockTable fermi_blocks;
+  if constexpr (fermionic && std::is_integral_v<bit_t>) {
+    fermi_blocks = FermiBlockTable(action.group());
+  }
+  // Generic, such that it is only instantiated for the fermionic enumerations
+  auto fermi_bool = [&](auto const &state, int64_t sym) {
+    if constexpr (std::is_integral_v<bit_t>) {
+      return fermi_blocks.sign(sym, (uint64_t)state);
+    } else {
+      return fermi_bool_of_permutation(state, action.group().ptr(sym),
+                                       action.nsites());
+    }
+  };
+  // Norm of the orbit if state is its representative and zero otherwise. For
+  // bosonic states both follow from a single scan of the orbit.
+  auto representative_orbit_norm = [&](bit_t state) {
     if constexpr (fermionic) {
-      return norm_fermionic(state, action, characters);
+      if (!isrepresentative(state, action)) {
+        return 0.;
+      }
+      if constexpr (std::is_integral_v<bit_t>) {
+        return norm_fermionic(state, action, characters, fermi_blocks);
+      } else {
+        return norm_fermionic(state, action, characters);
+      }
     } else {
-      return norm(state, action, characters);
+      return representative_norm(state, action, characters);
     }
   };
 
@@ -73,76 +112,101 @@ static void representative_table_initialize(
                     action.nsites(), enumeration.n()));
   }
 
-  // First pass, simply count number of representatives and number of different
-  // norms
+  // The representatives are found in two passes. The enumeration is split into
+  // contiguous per-thread chunks and the first pass collects the
+  // representatives of every chunk together with their norms. The second pass
+  // copies them to their final position, given by the prefix sums of the
+  // number of representatives per chunk. Since the chunks are ordered, the
+  // representatives come out in the order of the enumeration, and every state
+  // is checked only once.
   Log(2, "Creating representative table...");
   auto time_total = rightnow();
 
-  Log(2, "  counting representatives...");
+  Log(2, "  collect representatives...");
   auto time_count = rightnow();
 
 #ifdef _OPENMP
   int nthreads = omp_get_max_threads();
-  std::vector<int64_t> nrepresentatives_for_thread(nthreads, 0);
-  std::vector<std::set<double>> norms_for_thread(nthreads);
+#else
+  int nthreads = 1;
+#endif
+  std::vector<std::vector<bit_t>> representatives_for_thread(nthreads);
+  std::vector<std::vector<double>> norms_for_thread(nthreads);
+  std::vector<std::vector<double>> distinct_norms_for_thread(nthreads);
+
+  // Norms which agree up to 1e-6 are considered equal
+  auto find_norm = [](std::vector<double> const &nrms, double nrm) {
+    return std::find_if(nrms.begin(), nrms.end(),
+                        [&](double n) { return std::fabs(n - nrm) < 1e-6; });
+  };
 
-#pragma omp parallel
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
   {
+#ifdef _OPENMP
     int num_thread = omp_get_thread_num();
+#else
+    int num_thread = 0;
+#endif
+    auto &reps = representatives_for_thread[num_thread];
+    auto &nrms = norms_for_thread[num_thread];
+    auto &distinct = distinct_norms_for_thread[num_thread];
     auto range = utils::thread_range(enumeration, num_thread, nthreads);
     for (auto it = range.begin; it != range.end; ++it) {
-      auto state = *it;
-      if (isrepresentative(state, action)) {
-        double nrm = orbit_norm(state);
-        if (std::fabs(nrm) > 1e-6) { // representative found
-          ++nrepresentatives_for_thread[num_thread];
-          norms_for_thread[num_thread].insert(nrm);
+      bit_t state = *it;
+      double nrm = representative_orbit_norm(state);
+      if (std::fabs(nrm) > 1e-6) { // representative found
+        reps.push_back(state);
+        nrms.push_back(nrm);
+        if (find_norm(distinct, nrm) == distinct.end()) {
+          distinct.push_back(nrm);
         }
       }
     }
   }
 
-  // combine norms from different threads
-  std::set<double> norms_set;
-  for (auto const &s : norms_for_thread) {
-    norms_set.insert(s.begin(), s.end());
+  // combine the norms of the different threads
+  for (auto const &distinct : distinct_norms_for_thread) {
+    for (double nrm : distinct) {
+      if (find_norm(norms, nrm) == norms.end()) {
+        norms.push_back(nrm);
+      }
+    }
   }
-  norms = std::vector<double>(norms_set.begin(), norms_set.end());
-
-  // get the offsets for nrepresentatives
-  std::vector<int64_t> nrepresentatives_for_thread_offset(nthreads, 0);
-  std::partial_sum(nrepresentatives_for_thread.begin(),
-                   nrepresentatives_for_thread.end() - 1,
-                   nrepresentatives_for_thread_offset.begin() + 1);
-
-  // get the total number of representatives
-  int64_t nrepresentatives =
-      std::accumulate(nrepresentatives_for_thread.begin(),
-                      nrepresentatives_for_thread.end(), 0);
-#else
-  int64_t nrepresentatives = 0;
-  for (auto state : enumeration) {
-    if (isrepresentative(state, action)) {
-      double nrm = orbit_norm(state);
-
-      if (std::fabs(nrm) > 1e-6) { // representative found
-        ++nrepresentatives;
+  std::sort(norms.begin(), norms.end());
 
-        // Check if norm already registered ...
-        auto it = std::find_if(norms.begin(), norms.end(), [&](double n) {
-          return std::fabs(n - nrm) < 1e-6;
-        });
+  // offsets of the representatives of each thread
+  std::vector<int64_t> nrepresentatives_for_thread_offset(nthreads + 1, 0);
+  for (int t = 0; t < nthreads; ++t) {
+    nrepresentatives_for_thread_offset[t + 1] =
+        nrepresentatives_for_thread_offset[t] +
+        (int64_t)representatives_for_thread[t].size();
+  }
+  int64_t nrepresentatives = nrepresentatives_for_thread_offset[nthreads];
+  timing(time_count, rightnow(), "  time (collect)", 2);
 
-        // ... if not, register it
-        if (it == norms.end()) {
-          norms.push_back(nrm);
-        }
-      }
+  // Compact tables keep the precompiled action, the fermi sign blocks and the
+  // bucket offsets instead of the per-state arrays. This only pays off for
+  // enumerations large enough compared to the tables of the action.
+  if (compact) {
+    int64_t size = enumeration.size();
+    int64_t nbits_index = std::max(1u, math::ceillog2(nrepresentatives + 1));
+    int64_t nbits_sym = std::max(1u, math::ceillog2(action.size()));
+    int64_t memory_full = bitvector_memory(size, nbits_index) +
+                          bitvector_memory(size, nbits_sym) +
+                          (fermionic ? bitvector_memory(size, 1) : 0);
+    int64_t nprefixes =
+        (int64_t)1 << compact_prefix_bits(nrepresentatives, action.nsites());
+    int64_t memory_compact = action.memory() + fermi_blocks.memory() +
+                             (nprefixes + 1) * (int64_t)sizeof(int64_t);
+    if (memory_compact >= memory_full) {
+      Log(2, "  compact tables ({} bytes) not smaller than full tables ({} "
+             "bytes), using full tables",
+          memory_compact, memory_full);
+      compact = false;
     }
   }
-#endif
-  std::sort(norms.begin(), norms.end());
-  timing(time_count, rightnow(), "  time (count)", 2);
 
   // --------------------------------------------------------------
   // Now come the allocations, since we know al the relevant sizes
@@ -160,23 +224,25 @@ static void representative_table_initialize(
     XDIAG_THROW("Unable to allocate representative array");
   }
 
-  // Create vector holding the indices for each state yielding the
-  // representative
-  try {
-    int64_t size = enumeration.size();
-    int64_t nbits = std::max(1u, math::ceillog2(nrepresentatives + 1));
-    representative_index = BitVector<uint64_t>(size, nbits);
-  } catch (...) {
-    XDIAG_THROW("Unable to allocate representative index array");
-  }
+  // Create vectors holding the indices for each state yielding the
+  // representative and the symmetry which yields the representative. Compact
+  // tables only hold representative-level data and skip these.
+  if (!compact) {
+    try {
+      int64_t size = enumeration.size();
+      int64_t nbits = std::max(1u, math::ceillog2(nrepresentatives + 1));
+      representative_index = BitVector<uint64_t>(size, nbits);
+    } catch (...) {
+      XDIAG_THROW("Unable to allocate representative index array");
+    }
 
-  // Create vector holding the symmetry which yields the representative
-  try {
-    int64_t size = enumeration.size();
-    int64_t nbits = std::max(1u, math::ceillog2(action.size()));
-    representative_symmetry = BitVector<uint64_t>(size, nbits);
-  } catch (...) {
-    XDIAG_THROW("Unable to allocate representative symmetry array");
+    try {
+      int64_t size = enumeration.size();
+      int64_t nbits = std::max(1u, math::ceillog2(action.size()));
+      representative_symmetry = BitVector<uint64_t>(size, nbits);
+    } catch (...) {
+      XDIAG_THROW("Unable to allocate representative symmetry array");
+    }
   }
 
   // Create vector holding the norm index of the states
@@ -191,10 +257,12 @@ static void representative_table_initialize(
   // Create vector holding the fermi sign (1 bit per state) of the symmetry
   // stored in representative_symmetry. Only needed for fermionic tables.
   if constexpr (fermionic) {
-    try {
-      representative_fermi = BitVector<uint64_t>(enumeration.size(), 1);
-    } catch (...) {
-      XDIAG_THROW("Unable to allocate representative fermi array");
+    if (!compact) {
+      try {
+        representative_fermi = BitVector<uint64_t>(enumeration.size(), 1);
+      } catch (...) {
+        XDIAG_THROW("Unable to allocate representative fermi array");
+      }
     }
   }
   timing(time_allocation, rightnow(), "  time (allocation)", 2);
@@ -210,51 +278,26 @@ static void representative_table_initialize(
   auto time_write_rep = rightnow();
 
 #ifdef _OPENMP
-#pragma omp parallel
+#pragma omp parallel num_threads(nthreads)
+#endif
   {
-    int t = omp_get_thread_num();
-    auto range = utils::thread_range(enumeration, t, nthreads);
-    int64_t local_rep_idx = nrepresentatives_for_thread_offset[t];
-    for (auto it = range.begin; it != range.end; ++it) {
-      bit_t state = *it;
-      if (isrepresentative(state, action)) {
-        double nrm = orbit_norm(state);
-        if (std::fabs(nrm) > 1e-6) {
-          // Each thread writes a disjoint index range into the unpacked
-          // representative vector, so a plain assignment is race-free (unlike
-          // the packed norm-index BitVector below, whose adjacent elements may
-          // share a storage chunk and hence use atomic_or_element).
-          // representative.atomic_or_element(local_rep_idx, state);
-          representative[local_rep_idx] = state;
-          auto it2 = std::find_if(norms.begin(), norms.end(), [&](double n) {
-            return std::fabs(n - nrm) < 1e-6;
-          });
-          representative_norm_index.atomic_or_element(
-              local_rep_idx, (uint64_t)std::distance(norms.begin(), it2));
-          ++local_rep_idx;
-        }
-      }
-    }
-  }
+#ifdef _OPENMP
+    int num_thread = omp_get_thread_num();
 #else
-  {
-    int64_t rep_idx = 0;
-    for (auto state : enumeration) {
-      if (isrepresentative(state, action)) {
-        double nrm = orbit_norm(state);
-        if (std::fabs(nrm) > 1e-6) {
-          representative[rep_idx] = state;
-          auto it = std::find_if(norms.begin(), norms.end(), [&](double n) {
-            return std::fabs(n - nrm) < 1e-6;
-          });
-          representative_norm_index[rep_idx] =
-              (uint64_t)std::distance(norms.begin(), it);
-          ++rep_idx;
-        }
-      }
+    int num_thread = 0;
+#endif
+    auto &reps = representatives_for_thread[num_thread];
+    auto &nrms = norms_for_thread[num_thread];
+    int64_t offset = nrepresentatives_for_thread_offset[num_thread];
+    for (int64_t i = 0; i < (int64_t)reps.size(); ++i) {
+      representative[offset + i] = reps[i];
+      auto it = find_norm(norms, nrms[i]);
+      representative_norm_index.atomic_or_element(
+          offset + i, (uint64_t)(it - norms.cbegin()));
     }
+    std::vector<bit_t>().swap(reps);
+    std::vector<double>().swap(nrms);
   }
-#endif
   timing(time_write_rep, rightnow(), "  time (write representative)", 2);
 
   // --------------------------------------------------------------
@@ -267,22 +310,40 @@ static void representative_table_initialize(
   // In the OMP path we use atomic_or_element (OR into zero-initialised
   // storage) so concurrent writes to different rep_idx are race-free.
   // --------------------------------------------------------------
+  if (compact) {
+    timing(time_total, rightnow(), "done", 2);
+    return;
+  }
+
   Log(2, "  write non-representatives...");
   auto time_write_non_rep = rightnow();
 
+  // Images of a representative under all symmetries, batched for native
+  // integers
   auto const &group = action.group();
+  auto compute_orbit = [&](bit_t rep, std::vector<bit_t> &orbit) {
+    if constexpr (std::is_integral_v<bit_t>) {
+      action.apply_range(0, action.size(), rep, orbit.data());
+    } else {
+      for (int64_t sym = 0; sym < action.size(); ++sym) {
+        orbit[sym] = action.apply(sym, rep);
+      }
+    }
+  };
+
 #ifdef _OPENMP
 #pragma omp parallel
   {
     std::vector<int64_t> seen;
     seen.reserve(action.size());
+    std::vector<bit_t> orbit(action.size());
 #pragma omp for schedule(static)
     for (int64_t rep_idx = 0; rep_idx < (int64_t)representative.size();
          ++rep_idx) {
       seen.clear();
-      bit_t rep = representative[rep_idx];
+      compute_orbit(representative[rep_idx], orbit);
       for (int64_t sym = 0; sym < action.size(); ++sym) {
-        bit_t state = action.apply(sym, rep);
+        bit_t state = orbit[sym];
         int64_t idx = enumeration.index(state);
         if (std::find(seen.begin(), seen.end(), idx) != seen.end())
           continue;
@@ -291,8 +352,7 @@ static void representative_table_initialize(
         representative_index.atomic_or_element(idx, (uint64_t)(rep_idx + 1));
         representative_symmetry.atomic_or_element(idx, (uint64_t)inv_sym);
         if constexpr (fermionic) {
-          if (fermi_bool_of_permutation(state, group.ptr(inv_sym),
-                                        group.nsites())) {
+          if (fermi_bool(state, inv_sym)) {
             representative_fermi.atomic_or_element(idx, (uint64_t)1);
           }
         }
@@ -300,18 +360,18 @@ static void representative_table_initialize(
     }
   }
 #else
+  std::vector<bit_t> orbit(action.size());
   for (int64_t rep_idx = 0; rep_idx < (int64_t)representative.size();
        ++rep_idx) {
-    bit_t rep = representative[rep_idx];
+    compute_orbit(representative[rep_idx], orbit);
     for (int64_t sym = 0; sym < action.size(); ++sym) {
-      bit_t state = action.apply(sym, rep);
+      bit_t state = orbit[sym];
       int64_t idx = enumeration.index(state);
       int64_t inv_sym = group.inv(sym);
       representative_index[idx] = (uint64_t)(rep_idx + 1);
       representative_symmetry[idx] = (uint64_t)inv_sym;
       if constexpr (fermionic) {
-        if (fermi_bool_of_permutation(state, group.ptr(inv_sym),
-                                      group.nsites())) {
+        if (fermi_bool(state, inv_sym)) {
           representative_fermi[idx] = (uint64_t)1;
         }
       }
@@ -327,76 +387,190 @@ XDIAG_CATCH
 template <typename enumeration_t>
 RepresentativeTable<enumeration_t>::RepresentativeTable(
     enumeration_t const &enumeration, PermutationGroup const &group,
-    Vector const &characters, bool fermionic) try {
+    Vector const &characters, bool fermionic, bool compact) try {
   using bit_t = typename enumeration_t::bit_t;
   SitePermutation action(group);
+  if (compact && !std::is_integral_v<bit_t>) {
+    XDIAG_THROW("Compact representative tables are only supported for states "
+                "coded by native integers (nsites <= 64)");
+  }
 
-  // The fermionic path is only compiled for fermi_capable backends (native
-  // integers / Bitset). The BitArray-backed bosonic bases never request it, so
-  // for them we compile only the bosonic path and reject a fermionic request.
-  if constexpr (fermi_capable<bit_t>::value) {
-    if (characters.isreal()) {
-      arma::vec chars = characters.as<arma::vec>();
-      if (fermionic) {
-        representative_table_initialize<true>(
-            enumeration, action, chars, representative_, representative_index_,
-            representative_symmetry_, representative_norm_index_,
-            representative_fermi_, norm_);
+  // Tables of native integers and static bitsets can be cached on disk
+  io::CacheKey key;
+  std::string filename;
+  if constexpr (std::is_trivially_copyable_v<bit_t>) {
+    key.add(std::string_view("RepresentativeTable"))
+        .add(utils::get_type_name<enumeration_t>())
+        .add(enumeration.n())
+        .add(enumeration.size());
+    if (enumeration.size() > 0) {
+      bit_t first = *enumeration.begin();
+      bit_t last = *(enumeration.begin() + (enumeration.size() - 1));
+      key.add(std::string_view(bits::to_string(first, enumeration.n())))
+          .add(std::string_view(bits::to_string(last, enumeration.n())));
+    }
+    key.add(group).add(characters).add(fermionic).add(compact);
+    filename = io::basis_cache_filename("representative_table", key);
+  }
+
+  if (!filename.empty() && read_cache(filename, key)) {
+    Log(2, "Read representative table from \"{}\"", filename);
+    // compact tables might have been replaced by full ones, see below
+    compact = compact && (representative_index_.size() != enumeration.size());
+  } else {
+    // The fermionic path is only compiled for fermi_capable backends (native
+    // integers / Bitset). The BitArray-backed bosonic bases never request it, so
+    // for them we compile only the bosonic path and reject a fermionic request.
+    if constexpr (fermi_capable<bit_t>::value) {
+      if (characters.isreal()) {
+        arma::vec chars = characters.as<arma::vec>();
+        if (fermionic) {
+          representative_table_initialize<true>(
+              enumeration, action, chars, compact, representative_, representative_index_,
+              representative_symmetry_, representative_norm_index_,
+              representative_fermi_, norm_);
+        } else {
+          representative_table_initialize<false>(
+              enumeration, action, chars, compact, representative_, representative_index_,
+              representative_symmetry_, representative_norm_index_,
+              representative_fermi_, norm_);
+        }
       } else {
-        representative_table_initialize<false>(
-            enumeration, action, chars, representative_, representative_index_,
-            representative_symmetry_, representative_norm_index_,
-            representative_fermi_, norm_);
+        arma::cx_vec chars = characters.as<arma::cx_vec>();
+        if (fermionic) {
+          representative_table_initialize<true>(
+              enumeration, action, chars, compact, representative_, representative_index_,
+              representative_symmetry_, representative_norm_index_,
+              representative_fermi_, norm_);
+        } else {
+          representative_table_initialize<false>(
+              enumeration, action, chars, compact, representative_, representative_index_,
+              representative_symmetry_, representative_norm_index_,
+              representative_fermi_, norm_);
+        }
       }
     } else {
-      arma::cx_vec chars = characters.as<arma::cx_vec>();
       if (fermionic) {
-        representative_table_initialize<true>(
-            enumeration, action, chars, representative_, representative_index_,
+        XDIAG_THROW("fermionic representative tables are not supported for this "
+                    "enumeration backend (it is bosonic)");
+      }
+      if (characters.isreal()) {
+        arma::vec chars = characters.as<arma::vec>();
+        representative_table_initialize<false>(
+            enumeration, action, chars, compact, representative_, representative_index_,
             representative_symmetry_, representative_norm_index_,
             representative_fermi_, norm_);
       } else {
+        arma::cx_vec chars = characters.as<arma::cx_vec>();
         representative_table_initialize<false>(
-            enumeration, action, chars, representative_, representative_index_,
+            enumeration, action, chars, compact, representative_, representative_index_,
             representative_symmetry_, representative_norm_index_,
             representative_fermi_, norm_);
       }
     }
-  } else {
-    if (fermionic) {
-      XDIAG_THROW("fermionic representative tables are not supported for this "
-                  "enumeration backend (it is bosonic)");
-    }
-    if (characters.isreal()) {
-      arma::vec chars = characters.as<arma::vec>();
-      representative_table_initialize<false>(
-          enumeration, action, chars, representative_, representative_index_,
-          representative_symmetry_, representative_norm_index_,
-          representative_fermi_, norm_);
-    } else {
-      arma::cx_vec chars = characters.as<arma::cx_vec>();
-      representative_table_initialize<false>(
-          enumeration, action, chars, representative_, representative_index_,
-          representative_symmetry_, representative_norm_index_,
-          representative_fermi_, norm_);
+    if (!filename.empty()) {
+      write_cache(filename, key);
     }
   }
   inv_norm_.resize(norm_.size());
   for (int64_t i = 0; i < (int64_t)norm_.size(); ++i) {
     inv_norm_[i] = 1.0 / norm_[i];
   }
+
+  // Compact tables: bucket the sorted representatives by their leading bits,
+  // using about one bucket per four representatives
+  compact_ = compact;
+  if (compact_) {
+    if (!std::is_sorted(representative_.begin(), representative_.end())) {
+      XDIAG_THROW("Compact representative tables require an enumeration of "
+                  "states in ascending order");
+    }
+    action_ = action;
+    if (fermionic) {
+      fermi_blocks_ = FermiBlockTable(group);
+    }
+    int64_t nsites = action.nsites();
+    int64_t nreps = representative_.size();
+    int64_t n_prefix_bits = compact_prefix_bits(nreps, nsites);
+    n_postfix_bits_ = nsites - n_prefix_bits;
+    int64_t nprefixes = (int64_t)1 << n_prefix_bits;
+    prefix_offsets_.assign(nprefixes + 1, 0);
+    if constexpr (std::is_integral_v<bit_t>) {
+      for (bit_t rep : representative_) {
+        uint64_t prefix =
+            (n_postfix_bits_ < 64) ? ((uint64_t)rep >> n_postfix_bits_) : 0;
+        ++prefix_offsets_[prefix + 1];
+      }
+    }
+    std::partial_sum(prefix_offsets_.begin(), prefix_offsets_.end(),
+                     prefix_offsets_.begin());
+  }
 }
 XDIAG_CATCH
 
+template <typename enumeration_t>
+bool RepresentativeTable<enumeration_t>::read_cache(
+    std::string const &filename, io::CacheKey const &key) {
+  if constexpr (std::is_trivially_copyable_v<bit_t>) {
+    io::CacheReader file(filename, key);
+    file.read(representative_);
+    file.read(representative_index_);
+    file.read(representative_symmetry_);
+    file.read(representative_norm_index_);
+    file.read(representative_fermi_);
+    file.read(norm_);
+    return file.good();
+  } else {
+    return false;
+  }
+}
+
+// The cache is optional, failing to write it only issues a warning
+template <typename enumeration_t>
+void RepresentativeTable<enumeration_t>::write_cache(
+    std::string const &filename, io::CacheKey const &key) const {
+  if constexpr (std::is_trivially_copyable_v<bit_t>) {
+    try {
+      io::CacheWriter file(filename, key);
+      file.write(representative_);
+      file.write(representative_index_);
+      file.write(representative_symmetry_);
+      file.write(representative_norm_index_);
+      file.write(representative_fermi_);
+      file.write(norm_);
+      file.commit();
+      Log(2, "Wrote representative table to \"{}\"", filename);
+    } catch (Error const &e) {
+      Log.warn("Warning: unable to write representative table to basis "
+               "cache \"{}\": {}",
+               filename, e.what());
+    }
+  }
+}
+
 template <typename enumeration_t>
 int64_t RepresentativeTable<enumeration_t>::size() const {
   return representative_.size();
 }
 
+template <typename enumeration_t>
+int64_t RepresentativeTable<enumeration_t>::memory() const {
+  auto memory = [](bits::BitVector<uint64_t> const &v) {
+    return bitvector_memory(v.size(), v.nbits());
+  };
+  return (int64_t)(representative_.size() * sizeof(bit_t)) +
+         memory(representative_index_) + memory(representative_symmetry_) +
+         memory(representative_norm_index_) + memory(representative_fermi_) +
+         action_.memory() + fermi_blocks_.memory() +
+         (int64_t)((norm_.size() + inv_norm_.size()) * sizeof(double)) +
+         (int64_t)(prefix_offsets_.size() * sizeof(int64_t));
+}
+
 template <typename enumeration_t>
 bool RepresentativeTable<enumeration_t>::operator==(
     RepresentativeTable const &rhs) const {
-  return (representative_ == rhs.representative_) &&
+  return (compact_ == rhs.compact_) &&
+         (representative_ == rhs.representative_) &&
          (representative_index_ == rhs.representative_index_) &&
          (representative_symmetry_ == rhs.representative_symmetry_) &&
          (representative_norm_index_ == rhs.representative_norm_index_) &&
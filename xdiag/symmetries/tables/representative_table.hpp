@@ -4,12 +4,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <xdiag/bits/bitvector.hpp>
+#include <xdiag/io/basis_cache.hpp>
 #include <xdiag/math/vector.hpp>
+#include <xdiag/symmetries/action/representative.hpp>
 #include <xdiag/symmetries/action/site_permutation.hpp>
+#include <xdiag/symmetries/fermi_sign.hpp>
 #include <xdiag/symmetries/permutation_group.hpp>
+#include <xdiag/symmetries/tables/fermi_block_table.hpp>
 
 namespace xdiag::symmetries {
 
@@ -28,6 +36,20 @@ namespace xdiag::symmetries {
 // Iteration (begin/end) yields the representatives in enumeration order.
 // The PermutationGroup defines the action; characters are the 1-D irrep
 // characters, one per group element.
+//
+// A compact table (native integer states only) does not store the per-state
+// arrays index/symmetry/fermi, whose size is the one of the full enumeration.
+// Instead, raw_representative_index_sym(bits) computes the representative on
+// the fly and looks it up in the sorted list of representatives, bucketed by
+// its leading bits. This trades a representative search per lookup for a
+// memory footprint proportional to the number of representatives. A compact
+// table also keeps the precompiled SitePermutation. If this would not take
+// less memory than the per-state arrays, full tables are built instead and
+// compact() returns false.
+//
+// If io::basis_cache_settings.directory is set, the tables are read from and
+// written to an on-disk cache, keyed by the enumeration, group, characters and
+// options.
 template <typename enumeration_tt> class RepresentativeTable {
 public:
   using enumeration_t = enumeration_tt;
@@ -38,7 +60,7 @@ public:
   RepresentativeTable() = default;
   RepresentativeTable(enumeration_t const &enumeration,
                       PermutationGroup const &group, Vector const &characters,
-                      bool fermionic = false);
+                      bool fermionic = false, bool compact = false);
 
   inline bit_t operator[](int64_t idx) const { return representative_[idx]; }
   inline bit_t representative(int64_t idx) const {
@@ -63,7 +85,38 @@ public:
   inline bool representative_fermi_bool(int64_t idx) const {
     return representative_fermi_[idx];
   }
+
+  // Lookup for compact tables: {index of the representative of bits + 1 (0 if
+  // it has zero norm), symmetry mapping bits to its representative}
+  inline bool compact() const { return compact_; }
+  inline std::pair<int64_t, int64_t>
+  raw_representative_index_sym(bit_t bits) const {
+    if constexpr (std::is_integral_v<bit_t>) {
+      auto [rep, sym] = symmetries::representative_sym(bits, action_);
+      uint64_t prefix =
+          (n_postfix_bits_ < 64) ? ((uint64_t)rep >> n_postfix_bits_) : 0;
+      auto begin = representative_.begin() + prefix_offsets_[prefix];
+      auto end = representative_.begin() + prefix_offsets_[prefix + 1];
+      auto it = std::lower_bound(begin, end, rep);
+      if ((it != end) && (*it == rep)) {
+        return {(it - representative_.begin()) + 1, sym};
+      }
+    }
+    return {0, 0};
+  }
+  inline bool representative_fermi_bool(bit_t bits, int64_t sym) const {
+    if constexpr (std::is_integral_v<bit_t>) {
+      return fermi_blocks_.sign(sym, (uint64_t)bits);
+    } else if constexpr (fermi_capable<bit_t>::value) {
+      return fermi_bool_of_permutation(bits, action_.group().ptr(sym),
+                                       action_.nsites());
+    } else {
+      return false; // bosonic backends never hold fermionic tables
+    }
+  }
+
   int64_t size() const;
+  int64_t memory() const; // memory occupied by the tables in bytes
 
   const_iterator begin() const noexcept { return representative_.cbegin(); }
   const_iterator end() const noexcept { return representative_.cend(); }
@@ -83,6 +136,17 @@ private:
   bits::BitVector<uint64_t> representative_fermi_;
   std::vector<double> norm_;
   std::vector<double> inv_norm_;
+
+  // compact tables
+  bool compact_ = false;
+  SitePermutation action_;
+  FermiBlockTable fermi_blocks_; // only for fermionic tables
+  int64_t n_postfix_bits_ = 0;
+  std::vector<int64_t> prefix_offsets_;
+
+  // on-disk cache of the tables (cf. io::basis_cache_settings)
+  bool read_cache(std::string const &filename, io::CacheKey const &key);
+  void write_cache(std::string const &filename, io::CacheKey const &key) const;
 };
 
 } // namespace xdiag::symmetries
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "memory.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace xdiag {
+
+int64_t available_memory() {
+  // Linux: MemAvailable also accounts for reclaimable page cache
+  std::ifstream meminfo("/proc/meminfo");
+  std::string line;
+  while (std::getline(meminfo, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    int64_t kb;
+    if ((ss >> key >> kb) && (key == "MemAvailable:")) {
+      return kb * 1024;
+    }
+  }
+
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+  long pages = sysconf(_SC_AVPHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if ((pages > 0) && (page_size > 0)) {
+    return (int64_t)pages * (int64_t)page_size;
+  }
+#endif
+  return -1;
+}
+
+// Number of processes on this node, as exported by common launchers
+static int64_t processes_per_node() {
+  for (char const *var :
+       {"OMPI_COMM_WORLD_LOCAL_SIZE", "MPI_LOCALNRANKS", "MPICH_LOCALNRANKS",
+        "PMI_LOCAL_SIZE", "SLURM_NTASKS_PER_NODE"}) {
+    char const *value = std::getenv(var);
+    if (value) {
+      long n = std::strtol(value, nullptr, 10);
+      if (n > 0) {
+        return n;
+      }
+    }
+  }
+  return 1;
+}
+
+int64_t available_memory_per_process() {
+  int64_t available = available_memory();
+  if (available < 0) {
+    return -1;
+  }
+  return available / processes_per_node();
+}
+
+} // namespace xdiag
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+
+#include <xdiag/utils/xdiag_api.hpp>
+
+namespace xdiag {
+
+// Physical memory in bytes currently available to the process, as reported by
+// the operating system (MemAvailable on Linux). Returns -1 if it cannot be
+// determined.
+XDIAG_API int64_t available_memory();
+
+// Share of the available memory of a single process, i.e. available_memory()
+// divided by the number of processes the MPI launcher (or SLURM) has started
+// on this node. Does not communicate. Returns -1 if it cannot be determined.
+XDIAG_API int64_t available_memory_per_process();
+
+} // namespace xdiag
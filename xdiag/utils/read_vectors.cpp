@@ -4,7 +4,7 @@
 
 #include "read_vectors.hpp"
 
-#include <sstream>
+#include <fstream>
 #include <extern/fmt/format.hpp>
 #include <xdiag/math/complex.hpp>
 #include <xdiag/utils/error.hpp>
@@ -21,14 +21,13 @@ arma::Mat<coeff_t> read_vectors(std::string type, std::string path_to_vecs,
                                 int n) try {
   using namespace arma;
 
-  std::stringstream ss;
-  ss << type << "/" << path_to_vecs << "_" << n << ".arm";
-  std::string filename = ss.str();
+  auto filename = [&](int i) {
+    return fmt::format("{}/{}_{}.arm", path_to_vecs, type, i);
+  };
 
-  // get number of vecs if n=-1
+  // get number of vecs if n=0
   if (n == 0) {
-    n = 0;
-    while (file_exists(filename)) {
+    while (file_exists(filename(n))) {
       ++n;
     }
   } else if (n < 0) {
@@ -39,27 +38,19 @@ arma::Mat<coeff_t> read_vectors(std::string type, std::string path_to_vecs,
   if (n == 0) {
     return Mat<coeff_t>();
   } else {
-    if (!file_exists(filename)) {
-      XDIAG_THROW(fmt::format("Unable to read \"{}\" vector from file {}", type,
-                              filename));
-    }
     Col<coeff_t> v;
-    v.load(filename);
-    int64_t N = v.size();
-
-    Mat<coeff_t> Avecs(N, n);
-    Avecs.col(0) = v;
-
-    for (int i = 1; i < n; ++i) {
-      if (!file_exists(filename)) {
+    Mat<coeff_t> vecs;
+    for (int i = 0; i < n; ++i) {
+      if (!file_exists(filename(i)) || !v.load(filename(i))) {
         XDIAG_THROW(fmt::format("Unable to read \"{}\" vector from file {}",
-                                type, filename));
+                                type, filename(i)));
       }
-      v.load(filename);
-      Avecs.col(n) = v;
+      if (i == 0) {
+        vecs.set_size(v.n_elem, n);
+      }
+      vecs.col(i) = v;
     }
-
-    return Avecs;
+    return vecs;
   }
 }
 XDIAG_CATCH
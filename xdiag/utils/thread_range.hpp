@@ -43,4 +43,53 @@ inline auto thread_range(container_t const &container, int num_thread,
           index};
 }
 
+// Split a container into `nthreads` contiguous chunks of near-equal cost
+// instead of near-equal numbers of elements. `offset(i)` is the accumulated
+// cost of the elements before element i, which must be non-decreasing, and
+// `total` is the cost of all elements. The chunk boundaries are found by
+// bisection, an element is never split.
+template <typename container_t, typename offset_f>
+inline auto thread_range(container_t const &container, offset_f &&offset,
+                         int64_t total, int num_thread, int nthreads)
+    -> ThreadRange<decltype(container.begin())> {
+  int64_t size = container.size();
+
+  // first element whose offset reaches the share of thread t
+  auto first = [&](int t) -> int64_t {
+    if (t == 0) {
+      return 0;
+    } else if (t == nthreads) {
+      return size;
+    }
+    int64_t target =
+        (total / nthreads) * t + ((total % nthreads) * t) / nthreads;
+    int64_t lo = 0;
+    int64_t hi = size;
+    while (lo < hi) {
+      int64_t mid = lo + (hi - lo) / 2;
+      if (offset(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  };
+  int64_t begin = first(num_thread);
+  int64_t end = first(num_thread + 1);
+  return {container.begin() + begin, container.begin() + end, begin};
+}
+
+// Split the up-spin configurations of an electron or tJ basis, such that
+// every thread processes a near-equal number of basis states. The number of
+// dn configurations per up-spin configuration, and hence the work, can vary
+// by orders of magnitude for symmetric bases.
+template <typename basis_t>
+inline auto thread_range_ups(basis_t const &basis, int num_thread,
+                             int nthreads) {
+  return thread_range(
+      basis.basis_up(), [&](int64_t idx) { return basis.ups_offset(idx); },
+      basis.size(), num_thread, nthreads);
+}
+
 } // namespace xdiag::utils
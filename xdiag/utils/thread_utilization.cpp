@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "thread_utilization.hpp"
+
+#include <algorithm>
+
+#include <xdiag/utils/logger.hpp>
+
+namespace xdiag::utils {
+
+ThreadUtilization::ThreadUtilization(std::string name)
+    : name_(name), active_(false) {
+#ifdef _OPENMP
+  active_ = (Log.verbosity() >= 3);
+  if (active_) {
+    times_.assign(omp_get_max_threads(), -1.);
+  }
+#endif
+}
+
+ThreadUtilization::~ThreadUtilization() {
+  if (!active_) {
+    return;
+  }
+  int nthreads = 0;
+  double sum = 0.;
+  double max = 0.;
+  for (double t : times_) {
+    if (t >= 0.) {
+      ++nthreads;
+      sum += t;
+      max = std::max(max, t);
+    }
+  }
+  if ((nthreads > 0) && (max > 0.)) {
+    Log(3, "{}: {} threads, utilization {:.1f}%, max time {:.5f} secs", name_,
+        nthreads, 100. * sum / (nthreads * max), max);
+  }
+}
+
+} // namespace xdiag::utils
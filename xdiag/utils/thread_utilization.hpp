@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2026 Alexander Wietek <awietek@pks.mpg.de>
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace xdiag::utils {
+
+// Measures the time every OpenMP thread spends in a parallel region. When
+// the object is destroyed, the utilization of the threads, i.e. the mean over
+// the maximal time spent, is logged at verbosity level 3. Nothing is measured
+// at lower verbosity. Use as:
+//
+//   ThreadUtilization utilization("electron::term_offdiag");
+//   #pragma omp parallel
+//   {
+//     auto timer = utilization.timer(omp_get_thread_num());
+//     ...
+//   }
+class ThreadUtilization {
+public:
+  class Timer {
+  public:
+    Timer(ThreadUtilization &utilization, int num_thread)
+        : utilization_(utilization), num_thread_(num_thread) {
+#ifdef _OPENMP
+      if (utilization_.active_) {
+        t0_ = omp_get_wtime();
+      }
+#endif
+    }
+    ~Timer() {
+#ifdef _OPENMP
+      if (utilization_.active_) {
+        utilization_.times_[num_thread_] = omp_get_wtime() - t0_;
+      }
+#endif
+    }
+
+  private:
+    ThreadUtilization &utilization_;
+    int num_thread_;
+    double t0_ = 0.;
+  };
+
+  explicit ThreadUtilization(std::string name);
+  ~ThreadUtilization();
+  ThreadUtilization(ThreadUtilization const &) = delete;
+  ThreadUtilization &operator=(ThreadUtilization const &) = delete;
+
+  Timer timer(int num_thread) { return Timer(*this, num_thread); }
+
+private:
+  std::string name_;
+  bool active_;
+  std::vector<double> times_;
+};
+
+} // namespace xdiag::utils